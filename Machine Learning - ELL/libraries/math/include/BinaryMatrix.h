@@ -0,0 +1,374 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/BinaryMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the kernels below are defined in BinaryMatrix.cpp, which picks the AVX-512 VPOPCNTDQ, the POPCNT or the
+        // portable implementation for the host the first time one of them is called
+
+        // one implementation of the kernels below, named after the instructions it needs
+        struct PopcountKernels
+        {
+            const char* name;
+            uint64_t (*xorPopcount)(const uint64_t* pA, const uint64_t* pB, size_t numWords);
+            void (*pairwiseXorPopcount)(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement);
+        };
+
+        // the implementations the host supports, from the portable one to the one that is picked
+        const std::vector<PopcountKernels>& GetSupportedPopcountKernels();
+
+        // the number of bits set in a xor b, over numWords words
+        uint64_t XorPopcount(const uint64_t* pA, const uint64_t* pB, size_t numWords);
+
+        // pOutput[i * outputRowIncrement + j] = XorPopcount(row i of A, row j of B), for rows of numWords words
+        void PairwiseXorPopcount(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement);
+
+        // the name of the implementation picked for the host: "avx512vpopcntdq", "popcnt" or "portable"
+        const char* GetPopcountImplementationName();
+    } // namespace Internal
+
+    /// <summary>
+    /// A reference to a bit-packed binary vector: element i is bit i % 64 of word i / 64, and a set bit stands for +1
+    /// and a clear bit for -1. The bits past the size in the last word are zero.
+    /// </summary>
+    class ConstBinaryVectorReference
+    {
+    public:
+        /// <summary> Constructs a reference to packed words. </summary>
+        ///
+        /// <param name="pData"> The words. </param>
+        /// <param name="size"> The number of elements. </param>
+        ConstBinaryVectorReference(const uint64_t* pData, size_t size) :
+            _pData(pData),
+            _size(size)
+        {}
+
+        /// <summary> Gets the number of elements. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the number of 64 bit words. </summary>
+        ///
+        /// <returns> The number of words. </returns>
+        size_t NumWords() const { return (_size + 63) / 64; }
+
+        /// <summary> Gets a pointer to the words. </summary>
+        ///
+        /// <returns> The data pointer. </returns>
+        const uint64_t* GetConstDataPointer() const { return _pData; }
+
+        /// <summary> Gets an element. </summary>
+        ///
+        /// <param name="index"> The element index. </param>
+        ///
+        /// <returns> True for +1, false for -1. </returns>
+        bool operator[](size_t index) const { return (_pData[index / 64] >> (index % 64)) & 1; }
+
+    private:
+        const uint64_t* _pData;
+        size_t _size;
+    };
+
+    /// <summary> A bit-packed binary vector, 64 elements per word, with elements +1 (set bits) or -1 (clear bits). </summary>
+    class BinaryVector
+    {
+    public:
+        /// <summary> Constructs a vector of -1 elements. </summary>
+        ///
+        /// <param name="size"> The number of elements. </param>
+        explicit BinaryVector(size_t size);
+
+        /// <summary> Constructs a vector from the signs of a vector: +1 for elements greater than or equal to zero, -1 otherwise. </summary>
+        ///
+        /// <param name="vector"> The vector. </param>
+        template <typename ElementType, VectorOrientation orientation>
+        explicit BinaryVector(ConstVectorReference<ElementType, orientation> vector);
+
+        /// <summary> Gets the number of elements. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the number of 64 bit words. </summary>
+        ///
+        /// <returns> The number of words. </returns>
+        size_t NumWords() const { return _words.size(); }
+
+        /// <summary> Gets an element. </summary>
+        ///
+        /// <param name="index"> The element index. </param>
+        ///
+        /// <returns> True for +1, false for -1. </returns>
+        bool operator[](size_t index) const { return GetReference()[index]; }
+
+        /// <summary> Sets an element. </summary>
+        ///
+        /// <param name="index"> The element index. </param>
+        /// <param name="value"> True for +1, false for -1. </param>
+        void Set(size_t index, bool value);
+
+        /// <summary> Gets a pointer to the words. </summary>
+        ///
+        /// <returns> The data pointer. </returns>
+        const uint64_t* GetConstDataPointer() const { return _words.data(); }
+
+        /// <summary> Gets a reference to the vector. </summary>
+        ///
+        /// <returns> The reference. </returns>
+        ConstBinaryVectorReference GetReference() const { return { _words.data(), _size }; }
+
+        /// <summary> Converts to a reference to the vector. </summary>
+        operator ConstBinaryVectorReference() const { return GetReference(); }
+
+    private:
+        size_t _size;
+        std::vector<uint64_t> _words;
+    };
+
+    /// <summary>
+    /// A bit-packed binary matrix, with each row packed like a BinaryVector in NumWordsPerRow() words. The rows are
+    /// the codes (or the binarized weight rows of a layer), so products with another binary matrix are taken
+    /// row by row, between rows of equal length.
+    /// </summary>
+    class BinaryMatrix
+    {
+    public:
+        /// <summary> Constructs a matrix of -1 elements. </summary>
+        ///
+        /// <param name="numRows"> The number of rows. </param>
+        /// <param name="numColumns"> The number of columns. </param>
+        BinaryMatrix(size_t numRows, size_t numColumns);
+
+        /// <summary> Constructs a matrix from the signs of a matrix: +1 for elements greater than or equal to zero, -1 otherwise. </summary>
+        ///
+        /// <param name="matrix"> The matrix. </param>
+        template <typename ElementType, MatrixLayout layout>
+        explicit BinaryMatrix(ConstMatrixReference<ElementType, layout> matrix);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets the number of 64 bit words per row. </summary>
+        ///
+        /// <returns> The number of words per row. </returns>
+        size_t NumWordsPerRow() const { return (_numColumns + 63) / 64; }
+
+        /// <summary> Gets an element. </summary>
+        ///
+        /// <param name="rowIndex"> The row index. </param>
+        /// <param name="columnIndex"> The column index. </param>
+        ///
+        /// <returns> True for +1, false for -1. </returns>
+        bool operator()(size_t rowIndex, size_t columnIndex) const { return GetRow(rowIndex)[columnIndex]; }
+
+        /// <summary> Sets an element. </summary>
+        ///
+        /// <param name="rowIndex"> The row index. </param>
+        /// <param name="columnIndex"> The column index. </param>
+        /// <param name="value"> True for +1, false for -1. </param>
+        void Set(size_t rowIndex, size_t columnIndex, bool value);
+
+        /// <summary> Gets a row. </summary>
+        ///
+        /// <param name="index"> The row index. </param>
+        ///
+        /// <returns> A reference to the row. </returns>
+        ConstBinaryVectorReference GetRow(size_t index) const { return { GetRowPointer(index), _numColumns }; }
+
+        /// <summary> Gets a pointer to the words of a row. </summary>
+        ///
+        /// <param name="index"> The row index. </param>
+        ///
+        /// <returns> The row pointer. </returns>
+        const uint64_t* GetRowPointer(size_t index) const { return _words.data() + index * NumWordsPerRow(); }
+
+    private:
+        size_t _numRows;
+        size_t _numColumns;
+        std::vector<uint64_t> _words;
+    };
+
+    /// <summary> Computes the Hamming distance, the number of elements that differ. </summary>
+    ///
+    /// <param name="vectorA"> The first vector. </param>
+    /// <param name="vectorB"> The second vector, of the same size. </param>
+    ///
+    /// <returns> The Hamming distance. </returns>
+    size_t HammingDistance(ConstBinaryVectorReference vectorA, ConstBinaryVectorReference vectorB);
+
+    /// <summary> Computes the dot product of two +1/-1 vectors with XNOR and popcount, size - 2 * HammingDistance. </summary>
+    ///
+    /// <param name="vectorA"> The first vector. </param>
+    /// <param name="vectorB"> The second vector, of the same size. </param>
+    ///
+    /// <returns> The dot product. </returns>
+    int64_t XnorDot(ConstBinaryVectorReference vectorA, ConstBinaryVectorReference vectorB);
+
+    /// <summary>
+    /// Computes the Hamming distance between every row of matrixA and every row of matrixB: output(i, j) is the distance
+    /// between row i of matrixA and row j of matrixB. The rows of matrixB are visited in tiles that stay in cache, and
+    /// blocks of rows of matrixA are processed in parallel.
+    /// </summary>
+    ///
+    /// <param name="matrixA"> The first set of vectors, one per row. </param>
+    /// <param name="matrixB"> The second set of vectors, one per row, with as many columns as matrixA. </param>
+    /// <param name="output"> The matrix used to store the result, with one row per row of matrixA and one column per row of matrixB. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void PairwiseHammingDistances(const BinaryMatrix& matrixA, const BinaryMatrix& matrixB, MatrixReference<ElementType, layout> output);
+
+    /// <summary>
+    /// The popcount matrix-matrix product of +1/-1 matrices, matrixC = scalarA * matrixA * transpose(matrixB) + scalarC * matrixC,
+    /// where each product of a row of matrixA with a row of matrixB is an XnorDot. With the rows of matrixA the binarized
+    /// inputs of a layer and the rows of matrixB its binarized weights, matrixC holds the outputs of the layer.
+    /// </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The left matrix. </param>
+    /// <param name="matrixB"> The right matrix, transposed: one row per column of the product. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC, when zero matrixC is not read. </param>
+    /// <param name="matrixC"> The result matrix, with one row per row of matrixA and one column per row of matrixB. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void XnorMultiplyScaleAddUpdate(ElementType scalarA, const BinaryMatrix& matrixA, const BinaryMatrix& matrixB, ElementType scalarC, MatrixReference<ElementType, layout> matrixC);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the sign bits of the elements [64 * word, 64 * word + 64) of a row
+        template <typename GetElementType>
+        uint64_t PackSigns(size_t word, size_t size, GetElementType&& getElement)
+        {
+            uint64_t bits = 0;
+            size_t end = std::min(size, 64 * word + 64);
+            for (size_t index = 64 * word; index < end; ++index)
+            {
+                bits |= static_cast<uint64_t>(getElement(index) >= 0) << (index % 64);
+            }
+            return bits;
+        }
+
+        // calls function(i, j, count) with the number of differing bits of every row i of matrixA and row j of matrixB
+        template <typename FunctionType>
+        void ForEachXorPopcount(const BinaryMatrix& matrixA, const BinaryMatrix& matrixB, FunctionType&& function)
+        {
+            if (matrixA.NumColumns() != matrixB.NumColumns())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The binary matrices must have the same number of columns.");
+            }
+
+            // tiles of rows of matrixB that fit in a 256KB cache, against blocks of rows of matrixA
+            const size_t numWords = matrixA.NumWordsPerRow();
+            const size_t tileColumns = std::max<size_t>(16, (1 << 15) / std::max<size_t>(numWords, 1));
+            const size_t numRowsB = matrixB.NumRows();
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(numRowsB * numWords, 1));
+            utilities::ParallelFor(matrixA.NumRows(), grainSize, [&](size_t begin, size_t end) {
+                std::vector<uint32_t> tile((end - begin) * std::min(tileColumns, numRowsB));
+                for (size_t firstColumn = 0; firstColumn < numRowsB; firstColumn += tileColumns)
+                {
+                    size_t numColumns = std::min(tileColumns, numRowsB - firstColumn);
+                    PairwiseXorPopcount(matrixA.GetRowPointer(begin), end - begin, matrixB.GetRowPointer(firstColumn), numColumns, numWords, tile.data(), numColumns);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        for (size_t j = 0; j < numColumns; ++j)
+                        {
+                            function(i, firstColumn + j, tile[(i - begin) * numColumns + j]);
+                        }
+                    }
+                }
+            });
+        }
+    } // namespace Internal
+
+    template <typename ElementType, VectorOrientation orientation>
+    BinaryVector::BinaryVector(ConstVectorReference<ElementType, orientation> vector) :
+        BinaryVector(vector.Size())
+    {
+        for (size_t word = 0; word < _words.size(); ++word)
+        {
+            _words[word] = Internal::PackSigns(word, _size, [&](size_t index) { return vector[index]; });
+        }
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    BinaryMatrix::BinaryMatrix(ConstMatrixReference<ElementType, layout> matrix) :
+        BinaryMatrix(matrix.NumRows(), matrix.NumColumns())
+    {
+        size_t numWords = NumWordsPerRow();
+        for (size_t i = 0; i < _numRows; ++i)
+        {
+            for (size_t word = 0; word < numWords; ++word)
+            {
+                _words[i * numWords + word] = Internal::PackSigns(word, _numColumns, [&](size_t j) { return matrix(i, j); });
+            }
+        }
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void PairwiseHammingDistances(const BinaryMatrix& matrixA, const BinaryMatrix& matrixB, MatrixReference<ElementType, layout> output)
+    {
+        if (output.NumRows() != matrixA.NumRows() || output.NumColumns() != matrixB.NumRows())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The output must have one row per row of matrixA and one column per row of matrixB.");
+        }
+
+        Internal::ForEachXorPopcount(matrixA, matrixB, [&](size_t i, size_t j, uint32_t count) { output(i, j) = static_cast<ElementType>(count); });
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void XnorMultiplyScaleAddUpdate(ElementType scalarA, const BinaryMatrix& matrixA, const BinaryMatrix& matrixB, ElementType scalarC, MatrixReference<ElementType, layout> matrixC)
+    {
+        if (matrixC.NumRows() != matrixA.NumRows() || matrixC.NumColumns() != matrixB.NumRows())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The result must have one row per row of matrixA and one column per row of matrixB.");
+        }
+
+        const int64_t size = static_cast<int64_t>(matrixA.NumColumns());
+        Internal::ForEachXorPopcount(matrixA, matrixB, [&](size_t i, size_t j, uint32_t count) {
+            ElementType product = scalarA * static_cast<ElementType>(size - 2 * static_cast<int64_t>(count));
+            ElementType& c = matrixC(i, j);
+            c = scalarC == 0 ? product : product + scalarC * c;
+        });
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,477 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/BlockSparseMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// A matrix in block compressed sparse row (BSR) format: the matrix is cut into blocks of blockRows x blockColumns
+    /// elements and only the nonzero blocks are stored, each as a small dense row major matrix. The products run a
+    /// dense kernel on every stored block, so their cost falls with the fraction of stored blocks, unlike element-wise
+    /// sparse formats whose index overhead cancels the savings at moderate sparsity. Matrices whose sizes are not
+    /// multiples of the block size are padded with zeros in the last block row and column.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class BlockSparseMatrix
+    {
+    public:
+        /// <summary>
+        /// Prunes a dense matrix to a block mask: a block is stored when the Euclidean norm of its elements is larger
+        /// than the threshold, and dropped otherwise. With the default threshold, only the all-zero blocks are dropped.
+        /// </summary>
+        ///
+        /// <param name="matrix"> The dense matrix, it is copied and not referenced afterwards. </param>
+        /// <param name="blockRows"> The number of rows of a block. </param>
+        /// <param name="blockColumns"> The number of columns of a block. </param>
+        /// <param name="threshold"> The norm a block must exceed to be stored. </param>
+        template <MatrixLayout layout>
+        BlockSparseMatrix(ConstMatrixReference<ElementType, layout> matrix, size_t blockRows, size_t blockColumns, ElementType threshold = 0);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets the number of rows of a block. </summary>
+        ///
+        /// <returns> The number of rows of a block. </returns>
+        size_t GetBlockRows() const { return _blockRows; }
+
+        /// <summary> Gets the number of columns of a block. </summary>
+        ///
+        /// <returns> The number of columns of a block. </returns>
+        size_t GetBlockColumns() const { return _blockColumns; }
+
+        /// <summary> Gets the number of block rows, the number of rows divided by the block rows, rounded up. </summary>
+        ///
+        /// <returns> The number of block rows. </returns>
+        size_t NumBlockRows() const { return _rowOffsets.size() - 1; }
+
+        /// <summary> Gets the number of stored blocks. </summary>
+        ///
+        /// <returns> The number of stored blocks. </returns>
+        size_t NumStoredBlocks() const { return _blockColumnIndices.size(); }
+
+        /// <summary> Gets the fraction of blocks that are stored. </summary>
+        ///
+        /// <returns> The fraction of stored blocks, between 0 and 1. </returns>
+        double GetBlockDensity() const;
+
+        /// <summary> Gets an element, zero outside the stored blocks. </summary>
+        ///
+        /// <param name="row"> The row index. </param>
+        /// <param name="column"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column) const;
+
+        /// <summary> Gets the index of the first stored block of a block row, the blocks of block row b are [GetRowOffsets()[b], GetRowOffsets()[b + 1]). </summary>
+        ///
+        /// <returns> The offsets of the block rows, NumBlockRows() + 1 of them. </returns>
+        const std::vector<size_t>& GetRowOffsets() const { return _rowOffsets; }
+
+        /// <summary> Gets the block column of every stored block, increasing within a block row. </summary>
+        ///
+        /// <returns> The block column indices. </returns>
+        const std::vector<size_t>& GetBlockColumnIndices() const { return _blockColumnIndices; }
+
+        /// <summary> Gets the elements of a stored block, blockRows x blockColumns in row major order. </summary>
+        ///
+        /// <param name="block"> The index of the stored block. </param>
+        ///
+        /// <returns> Pointer to the elements. </returns>
+        const ElementType* GetBlockData(size_t block) const { return _values.data() + block * _blockRows * _blockColumns; }
+
+        /// <summary> Copies the matrix to a dense matrix of the same size, zeros included. </summary>
+        ///
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout layout>
+        void CopyTo(MatrixReference<ElementType, layout> matrix) const;
+
+    private:
+        size_t _numRows;
+        size_t _numColumns;
+        size_t _blockRows;
+        size_t _blockColumns;
+        std::vector<size_t> _rowOffsets;
+        std::vector<size_t> _blockColumnIndices;
+        std::vector<ElementType> _values;
+    };
+
+    /// <summary> Multiplies a block sparse matrix by a column vector, vectorB = scalarA * matrix * vectorA + scalarB * vectorB. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrix"> The block sparse matrix. </param>
+    /// <param name="vectorA"> The column vector. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const BlockSparseMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+    /// <summary>
+    /// Multiplies a block sparse matrix by a dense matrix, matrixC = scalarA * matrixA * matrixB + scalarC * matrixC.
+    /// A layer that computes input * transpose(weights) can pass weights as matrixA, transpose(input) as matrixB and
+    /// the transpose of its output as matrixC.
+    /// </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The block sparse matrix. </param>
+    /// <param name="matrixB"> The dense matrix. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC, when zero matrixC is not read. </param>
+    /// <param name="matrixC"> The result matrix. </param>
+    template <typename ElementType, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const BlockSparseMatrix<ElementType>& matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the products of one stored block, with a vector (sums[r] += block(r, :) . x) or with rows of a matrix; the
+        // block sizes used by pruning get fixed trip counts so that the loops unroll and vectorize, any other size
+        // runs the same loops with runtime counts
+        template <size_t blockRows, size_t blockColumns>
+        struct FixedSparseBlockKernel
+        {
+            template <typename ElementType>
+            void operator()(const ElementType* pBlock, const ElementType* pX, ElementType* pSums) const
+            {
+                for (size_t r = 0; r < blockRows; ++r)
+                {
+                    ElementType sum = 0;
+                    for (size_t c = 0; c < blockColumns; ++c)
+                    {
+                        sum += pBlock[r * blockColumns + c] * pX[c];
+                    }
+                    pSums[r] += sum;
+                }
+            }
+
+            // accumulator row r += block(r, :) * the blockColumns rows of B, in one pass over the accumulator
+            template <typename ElementType>
+            void operator()(const ElementType* pBlock, const ElementType* pB, size_t bIncrement, ElementType* pAccumulator, size_t accumulatorIncrement, size_t width) const
+            {
+                for (size_t r = 0; r < blockRows; ++r)
+                {
+                    ElementType* pRow = pAccumulator + r * accumulatorIncrement;
+                    const ElementType* pBlockRow = pBlock + r * blockColumns;
+                    for (size_t j = 0; j < width; ++j)
+                    {
+                        ElementType sum = pRow[j];
+                        for (size_t c = 0; c < blockColumns; ++c)
+                        {
+                            sum += pBlockRow[c] * pB[c * bIncrement + j];
+                        }
+                        pRow[j] = sum;
+                    }
+                }
+            }
+        };
+
+        struct SparseBlockKernel
+        {
+            size_t blockRows;
+            size_t blockColumns;
+
+            template <typename ElementType>
+            void operator()(const ElementType* pBlock, const ElementType* pX, ElementType* pSums) const
+            {
+                for (size_t r = 0; r < blockRows; ++r)
+                {
+                    ElementType sum = 0;
+                    for (size_t c = 0; c < blockColumns; ++c)
+                    {
+                        sum += pBlock[r * blockColumns + c] * pX[c];
+                    }
+                    pSums[r] += sum;
+                }
+            }
+
+            template <typename ElementType>
+            void operator()(const ElementType* pBlock, const ElementType* pB, size_t bIncrement, ElementType* pAccumulator, size_t accumulatorIncrement, size_t width) const
+            {
+                for (size_t r = 0; r < blockRows; ++r)
+                {
+                    ElementType* pRow = pAccumulator + r * accumulatorIncrement;
+                    for (size_t c = 0; c < blockColumns; ++c)
+                    {
+                        ElementType a = pBlock[r * blockColumns + c];
+                        const ElementType* pRowB = pB + c * bIncrement;
+                        for (size_t j = 0; j < width; ++j)
+                        {
+                            pRow[j] += a * pRowB[j];
+                        }
+                    }
+                }
+            }
+        };
+
+        // calls function(kernel) with the block kernel for the block size of the matrix
+        template <typename FunctionType>
+        void WithSparseBlockKernel(size_t blockRows, size_t blockColumns, FunctionType&& function)
+        {
+            if (blockRows == 4 && blockColumns == 4)
+            {
+                function(FixedSparseBlockKernel<4, 4>{});
+            }
+            else if (blockRows == 8 && blockColumns == 1)
+            {
+                function(FixedSparseBlockKernel<8, 1>{});
+            }
+            else if (blockRows == 1 && blockColumns == 8)
+            {
+                function(FixedSparseBlockKernel<1, 8>{});
+            }
+            else if (blockRows == 8 && blockColumns == 8)
+            {
+                function(FixedSparseBlockKernel<8, 8>{});
+            }
+            else
+            {
+                function(SparseBlockKernel{ blockRows, blockColumns });
+            }
+        }
+
+        // the grain of the block row loops: enough block rows to make up minElementsPerTask stored elements
+        template <typename ElementType>
+        size_t GetBlockRowGrainSize(const BlockSparseMatrix<ElementType>& matrix, size_t elementsPerBlock)
+        {
+            size_t storedPerBlockRow = matrix.NumStoredBlocks() * elementsPerBlock / std::max<size_t>(matrix.NumBlockRows(), 1);
+            return std::max<size_t>(1, minElementsPerTask / std::max<size_t>(storedPerBlockRow, 1));
+        }
+    } // namespace Internal
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    BlockSparseMatrix<ElementType>::BlockSparseMatrix(ConstMatrixReference<ElementType, layout> matrix, size_t blockRows, size_t blockColumns, ElementType threshold) :
+        _numRows(matrix.NumRows()),
+        _numColumns(matrix.NumColumns()),
+        _blockRows(blockRows),
+        _blockColumns(blockColumns),
+        _rowOffsets(1, 0)
+    {
+        if (blockRows == 0 || blockColumns == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The block sizes must be positive.");
+        }
+
+        size_t numBlockRows = (_numRows + blockRows - 1) / blockRows;
+        size_t numBlockColumns = (_numColumns + blockColumns - 1) / blockColumns;
+        std::vector<ElementType> block(blockRows * blockColumns);
+        for (size_t blockRow = 0; blockRow < numBlockRows; ++blockRow)
+        {
+            for (size_t blockColumn = 0; blockColumn < numBlockColumns; ++blockColumn)
+            {
+                double squaredNorm = 0;
+                for (size_t r = 0; r < blockRows; ++r)
+                {
+                    for (size_t c = 0; c < blockColumns; ++c)
+                    {
+                        size_t i = blockRow * blockRows + r;
+                        size_t j = blockColumn * blockColumns + c;
+                        ElementType value = i < _numRows && j < _numColumns ? matrix(i, j) : 0;
+                        block[r * blockColumns + c] = value;
+                        squaredNorm += static_cast<double>(value) * value;
+                    }
+                }
+                if (squaredNorm > 0 && std::sqrt(squaredNorm) > threshold)
+                {
+                    _blockColumnIndices.push_back(blockColumn);
+                    _values.insert(_values.end(), block.begin(), block.end());
+                }
+            }
+            _rowOffsets.push_back(_blockColumnIndices.size());
+        }
+    }
+
+    template <typename ElementType>
+    double BlockSparseMatrix<ElementType>::GetBlockDensity() const
+    {
+        size_t numBlockColumns = (_numColumns + _blockColumns - 1) / _blockColumns;
+        size_t numBlocks = NumBlockRows() * numBlockColumns;
+        return numBlocks == 0 ? 0 : static_cast<double>(NumStoredBlocks()) / numBlocks;
+    }
+
+    template <typename ElementType>
+    ElementType BlockSparseMatrix<ElementType>::operator()(size_t row, size_t column) const
+    {
+        size_t blockRow = row / _blockRows;
+        size_t blockColumn = column / _blockColumns;
+        auto begin = _blockColumnIndices.begin() + _rowOffsets[blockRow];
+        auto end = _blockColumnIndices.begin() + _rowOffsets[blockRow + 1];
+        auto found = std::lower_bound(begin, end, blockColumn);
+        if (found == end || *found != blockColumn)
+        {
+            return 0;
+        }
+        const ElementType* pBlock = GetBlockData(static_cast<size_t>(found - _blockColumnIndices.begin()));
+        return pBlock[(row % _blockRows) * _blockColumns + column % _blockColumns];
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void BlockSparseMatrix<ElementType>::CopyTo(MatrixReference<ElementType, layout> matrix) const
+    {
+        if (matrix.NumRows() != _numRows || matrix.NumColumns() != _numColumns)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The dense matrix must have the size of the block sparse matrix.");
+        }
+
+        matrix.Fill(0);
+        for (size_t blockRow = 0; blockRow < NumBlockRows(); ++blockRow)
+        {
+            for (size_t block = _rowOffsets[blockRow]; block < _rowOffsets[blockRow + 1]; ++block)
+            {
+                const ElementType* pBlock = GetBlockData(block);
+                for (size_t r = 0; r < _blockRows && blockRow * _blockRows + r < _numRows; ++r)
+                {
+                    for (size_t c = 0; c < _blockColumns && _blockColumnIndices[block] * _blockColumns + c < _numColumns; ++c)
+                    {
+                        matrix(blockRow * _blockRows + r, _blockColumnIndices[block] * _blockColumns + c) = pBlock[r * _blockColumns + c];
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const BlockSparseMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumColumns() != vectorA.Size() || matrix.NumRows() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        // a contiguous copy of x, padded to whole blocks, so that every block reads a full unit stride segment
+        const size_t R = matrix.GetBlockRows();
+        const size_t C = matrix.GetBlockColumns();
+        const size_t numBlockColumns = (matrix.NumColumns() + C - 1) / C;
+        std::vector<ElementType> x(numBlockColumns * C);
+        for (size_t j = 0; j < vectorA.Size(); ++j)
+        {
+            x[j] = vectorA[j];
+        }
+
+        const auto& rowOffsets = matrix.GetRowOffsets();
+        const auto& blockColumns = matrix.GetBlockColumnIndices();
+        Internal::WithSparseBlockKernel(R, C, [&](auto multiplyBlock) {
+            utilities::ParallelFor(matrix.NumBlockRows(), Internal::GetBlockRowGrainSize(matrix, R * C), [&](size_t begin, size_t end) {
+                std::vector<ElementType> sums(R);
+                for (size_t blockRow = begin; blockRow < end; ++blockRow)
+                {
+                    std::fill(sums.begin(), sums.end(), ElementType{ 0 });
+                    for (size_t block = rowOffsets[blockRow]; block < rowOffsets[blockRow + 1]; ++block)
+                    {
+                        multiplyBlock(matrix.GetBlockData(block), x.data() + blockColumns[block] * C, sums.data());
+                    }
+                    for (size_t r = 0; r < R && blockRow * R + r < matrix.NumRows(); ++r)
+                    {
+                        ElementType& y = vectorB[blockRow * R + r];
+                        y = scalarB == 0 ? scalarA * sums[r] : scalarA * sums[r] + scalarB * y;
+                    }
+                }
+            });
+        });
+    }
+
+    template <typename ElementType, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const BlockSparseMatrix<ElementType>& matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+    {
+        DEBUG_CHECK_SIZES(matrixA.NumColumns() != matrixB.NumRows() || matrixA.NumRows() != matrixC.NumRows() || matrixB.NumColumns() != matrixC.NumColumns(), "Incompatible matrix sizes.");
+
+        // each block element scales a row of B into a row of the accumulator, so B is read by rows: it is copied to
+        // a row major buffer padded to whole blocks when it is not row major already; the columns of B are split in
+        // panels that keep the accumulator and the rows of B in cache
+        constexpr size_t panelColumns = 256;
+        const size_t R = matrixA.GetBlockRows();
+        const size_t C = matrixA.GetBlockColumns();
+        const size_t numColumns = matrixB.NumColumns();
+        if (numColumns == 0)
+        {
+            // C has no elements to scale, and there are no panels to split the work into
+            return;
+        }
+        const size_t numBlockColumns = (matrixA.NumColumns() + C - 1) / C;
+        const ElementType* pB = matrixB.GetConstDataPointer();
+        size_t bIncrement = matrixB.GetRowIncrement();
+        std::vector<ElementType> rowMajorB;
+        if (matrixB.GetColumnIncrement() != 1 || numBlockColumns * C != matrixB.NumRows())
+        {
+            rowMajorB.assign(numBlockColumns * C * numColumns, 0);
+            for (size_t k = 0; k < matrixB.NumRows(); ++k)
+            {
+                for (size_t j = 0; j < numColumns; ++j)
+                {
+                    rowMajorB[k * numColumns + j] = matrixB(k, j);
+                }
+            }
+            pB = rowMajorB.data();
+            bIncrement = numColumns;
+        }
+
+        const size_t numPanels = (numColumns + panelColumns - 1) / panelColumns;
+        const size_t numBlockRows = matrixA.NumBlockRows();
+        const auto& rowOffsets = matrixA.GetRowOffsets();
+        const auto& blockColumns = matrixA.GetBlockColumnIndices();
+        size_t grainSize = std::max<size_t>(1, Internal::GetBlockRowGrainSize(matrixA, R * C * panelColumns) / numPanels);
+        Internal::WithSparseBlockKernel(R, C, [&](auto multiplyBlock) {
+            utilities::ParallelFor(numBlockRows * numPanels, grainSize, [&](size_t begin, size_t end) {
+                std::vector<ElementType> accumulator(R * panelColumns);
+                for (size_t task = begin; task < end; ++task)
+                {
+                    size_t blockRow = task / numPanels;
+                    size_t firstColumn = (task % numPanels) * panelColumns;
+                    size_t width = std::min(panelColumns, numColumns - firstColumn);
+                    std::fill(accumulator.begin(), accumulator.end(), ElementType{ 0 });
+                    for (size_t block = rowOffsets[blockRow]; block < rowOffsets[blockRow + 1]; ++block)
+                    {
+                        multiplyBlock(matrixA.GetBlockData(block), pB + blockColumns[block] * C * bIncrement + firstColumn, bIncrement, accumulator.data(), panelColumns, width);
+                    }
+                    for (size_t r = 0; r < R && blockRow * R + r < matrixA.NumRows(); ++r)
+                    {
+                        const ElementType* pRow = accumulator.data() + r * panelColumns;
+                        for (size_t j = 0; j < width; ++j)
+                        {
+                            ElementType& c = matrixC(blockRow * R + r, firstColumn + j);
+                            c = scalarC == 0 ? scalarA * pRow[j] : scalarA * pRow[j] + scalarC * c;
+                        }
+                    }
+                }
+            });
+        });
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
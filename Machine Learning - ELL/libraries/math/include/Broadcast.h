@@ -0,0 +1,367 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/Broadcast.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+#include "Tensor.h"
+#include "Vector.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The binary elementwise operations that support broadcasting. </summary>
+    enum class BroadcastOperation
+    {
+        add,
+        subtract,
+        multiply,
+        divide,
+        minimum,
+        maximum
+    };
+
+    /// \name Broadcasting
+    /// Computes output = A op B elementwise, with numpy broadcasting rules. The operands are aligned on their
+    /// trailing dimensions: a tensor has the logical shape (rows, columns, channels), a matrix with m rows and n
+    /// columns is treated as a tensor of shape (1, m, n), a column vector of size m as a matrix of shape (m, 1) and
+    /// a row vector of size n as a matrix of shape (1, n). Every dimension of an operand must either match the
+    /// output or be 1, in which case the operand is repeated along that dimension. The repeated operand is never
+    /// copied: the operation is one strided loop over the output, split across the thread pool, and the layouts
+    /// of the three arguments are independent. The output may be the same memory as an operand that is not
+    /// broadcast, which makes the operation an in-place update.
+    /// @{
+
+    /// <summary> Broadcasting binary operation between two tensors, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand. </param>
+    /// <param name="B"> The right operand. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Broadcasting binary operation between a tensor and a matrix, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand. </param>
+    /// <param name="B"> The right operand, which has the shape (1, rows, columns). </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, MatrixLayout layoutB, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstMatrixReference<ElementType, layoutB> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Broadcasting binary operation between a matrix and a tensor, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand, which has the shape (1, rows, columns). </param>
+    /// <param name="B"> The right operand. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Broadcasting binary operation between a tensor and a vector, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand. </param>
+    /// <param name="B"> The right operand, which has the shape (1, size, 1) for a column vector and (1, 1, size) for a row vector. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, VectorOrientation orientationB, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstVectorReference<ElementType, orientationB> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Broadcasting binary operation between a vector and a tensor, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand, which has the shape (1, size, 1) for a column vector and (1, 1, size) for a row vector. </param>
+    /// <param name="B"> The right operand. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, VectorOrientation orientationA, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstVectorReference<ElementType, orientationA> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Broadcasting binary operation between two matrices, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand. </param>
+    /// <param name="B"> The right operand. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layout>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstMatrixReference<ElementType, layoutB> B, MatrixReference<ElementType, layout> output);
+
+    /// <summary> Broadcasting binary operation between a matrix and a vector, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand. </param>
+    /// <param name="B"> The right operand, a column vector is repeated along the columns and a row vector along the rows. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, VectorOrientation orientationB, MatrixLayout layout>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstVectorReference<ElementType, orientationB> B, MatrixReference<ElementType, layout> output);
+
+    /// <summary> Broadcasting binary operation between a vector and a matrix, see the Broadcasting group. </summary>
+    ///
+    /// <typeparam name="operation"> The binary operation. </typeparam>
+    /// <param name="A"> The left operand, a column vector is repeated along the columns and a row vector along the rows. </param>
+    /// <param name="B"> The right operand. </param>
+    /// <param name="output"> The output, with the broadcast shape of the operands. </param>
+    template <BroadcastOperation operation, typename ElementType, VectorOrientation orientationA, MatrixLayout layoutB, MatrixLayout layout>
+    void Broadcast(ConstVectorReference<ElementType, orientationA> A, ConstMatrixReference<ElementType, layoutB> B, MatrixReference<ElementType, layout> output);
+
+    /// @}
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "TensorPermutationKernels.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <string>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        template <BroadcastOperation operation>
+        struct BroadcastFunction;
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::add>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a + b; }
+        };
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::subtract>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a - b; }
+        };
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::multiply>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a * b; }
+        };
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::divide>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a / b; }
+        };
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::minimum>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return b < a ? b : a; }
+        };
+
+        template <>
+        struct BroadcastFunction<BroadcastOperation::maximum>
+        {
+            template <typename ElementType>
+            static ElementType Apply(ElementType a, ElementType b) { return a < b ? b : a; }
+        };
+
+        // an operand or output of a broadcast operation, with its logical sizes and memory increments
+        template <typename DataPointerType>
+        struct BroadcastArgument
+        {
+            DataPointerType pData;
+            LogicalTriplet sizes;
+            LogicalTriplet increments;
+        };
+
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        BroadcastArgument<const ElementType*> GetBroadcastArgument(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor)
+        {
+            return { tensor.GetConstDataPointer(), { tensor.NumRows(), tensor.NumColumns(), tensor.NumChannels() }, GetLogicalIncrements<dimension0, dimension1, dimension2>(tensor.GetIncrement1(), tensor.GetIncrement2()) };
+        }
+
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        BroadcastArgument<ElementType*> GetBroadcastArgument(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor)
+        {
+            return { tensor.GetDataPointer(), { tensor.NumRows(), tensor.NumColumns(), tensor.NumChannels() }, GetLogicalIncrements<dimension0, dimension1, dimension2>(tensor.GetIncrement1(), tensor.GetIncrement2()) };
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        BroadcastArgument<const ElementType*> GetBroadcastArgument(ConstMatrixReference<ElementType, layout> matrix)
+        {
+            return { matrix.GetConstDataPointer(), { 1, matrix.NumRows(), matrix.NumColumns() }, { 0, matrix.GetRowIncrement(), matrix.GetColumnIncrement() } };
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        BroadcastArgument<ElementType*> GetBroadcastArgument(MatrixReference<ElementType, layout> matrix)
+        {
+            return { matrix.GetDataPointer(), { 1, matrix.NumRows(), matrix.NumColumns() }, { 0, matrix.GetRowIncrement(), matrix.GetColumnIncrement() } };
+        }
+
+        template <typename ElementType>
+        BroadcastArgument<const ElementType*> GetBroadcastArgument(ConstColumnVectorReference<ElementType> vector)
+        {
+            return { vector.GetConstDataPointer(), { 1, vector.Size(), 1 }, { 0, vector.GetIncrement(), 0 } };
+        }
+
+        template <typename ElementType>
+        BroadcastArgument<const ElementType*> GetBroadcastArgument(ConstRowVectorReference<ElementType> vector)
+        {
+            return { vector.GetConstDataPointer(), { 1, 1, vector.Size() }, { 0, 0, vector.GetIncrement() } };
+        }
+
+        // sets the increments of the dimensions along which an operand is repeated to zero
+        inline void ExpandBroadcastOperand(LogicalTriplet& increments, const LogicalTriplet& sizes, const LogicalTriplet& outputSizes)
+        {
+            for (size_t d = 0; d < 3; ++d)
+            {
+                if (sizes[d] != outputSizes[d])
+                {
+                    if (sizes[d] != 1)
+                    {
+                        throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "operand dimension " + std::to_string(d) + " has size " + std::to_string(sizes[d]) + ", which cannot be broadcast to " + std::to_string(outputSizes[d]));
+                    }
+                    increments[d] = 0;
+                }
+            }
+        }
+
+        // output[i] = A[i * incrementA] op B[i * incrementB], with separate loops for the increments that the
+        // compiler can vectorize: both contiguous, or one of the operands repeated
+        template <BroadcastOperation operation, typename ElementType>
+        void BroadcastVector(const ElementType* pA, size_t incrementA, const ElementType* pB, size_t incrementB, ElementType* pOutput, size_t outputIncrement, size_t size)
+        {
+            using Function = BroadcastFunction<operation>;
+            if (outputIncrement == 1 && incrementA == 1 && incrementB == 1)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pOutput[i] = Function::Apply(pA[i], pB[i]);
+                }
+            }
+            else if (outputIncrement == 1 && incrementA == 1 && incrementB == 0)
+            {
+                const ElementType b = *pB;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pOutput[i] = Function::Apply(pA[i], b);
+                }
+            }
+            else if (outputIncrement == 1 && incrementA == 0 && incrementB == 1)
+            {
+                const ElementType a = *pA;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pOutput[i] = Function::Apply(a, pB[i]);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pOutput[i * outputIncrement] = Function::Apply(pA[i * incrementA], pB[i * incrementB]);
+                }
+            }
+        }
+
+        template <BroadcastOperation operation, typename ElementType>
+        void Broadcast(BroadcastArgument<const ElementType*> A, BroadcastArgument<const ElementType*> B, BroadcastArgument<ElementType*> output)
+        {
+            const auto& sizes = output.sizes;
+            ExpandBroadcastOperand(A.increments, A.sizes, sizes);
+            ExpandBroadcastOperand(B.increments, B.sizes, sizes);
+            if (sizes[0] * sizes[1] * sizes[2] == 0)
+            {
+                return;
+            }
+
+            // the inner loop runs along the contiguous dimension of the output, the outer loops in its memory order
+            size_t inner = GetInnermostDimension(output.increments, sizes);
+            size_t middle = (inner + 1) % 3;
+            size_t outer = (inner + 2) % 3;
+            if (output.increments[middle] > output.increments[outer])
+            {
+                std::swap(middle, outer);
+            }
+
+            size_t numVectors = sizes[middle] * sizes[outer];
+            size_t grainSize = (minElementsPerTask + sizes[inner] - 1) / sizes[inner];
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    size_t i = index % sizes[middle];
+                    size_t j = index / sizes[middle];
+                    BroadcastVector<operation>(A.pData + i * A.increments[middle] + j * A.increments[outer],
+                                               A.increments[inner],
+                                               B.pData + i * B.increments[middle] + j * B.increments[outer],
+                                               B.increments[inner],
+                                               output.pData + i * output.increments[middle] + j * output.increments[outer],
+                                               output.increments[inner],
+                                               sizes[inner]);
+                }
+            });
+        }
+    } // namespace Internal
+
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, MatrixLayout layoutB, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstMatrixReference<ElementType, layoutB> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, Dimension dimensionA0, Dimension dimensionA1, Dimension dimensionA2, VectorOrientation orientationB, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstTensorReference<ElementType, dimensionA0, dimensionA1, dimensionA2> A, ConstVectorReference<ElementType, orientationB> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, VectorOrientation orientationA, Dimension dimensionB0, Dimension dimensionB1, Dimension dimensionB2, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Broadcast(ConstVectorReference<ElementType, orientationA> A, ConstTensorReference<ElementType, dimensionB0, dimensionB1, dimensionB2> B, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layout>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstMatrixReference<ElementType, layoutB> B, MatrixReference<ElementType, layout> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, MatrixLayout layoutA, VectorOrientation orientationB, MatrixLayout layout>
+    void Broadcast(ConstMatrixReference<ElementType, layoutA> A, ConstVectorReference<ElementType, orientationB> B, MatrixReference<ElementType, layout> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+
+    template <BroadcastOperation operation, typename ElementType, VectorOrientation orientationA, MatrixLayout layoutB, MatrixLayout layout>
+    void Broadcast(ConstVectorReference<ElementType, orientationA> A, ConstMatrixReference<ElementType, layoutB> B, MatrixReference<ElementType, layout> output)
+    {
+        Internal::Broadcast<operation>(Internal::GetBroadcastArgument(A), Internal::GetBroadcastArgument(B), Internal::GetBroadcastArgument(output));
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -8,6 +8,8 @@
 
 #pragma once 
 
+#include <cstddef>
+
 namespace ell 
 {
     namespace math
@@ -15,11 +17,26 @@ namespace ell
         enum class ImplementationType 
         {
             native,
-            openBlas
+            openBlas,
+            blocked,    // cache blocked and multi-threaded, for large products
+            automatic   // chosen per call from the problem size, see ImplementationThresholds.h
         };   
 
+        enum class ConvolutionMethod
+        {
+            direct,
+            fft,        // overlap-save with real FFTs, for long kernels
+            automatic   // chosen per call from the kernel size, see ImplementationThresholds.h
+        };
+
         struct One
         {};
-        
+
+        namespace Internal
+        {
+            // the smallest amount of elements worth handing to another thread
+            constexpr size_t minElementsPerTask = 1 << 14;
+        }
+
     } 
 }
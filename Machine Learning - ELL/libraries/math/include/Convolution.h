@@ -0,0 +1,214 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/Convolution.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Vector.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Full one dimensional convolution, output[i] = sum_j kernel[j] * signal[i - j], for i from 0 to
+    /// signal.Size() + kernel.Size() - 2; the output elements that overlap the signal completely are the
+    /// subvector at kernel.Size() - 1 of size signal.Size() - kernel.Size() + 1. The direct method costs
+    /// signal.Size() * kernel.Size() operations, the FFT method a few times log2(kernel.Size()) operations per output.
+    /// </summary>
+    ///
+    /// <typeparam name="method"> The method: direct, fft or automatic (see ImplementationThresholds.h). </typeparam>
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <typeparam name="orientation"> The vector orientation. </typeparam>
+    /// <param name="signal"> The signal, which must not be empty. </param>
+    /// <param name="kernel"> The kernel, which must not be empty. </param>
+    /// <param name="output"> The output, of size signal.Size() + kernel.Size() - 1. </param>
+    template <ConvolutionMethod method = ConvolutionMethod::automatic, typename ElementType, VectorOrientation orientation>
+    void Convolve(ConstVectorReference<ElementType, orientation> signal, ConstVectorReference<ElementType, orientation> kernel, VectorReference<ElementType, orientation> output);
+
+    /// <summary>
+    /// Full one dimensional correlation, output[i] = sum_j kernel[j] * signal[i + j - (kernel.Size() - 1)], which is
+    /// the convolution with the reversed kernel; the output elements that overlap the signal completely are the
+    /// subvector at kernel.Size() - 1 of size signal.Size() - kernel.Size() + 1.
+    /// </summary>
+    ///
+    /// <typeparam name="method"> The method: direct, fft or automatic (see ImplementationThresholds.h). </typeparam>
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <typeparam name="orientation"> The vector orientation. </typeparam>
+    /// <param name="signal"> The signal, which must not be empty. </param>
+    /// <param name="kernel"> The kernel, which must not be empty. </param>
+    /// <param name="output"> The output, of size signal.Size() + kernel.Size() - 1. </param>
+    template <ConvolutionMethod method = ConvolutionMethod::automatic, typename ElementType, VectorOrientation orientation>
+    void Correlate(ConstVectorReference<ElementType, orientation> signal, ConstVectorReference<ElementType, orientation> kernel, VectorReference<ElementType, orientation> output);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "FFT.h"
+#include "ImplementationThresholds.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        template <typename ElementType, VectorOrientation orientation>
+        std::vector<ElementType> ToContiguous(ConstVectorReference<ElementType, orientation> vector, bool reverse)
+        {
+            std::vector<ElementType> result(vector.Size());
+            for (size_t i = 0; i < vector.Size(); ++i)
+            {
+                result[reverse ? vector.Size() - 1 - i : i] = vector[i];
+            }
+            return result;
+        }
+
+        // each task computes a range of outputs as kernel.size() passes of y[i] += kernel[j] * signal[i - j]
+        // over the range, which the compiler vectorizes
+        template <typename ElementType, VectorOrientation orientation>
+        void DirectConvolve(const std::vector<ElementType>& signal, const std::vector<ElementType>& kernel, VectorReference<ElementType, orientation> output)
+        {
+            size_t outputSize = output.Size();
+            size_t grainSize = std::max<size_t>(256, minElementsPerTask / kernel.size());
+            utilities::ParallelFor(outputSize, grainSize, [&](size_t begin, size_t end) {
+                std::vector<ElementType> sums(end - begin);
+                for (size_t j = 0; j < kernel.size(); ++j)
+                {
+                    // the outputs i in [begin, end) with 0 <= i - j < signal.size()
+                    size_t first = std::max(begin, j);
+                    size_t last = std::min(end, j + signal.size());
+                    if (first >= last)
+                    {
+                        // the pointers below would point past the signal or the sums
+                        continue;
+                    }
+                    ElementType weight = kernel[j];
+                    const ElementType* pSignal = signal.data() + (first - j);
+                    ElementType* pSums = sums.data() + (first - begin);
+                    for (size_t i = 0; i < last - first; ++i)
+                    {
+                        pSums[i] += weight * pSignal[i];
+                    }
+                }
+                for (size_t i = begin; i < end; ++i)
+                {
+                    output[i] = sums[i - begin];
+                }
+            });
+        }
+
+        // overlap-save: a block of blockSize - (kernel.size() - 1) outputs is the valid part of the circular
+        // convolution of the kernel with the blockSize signal elements that end at the last output; the blocks
+        // are independent, and are computed in parallel
+        template <typename ElementType, VectorOrientation orientation>
+        void FFTConvolve(const std::vector<ElementType>& signal, const std::vector<ElementType>& kernel, VectorReference<ElementType, orientation> output)
+        {
+            using ComplexType = std::complex<ElementType>;
+            size_t outputSize = output.Size();
+            size_t overlap = kernel.size() - 1;
+            size_t blockSize = 64;
+            while (blockSize < 4 * kernel.size() && blockSize < outputSize + overlap)
+            {
+                blockSize *= 2;
+            }
+            size_t outputsPerBlock = blockSize - overlap;
+            size_t numBlocks = (outputSize + outputsPerBlock - 1) / outputsPerBlock;
+
+            RealFFTPlan<ElementType> plan(blockSize);
+            ColumnVector<ElementType> paddedKernel(blockSize);
+            std::copy(kernel.begin(), kernel.end(), paddedKernel.GetDataPointer());
+            ColumnVector<ComplexType> kernelSpectrum(plan.SpectrumSize());
+            plan.Forward(ConstColumnVectorReference<ElementType>(paddedKernel), kernelSpectrum.GetReference());
+
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / blockSize);
+            utilities::ParallelFor(numBlocks, grainSize, [&](size_t begin, size_t end) {
+                ColumnVector<ElementType> block(blockSize);
+                ColumnVector<ComplexType> spectrum(plan.SpectrumSize());
+                for (size_t blockIndex = begin; blockIndex < end; ++blockIndex)
+                {
+                    // block element r holds signal[first + r - overlap], or zero outside the signal
+                    size_t first = blockIndex * outputsPerBlock;
+                    for (size_t r = 0; r < blockSize; ++r)
+                    {
+                        size_t index = first + r;
+                        block[r] = index >= overlap && index - overlap < signal.size() ? signal[index - overlap] : ElementType{ 0 };
+                    }
+                    plan.Forward(ConstColumnVectorReference<ElementType>(block), spectrum.GetReference());
+                    for (size_t k = 0; k < spectrum.Size(); ++k)
+                    {
+                        const ComplexType a = spectrum[k];
+                        const ComplexType b = kernelSpectrum[k];
+                        spectrum[k] = { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+                    }
+                    plan.Inverse(ConstColumnVectorReference<ComplexType>(spectrum), block.GetReference());
+
+                    size_t count = std::min(outputsPerBlock, outputSize - first);
+                    for (size_t r = 0; r < count; ++r)
+                    {
+                        output[first + r] = block[overlap + r];
+                    }
+                }
+            });
+        }
+
+        template <ConvolutionMethod method, typename ElementType, VectorOrientation orientation>
+        void Convolve(ConstVectorReference<ElementType, orientation> signal, ConstVectorReference<ElementType, orientation> kernel, VectorReference<ElementType, orientation> output, bool reverseKernel)
+        {
+            if (signal.Size() == 0 || kernel.Size() == 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The signal and the kernel must not be empty.");
+            }
+            if (output.Size() != signal.Size() + kernel.Size() - 1)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The output size must be signal size + kernel size - 1.");
+            }
+
+            ConvolutionMethod type = method == ConvolutionMethod::automatic ? ChooseConvolutionMethod(signal.Size(), kernel.Size()) : method;
+            auto contiguousSignal = ToContiguous(signal, false);
+            auto contiguousKernel = ToContiguous(kernel, reverseKernel);
+            if (type == ConvolutionMethod::fft)
+            {
+                // the shorter argument is the better kernel, since the FFT size grows with the kernel
+                if (contiguousKernel.size() > contiguousSignal.size())
+                {
+                    std::swap(contiguousKernel, contiguousSignal);
+                }
+                FFTConvolve(contiguousSignal, contiguousKernel, output);
+            }
+            else
+            {
+                DirectConvolve(contiguousSignal, contiguousKernel, output);
+            }
+        }
+    } // namespace Internal
+
+    template <ConvolutionMethod method, typename ElementType, VectorOrientation orientation>
+    void Convolve(ConstVectorReference<ElementType, orientation> signal, ConstVectorReference<ElementType, orientation> kernel, VectorReference<ElementType, orientation> output)
+    {
+        Internal::Convolve<method>(signal, kernel, output, false);
+    }
+
+    template <ConvolutionMethod method, typename ElementType, VectorOrientation orientation>
+    void Correlate(ConstVectorReference<ElementType, orientation> signal, ConstVectorReference<ElementType, orientation> kernel, VectorReference<ElementType, orientation> output)
+    {
+        Internal::Convolve<method>(signal, kernel, output, true);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
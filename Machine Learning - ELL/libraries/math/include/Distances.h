@@ -0,0 +1,206 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/Distances.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The measures computed by PairwiseDistances. </summary>
+    enum class DistanceMetric
+    {
+        squaredEuclidean, // |x - y|^2, computed as |x|^2 + |y|^2 - 2 x.y and clamped at zero
+        cosine, // 1 - x.y / (|x| |y|), and 1 when either vector is zero
+        innerProduct // x.y, a similarity: larger values are closer
+    };
+
+    /// <summary>
+    /// Computes the distance between every row of matrixA and every row of matrixB: output(i, j) is the distance
+    /// between row i of matrixA and row j of matrixB. All the inner products come from one matrix-matrix
+    /// multiplication, and the row norms are applied to its result in a second pass over the output.
+    /// </summary>
+    ///
+    /// <typeparam name="metric"> The distance metric. </typeparam>
+    /// <typeparam name="implementation"> The implementation of the matrix-matrix multiplication. </typeparam>
+    /// <param name="matrixA"> The first set of vectors, one per row. </param>
+    /// <param name="matrixB"> The second set of vectors, one per row, with as many columns as matrixA. </param>
+    /// <param name="output"> The matrix used to store the result, with one row per row of matrixA and one column per row of matrixB. </param>
+    template <DistanceMetric metric, ImplementationType implementation = ImplementationType::automatic, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout outputLayout>
+    void PairwiseDistances(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, MatrixReference<ElementType, outputLayout> output);
+
+    /// <summary>
+    /// Computes the same distances as PairwiseDistances, one tile at a time, without ever storing the full output.
+    /// Each tile covers up to tileRows rows of matrixA and tileColumns rows of matrixB; it is computed into a buffer
+    /// and passed to consumer(firstRow, firstColumn, tile), where tile(i, j) is the distance between row firstRow + i
+    /// of matrixA and row firstColumn + j of matrixB. The consumer is called on the calling thread, one tile at a
+    /// time, for the tiles of each block of rows in increasing order of columns, so it can keep per-row state
+    /// (such as the nearest neighbors found so far) without synchronization. The tile is only valid during the call.
+    /// </summary>
+    ///
+    /// <typeparam name="metric"> The distance metric. </typeparam>
+    /// <typeparam name="implementation"> The implementation of the matrix-matrix multiplications. </typeparam>
+    /// <typeparam name="ConsumerType"> A callable with signature void(size_t, size_t, ConstRowMatrixReference&lt;ElementType&gt;). </typeparam>
+    /// <param name="matrixA"> The first set of vectors, one per row. </param>
+    /// <param name="matrixB"> The second set of vectors, one per row, with as many columns as matrixA. </param>
+    /// <param name="consumer"> The callable that receives the tiles. </param>
+    /// <param name="tileRows"> The maximum number of rows of matrixA per tile. </param>
+    /// <param name="tileColumns"> The maximum number of rows of matrixB per tile. </param>
+    template <DistanceMetric metric, ImplementationType implementation = ImplementationType::automatic, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, typename ConsumerType>
+    void StreamPairwiseDistances(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ConsumerType&& consumer, size_t tileRows = 256, size_t tileColumns = 2048);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "MatrixOperations.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the value stored per row for each metric: the squared norm for squaredEuclidean, the inverse norm (or 0 for a
+        // zero row) for cosine, and nothing for innerProduct
+        template <DistanceMetric metric, typename ElementType, MatrixLayout layout>
+        std::vector<ElementType> GetDistanceRowFactors(ConstMatrixReference<ElementType, layout> matrix)
+        {
+            if (metric == DistanceMetric::innerProduct)
+            {
+                return {};
+            }
+
+            std::vector<ElementType> factors(matrix.NumRows());
+            size_t size = matrix.NumColumns();
+            size_t grainSize = size == 0 ? matrix.NumRows() : (minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(matrix.NumRows(), grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ElementType squaredNorm = matrix.GetRow(i).Norm2Squared();
+                    factors[i] = metric == DistanceMetric::squaredEuclidean ? squaredNorm : (squaredNorm > 0 ? 1 / std::sqrt(squaredNorm) : 0);
+                }
+            });
+            return factors;
+        }
+
+        // multiplies the two blocks of rows into output and turns the inner products into distances, given the
+        // factors of the rows of each block
+        template <DistanceMetric metric, ImplementationType implementation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout outputLayout>
+        void ComputeDistances(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, const ElementType* pFactorsA, const ElementType* pFactorsB, MatrixReference<ElementType, outputLayout> output)
+        {
+            ElementType scalar = metric == DistanceMetric::squaredEuclidean ? -2 : 1;
+            MultiplyScaleAddUpdate<implementation>(scalar, matrixA, matrixB.Transpose(), ElementType{ 0 }, output);
+            if (metric == DistanceMetric::innerProduct)
+            {
+                return;
+            }
+
+            // along the contiguous vectors of the output
+            const bool byRows = outputLayout == MatrixLayout::rowMajor;
+            const size_t numVectors = output.GetMinorSize();
+            const size_t size = output.GetMajorSize();
+            const ElementType* pVectorFactors = byRows ? pFactorsA : pFactorsB;
+            const ElementType* pElementFactors = byRows ? pFactorsB : pFactorsA;
+            ElementType* pData = output.GetDataPointer();
+            size_t grainSize = size == 0 ? numVectors : (minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ElementType* pVector = pData + i * output.GetIncrement();
+                    ElementType vectorFactor = pVectorFactors[i];
+                    if (metric == DistanceMetric::squaredEuclidean)
+                    {
+                        for (size_t j = 0; j < size; ++j)
+                        {
+                            ElementType distance = pVector[j] + vectorFactor + pElementFactors[j];
+                            pVector[j] = distance > 0 ? distance : 0;
+                        }
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < size; ++j)
+                        {
+                            pVector[j] = 1 - pVector[j] * vectorFactor * pElementFactors[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB>
+        void CheckDistanceSizes(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB)
+        {
+            if (matrixA.NumColumns() != matrixB.NumColumns())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The two sets of vectors must have the same number of columns.");
+            }
+        }
+    } // namespace Internal
+
+    template <DistanceMetric metric, ImplementationType implementation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout outputLayout>
+    void PairwiseDistances(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, MatrixReference<ElementType, outputLayout> output)
+    {
+        Internal::CheckDistanceSizes(matrixA, matrixB);
+        if (output.NumRows() != matrixA.NumRows() || output.NumColumns() != matrixB.NumRows())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The output must have one row per row of matrixA and one column per row of matrixB.");
+        }
+
+        auto factorsA = Internal::GetDistanceRowFactors<metric>(matrixA);
+        auto factorsB = Internal::GetDistanceRowFactors<metric>(matrixB);
+        Internal::ComputeDistances<metric, implementation>(matrixA, matrixB, factorsA.data(), factorsB.data(), output);
+    }
+
+    template <DistanceMetric metric, ImplementationType implementation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, typename ConsumerType>
+    void StreamPairwiseDistances(ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ConsumerType&& consumer, size_t tileRows, size_t tileColumns)
+    {
+        Internal::CheckDistanceSizes(matrixA, matrixB);
+        if (tileRows == 0 || tileColumns == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The tile sizes must be positive.");
+        }
+
+        const size_t numRows = matrixA.NumRows();
+        const size_t numColumns = matrixB.NumRows();
+        const size_t depth = matrixA.NumColumns();
+        tileRows = std::min(tileRows, numRows);
+        tileColumns = std::min(tileColumns, numColumns);
+
+        // the factors of matrixB are computed once, those of matrixA one block of rows at a time
+        auto factorsB = Internal::GetDistanceRowFactors<metric>(matrixB);
+        RowMatrix<ElementType> buffer(tileRows, tileColumns);
+        for (size_t firstRow = 0; firstRow < numRows; firstRow += tileRows)
+        {
+            size_t blockRows = std::min(tileRows, numRows - firstRow);
+            auto blockA = matrixA.GetSubMatrix(firstRow, 0, blockRows, depth);
+            auto factorsA = Internal::GetDistanceRowFactors<metric>(blockA);
+            for (size_t firstColumn = 0; firstColumn < numColumns; firstColumn += tileColumns)
+            {
+                size_t blockColumns = std::min(tileColumns, numColumns - firstColumn);
+                auto blockB = matrixB.GetSubMatrix(firstColumn, 0, blockColumns, depth);
+                auto tile = buffer.GetSubMatrix(0, 0, blockRows, blockColumns);
+                Internal::ComputeDistances<metric, implementation>(blockA, blockB, factorsA.data(), factorsB.data() + (factorsB.empty() ? 0 : firstColumn), tile);
+                consumer(firstRow, firstColumn, ConstRowMatrixReference<ElementType>(tile));
+            }
+        }
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,348 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/ElementConversion.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> An IEEE 754 half precision floating point number, used as a storage type. </summary>
+    struct Float16
+    {
+        Float16() = default;
+
+        /// <summary> Converts from float, rounding to the nearest half precision value (ties to even). </summary>
+        explicit Float16(float value);
+
+        /// <summary> Converts to float, which is exact. </summary>
+        explicit operator float() const;
+
+        uint16_t bits = 0;
+    };
+
+    /// <summary> A bfloat16 number (the upper half of a float), used as a storage type. </summary>
+    struct BFloat16
+    {
+        BFloat16() = default;
+
+        /// <summary> Converts from float, rounding to the nearest bfloat16 value (ties to even). </summary>
+        explicit BFloat16(float value);
+
+        /// <summary> Converts to float, which is exact. </summary>
+        explicit operator float() const;
+
+        uint16_t bits = 0;
+    };
+
+    /// <summary> Options of the element type conversions. </summary>
+    struct ConversionOptions
+    {
+        /// <summary> Each source element is multiplied by this value before it is converted. </summary>
+        double scale = 1.0;
+
+        /// <summary>
+        /// When true, values outside the range of the target type are clamped to it, conversions to integer
+        /// types round to the nearest integer and NaN converts to zero. When false, conversions behave like
+        /// static_cast, and values outside the target range are undefined.
+        /// </summary>
+        bool saturate = false;
+    };
+
+    /// <summary>
+    /// Converts a strided array of elements to another element type. Supported element types are float, double,
+    /// int32_t, int16_t, int8_t, uint8_t, Float16 and BFloat16. Contiguous arrays are converted in loops that the
+    /// compiler vectorizes, including the Float16 and BFloat16 conversions, which are branch free. Without
+    /// options, arithmetic types convert exactly like static_cast.
+    /// </summary>
+    ///
+    /// <param name="pSource"> The source elements. </param>
+    /// <param name="sourceIncrement"> The distance between consecutive source elements. </param>
+    /// <param name="pTarget"> The target elements. </param>
+    /// <param name="targetIncrement"> The distance between consecutive target elements. </param>
+    /// <param name="size"> The number of elements. </param>
+    /// <param name="options"> The conversion options. </param>
+    template <typename SourceType, typename TargetType>
+    void ConvertElements(const SourceType* pSource, size_t sourceIncrement, TargetType* pTarget, size_t targetIncrement, size_t size, ConversionOptions options = {});
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        inline uint32_t FloatToBits(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float BitsToFloat(uint32_t bits)
+        {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // every case is computed and the result is selected, so that loops over arrays vectorize
+        inline uint16_t FloatToHalfBits(float value)
+        {
+            const uint32_t infinity = 255u << 23;
+            const uint32_t halfOverflow = (127u + 16) << 23; // 65536, the first value that rounds to infinity
+            const uint32_t halfNormal = (127u - 14) << 23; // 2^-14, the smallest normal half
+
+            uint32_t bits = FloatToBits(value);
+            uint32_t sign = bits & 0x80000000u;
+            bits ^= sign;
+
+            // subnormal results: adding 0.5 aligns the mantissa so that the float addition does the rounding
+            uint32_t subnormal = FloatToBits(BitsToFloat(bits) + 0.5f) - FloatToBits(0.5f);
+
+            // normal results: rebias the exponent and round the mantissa to nearest, ties to even
+            uint32_t normal = (bits + ((15u - 127u) << 23) + 0xfffu + ((bits >> 13) & 1u)) >> 13;
+
+            uint32_t special = bits > infinity ? 0x7e00u : 0x7c00u;
+            uint32_t result = bits >= halfOverflow ? special : (bits < halfNormal ? subnormal : normal);
+            return static_cast<uint16_t>(result | (sign >> 16));
+        }
+
+        inline float HalfBitsToFloat(uint16_t half)
+        {
+            const uint32_t shiftedExponent = 0x7c00u << 13;
+            uint32_t bits = (static_cast<uint32_t>(half) & 0x7fffu) << 13;
+            uint32_t exponent = bits & shiftedExponent;
+            bits += (127u - 15u) << 23;
+
+            uint32_t special = bits + ((128u - 16u) << 23);
+            uint32_t subnormal = FloatToBits(BitsToFloat(bits + (1u << 23)) - BitsToFloat(113u << 23));
+            uint32_t result = exponent == shiftedExponent ? special : (exponent == 0 ? subnormal : bits);
+            return BitsToFloat(result | ((static_cast<uint32_t>(half) & 0x8000u) << 16));
+        }
+
+        inline uint16_t FloatToBFloatBits(float value)
+        {
+            uint32_t bits = FloatToBits(value);
+            uint32_t rounded = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+            uint32_t quietNaN = (bits >> 16) | 0x40u;
+            return static_cast<uint16_t>((bits & 0x7fffffffu) > 0x7f800000u ? quietNaN : rounded);
+        }
+
+        inline float BFloatBitsToFloat(uint16_t bfloat)
+        {
+            return BitsToFloat(static_cast<uint32_t>(bfloat) << 16);
+        }
+
+        // How each element type converts to and from the type the conversions compute in, and its range.
+        template <typename ElementType>
+        struct ConversionTraits
+        {
+            static_assert(std::is_arithmetic<ElementType>::value, "unsupported element type");
+            static constexpr bool isInteger = std::is_integral<ElementType>::value;
+
+            template <typename ComputeType>
+            static ComputeType ToCompute(ElementType value) { return static_cast<ComputeType>(value); }
+
+            template <typename ComputeType>
+            static ElementType FromCompute(ComputeType value) { return static_cast<ElementType>(value); }
+
+            static constexpr double Lowest() { return static_cast<double>(std::numeric_limits<ElementType>::lowest()); }
+            static constexpr double Max() { return static_cast<double>(std::numeric_limits<ElementType>::max()); }
+        };
+
+        template <>
+        struct ConversionTraits<Float16>
+        {
+            static constexpr bool isInteger = false;
+
+            template <typename ComputeType>
+            static ComputeType ToCompute(Float16 value) { return static_cast<ComputeType>(HalfBitsToFloat(value.bits)); }
+
+            template <typename ComputeType>
+            static Float16 FromCompute(ComputeType value)
+            {
+                Float16 result;
+                result.bits = FloatToHalfBits(static_cast<float>(value));
+                return result;
+            }
+
+            static constexpr double Lowest() { return -65504.0; }
+            static constexpr double Max() { return 65504.0; }
+        };
+
+        template <>
+        struct ConversionTraits<BFloat16>
+        {
+            static constexpr bool isInteger = false;
+
+            template <typename ComputeType>
+            static ComputeType ToCompute(BFloat16 value) { return static_cast<ComputeType>(BFloatBitsToFloat(value.bits)); }
+
+            template <typename ComputeType>
+            static BFloat16 FromCompute(ComputeType value)
+            {
+                BFloat16 result;
+                result.bits = FloatToBFloatBits(static_cast<float>(value));
+                return result;
+            }
+
+            static constexpr double Lowest() { return -3.38953139e38; }
+            static constexpr double Max() { return 3.38953139e38; }
+        };
+
+        // the conversions compute in double when either type is double or holds integers that float cannot represent
+        template <typename SourceType, typename TargetType>
+        struct ConversionComputeType
+        {
+            using Type = typename std::conditional<std::is_same<SourceType, double>::value || std::is_same<TargetType, double>::value || std::is_same<SourceType, int32_t>::value || std::is_same<TargetType, int32_t>::value, double, float>::type;
+        };
+
+        // a plain conversion between arithmetic types (or to the same type) is a static_cast, which keeps the
+        // integer to integer semantics
+        template <typename SourceType, typename TargetType>
+        TargetType ConvertPlain(SourceType value, std::true_type)
+        {
+            return static_cast<TargetType>(value);
+        }
+
+        template <typename SourceType, typename TargetType>
+        TargetType ConvertPlain(SourceType value, std::false_type)
+        {
+            using ComputeType = typename ConversionComputeType<SourceType, TargetType>::Type;
+            return ConversionTraits<TargetType>::template FromCompute<ComputeType>(ConversionTraits<SourceType>::template ToCompute<ComputeType>(value));
+        }
+
+        template <typename SourceType, typename TargetType>
+        TargetType ConvertPlain(SourceType value)
+        {
+            using IsStaticCast = std::integral_constant<bool, std::is_same<SourceType, TargetType>::value || (std::is_arithmetic<SourceType>::value && std::is_arithmetic<TargetType>::value)>;
+            return ConvertPlain<SourceType, TargetType>(value, IsStaticCast{});
+        }
+
+        template <typename ComputeType>
+        ComputeType RoundToInteger(ComputeType value, std::true_type)
+        {
+            return std::nearbyint(value);
+        }
+
+        template <typename ComputeType>
+        ComputeType RoundToInteger(ComputeType value, std::false_type)
+        {
+            return value;
+        }
+
+        template <typename SourceType, typename TargetType, bool isSaturated>
+        TargetType ConvertScaled(SourceType value, typename ConversionComputeType<SourceType, TargetType>::Type scale)
+        {
+            using ComputeType = typename ConversionComputeType<SourceType, TargetType>::Type;
+            using Traits = ConversionTraits<TargetType>;
+            ComputeType x = ConversionTraits<SourceType>::template ToCompute<ComputeType>(value) * scale;
+            if (isSaturated)
+            {
+                x = RoundToInteger(x, std::integral_constant<bool, Traits::isInteger>{});
+                const ComputeType lowest = static_cast<ComputeType>(Traits::Lowest());
+                const ComputeType highest = static_cast<ComputeType>(Traits::Max());
+                x = x == x ? (x < lowest ? lowest : (x > highest ? highest : x)) : 0;
+            }
+            return Traits::template FromCompute<ComputeType>(x);
+        }
+
+        // converts one element, with the options fixed at compile time so that the loops that call it vectorize
+        template <typename SourceType, typename TargetType, bool isScaled, bool isSaturated>
+        struct ElementConverter
+        {
+            typename ConversionComputeType<SourceType, TargetType>::Type scale;
+
+            TargetType operator()(SourceType value) const
+            {
+                return isScaled || isSaturated ? ConvertScaled<SourceType, TargetType, isSaturated>(value, scale) : ConvertPlain<SourceType, TargetType>(value);
+            }
+        };
+
+        // calls function with the ElementConverter that implements the options
+        template <typename SourceType, typename TargetType, typename FunctionType>
+        void WithElementConverter(ConversionOptions options, FunctionType function)
+        {
+            using ComputeType = typename ConversionComputeType<SourceType, TargetType>::Type;
+            auto scale = static_cast<ComputeType>(options.scale);
+            if (options.saturate)
+            {
+                function(ElementConverter<SourceType, TargetType, true, true>{ scale });
+            }
+            else if (options.scale != 1.0)
+            {
+                function(ElementConverter<SourceType, TargetType, true, false>{ scale });
+            }
+            else
+            {
+                function(ElementConverter<SourceType, TargetType, false, false>{ scale });
+            }
+        }
+
+        template <typename SourceType, typename TargetType, typename ConverterType>
+        void ConvertElements(const SourceType* pSource, size_t sourceIncrement, TargetType* pTarget, size_t targetIncrement, size_t size, ConverterType converter)
+        {
+            if (sourceIncrement == 1 && targetIncrement == 1)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pTarget[i] = converter(pSource[i]);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pTarget[i * targetIncrement] = converter(pSource[i * sourceIncrement]);
+                }
+            }
+        }
+    } // namespace Internal
+
+    inline Float16::Float16(float value) :
+        bits(Internal::FloatToHalfBits(value))
+    {}
+
+    inline Float16::operator float() const
+    {
+        return Internal::HalfBitsToFloat(bits);
+    }
+
+    inline BFloat16::BFloat16(float value) :
+        bits(Internal::FloatToBFloatBits(value))
+    {}
+
+    inline BFloat16::operator float() const
+    {
+        return Internal::BFloatBitsToFloat(bits);
+    }
+
+    template <typename SourceType, typename TargetType>
+    void ConvertElements(const SourceType* pSource, size_t sourceIncrement, TargetType* pTarget, size_t targetIncrement, size_t size, ConversionOptions options)
+    {
+        Internal::WithElementConverter<SourceType, TargetType>(options, [&](auto converter) {
+            Internal::ConvertElements(pSource, sourceIncrement, pTarget, targetIncrement, size, converter);
+        });
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,394 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/FFT.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Vector.h"
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // one pass of a Stockham transform, see FFTPlan::Transform
+        struct FFTStage
+        {
+            size_t radix;
+            size_t length;
+            size_t twiddleOffset;
+        };
+
+        // a radix pass of the Stockham transform: reads radix interleaved transforms of the given length from
+        // pInput and writes one transform radix times as long to pOutput; stride is the number of transforms
+        // computed side by side. The twiddles hold (radix - 1) * length multipliers followed by the radix roots
+        // of unity. Defined in FFT.cpp, which is compiled for vectorization.
+        void FFTPass(const std::complex<float>* pInput, std::complex<float>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<float>* pTwiddles);
+        void FFTPass(const std::complex<double>* pInput, std::complex<double>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<double>* pTwiddles);
+    } // namespace Internal
+
+    /// <summary>
+    /// A plan for the discrete Fourier transform of complex vectors of one size, output[k] = sum_j input[j] * exp(-2 pi i j k / size).
+    /// Any size is supported: the size is factored into radix 4, 2 and 3 passes, with a slower generic pass
+    /// for the other prime factors, and all twiddle factors are computed once, when the plan is constructed.
+    /// A plan is immutable and can be shared by threads.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The real element type, float or double. </typeparam>
+    template <typename ElementType>
+    class FFTPlan
+    {
+    public:
+        using ComplexType = std::complex<ElementType>;
+
+        /// <summary> Constructs a plan. </summary>
+        ///
+        /// <param name="size"> The transform size, which must be positive. </param>
+        explicit FFTPlan(size_t size);
+
+        /// <summary> Gets the transform size. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Computes the forward transform. The input and output may be the same vector. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        /// <param name="output"> The output vector. </param>
+        template <VectorOrientation orientation>
+        void Forward(ConstVectorReference<ComplexType, orientation> input, VectorReference<ComplexType, orientation> output) const;
+
+        /// <summary> Computes the inverse transform, scaled by 1 / size so that it undoes Forward. The input and output may be the same vector. </summary>
+        ///
+        /// <param name="input"> The input vector. </param>
+        /// <param name="output"> The output vector. </param>
+        template <VectorOrientation orientation>
+        void Inverse(ConstVectorReference<ComplexType, orientation> input, VectorReference<ComplexType, orientation> output) const;
+
+        /// <summary> Computes a transform between contiguous arrays of Size() elements, which may be the same array. </summary>
+        ///
+        /// <param name="pInput"> The input array. </param>
+        /// <param name="pOutput"> The output array. </param>
+        /// <param name="inverse"> Whether to compute the (scaled) inverse transform. </param>
+        void Transform(const ComplexType* pInput, ComplexType* pOutput, bool inverse) const;
+
+    private:
+        void Transform(const ComplexType* pInput, size_t inputIncrement, ComplexType* pOutput, size_t outputIncrement, bool inverse) const;
+
+        size_t _size;
+        std::vector<Internal::FFTStage> _stages;
+        std::vector<ComplexType> _twiddles;
+    };
+
+    /// <summary>
+    /// A plan for the discrete Fourier transform of real vectors of one size. The spectrum of a real vector is
+    /// conjugate symmetric, so only its first size / 2 + 1 elements are computed. Even sizes are transformed
+    /// with a complex transform of half the size, which is about twice as fast as a complex transform.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The real element type, float or double. </typeparam>
+    template <typename ElementType>
+    class RealFFTPlan
+    {
+    public:
+        using ComplexType = std::complex<ElementType>;
+
+        /// <summary> Constructs a plan. </summary>
+        ///
+        /// <param name="size"> The transform size, which must be positive. </param>
+        explicit RealFFTPlan(size_t size);
+
+        /// <summary> Gets the transform size. </summary>
+        ///
+        /// <returns> The size. </returns>
+        size_t Size() const { return _size; }
+
+        /// <summary> Gets the size of the spectrum, size / 2 + 1. </summary>
+        ///
+        /// <returns> The spectrum size. </returns>
+        size_t SpectrumSize() const { return _size / 2 + 1; }
+
+        /// <summary> Computes the first SpectrumSize() elements of the forward transform. </summary>
+        ///
+        /// <param name="input"> The real input vector. </param>
+        /// <param name="spectrum"> The spectrum vector. </param>
+        template <VectorOrientation orientation>
+        void Forward(ConstVectorReference<ElementType, orientation> input, VectorReference<ComplexType, orientation> spectrum) const;
+
+        /// <summary>
+        /// Computes the inverse transform of a conjugate symmetric spectrum given by its first SpectrumSize()
+        /// elements, scaled by 1 / size so that it undoes Forward. The imaginary parts of the elements that must be
+        /// real, the first one and (for even sizes) the last one, are ignored.
+        /// </summary>
+        ///
+        /// <param name="spectrum"> The spectrum vector. </param>
+        /// <param name="output"> The real output vector. </param>
+        template <VectorOrientation orientation>
+        void Inverse(ConstVectorReference<ComplexType, orientation> spectrum, VectorReference<ElementType, orientation> output) const;
+
+    private:
+        size_t _size;
+        FFTPlan<ElementType> _complexPlan;
+        std::vector<ComplexType> _twiddles;
+    };
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "MathConstants.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // exp(-2 pi i numerator / denominator), computed in double precision
+        template <typename ElementType>
+        std::complex<ElementType> RootOfUnity(size_t numerator, size_t denominator)
+        {
+            double angle = -2 * Constants<double>::pi * static_cast<double>(numerator % denominator) / static_cast<double>(denominator);
+            return { static_cast<ElementType>(std::cos(angle)), static_cast<ElementType>(std::sin(angle)) };
+        }
+
+        // radix 4 passes first, then radix 2, then the odd primes in increasing order
+        inline std::vector<size_t> FactorFFTSize(size_t size)
+        {
+            std::vector<size_t> radices;
+            while (size % 4 == 0)
+            {
+                radices.push_back(4);
+                size /= 4;
+            }
+            if (size % 2 == 0)
+            {
+                radices.push_back(2);
+                size /= 2;
+            }
+            for (size_t factor = 3; factor * factor <= size; factor += 2)
+            {
+                while (size % factor == 0)
+                {
+                    radices.push_back(factor);
+                    size /= factor;
+                }
+            }
+            if (size > 1)
+            {
+                radices.push_back(size);
+            }
+            return radices;
+        }
+    } // namespace Internal
+
+    template <typename ElementType>
+    FFTPlan<ElementType>::FFTPlan(size_t size) :
+        _size(size)
+    {
+        if (size == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The transform size must be positive.");
+        }
+
+        // the stage of radix p after transforms of length L multiplies input q of butterfly t by exp(-2 pi i q t / (L p))
+        size_t length = 1;
+        for (auto radix : Internal::FactorFFTSize(size))
+        {
+            _stages.push_back({ radix, length, _twiddles.size() });
+            for (size_t q = 1; q < radix; ++q)
+            {
+                for (size_t t = 0; t < length; ++t)
+                {
+                    _twiddles.push_back(Internal::RootOfUnity<ElementType>(q * t, length * radix));
+                }
+            }
+            for (size_t k = 0; k < radix; ++k)
+            {
+                _twiddles.push_back(Internal::RootOfUnity<ElementType>(k, radix));
+            }
+            length *= radix;
+        }
+    }
+
+    template <typename ElementType>
+    template <VectorOrientation orientation>
+    void FFTPlan<ElementType>::Forward(ConstVectorReference<ComplexType, orientation> input, VectorReference<ComplexType, orientation> output) const
+    {
+        if (input.Size() != _size || output.Size() != _size)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The vectors must have the size of the plan.");
+        }
+        Transform(input.GetConstDataPointer(), input.GetIncrement(), output.GetDataPointer(), output.GetIncrement(), false);
+    }
+
+    template <typename ElementType>
+    template <VectorOrientation orientation>
+    void FFTPlan<ElementType>::Inverse(ConstVectorReference<ComplexType, orientation> input, VectorReference<ComplexType, orientation> output) const
+    {
+        if (input.Size() != _size || output.Size() != _size)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The vectors must have the size of the plan.");
+        }
+        Transform(input.GetConstDataPointer(), input.GetIncrement(), output.GetDataPointer(), output.GetIncrement(), true);
+    }
+
+    template <typename ElementType>
+    void FFTPlan<ElementType>::Transform(const ComplexType* pInput, ComplexType* pOutput, bool inverse) const
+    {
+        Transform(pInput, 1, pOutput, 1, inverse);
+    }
+
+    template <typename ElementType>
+    void FFTPlan<ElementType>::Transform(const ComplexType* pInput, size_t inputIncrement, ComplexType* pOutput, size_t outputIncrement, bool inverse) const
+    {
+        // the passes ping-pong between two buffers; the inverse transform is the conjugate of the forward
+        // transform of the conjugate, and the conjugations are folded into the copies in and out
+        std::vector<ComplexType> buffer(_size);
+        std::vector<ComplexType> scratch(_size);
+        for (size_t i = 0; i < _size; ++i)
+        {
+            buffer[i] = inverse ? std::conj(pInput[i * inputIncrement]) : pInput[i * inputIncrement];
+        }
+
+        ComplexType* pSource = buffer.data();
+        ComplexType* pTarget = scratch.data();
+        for (const auto& stage : _stages)
+        {
+            Internal::FFTPass(pSource, pTarget, stage.radix, stage.length, _size / (stage.length * stage.radix), _twiddles.data() + stage.twiddleOffset);
+            std::swap(pSource, pTarget);
+        }
+
+        ElementType scale = ElementType{ 1 } / static_cast<ElementType>(_size);
+        for (size_t i = 0; i < _size; ++i)
+        {
+            pOutput[i * outputIncrement] = inverse ? std::conj(pSource[i]) * scale : pSource[i];
+        }
+    }
+
+    template <typename ElementType>
+    RealFFTPlan<ElementType>::RealFFTPlan(size_t size) :
+        _size(size),
+        _complexPlan(size % 2 == 0 ? size / 2 : size)
+    {
+        // exp(-2 pi i k / size) for the even-odd split of the half size transform
+        if (size % 2 == 0)
+        {
+            for (size_t k = 0; k <= size / 2; ++k)
+            {
+                _twiddles.push_back(Internal::RootOfUnity<ElementType>(k, size));
+            }
+        }
+    }
+
+    template <typename ElementType>
+    template <VectorOrientation orientation>
+    void RealFFTPlan<ElementType>::Forward(ConstVectorReference<ElementType, orientation> input, VectorReference<ComplexType, orientation> spectrum) const
+    {
+        if (input.Size() != _size || spectrum.Size() != SpectrumSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The input must have the size of the plan and the spectrum size / 2 + 1 elements.");
+        }
+
+        if (_size % 2 != 0)
+        {
+            std::vector<ComplexType> buffer(_size);
+            for (size_t i = 0; i < _size; ++i)
+            {
+                buffer[i] = input[i];
+            }
+            _complexPlan.Transform(buffer.data(), buffer.data(), false);
+            for (size_t k = 0; k < SpectrumSize(); ++k)
+            {
+                spectrum[k] = buffer[k];
+            }
+            return;
+        }
+
+        // z[k] = x[2k] + i x[2k + 1] holds the even and the odd elements, whose transforms E and O are
+        // separated using the conjugate symmetry of real transforms, and X[k] = E[k] + exp(-2 pi i k / size) O[k]
+        size_t half = _size / 2;
+        std::vector<ComplexType> z(half);
+        for (size_t k = 0; k < half; ++k)
+        {
+            z[k] = { input[2 * k], input[2 * k + 1] };
+        }
+        _complexPlan.Transform(z.data(), z.data(), false);
+        for (size_t k = 0; k <= half; ++k)
+        {
+            ComplexType zk = z[k % half];
+            ComplexType zc = std::conj(z[(half - k) % half]);
+            ComplexType even = (zk + zc) * ElementType{ 0.5 };
+            ComplexType difference = (zk - zc) * ElementType{ 0.5 };
+            ComplexType odd = { difference.imag(), -difference.real() };
+            const ComplexType& w = _twiddles[k];
+            spectrum[k] = { even.real() + w.real() * odd.real() - w.imag() * odd.imag(), even.imag() + w.real() * odd.imag() + w.imag() * odd.real() };
+        }
+    }
+
+    template <typename ElementType>
+    template <VectorOrientation orientation>
+    void RealFFTPlan<ElementType>::Inverse(ConstVectorReference<ComplexType, orientation> spectrum, VectorReference<ElementType, orientation> output) const
+    {
+        if (output.Size() != _size || spectrum.Size() != SpectrumSize())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The output must have the size of the plan and the spectrum size / 2 + 1 elements.");
+        }
+
+        if (_size % 2 != 0)
+        {
+            std::vector<ComplexType> buffer(_size);
+            buffer[0] = spectrum[0].real();
+            for (size_t k = 1; k < SpectrumSize(); ++k)
+            {
+                buffer[k] = spectrum[k];
+                buffer[_size - k] = std::conj(spectrum[k]);
+            }
+            _complexPlan.Transform(buffer.data(), buffer.data(), true);
+            for (size_t i = 0; i < _size; ++i)
+            {
+                output[i] = buffer[i].real();
+            }
+            return;
+        }
+
+        // undo the split of the forward transform: E[k] = (X[k] + conj(X[h - k])) / 2,
+        // O[k] = (X[k] - conj(X[h - k])) exp(2 pi i k / size) / 2 and Z[k] = E[k] + i O[k]
+        size_t half = _size / 2;
+        std::vector<ComplexType> z(half);
+        for (size_t k = 0; k < half; ++k)
+        {
+            ComplexType xk = k == 0 ? ComplexType(spectrum[0].real()) : spectrum[k];
+            ComplexType xc = k == 0 ? ComplexType(spectrum[half].real()) : std::conj(spectrum[half - k]);
+            ComplexType even = (xk + xc) * ElementType{ 0.5 };
+            ComplexType difference = (xk - xc) * ElementType{ 0.5 };
+            const ComplexType& w = _twiddles[k];
+            ComplexType odd = { difference.real() * w.real() + difference.imag() * w.imag(), difference.imag() * w.real() - difference.real() * w.imag() };
+            z[k] = { even.real() - odd.imag(), even.imag() + odd.real() };
+        }
+        _complexPlan.Transform(z.data(), z.data(), true);
+        for (size_t k = 0; k < half; ++k)
+        {
+            output[2 * k] = z[k].real();
+            output[2 * k + 1] = z[k].imag();
+        }
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,433 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/GemmKernels.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        /// <summary>
+        /// Block sizes of the cache blocked matrix multiplication. The micro-kernel keeps a tile of
+        /// rowsPerTile x columnsPerTile results in registers; the left operand is packed in blocks of
+        /// rowsPerBlock x depthPerBlock elements (sized for the L2 cache), the right operand in blocks of
+        /// depthPerBlock x columnsPerBlock elements (sized for the L3 cache).
+        /// </summary>
+        template <typename ElementType>
+        struct GemmBlocking
+        {
+            static constexpr size_t rowsPerTile = 4;
+            static constexpr size_t columnsPerTile = 64 / sizeof(ElementType);
+            static constexpr size_t depthPerBlock = 256;
+            static constexpr size_t rowsPerBlock = 128;
+            static constexpr size_t columnsPerBlock = 4096;
+        };
+
+        /// <summary> A read only view of a matrix with arbitrary row and column increments. </summary>
+        template <typename ElementType>
+        struct StridedMatrixView
+        {
+            const ElementType* pData;
+            size_t rowIncrement;
+            size_t columnIncrement;
+
+            const ElementType& operator()(size_t row, size_t column) const { return pData[row * rowIncrement + column * columnIncrement]; }
+        };
+
+        /// <summary> A writable view of a matrix with arbitrary row and column increments. </summary>
+        template <typename ElementType>
+        struct MutableStridedMatrixView
+        {
+            ElementType* pData;
+            size_t rowIncrement;
+            size_t columnIncrement;
+
+            ElementType& operator()(size_t row, size_t column) const { return pData[row * rowIncrement + column * columnIncrement]; }
+        };
+
+        /// <summary>
+        /// Packs depth x numColumns elements of the right operand, starting at (firstRow, firstColumn), into
+        /// panels of columnsPerTile columns: pPacked[panel * depth * columnsPerTile + k * columnsPerTile + j]
+        /// holds B(firstRow + k, firstColumn + panel * columnsPerTile + j). The last panel is padded with zeros.
+        /// </summary>
+        template <typename ElementType>
+        void PackGemmPanels(StridedMatrixView<ElementType> B, size_t firstRow, size_t firstColumn, size_t depth, size_t numColumns, ElementType* pPacked);
+
+        /// <summary>
+        /// Computes C = alpha * A * B + beta * C, where A is numRows x depth, B is depth x numColumns and C is
+        /// numRows x numColumns, with the cache blocked, multi-threaded algorithm. When beta is zero, C is not read.
+        /// </summary>
+        template <typename ElementType>
+        void BlockedGemm(size_t numRows, size_t numColumns, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, StridedMatrixView<ElementType> B, ElementType beta, MutableStridedMatrixView<ElementType> C);
+
+        /// <summary>
+        /// Computes C = alpha * A * B + beta * C, where B has been packed once with PackGemmPanels into blocks of
+        /// depthPerBlock rows: the block that starts at row k0 begins at pPackedB + k0 * paddedColumns, where
+        /// paddedColumns is numColumns rounded up to a multiple of columnsPerTile.
+        /// </summary>
+        template <typename ElementType>
+        void BlockedGemmPrepacked(size_t numRows, size_t numColumns, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, const ElementType* pPackedB, ElementType beta, MutableStridedMatrixView<ElementType> C);
+
+        /// <summary>
+        /// Computes y = alpha * M * x + beta * y, where M is numRows x numColumns, with the rows or the columns of
+        /// M (whichever is contiguous) streamed through a vectorizable inner loop, on the thread pool. When beta
+        /// is zero, y is not read.
+        /// </summary>
+        template <typename ElementType>
+        void ThreadedGemv(size_t numRows, size_t numColumns, ElementType alpha, StridedMatrixView<ElementType> M, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement);
+
+        /// <summary>
+        /// Computes the lower triangle of C = alpha * transpose(A) * A + beta * C, where A is depth x size and C is
+        /// size x size. Each block of rowsPerBlock rows of C is one blocked product over the columns left of the
+        /// diagonal block plus a product for the diagonal block itself, so about half the work of the full product
+        /// is done. The strict upper triangle of C is neither read nor written; when beta is zero, C is not read.
+        /// </summary>
+        template <typename ElementType>
+        void BlockedSyrk(size_t size, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, ElementType beta, MutableStridedMatrixView<ElementType> C);
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        template <typename ElementType>
+        void PackGemmPanels(StridedMatrixView<ElementType> B, size_t firstRow, size_t firstColumn, size_t depth, size_t numColumns, ElementType* pPacked)
+        {
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            for (size_t panelBegin = 0; panelBegin < numColumns; panelBegin += NR)
+            {
+                size_t panelColumns = std::min(NR, numColumns - panelBegin);
+                for (size_t k = 0; k < depth; ++k)
+                {
+                    ElementType* pRow = pPacked + k * NR;
+                    for (size_t j = 0; j < panelColumns; ++j)
+                    {
+                        pRow[j] = B(firstRow + k, firstColumn + panelBegin + j);
+                    }
+                    for (size_t j = panelColumns; j < NR; ++j)
+                    {
+                        pRow[j] = 0;
+                    }
+                }
+                pPacked += depth * NR;
+            }
+        }
+
+        // packs rows [firstRow, firstRow + numRows) and columns [firstColumn, firstColumn + depth) of the left
+        // operand into panels of rowsPerTile rows: pPacked[panel * depth * MR + k * MR + i] = A(firstRow + panel * MR + i, firstColumn + k)
+        template <typename ElementType>
+        void PackGemmRowPanels(StridedMatrixView<ElementType> A, size_t firstRow, size_t firstColumn, size_t numRows, size_t depth, ElementType* pPacked)
+        {
+            constexpr size_t MR = GemmBlocking<ElementType>::rowsPerTile;
+            for (size_t panelBegin = 0; panelBegin < numRows; panelBegin += MR)
+            {
+                size_t panelRows = std::min(MR, numRows - panelBegin);
+                for (size_t k = 0; k < depth; ++k)
+                {
+                    ElementType* pColumn = pPacked + k * MR;
+                    for (size_t i = 0; i < panelRows; ++i)
+                    {
+                        pColumn[i] = A(firstRow + panelBegin + i, firstColumn + k);
+                    }
+                    for (size_t i = panelRows; i < MR; ++i)
+                    {
+                        pColumn[i] = 0;
+                    }
+                }
+                pPacked += depth * MR;
+            }
+        }
+
+        // multiplies a packed row panel by a packed column panel and stores the rowsPerTile x columnsPerTile
+        // result tile; the fixed trip counts let the compiler keep the tile in vector registers
+        template <typename ElementType>
+        void GemmMicroKernel(size_t depth, const ElementType* pPackedA, const ElementType* pPackedB, ElementType* pTile)
+        {
+            constexpr size_t MR = GemmBlocking<ElementType>::rowsPerTile;
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            ElementType tile[MR][NR] = {};
+            for (size_t k = 0; k < depth; ++k)
+            {
+                const ElementType* pA = pPackedA + k * MR;
+                const ElementType* pB = pPackedB + k * NR;
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    for (size_t j = 0; j < NR; ++j)
+                    {
+                        tile[i][j] += pA[i] * pB[j];
+                    }
+                }
+            }
+            for (size_t i = 0; i < MR; ++i)
+            {
+                for (size_t j = 0; j < NR; ++j)
+                {
+                    pTile[i * NR + j] = tile[i][j];
+                }
+            }
+        }
+
+        // C = alpha * tile + beta * C for the valid part of a tile, C is not read when beta is zero
+        template <typename ElementType>
+        void StoreGemmTile(const ElementType* pTile, size_t numRows, size_t numColumns, ElementType alpha, ElementType beta, MutableStridedMatrixView<ElementType> C, size_t firstRow, size_t firstColumn)
+        {
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            for (size_t i = 0; i < numRows; ++i)
+            {
+                for (size_t j = 0; j < numColumns; ++j)
+                {
+                    ElementType& c = C(firstRow + i, firstColumn + j);
+                    c = beta == 0 ? alpha * pTile[i * NR + j] : alpha * pTile[i * NR + j] + beta * c;
+                }
+            }
+        }
+
+        // runs the micro-kernels for one block of packed columns: rows [0, numRows) of A, columns [0, numColumns)
+        // of the packed block, depth [firstDepth, firstDepth + depth); the first depth block applies beta, the
+        // others accumulate
+        template <typename ElementType>
+        void MultiplyPackedBlock(size_t numRows, size_t numColumns, size_t firstDepth, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, const ElementType* pPackedBlock, ElementType beta, MutableStridedMatrixView<ElementType> C, size_t firstColumn)
+        {
+            using Blocking = GemmBlocking<ElementType>;
+            constexpr size_t MR = Blocking::rowsPerTile;
+            constexpr size_t NR = Blocking::columnsPerTile;
+            constexpr size_t MC = Blocking::rowsPerBlock;
+
+            size_t numRowBlocks = (numRows + MC - 1) / MC;
+            size_t numPanels = (numColumns + NR - 1) / NR;
+
+            // split the columns too when there are fewer row blocks than threads, so that a short and wide
+            // product (a small batch times a large weight matrix) still uses every thread
+            size_t desiredTasks = 4 * utilities::GetThreadPool().NumThreads();
+            size_t numColumnGroups = std::max<size_t>(1, std::min(numPanels, desiredTasks / numRowBlocks));
+            size_t panelsPerGroup = (numPanels + numColumnGroups - 1) / numColumnGroups;
+            numColumnGroups = (numPanels + panelsPerGroup - 1) / panelsPerGroup;
+
+            ElementType blockBeta = firstDepth == 0 ? beta : 1;
+            utilities::ParallelFor(numRowBlocks * numColumnGroups, 1, [&](size_t begin, size_t end) {
+                std::vector<ElementType> packedA(MC * depth);
+                ElementType tile[MR * NR];
+                size_t packedRowBlock = numRowBlocks;
+                for (size_t task = begin; task < end; ++task)
+                {
+                    size_t rowBlock = task / numColumnGroups;
+                    size_t columnGroup = task % numColumnGroups;
+                    size_t rowBegin = rowBlock * MC;
+                    size_t blockRows = std::min(MC, numRows - rowBegin);
+                    if (rowBlock != packedRowBlock)
+                    {
+                        PackGemmRowPanels(A, rowBegin, firstDepth, blockRows, depth, packedA.data());
+                        packedRowBlock = rowBlock;
+                    }
+
+                    size_t panelEnd = std::min(numPanels, (columnGroup + 1) * panelsPerGroup);
+                    for (size_t panel = columnGroup * panelsPerGroup; panel < panelEnd; ++panel)
+                    {
+                        size_t columnBegin = panel * NR;
+                        size_t tileColumns = std::min(NR, numColumns - columnBegin);
+                        const ElementType* pPanel = pPackedBlock + panel * depth * NR;
+                        for (size_t rowPanel = 0; rowPanel * MR < blockRows; ++rowPanel)
+                        {
+                            size_t tileRows = std::min(MR, blockRows - rowPanel * MR);
+                            GemmMicroKernel(depth, packedA.data() + rowPanel * depth * MR, pPanel, tile);
+                            StoreGemmTile(tile, tileRows, tileColumns, alpha, blockBeta, C, rowBegin + rowPanel * MR, firstColumn + columnBegin);
+                        }
+                    }
+                }
+            });
+        }
+
+        template <typename ElementType>
+        void ScaleStrided(size_t numRows, size_t numColumns, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            for (size_t i = 0; i < numRows; ++i)
+            {
+                for (size_t j = 0; j < numColumns; ++j)
+                {
+                    C(i, j) = beta == 0 ? 0 : beta * C(i, j);
+                }
+            }
+        }
+
+        template <typename ElementType>
+        void BlockedGemm(size_t numRows, size_t numColumns, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, StridedMatrixView<ElementType> B, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            using Blocking = GemmBlocking<ElementType>;
+            constexpr size_t NR = Blocking::columnsPerTile;
+            constexpr size_t KC = Blocking::depthPerBlock;
+            constexpr size_t NC = Blocking::columnsPerBlock;
+
+            // an empty product only scales C, and an empty C has no blocks to split the work into
+            if (depth == 0 || numRows == 0 || numColumns == 0)
+            {
+                ScaleStrided(numRows, numColumns, beta, C);
+                return;
+            }
+
+            std::vector<ElementType> packedB(KC * NC);
+            for (size_t columnBegin = 0; columnBegin < numColumns; columnBegin += NC)
+            {
+                size_t blockColumns = std::min(NC, numColumns - columnBegin);
+                size_t numPanels = (blockColumns + NR - 1) / NR;
+                for (size_t depthBegin = 0; depthBegin < depth; depthBegin += KC)
+                {
+                    size_t blockDepth = std::min(KC, depth - depthBegin);
+                    utilities::ParallelFor(numPanels, std::max<size_t>(1, minElementsPerTask / (blockDepth * NR)), [&](size_t begin, size_t end) {
+                        size_t firstColumn = columnBegin + begin * NR;
+                        size_t lastColumn = std::min(columnBegin + blockColumns, columnBegin + end * NR);
+                        PackGemmPanels(B, depthBegin, firstColumn, blockDepth, lastColumn - firstColumn, packedB.data() + begin * blockDepth * NR);
+                    });
+                    MultiplyPackedBlock(numRows, blockColumns, depthBegin, blockDepth, alpha, A, packedB.data(), beta, C, columnBegin);
+                }
+            }
+        }
+
+        template <typename ElementType>
+        void BlockedGemmPrepacked(size_t numRows, size_t numColumns, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, const ElementType* pPackedB, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            using Blocking = GemmBlocking<ElementType>;
+            constexpr size_t NR = Blocking::columnsPerTile;
+            constexpr size_t KC = Blocking::depthPerBlock;
+
+            // an empty product only scales C, and an empty C has no blocks to split the work into
+            if (depth == 0 || numRows == 0 || numColumns == 0)
+            {
+                ScaleStrided(numRows, numColumns, beta, C);
+                return;
+            }
+
+            size_t paddedColumns = (numColumns + NR - 1) / NR * NR;
+            for (size_t depthBegin = 0; depthBegin < depth; depthBegin += KC)
+            {
+                size_t blockDepth = std::min(KC, depth - depthBegin);
+                MultiplyPackedBlock(numRows, numColumns, depthBegin, blockDepth, alpha, A, pPackedB + depthBegin * paddedColumns, beta, C, 0);
+            }
+        }
+
+        template <typename ElementType>
+        void ThreadedGemv(size_t numRows, size_t numColumns, ElementType alpha, StridedMatrixView<ElementType> M, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement)
+        {
+            // the inner loops read x with unit stride
+            std::vector<ElementType> contiguousX;
+            if (xIncrement != 1)
+            {
+                contiguousX.resize(numColumns);
+                for (size_t j = 0; j < numColumns; ++j)
+                {
+                    contiguousX[j] = pX[j * xIncrement];
+                }
+                pX = contiguousX.data();
+            }
+
+            auto store = [alpha, beta, pY, yIncrement](size_t i, ElementType value) {
+                ElementType& y = pY[i * yIncrement];
+                y = beta == 0 ? alpha * value : alpha * value + beta * y;
+            };
+
+            if (M.columnIncrement == 1)
+            {
+                // contiguous rows: one dot product per row
+                size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(numColumns, 1));
+                utilities::ParallelFor(numRows, grainSize, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const ElementType* pRow = M.pData + i * M.rowIncrement;
+                        ElementType sum = 0;
+                        for (size_t j = 0; j < numColumns; ++j)
+                        {
+                            sum += pRow[j] * pX[j];
+                        }
+                        store(i, sum);
+                    }
+                });
+            }
+            else
+            {
+                // contiguous columns: each task accumulates x[j] * column j over a block of rows
+                constexpr size_t rowsPerBlock = 256;
+                size_t numBlocks = (numRows + rowsPerBlock - 1) / rowsPerBlock;
+                size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(rowsPerBlock * numColumns, 1));
+                utilities::ParallelFor(numBlocks, grainSize, [&](size_t begin, size_t end) {
+                    ElementType sums[rowsPerBlock];
+                    for (size_t block = begin; block < end; ++block)
+                    {
+                        size_t rowBegin = block * rowsPerBlock;
+                        size_t blockRows = std::min(rowsPerBlock, numRows - rowBegin);
+                        std::fill(sums, sums + blockRows, ElementType{ 0 });
+                        for (size_t j = 0; j < numColumns; ++j)
+                        {
+                            const ElementType* pColumn = M.pData + rowBegin * M.rowIncrement + j * M.columnIncrement;
+                            ElementType x = pX[j];
+                            for (size_t i = 0; i < blockRows; ++i)
+                            {
+                                sums[i] += pColumn[i * M.rowIncrement] * x;
+                            }
+                        }
+                        for (size_t i = 0; i < blockRows; ++i)
+                        {
+                            store(rowBegin + i, sums[i]);
+                        }
+                    }
+                });
+            }
+        }
+
+        template <typename ElementType>
+        void BlockedSyrk(size_t size, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            constexpr size_t MC = GemmBlocking<ElementType>::rowsPerBlock;
+
+            // the rows of transpose(A) are the columns of A
+            StridedMatrixView<ElementType> transposeA{ A.pData, A.columnIncrement, A.rowIncrement };
+            std::vector<ElementType> diagonal(MC * MC);
+            for (size_t rowBegin = 0; rowBegin < size; rowBegin += MC)
+            {
+                size_t blockRows = std::min(MC, size - rowBegin);
+                StridedMatrixView<ElementType> blockA{ transposeA.pData + rowBegin * transposeA.rowIncrement, transposeA.rowIncrement, transposeA.columnIncrement };
+                MutableStridedMatrixView<ElementType> blockC{ C.pData + rowBegin * C.rowIncrement, C.rowIncrement, C.columnIncrement };
+                if (rowBegin > 0)
+                {
+                    BlockedGemm(blockRows, rowBegin, depth, alpha, blockA, A, beta, blockC);
+                }
+
+                // the diagonal block goes through a buffer, so that its upper triangle is left alone
+                StridedMatrixView<ElementType> blockB{ A.pData + rowBegin * A.columnIncrement, A.rowIncrement, A.columnIncrement };
+                MutableStridedMatrixView<ElementType> diagonalView{ diagonal.data(), blockRows, 1 };
+                BlockedGemm(blockRows, blockRows, depth, ElementType{ 1 }, blockA, blockB, ElementType{ 0 }, diagonalView);
+                for (size_t i = 0; i < blockRows; ++i)
+                {
+                    for (size_t j = 0; j <= i; ++j)
+                    {
+                        ElementType& c = C(rowBegin + i, rowBegin + j);
+                        c = beta == 0 ? alpha * diagonalView(i, j) : alpha * diagonalView(i, j) + beta * c;
+                    }
+                }
+            }
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
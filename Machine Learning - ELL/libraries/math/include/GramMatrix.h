@@ -0,0 +1,210 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/GramMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Symmetric rank-k update, matrixC = scalarA * transpose(matrixA) * matrixA + scalarC * matrixC, computed on one
+    /// triangle of matrixC only, which is about half the work of the general matrix matrix multiplication. The other
+    /// triangle is either left untouched or, when mirror is true, overwritten with the transpose of the computed one.
+    /// </summary>
+    ///
+    /// <typeparam name="implementation"> The implementation: native, blocked or automatic (openBlas is treated as blocked). </typeparam>
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    /// <typeparam name="layoutA"> Matrix layout of the first matrix. </typeparam>
+    /// <typeparam name="layoutC"> Matrix layout of the result matrix. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The matrix, typically one sample per row. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC. </param>
+    /// <param name="matrixC"> A square matrix with one row per column of matrixA, used to store the result. </param>
+    /// <param name="triangle"> The triangle of matrixC that is computed. </param>
+    /// <param name="mirror"> Whether the other triangle is filled in too. </param>
+    template <ImplementationType implementation = ImplementationType::automatic, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyTransposeScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC, MatrixTriangle triangle = MatrixTriangle::lower, bool mirror = true);
+
+    /// <summary>
+    /// Accumulates the Gram matrix transpose(X) * X of a dataset X that arrives one block of rows at a time, so that
+    /// X never has to be held in memory. Only the lower triangle is accumulated; it is mirrored when the result is read.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type. </typeparam>
+    template <typename ElementType>
+    class GramMatrixAccumulator
+    {
+    public:
+        /// <summary> Constructs an empty accumulator. </summary>
+        ///
+        /// <param name="numColumns"> The number of columns of the dataset. </param>
+        GramMatrixAccumulator(size_t numColumns);
+
+        /// <summary> Adds transpose(rows) * rows to the accumulated matrix. </summary>
+        ///
+        /// <typeparam name="layout"> Matrix layout of the block. </typeparam>
+        /// <param name="rows"> The next block of rows of the dataset. </param>
+        template <MatrixLayout layout>
+        void Accumulate(ConstMatrixReference<ElementType, layout> rows);
+
+        /// <summary> Gets the number of rows accumulated so far. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns of the dataset. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _lower.NumRows(); }
+
+        /// <summary> Gets the accumulated Gram matrix, with both triangles filled in. </summary>
+        ///
+        /// <returns> The Gram matrix. </returns>
+        RowMatrix<ElementType> GetGramMatrix() const;
+
+        /// <summary> Discards the accumulated rows. </summary>
+        void Reset();
+
+    private:
+        RowMatrix<ElementType> _lower;
+        size_t _numRows = 0;
+    };
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "GemmKernels.h"
+#include "ImplementationThresholds.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the lower triangle of C = alpha * transpose(A) * A + beta * C, one dot product of columns per element
+        template <typename ElementType>
+        void NativeSyrk(size_t size, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                for (size_t j = 0; j <= i; ++j)
+                {
+                    ElementType sum = 0;
+                    for (size_t k = 0; k < depth; ++k)
+                    {
+                        sum += A(k, i) * A(k, j);
+                    }
+                    ElementType& c = C(i, j);
+                    c = beta == 0 ? alpha * sum : alpha * sum + beta * c;
+                }
+            }
+        }
+
+        // copies the strict lower triangle of C to the strict upper triangle
+        template <typename ElementType>
+        void MirrorLowerTriangle(size_t size, MutableStridedMatrixView<ElementType> C)
+        {
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(size, 1));
+            utilities::ParallelFor(size, grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    for (size_t j = 0; j < i; ++j)
+                    {
+                        C(j, i) = C(i, j);
+                    }
+                }
+            });
+        }
+
+        template <ImplementationType implementation, typename ElementType>
+        void Syrk(size_t size, size_t depth, ElementType alpha, StridedMatrixView<ElementType> A, ElementType beta, MutableStridedMatrixView<ElementType> C)
+        {
+            ImplementationType type = implementation == ImplementationType::automatic ? ChooseMatrixMatrixImplementation(size, size, depth) : implementation;
+            if (type == ImplementationType::native)
+            {
+                NativeSyrk(size, depth, alpha, A, beta, C);
+            }
+            else
+            {
+                BlockedSyrk(size, depth, alpha, A, beta, C);
+            }
+        }
+    } // namespace Internal
+
+    template <ImplementationType implementation, typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyTransposeScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC, MatrixTriangle triangle, bool mirror)
+    {
+        size_t size = matrixA.NumColumns();
+        if (matrixC.NumRows() != size || matrixC.NumColumns() != size)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The result must be a square matrix with one row per column of matrixA.");
+        }
+
+        // the upper triangle of C is the lower triangle of its transpose
+        Internal::MutableStridedMatrixView<ElementType> C{ matrixC.GetDataPointer(), matrixC.GetRowIncrement(), matrixC.GetColumnIncrement() };
+        if (triangle == MatrixTriangle::upper)
+        {
+            std::swap(C.rowIncrement, C.columnIncrement);
+        }
+
+        Internal::StridedMatrixView<ElementType> A{ matrixA.GetConstDataPointer(), matrixA.GetRowIncrement(), matrixA.GetColumnIncrement() };
+        Internal::Syrk<implementation>(size, matrixA.NumRows(), scalarA, A, scalarC, C);
+        if (mirror)
+        {
+            Internal::MirrorLowerTriangle(size, C);
+        }
+    }
+
+    template <typename ElementType>
+    GramMatrixAccumulator<ElementType>::GramMatrixAccumulator(size_t numColumns) :
+        _lower(numColumns, numColumns)
+    {}
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void GramMatrixAccumulator<ElementType>::Accumulate(ConstMatrixReference<ElementType, layout> rows)
+    {
+        if (rows.NumColumns() != NumColumns())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The block must have as many columns as the dataset.");
+        }
+
+        MultiplyTransposeScaleAddUpdate(ElementType{ 1 }, rows, ElementType{ 1 }, _lower.GetReference(), MatrixTriangle::lower, false);
+        _numRows += rows.NumRows();
+    }
+
+    template <typename ElementType>
+    RowMatrix<ElementType> GramMatrixAccumulator<ElementType>::GetGramMatrix() const
+    {
+        RowMatrix<ElementType> result(_lower);
+        Internal::MirrorLowerTriangle(NumColumns(), Internal::MutableStridedMatrixView<ElementType>{ result.GetDataPointer(), result.GetRowIncrement(), result.GetColumnIncrement() });
+        return result;
+    }
+
+    template <typename ElementType>
+    void GramMatrixAccumulator<ElementType>::Reset()
+    {
+        _lower.Reset();
+        _numRows = 0;
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,105 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/ImplementationThresholds.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+
+#include <cstddef>
+#include <limits>
+#include <string>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// The problem sizes at which ImplementationType::automatic switches from one implementation to the next.
+    /// Matrix-matrix sizes count multiply-adds (rows * columns * depth), matrix-vector sizes count matrix elements.
+    /// </summary>
+    struct ImplementationThresholds
+    {
+        static constexpr size_t never = std::numeric_limits<size_t>::max();
+
+        /// <summary> Matrix-matrix products at least this large use the blocked implementation. </summary>
+        size_t matrixMatrixBlocked = 32 * 32 * 32;
+
+        /// <summary> Matrix-matrix products at least this large use BLAS, when the library was built with it. </summary>
+        size_t matrixMatrixBlas = never;
+
+        /// <summary> Matrix-vector products at least this large use the blocked (multi-threaded) implementation. </summary>
+        size_t matrixVectorBlocked = 256 * 256;
+
+        /// <summary> Matrix-vector products at least this large use BLAS, when the library was built with it. </summary>
+        size_t matrixVectorBlas = never;
+
+        /// <summary> Convolutions and correlations with kernels at least this long use the FFT. </summary>
+        size_t convolutionFFT = 64;
+    };
+
+    /// <summary> The environment variable that names the thresholds file loaded on first use. </summary>
+    constexpr const char* implementationThresholdsVariable = "ELL_MATH_THRESHOLDS";
+
+    /// <summary>
+    /// Gets the thresholds used by ImplementationType::automatic. On first use, they are read from the file named by
+    /// the ELL_MATH_THRESHOLDS environment variable, or left at their defaults when it is not set.
+    /// </summary>
+    ///
+    /// <returns> The current thresholds. </returns>
+    ImplementationThresholds GetImplementationThresholds();
+
+    /// <summary>
+    /// Replaces the thresholds used by ImplementationType::automatic. A product that runs while they are replaced
+    /// sees either the old or the new thresholds.
+    /// </summary>
+    ///
+    /// <param name="thresholds"> The new thresholds. </param>
+    void SetImplementationThresholds(const ImplementationThresholds& thresholds);
+
+    /// <summary>
+    /// Reads thresholds from a text file with one "name = value" line per threshold; lines that start with '#' are
+    /// comments, thresholds missing from the file keep their defaults and the value "never" disables an implementation.
+    /// </summary>
+    ///
+    /// <param name="filepath"> The file path. </param>
+    ///
+    /// <returns> The thresholds. </returns>
+    ImplementationThresholds ReadImplementationThresholds(const std::string& filepath);
+
+    /// <summary> Writes thresholds in the format read by ReadImplementationThresholds. </summary>
+    ///
+    /// <param name="filepath"> The file path. </param>
+    /// <param name="thresholds"> The thresholds. </param>
+    void WriteImplementationThresholds(const std::string& filepath, const ImplementationThresholds& thresholds);
+
+    /// <summary> Chooses the implementation of a matrix-matrix product with the given sizes. </summary>
+    ///
+    /// <param name="numRows"> The number of rows of the result. </param>
+    /// <param name="numColumns"> The number of columns of the result. </param>
+    /// <param name="depth"> The number of columns of the left operand. </param>
+    ///
+    /// <returns> native, blocked or openBlas. </returns>
+    ImplementationType ChooseMatrixMatrixImplementation(size_t numRows, size_t numColumns, size_t depth);
+
+    /// <summary> Chooses the implementation of a matrix-vector product with the given sizes. </summary>
+    ///
+    /// <param name="numRows"> The number of matrix rows. </param>
+    /// <param name="numColumns"> The number of matrix columns. </param>
+    ///
+    /// <returns> native, blocked or openBlas. </returns>
+    ImplementationType ChooseMatrixVectorImplementation(size_t numRows, size_t numColumns);
+
+    /// <summary> Chooses the method of a convolution or correlation with the given sizes. </summary>
+    ///
+    /// <param name="signalSize"> The signal size. </param>
+    /// <param name="kernelSize"> The kernel size. </param>
+    ///
+    /// <returns> direct or fft. </returns>
+    ConvolutionMethod ChooseConvolutionMethod(size_t signalSize, size_t kernelSize);
+} // namespace math
+} // namespace ell
@@ -0,0 +1,388 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/KMeans.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Parameters of KMeans. </summary>
+    struct KMeansParameters
+    {
+        /// <summary> The number of clusters. </summary>
+        size_t numClusters = 8;
+
+        /// <summary> The maximum number of Lloyd iterations, or of mini-batches. </summary>
+        size_t maxIterations = 100;
+
+        /// <summary> The number of points per mini-batch, or 0 for Lloyd iterations over the whole dataset. </summary>
+        size_t batchSize = 0;
+
+        /// <summary>
+        /// The iterations stop once the sum of the squared movements of the centroids in one iteration is at most
+        /// tolerance times the mean variance of the columns of the dataset.
+        /// </summary>
+        double tolerance = 1.0e-4;
+
+        /// <summary> The seed of the random number generator, so that equal seeds give equal results. </summary>
+        uint64_t seed = 0;
+    };
+
+    /// <summary> The result of KMeans. </summary>
+    template <typename ElementType>
+    struct KMeansResult
+    {
+        /// <summary> The centroids, one per row. </summary>
+        RowMatrix<ElementType> centroids = RowMatrix<ElementType>(0, 0);
+
+        /// <summary> The index of the nearest centroid of each point. </summary>
+        std::vector<size_t> assignments;
+
+        /// <summary> The sum of the squared distances between the points and their nearest centroids. </summary>
+        double inertia = 0;
+
+        /// <summary> The number of iterations, or of mini-batches, that were run. </summary>
+        size_t numIterations = 0;
+
+        /// <summary> Whether the iterations stopped because the centroids settled. </summary>
+        bool converged = false;
+    };
+
+    /// <summary>
+    /// Clusters the rows of a dataset with k-means. The centroids are initialized with k-means++ and refined
+    /// with Lloyd iterations, or with mini-batch updates when parameters.batchSize is positive (each centroid
+    /// then moves toward the mean of its points in the batch, with a step that shrinks as it absorbs more points).
+    /// The nearest centroids are found with the GEMM-based distance tiles of StreamPairwiseDistances, and the
+    /// centroid sums are accumulated per thread and reduced in a fixed order, so that for a given seed and thread
+    /// count the result is always the same. A centroid that loses all its points keeps its position.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="data"> The dataset, one point per row. </param>
+    /// <param name="parameters"> The parameters. </param>
+    ///
+    /// <returns> The centroids, the assignments of the points and statistics of the run. </returns>
+    template <typename ElementType>
+    KMeansResult<ElementType> KMeans(ConstRowMatrixReference<ElementType> data, const KMeansParameters& parameters);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+#include "Distances.h"
+#include "Normalization.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the squared distances are summed in blocks of this many points, in a fixed order, so that the sums do not
+        // depend on how the work is split between threads
+        constexpr size_t kMeansSumBlockSize = 4096;
+
+        template <typename ElementType>
+        ElementType SquaredDistance(const ElementType* pA, const ElementType* pB, size_t size)
+        {
+            ElementType sum = 0;
+            for (size_t j = 0; j < size; ++j)
+            {
+                ElementType difference = pA[j] - pB[j];
+                sum += difference * difference;
+            }
+            return sum;
+        }
+
+        // sums the elements of a vector in fixed blocks, in double
+        template <typename ElementType>
+        double SumInBlocks(const std::vector<ElementType>& values, std::vector<double>& blockSums)
+        {
+            size_t numBlocks = (values.size() + kMeansSumBlockSize - 1) / kMeansSumBlockSize;
+            blockSums.assign(numBlocks, 0);
+            utilities::ParallelFor(numBlocks, 1, [&](size_t begin, size_t end) {
+                for (size_t block = begin; block < end; ++block)
+                {
+                    size_t last = std::min(values.size(), (block + 1) * kMeansSumBlockSize);
+                    double sum = 0;
+                    for (size_t i = block * kMeansSumBlockSize; i < last; ++i)
+                    {
+                        sum += values[i];
+                    }
+                    blockSums[block] = sum;
+                }
+            });
+
+            double total = 0;
+            for (double sum : blockSums)
+            {
+                total += sum;
+            }
+            return total;
+        }
+
+        // k-means++: each new centroid is a point drawn with probability proportional to its squared distance to
+        // the nearest centroid chosen so far
+        template <typename ElementType>
+        RowMatrix<ElementType> InitializeKMeansPlusPlus(ConstRowMatrixReference<ElementType> data, size_t numClusters, std::mt19937_64& generator)
+        {
+            const size_t numPoints = data.NumRows();
+            const size_t dimension = data.NumColumns();
+            RowMatrix<ElementType> centroids(numClusters, dimension);
+            std::vector<ElementType> minDistances(numPoints, std::numeric_limits<ElementType>::max());
+            std::vector<double> blockSums;
+
+            size_t chosen = std::uniform_int_distribution<size_t>(0, numPoints - 1)(generator);
+            for (size_t c = 0; c < numClusters; ++c)
+            {
+                centroids.GetRow(c).CopyFrom(data.GetRow(chosen));
+                if (c + 1 == numClusters)
+                {
+                    break;
+                }
+
+                const ElementType* pCentroid = centroids.GetConstDataPointer() + c * centroids.GetIncrement();
+                size_t grainSize = (minElementsPerTask + dimension) / (dimension + 1);
+                utilities::ParallelFor(numPoints, grainSize, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        ElementType distance = SquaredDistance(data.GetConstDataPointer() + i * data.GetIncrement(), pCentroid, dimension);
+                        minDistances[i] = std::min(minDistances[i], distance);
+                    }
+                });
+
+                double total = SumInBlocks(minDistances, blockSums);
+                if (!(total > 0))
+                {
+                    // every point coincides with a centroid
+                    chosen = std::uniform_int_distribution<size_t>(0, numPoints - 1)(generator);
+                    continue;
+                }
+
+                double target = std::uniform_real_distribution<double>(0, total)(generator);
+                size_t block = 0;
+                while (block + 1 < blockSums.size() && target >= blockSums[block])
+                {
+                    target -= blockSums[block];
+                    ++block;
+                }
+                size_t last = std::min(numPoints, (block + 1) * kMeansSumBlockSize);
+                chosen = last - 1;
+                for (size_t i = block * kMeansSumBlockSize; i < last; ++i)
+                {
+                    if (target < minDistances[i])
+                    {
+                        chosen = i;
+                        break;
+                    }
+                    target -= minDistances[i];
+                }
+            }
+            return centroids;
+        }
+
+        // stores the index of the nearest centroid of each point and returns the sum of the squared distances
+        template <typename ElementType>
+        double AssignClusters(ConstRowMatrixReference<ElementType> data, ConstRowMatrixReference<ElementType> centroids, size_t* pAssignments)
+        {
+            double inertia = 0;
+            std::vector<ElementType> rowDistances;
+            auto consumer = [&](size_t firstRow, size_t, ConstRowMatrixReference<ElementType> tile) {
+                rowDistances.resize(tile.NumRows());
+                size_t size = tile.NumColumns();
+                size_t grainSize = (minElementsPerTask + size - 1) / size;
+                utilities::ParallelFor(tile.NumRows(), grainSize, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const ElementType* pRow = tile.GetConstDataPointer() + i * tile.GetIncrement();
+                        size_t nearest = 0;
+                        for (size_t j = 1; j < size; ++j)
+                        {
+                            nearest = pRow[j] < pRow[nearest] ? j : nearest;
+                        }
+                        pAssignments[firstRow + i] = nearest;
+                        rowDistances[i] = pRow[nearest];
+                    }
+                });
+                for (ElementType distance : rowDistances)
+                {
+                    inertia += distance;
+                }
+            };
+
+            // each tile holds complete rows of the distance matrix
+            size_t tileRows = std::max<size_t>(64, (1 << 18) / centroids.NumRows());
+            StreamPairwiseDistances<DistanceMetric::squaredEuclidean>(data, centroids, consumer, tileRows, centroids.NumRows());
+            return inertia;
+        }
+
+        // the sum and the number of the points assigned to each cluster; each block of points has its own
+        // accumulators, which are added up in the order of the blocks
+        template <typename ElementType>
+        void AccumulateClusters(ConstRowMatrixReference<ElementType> data, const size_t* pAssignments, size_t numClusters, std::vector<double>& sums, std::vector<size_t>& counts)
+        {
+            const size_t dimension = data.NumColumns();
+            std::map<size_t, std::pair<std::vector<double>, std::vector<size_t>>> partials;
+            std::mutex mutex;
+            size_t grainSize = (minElementsPerTask + dimension) / (dimension + 1);
+            utilities::ParallelFor(data.NumRows(), grainSize, [&](size_t begin, size_t end) {
+                std::vector<double> blockSums(numClusters * dimension, 0);
+                std::vector<size_t> blockCounts(numClusters, 0);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t cluster = pAssignments[i];
+                    const ElementType* pPoint = data.GetConstDataPointer() + i * data.GetIncrement();
+                    double* pSum = blockSums.data() + cluster * dimension;
+                    for (size_t j = 0; j < dimension; ++j)
+                    {
+                        pSum[j] += pPoint[j];
+                    }
+                    ++blockCounts[cluster];
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                partials.emplace(begin, std::make_pair(std::move(blockSums), std::move(blockCounts)));
+            });
+
+            sums.assign(numClusters * dimension, 0);
+            counts.assign(numClusters, 0);
+            for (const auto& partial : partials)
+            {
+                for (size_t j = 0; j < sums.size(); ++j)
+                {
+                    sums[j] += partial.second.first[j];
+                }
+                for (size_t c = 0; c < numClusters; ++c)
+                {
+                    counts[c] += partial.second.second[c];
+                }
+            }
+        }
+
+        // moves each centroid toward the mean of its points, by the given fraction of the way for each cluster, and
+        // returns the sum of the squared movements
+        template <typename ElementType>
+        double MoveCentroids(RowMatrix<ElementType>& centroids, const std::vector<double>& sums, const std::vector<size_t>& counts, const std::vector<double>& steps)
+        {
+            const size_t dimension = centroids.NumColumns();
+            double movement = 0;
+            for (size_t c = 0; c < centroids.NumRows(); ++c)
+            {
+                if (counts[c] == 0)
+                {
+                    continue;
+                }
+                ElementType* pCentroid = centroids.GetDataPointer() + c * centroids.GetIncrement();
+                const double* pSum = sums.data() + c * dimension;
+                for (size_t j = 0; j < dimension; ++j)
+                {
+                    double shift = steps[c] * (pSum[j] / counts[c] - pCentroid[j]);
+                    pCentroid[j] = static_cast<ElementType>(pCentroid[j] + shift);
+                    movement += shift * shift;
+                }
+            }
+            return movement;
+        }
+
+        template <typename ElementType>
+        double GetMeanColumnVariance(ConstRowMatrixReference<ElementType> data)
+        {
+            ColumnVector<ElementType> mean(data.NumColumns());
+            ColumnVector<ElementType> variance(data.NumColumns());
+            RowwiseMeanAndVariance(data.Transpose(), mean, variance);
+            double sum = 0;
+            for (size_t j = 0; j < variance.Size(); ++j)
+            {
+                sum += variance[j];
+            }
+            return data.NumColumns() == 0 ? 0 : sum / data.NumColumns();
+        }
+    } // namespace Internal
+
+    template <typename ElementType>
+    KMeansResult<ElementType> KMeans(ConstRowMatrixReference<ElementType> data, const KMeansParameters& parameters)
+    {
+        const size_t numPoints = data.NumRows();
+        const size_t numClusters = parameters.numClusters;
+        if (numClusters == 0 || numClusters > numPoints)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The number of clusters must be positive and at most the number of points.");
+        }
+
+        std::mt19937_64 generator(parameters.seed);
+        KMeansResult<ElementType> result;
+        result.centroids = Internal::InitializeKMeansPlusPlus(data, numClusters, generator);
+        result.assignments.resize(numPoints);
+        const double threshold = parameters.tolerance * Internal::GetMeanColumnVariance(data);
+
+        std::vector<double> sums;
+        std::vector<size_t> counts;
+        if (parameters.batchSize == 0)
+        {
+            std::vector<double> steps(numClusters, 1.0);
+            while (result.numIterations < parameters.maxIterations && !result.converged)
+            {
+                Internal::AssignClusters(data, result.centroids, result.assignments.data());
+                Internal::AccumulateClusters(data, result.assignments.data(), numClusters, sums, counts);
+                double movement = Internal::MoveCentroids(result.centroids, sums, counts, steps);
+                ++result.numIterations;
+                result.converged = movement <= threshold;
+            }
+        }
+        else
+        {
+            // the number of points each centroid has absorbed, which sets the size of its steps
+            std::vector<double> absorbed(numClusters, 0);
+            std::vector<double> steps(numClusters);
+            const size_t batchSize = std::min(parameters.batchSize, numPoints);
+            RowMatrix<ElementType> batch(batchSize, data.NumColumns());
+            std::vector<size_t> batchAssignments(batchSize);
+            std::uniform_int_distribution<size_t> pick(0, numPoints - 1);
+            while (result.numIterations < parameters.maxIterations && !result.converged)
+            {
+                for (size_t i = 0; i < batchSize; ++i)
+                {
+                    batch.GetRow(i).CopyFrom(data.GetRow(pick(generator)));
+                }
+                Internal::AssignClusters(batch, result.centroids, batchAssignments.data());
+                Internal::AccumulateClusters(batch, batchAssignments.data(), numClusters, sums, counts);
+                for (size_t c = 0; c < numClusters; ++c)
+                {
+                    absorbed[c] += counts[c];
+                    steps[c] = counts[c] == 0 ? 0 : counts[c] / absorbed[c];
+                }
+                double movement = Internal::MoveCentroids(result.centroids, sums, counts, steps);
+                ++result.numIterations;
+                result.converged = movement <= threshold;
+            }
+        }
+
+        result.inertia = Internal::AssignClusters(data, result.centroids, result.assignments.data());
+        return result;
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
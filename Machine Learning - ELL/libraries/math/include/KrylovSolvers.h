@@ -0,0 +1,559 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/KrylovSolvers.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Parameters of the Krylov solvers. </summary>
+    struct KrylovSolverParameters
+    {
+        /// <summary> The maximum number of iterations, each of which applies the operator once. </summary>
+        size_t maxIterations = 1000;
+
+        /// <summary> The iterations stop once the norm of the residual b - A x is at most tolerance times the norm of b. </summary>
+        double tolerance = 1.0e-6;
+
+        /// <summary> The number of GMRES iterations between restarts, which is also the number of basis vectors it keeps. </summary>
+        size_t restart = 30;
+    };
+
+    /// <summary> The result of a Krylov solver. </summary>
+    struct KrylovSolverResult
+    {
+        /// <summary> The number of iterations that were run. </summary>
+        size_t numIterations = 0;
+
+        /// <summary> The norm of the residual that the stopping test used, relative to the norm of b. </summary>
+        double relativeResidual = 0;
+
+        /// <summary> Whether the relative residual reached the tolerance. </summary>
+        bool converged = false;
+    };
+
+    /// <summary>
+    /// The work vectors of the Krylov solvers. A workspace that is passed to a sequence of solves of the same size
+    /// allocates its vectors once, in the first solve; it must not be shared by solves that run at the same time.
+    /// </summary>
+    template <typename ElementType>
+    class KrylovWorkspace
+    {
+    public:
+        /// <summary> Gets work vectors, reallocating them only when the size changes or more of them are needed. </summary>
+        ///
+        /// <param name="size"> The size of the vectors. </param>
+        /// <param name="count"> The number of vectors. </param>
+        ///
+        /// <returns> At least count vectors of the given size, with unspecified contents. </returns>
+        std::vector<ColumnVector<ElementType>>& GetVectors(size_t size, size_t count);
+
+        /// <summary> Gets scalar work space, with unspecified contents. </summary>
+        ///
+        /// <param name="count"> The number of scalars. </param>
+        ///
+        /// <returns> At least count scalars. </returns>
+        std::vector<double>& GetScalars(size_t count);
+
+    private:
+        size_t _size = 0;
+        std::vector<ColumnVector<ElementType>> _vectors;
+        std::vector<double> _scalars;
+    };
+
+    /// <summary> The identity preconditioner, z = r. </summary>
+    struct IdentityPreconditioner
+    {
+        template <typename ElementType>
+        void operator()(ConstColumnVectorReference<ElementType> r, ColumnVectorReference<ElementType> z) const
+        {
+            z.CopyFrom(r);
+        }
+    };
+
+    /// <summary>
+    /// Solves A x = b with the preconditioned conjugate gradient method, for a symmetric positive definite A and
+    /// a symmetric positive definite preconditioner M. The operator and the preconditioner are only accessed through
+    /// callables, so A never has to be formed. The iterations stop early, without converging, if they find a direction
+    /// p with p' A p &lt;= 0, which shows that A is not positive definite.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="preconditioner"> A callable (ConstColumnVectorReference r, ColumnVectorReference z) that sets z = inverse(M) r, for a preconditioner M that approximates A. </param>
+    /// <param name="parameters"> The parameters. </param>
+    /// <param name="workspace"> The work vectors, which can be reused across solves. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveConjugateGradient(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace);
+
+    /// <summary> Solves A x = b with the conjugate gradient method, without a preconditioner. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="parameters"> The parameters. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveConjugateGradient(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters);
+
+    /// <summary>
+    /// Solves A x = b with MINRES, for a symmetric A that may be indefinite and a symmetric positive definite
+    /// preconditioner M. MINRES minimizes the residual over the Krylov space with a three term recurrence, so
+    /// it needs a fixed number of vectors. With a preconditioner, the residual and b are measured in the norm
+    /// defined by M.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="preconditioner"> A callable (ConstColumnVectorReference r, ColumnVectorReference z) that sets z = inverse(M) r, for a preconditioner M that approximates A. </param>
+    /// <param name="parameters"> The parameters. </param>
+    /// <param name="workspace"> The work vectors, which can be reused across solves. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveMinres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace);
+
+    /// <summary> Solves A x = b with MINRES, without a preconditioner. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="parameters"> The parameters. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveMinres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters);
+
+    /// <summary>
+    /// Solves A x = b with restarted GMRES, for any nonsingular A. The preconditioner is applied on the right,
+    /// A inverse(M) u = b with x = inverse(M) u, so the stopping test sees the true residual. Each cycle builds an
+    /// orthonormal basis of parameters.restart vectors with modified Gram-Schmidt, and the work space grows with it.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="preconditioner"> A callable (ConstColumnVectorReference r, ColumnVectorReference z) that sets z = inverse(M) r, for a preconditioner M that approximates A. </param>
+    /// <param name="parameters"> The parameters. </param>
+    /// <param name="workspace"> The work vectors, which can be reused across solves. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveGmres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace);
+
+    /// <summary> Solves A x = b with restarted GMRES, without a preconditioner. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="linearOperator"> A callable (ConstColumnVectorReference x, ColumnVectorReference y) that sets y = A x. </param>
+    /// <param name="b"> The right hand side. </param>
+    /// <param name="x"> The initial guess on input, and the solution on output. </param>
+    /// <param name="parameters"> The parameters. </param>
+    ///
+    /// <returns> The number of iterations and the relative residual. </returns>
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveGmres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "VectorOperations.h"
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType>
+    std::vector<ColumnVector<ElementType>>& KrylovWorkspace<ElementType>::GetVectors(size_t size, size_t count)
+    {
+        if (size != _size)
+        {
+            _vectors.clear();
+            _size = size;
+        }
+        while (_vectors.size() < count)
+        {
+            _vectors.emplace_back(size);
+        }
+        return _vectors;
+    }
+
+    template <typename ElementType>
+    std::vector<double>& KrylovWorkspace<ElementType>::GetScalars(size_t count)
+    {
+        if (_scalars.size() < count)
+        {
+            _scalars.resize(count);
+        }
+        return _scalars;
+    }
+
+    namespace Internal
+    {
+        template <typename ElementType>
+        void CheckKrylovSizes(ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x)
+        {
+            if (b.Size() != x.Size())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The right hand side and the solution must have the same size.");
+            }
+        }
+
+        template <typename ElementType>
+        double KrylovNorm(ConstColumnVectorReference<ElementType> vector)
+        {
+            return std::sqrt(static_cast<double>(Dot(vector, vector)));
+        }
+
+        // residual = b - A x
+        template <typename ElementType, typename OperatorType>
+        void SetResidual(OperatorType& linearOperator, ConstColumnVectorReference<ElementType> b, ConstColumnVectorReference<ElementType> x, ColumnVectorReference<ElementType> residual)
+        {
+            linearOperator(x, residual);
+            ScaleAddUpdate(One(), b, static_cast<ElementType>(-1), residual);
+        }
+
+        // Givens rotation (c, s) with c * a + s * b = r and -s * a + c * b = 0
+        inline void MakeGivensRotation(double a, double b, double& c, double& s, double& r)
+        {
+            r = std::hypot(a, b);
+            if (r == 0)
+            {
+                c = 1;
+                s = 0;
+            }
+            else
+            {
+                c = a / r;
+                s = b / r;
+            }
+        }
+    } // namespace Internal
+
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveConjugateGradient(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace)
+    {
+        Internal::CheckKrylovSizes(b, x);
+        KrylovSolverResult result;
+        double bNorm = Internal::KrylovNorm(b);
+        if (bNorm == 0)
+        {
+            x.Reset();
+            result.converged = true;
+            return result;
+        }
+
+        auto& vectors = workspace.GetVectors(b.Size(), 4);
+        ColumnVectorReference<ElementType> r = vectors[0];
+        ColumnVectorReference<ElementType> z = vectors[1];
+        ColumnVectorReference<ElementType> p = vectors[2];
+        ColumnVectorReference<ElementType> q = vectors[3];
+
+        Internal::SetResidual(linearOperator, b, x, r);
+        result.relativeResidual = Internal::KrylovNorm<ElementType>(r) / bNorm;
+        if (result.relativeResidual <= parameters.tolerance)
+        {
+            result.converged = true;
+            return result;
+        }
+        preconditioner(ConstColumnVectorReference<ElementType>(r), z);
+        p.CopyFrom(z);
+        ElementType rz = Dot(r, z);
+
+        while (result.numIterations < parameters.maxIterations)
+        {
+            linearOperator(ConstColumnVectorReference<ElementType>(p), q);
+            ++result.numIterations;
+            ElementType pq = Dot(p, q);
+            if (!(pq > 0))
+            {
+                break;
+            }
+
+            ElementType alpha = rz / pq;
+            ScaleAddUpdate(alpha, ConstColumnVectorReference<ElementType>(p), One(), x);
+            ScaleAddUpdate(-alpha, ConstColumnVectorReference<ElementType>(q), One(), r);
+            result.relativeResidual = Internal::KrylovNorm<ElementType>(r) / bNorm;
+            if (result.relativeResidual <= parameters.tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+
+            preconditioner(ConstColumnVectorReference<ElementType>(r), z);
+            ElementType rzNext = Dot(r, z);
+            ScaleAddUpdate(One(), ConstColumnVectorReference<ElementType>(z), rzNext / rz, p);
+            rz = rzNext;
+        }
+        return result;
+    }
+
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveConjugateGradient(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters)
+    {
+        KrylovWorkspace<ElementType> workspace;
+        return SolveConjugateGradient(linearOperator, b, x, IdentityPreconditioner(), parameters, workspace);
+    }
+
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveMinres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace)
+    {
+        // the Lanczos process of Paige and Saunders: the vectors r1 and r2 are the last two unnormalized Lanczos
+        // vectors, y = inverse(M) r2, and w1, w2, w are the last three search directions
+        Internal::CheckKrylovSizes(b, x);
+        KrylovSolverResult result;
+        auto& vectors = workspace.GetVectors(b.Size(), 7);
+        ColumnVectorReference<ElementType> v = vectors[0];
+        ColumnVectorReference<ElementType> y = vectors[1];
+        ColumnVectorReference<ElementType> r1 = vectors[2];
+        ColumnVectorReference<ElementType> r2 = vectors[3];
+        ColumnVectorReference<ElementType> w = vectors[4];
+        ColumnVectorReference<ElementType> w1 = vectors[5];
+        ColumnVectorReference<ElementType> w2 = vectors[6];
+
+        auto preconditionedNorm = [&](ConstColumnVectorReference<ElementType> vector, ColumnVectorReference<ElementType> preconditioned) {
+            preconditioner(vector, preconditioned);
+            double squaredNorm = Dot(vector, preconditioned);
+            if (squaredNorm < 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The MINRES preconditioner must be positive definite.");
+            }
+            return std::sqrt(squaredNorm);
+        };
+
+        double bNorm = preconditionedNorm(b, y);
+        if (bNorm == 0)
+        {
+            x.Reset();
+            result.converged = true;
+            return result;
+        }
+
+        Internal::SetResidual(linearOperator, b, x, r1);
+        double beta = preconditionedNorm(r1, y);
+        result.relativeResidual = beta / bNorm;
+        if (result.relativeResidual <= parameters.tolerance)
+        {
+            result.converged = true;
+            return result;
+        }
+
+        r2.CopyFrom(r1);
+        w.Reset();
+        w2.Reset();
+        double previousBeta = 0;
+        double dBar = 0;
+        double epsilon = 0;
+        double phiBar = beta;
+        double c = -1;
+        double s = 0;
+        while (result.numIterations < parameters.maxIterations)
+        {
+            v.CopyFrom(y);
+            ScaleUpdate(static_cast<ElementType>(1 / beta), v);
+            linearOperator(ConstColumnVectorReference<ElementType>(v), y);
+            ++result.numIterations;
+            if (result.numIterations >= 2)
+            {
+                ScaleAddUpdate(static_cast<ElementType>(-beta / previousBeta), ConstColumnVectorReference<ElementType>(r1), One(), y);
+            }
+            double alpha = Dot(v, y);
+            ScaleAddUpdate(static_cast<ElementType>(-alpha / beta), ConstColumnVectorReference<ElementType>(r2), One(), y);
+
+            // r1 <- r2, r2 <- y, and y <- inverse(M) r2 in the old r1
+            r1.Swap(r2);
+            r2.Swap(y);
+            previousBeta = beta;
+            beta = preconditionedNorm(r2, y);
+
+            // apply the previous rotation to the new column of the tridiagonal matrix, and eliminate its last element
+            double previousEpsilon = epsilon;
+            double delta = c * dBar + s * alpha;
+            double gBar = s * dBar - c * alpha;
+            epsilon = s * beta;
+            dBar = -c * beta;
+            double gamma = 0;
+            Internal::MakeGivensRotation(gBar, beta, c, s, gamma);
+            if (gamma == 0)
+            {
+                break;
+            }
+            double phi = c * phiBar;
+            phiBar = s * phiBar;
+
+            // w <- (v - previousEpsilon * w1 - delta * w2) / gamma, in the old w1, after w1 <- w2 and w2 <- w
+            w1.Swap(w2);
+            w2.Swap(w);
+            ScaleAddSet(static_cast<ElementType>(1 / gamma), ConstColumnVectorReference<ElementType>(v), static_cast<ElementType>(-previousEpsilon / gamma), ConstColumnVectorReference<ElementType>(w1), w);
+            ScaleAddUpdate(static_cast<ElementType>(-delta / gamma), ConstColumnVectorReference<ElementType>(w2), One(), w);
+            ScaleAddUpdate(static_cast<ElementType>(phi), ConstColumnVectorReference<ElementType>(w), One(), x);
+
+            result.relativeResidual = phiBar / bNorm;
+            if (result.relativeResidual <= parameters.tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+            if (beta == 0)
+            {
+                break;
+            }
+        }
+        return result;
+    }
+
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveMinres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters)
+    {
+        KrylovWorkspace<ElementType> workspace;
+        return SolveMinres(linearOperator, b, x, IdentityPreconditioner(), parameters, workspace);
+    }
+
+    template <typename ElementType, typename OperatorType, typename PreconditionerType>
+    KrylovSolverResult SolveGmres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, PreconditionerType&& preconditioner, const KrylovSolverParameters& parameters, KrylovWorkspace<ElementType>& workspace)
+    {
+        Internal::CheckKrylovSizes(b, x);
+        if (parameters.restart == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The GMRES restart length must be positive.");
+        }
+
+        KrylovSolverResult result;
+        double bNorm = Internal::KrylovNorm(b);
+        if (bNorm == 0)
+        {
+            x.Reset();
+            result.converged = true;
+            return result;
+        }
+
+        // the basis vectors v[0..m], followed by one vector for inverse(M) v[j] and the correction
+        const size_t m = parameters.restart;
+        auto& vectors = workspace.GetVectors(b.Size(), m + 2);
+        ColumnVectorReference<ElementType> z = vectors[m + 1];
+
+        // the m + 1 by m Hessenberg matrix in column major order, the rotations and the rotated residual
+        auto& scalars = workspace.GetScalars((m + 1) * m + 2 * m + (m + 1));
+        double* h = scalars.data();
+        double* cosines = h + (m + 1) * m;
+        double* sines = cosines + m;
+        double* g = sines + m;
+
+        while (true)
+        {
+            ColumnVectorReference<ElementType> v0 = vectors[0];
+            Internal::SetResidual(linearOperator, b, x, v0);
+            double beta = Internal::KrylovNorm<ElementType>(v0);
+            result.relativeResidual = beta / bNorm;
+            if (result.relativeResidual <= parameters.tolerance)
+            {
+                result.converged = true;
+                break;
+            }
+            if (result.numIterations >= parameters.maxIterations)
+            {
+                break;
+            }
+            ScaleUpdate(static_cast<ElementType>(1 / beta), v0);
+            std::fill(g, g + m + 1, 0.0);
+            g[0] = beta;
+
+            size_t numColumns = 0;
+            while (numColumns < m && result.numIterations < parameters.maxIterations)
+            {
+                size_t j = numColumns;
+                double* column = h + j * (m + 1);
+                ColumnVectorReference<ElementType> w = vectors[j + 1];
+                preconditioner(ConstColumnVectorReference<ElementType>(vectors[j]), z);
+                linearOperator(ConstColumnVectorReference<ElementType>(z), w);
+                ++result.numIterations;
+                ++numColumns;
+
+                for (size_t i = 0; i <= j; ++i)
+                {
+                    column[i] = Dot(w, vectors[i]);
+                    ScaleAddUpdate(static_cast<ElementType>(-column[i]), ConstColumnVectorReference<ElementType>(vectors[i]), One(), w);
+                }
+                column[j + 1] = Internal::KrylovNorm<ElementType>(w);
+                bool breakdown = column[j + 1] == 0;
+                if (!breakdown)
+                {
+                    ScaleUpdate(static_cast<ElementType>(1 / column[j + 1]), w);
+                }
+
+                for (size_t i = 0; i < j; ++i)
+                {
+                    double rotated = cosines[i] * column[i] + sines[i] * column[i + 1];
+                    column[i + 1] = -sines[i] * column[i] + cosines[i] * column[i + 1];
+                    column[i] = rotated;
+                }
+                Internal::MakeGivensRotation(column[j], column[j + 1], cosines[j], sines[j], column[j]);
+                column[j + 1] = 0;
+                g[j + 1] = -sines[j] * g[j];
+                g[j] = cosines[j] * g[j];
+
+                result.relativeResidual = std::abs(g[j + 1]) / bNorm;
+                if (result.relativeResidual <= parameters.tolerance || breakdown)
+                {
+                    break;
+                }
+            }
+
+            // solve the triangular system in place of g, and x += inverse(M) (v[0..k) * g)
+            for (size_t i = numColumns; i-- > 0;)
+            {
+                double sum = g[i];
+                for (size_t k = i + 1; k < numColumns; ++k)
+                {
+                    sum -= h[k * (m + 1) + i] * g[k];
+                }
+                g[i] = sum / h[i * (m + 1) + i];
+            }
+            ColumnVectorReference<ElementType> correction = vectors[0];
+            ScaleUpdate(static_cast<ElementType>(g[0]), correction);
+            for (size_t i = 1; i < numColumns; ++i)
+            {
+                ScaleAddUpdate(static_cast<ElementType>(g[i]), ConstColumnVectorReference<ElementType>(vectors[i]), One(), correction);
+            }
+            preconditioner(ConstColumnVectorReference<ElementType>(correction), z);
+            ScaleAddUpdate(static_cast<ElementType>(1), ConstColumnVectorReference<ElementType>(z), One(), x);
+        }
+        return result;
+    }
+
+    template <typename ElementType, typename OperatorType>
+    KrylovSolverResult SolveGmres(OperatorType&& linearOperator, ConstColumnVectorReference<ElementType> b, ColumnVectorReference<ElementType> x, const KrylovSolverParameters& parameters)
+    {
+        KrylovWorkspace<ElementType> workspace;
+        return SolveGmres(linearOperator, b, x, IdentityPreconditioner(), parameters, workspace);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
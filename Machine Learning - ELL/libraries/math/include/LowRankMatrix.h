@@ -0,0 +1,459 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/LowRankMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// A matrix stored as the factors U * diag(s) * transpose(V) of rank k, where U is numRows x k and V is
+    /// numColumns x k. Products are computed as two thin products through the rank, so they cost
+    /// k * (numRows + numColumns) per column instead of numRows * numColumns, and the dense matrix is never formed.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class LowRankMatrix
+    {
+    public:
+        /// <summary> Constructs a low rank matrix from its factors. </summary>
+        ///
+        /// <param name="u"> The left factor, numRows x k. </param>
+        /// <param name="singularValues"> The k scales of the rank one terms. </param>
+        /// <param name="v"> The right factor, numColumns x k. </param>
+        template <MatrixLayout layoutU, MatrixLayout layoutV>
+        LowRankMatrix(ConstMatrixReference<ElementType, layoutU> u, std::vector<ElementType> singularValues, ConstMatrixReference<ElementType, layoutV> v);
+
+        /// <summary>
+        /// Compresses a matrix with its truncated singular value decomposition: the rank is the smallest number of
+        /// singular values whose squares add up to the given fraction of the squared Frobenius norm of the matrix,
+        /// capped at maxRank. The decomposition is computed in double precision with the one-sided Jacobi method.
+        /// </summary>
+        ///
+        /// <param name="matrix"> The matrix, it is not referenced afterwards. </param>
+        /// <param name="energy"> The fraction of the squared Frobenius norm to keep, between 0 and 1. </param>
+        /// <param name="maxRank"> The largest rank allowed, or 0 for no limit. </param>
+        template <MatrixLayout layout>
+        explicit LowRankMatrix(ConstMatrixReference<ElementType, layout> matrix, double energy = 0.99, size_t maxRank = 0);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _u.NumRows(); }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _vTranspose.NumColumns(); }
+
+        /// <summary> Gets the rank, the number of rank one terms. </summary>
+        ///
+        /// <returns> The rank. </returns>
+        size_t GetRank() const { return _singularValues.size(); }
+
+        /// <summary> Gets the left factor U. </summary>
+        ///
+        /// <returns> U, numRows x rank. </returns>
+        ConstRowMatrixReference<ElementType> GetU() const { return _u; }
+
+        /// <summary> Gets the scales of the rank one terms, in decreasing order after a decomposition. </summary>
+        ///
+        /// <returns> The singular values. </returns>
+        const std::vector<ElementType>& GetSingularValues() const { return _singularValues; }
+
+        /// <summary> Gets the right factor V. </summary>
+        ///
+        /// <returns> V, numColumns x rank. </returns>
+        ConstMatrixReference<ElementType, MatrixLayout::columnMajor> GetV() const { return _vTranspose.Transpose(); }
+
+        /// <summary> Copies the matrix to a dense matrix of the same size. </summary>
+        ///
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout layout>
+        void CopyTo(MatrixReference<ElementType, layout> matrix) const;
+
+    private:
+        RowMatrix<ElementType> _u;
+        std::vector<ElementType> _singularValues;
+        RowMatrix<ElementType> _vTranspose;
+    };
+
+    /// <summary> Multiplies a low rank matrix by a column vector, vectorB = scalarA * matrix * vectorA + scalarB * vectorB. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrix"> The low rank matrix. </param>
+    /// <param name="vectorA"> The column vector. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const LowRankMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+    /// <summary> Multiplies a row vector by a low rank matrix, vectorB = scalarA * vectorA * matrix + scalarB * vectorB. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="vectorA"> The row vector. </param>
+    /// <param name="matrix"> The low rank matrix. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const LowRankMatrix<ElementType>& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+    /// <summary> Multiplies a low rank matrix by a dense matrix, matrixC = scalarA * matrixA * matrixB + scalarC * matrixC. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The low rank matrix. </param>
+    /// <param name="matrixB"> The dense matrix. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC, when zero matrixC is not read. </param>
+    /// <param name="matrixC"> The result matrix. </param>
+    template <typename ElementType, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const LowRankMatrix<ElementType>& matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+
+    /// <summary> Multiplies a dense matrix by a low rank matrix, matrixC = scalarA * matrixA * matrixB + scalarC * matrixC. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The dense matrix. </param>
+    /// <param name="matrixB"> The low rank matrix. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC, when zero matrixC is not read. </param>
+    /// <param name="matrixC"> The result matrix. </param>
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, const LowRankMatrix<ElementType>& matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+#include "MatrixOperations.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the singular value decomposition of a numRows x numColumns matrix with numRows >= numColumns, given as
+        // numColumns contiguous columns; on return, column i holds singular value i times left singular vector i,
+        // and rightVectors[i * numColumns, (i + 1) * numColumns) holds right singular vector i
+        struct JacobiSvd
+        {
+            size_t numRows;
+            size_t numColumns;
+            std::vector<double> columns;
+            std::vector<double> rightVectors;
+        };
+
+        inline double JacobiDot(const double* pA, const double* pB, size_t size)
+        {
+            double sum = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                sum += pA[i] * pB[i];
+            }
+            return sum;
+        }
+
+        inline void JacobiRotate(double* pA, double* pB, size_t size, double c, double s)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                double a = pA[i];
+                double b = pB[i];
+                pA[i] = c * a - s * b;
+                pB[i] = s * a + c * b;
+            }
+        }
+
+        // one-sided Jacobi (Hestenes): plane rotations orthogonalize every pair of columns, sweep after sweep,
+        // until no pair needs a rotation. Each sweep visits the pairs in round-robin order, numColumns / 2
+        // disjoint pairs per round, and the pairs of a round are rotated in parallel; as they are disjoint the
+        // result does not depend on the number of threads
+        inline void ComputeJacobiSvd(JacobiSvd& svd)
+        {
+            constexpr size_t maxSweeps = 60;
+            const double tolerance = 4 * std::numeric_limits<double>::epsilon();
+            const size_t m = svd.numRows;
+            const size_t n = svd.numColumns;
+            svd.rightVectors.assign(n * n, 0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                svd.rightVectors[i * n + i] = 1;
+            }
+
+            // players of the round-robin tournament, padded to an even count; index n stands for a bye
+            size_t numPlayers = n + n % 2;
+            std::vector<size_t> players(numPlayers);
+            std::iota(players.begin(), players.end(), size_t{ 0 });
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(5 * m + 2 * n, 1));
+
+            // columns that have shrunk to rounding noise of the whole matrix belong to the null space; rotating
+            // them against each other would only shuffle the noise, and rank deficient matrices would never converge
+            double negligible = tolerance * JacobiDot(svd.columns.data(), svd.columns.data(), m * n);
+            for (size_t sweep = 0; sweep < maxSweeps; ++sweep)
+            {
+                // set by every task that rotates a pair, so the stores are atomic; relaxed order suffices since
+                // ParallelFor joins the tasks before the flag is read
+                std::atomic<bool> rotated(false);
+                for (size_t round = 0; round + 1 < numPlayers; ++round)
+                {
+                    utilities::ParallelFor(numPlayers / 2, grainSize, [&](size_t begin, size_t end) {
+                        for (size_t pair = begin; pair < end; ++pair)
+                        {
+                            size_t p = std::min(players[pair], players[numPlayers - 1 - pair]);
+                            size_t q = std::max(players[pair], players[numPlayers - 1 - pair]);
+                            if (q >= n)
+                            {
+                                continue;
+                            }
+
+                            double* pP = svd.columns.data() + p * m;
+                            double* pQ = svd.columns.data() + q * m;
+                            double alpha = JacobiDot(pP, pP, m);
+                            double beta = JacobiDot(pQ, pQ, m);
+                            double gamma = JacobiDot(pP, pQ, m);
+                            if (std::max(alpha, beta) <= negligible || std::abs(gamma) <= tolerance * std::sqrt(alpha * beta))
+                            {
+                                continue;
+                            }
+
+                            // the rotation that zeroes the inner product of the pair
+                            double zeta = (beta - alpha) / (2 * gamma);
+                            double t = (zeta >= 0 ? 1 : -1) / (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+                            double c = 1 / std::sqrt(1 + t * t);
+                            double s = c * t;
+                            JacobiRotate(pP, pQ, m, c, s);
+                            JacobiRotate(svd.rightVectors.data() + p * n, svd.rightVectors.data() + q * n, n, c, s);
+                            rotated.store(true, std::memory_order_relaxed);
+                        }
+                    });
+
+                    // keep the first player in place and rotate the others by one position
+                    std::rotate(players.begin() + 1, players.end() - 1, players.end());
+                }
+                if (!rotated.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+        }
+
+        // multiplies row (column) r of a product through the rank by singular value r
+        template <typename ElementType>
+        void ScaleRows(RowMatrixReference<ElementType> matrix, const std::vector<ElementType>& scales)
+        {
+            for (size_t i = 0; i < matrix.NumRows(); ++i)
+            {
+                for (size_t j = 0; j < matrix.NumColumns(); ++j)
+                {
+                    matrix(i, j) *= scales[i];
+                }
+            }
+        }
+
+        template <typename ElementType>
+        void ScaleColumns(RowMatrixReference<ElementType> matrix, const std::vector<ElementType>& scales)
+        {
+            for (size_t i = 0; i < matrix.NumRows(); ++i)
+            {
+                for (size_t j = 0; j < matrix.NumColumns(); ++j)
+                {
+                    matrix(i, j) *= scales[j];
+                }
+            }
+        }
+    } // namespace Internal
+
+    template <typename ElementType>
+    template <MatrixLayout layoutU, MatrixLayout layoutV>
+    LowRankMatrix<ElementType>::LowRankMatrix(ConstMatrixReference<ElementType, layoutU> u, std::vector<ElementType> singularValues, ConstMatrixReference<ElementType, layoutV> v) :
+        _u(u.NumRows(), u.NumColumns()),
+        _singularValues(std::move(singularValues)),
+        _vTranspose(v.NumColumns(), v.NumRows())
+    {
+        if (u.NumColumns() != _singularValues.size() || v.NumColumns() != _singularValues.size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The factors must have one column per singular value.");
+        }
+        _u.CopyFrom(u);
+        _vTranspose.CopyFrom(v.Transpose());
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    LowRankMatrix<ElementType>::LowRankMatrix(ConstMatrixReference<ElementType, layout> matrix, double energy, size_t maxRank) :
+        _u(matrix.NumRows(), 0),
+        _vTranspose(0, matrix.NumColumns())
+    {
+        if (energy < 0 || energy > 1)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The energy must be between 0 and 1.");
+        }
+
+        // a wide matrix is decomposed through its transpose, whose left and right singular vectors are swapped
+        const bool isWide = matrix.NumRows() < matrix.NumColumns();
+        Internal::JacobiSvd svd;
+        svd.numRows = isWide ? matrix.NumColumns() : matrix.NumRows();
+        svd.numColumns = isWide ? matrix.NumRows() : matrix.NumColumns();
+        svd.columns.resize(svd.numRows * svd.numColumns);
+        for (size_t i = 0; i < matrix.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < matrix.NumColumns(); ++j)
+            {
+                svd.columns[isWide ? i * svd.numRows + j : j * svd.numRows + i] = matrix(i, j);
+            }
+        }
+        Internal::ComputeJacobiSvd(svd);
+
+        // sort by decreasing singular value and keep the smallest rank that reaches the energy
+        std::vector<double> singularValues(svd.numColumns);
+        double totalEnergy = 0;
+        for (size_t i = 0; i < svd.numColumns; ++i)
+        {
+            const double* pColumn = svd.columns.data() + i * svd.numRows;
+            singularValues[i] = std::sqrt(Internal::JacobiDot(pColumn, pColumn, svd.numRows));
+            totalEnergy += singularValues[i] * singularValues[i];
+        }
+        std::vector<size_t> order(svd.numColumns);
+        std::iota(order.begin(), order.end(), size_t{ 0 });
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return singularValues[a] > singularValues[b]; });
+
+        size_t rank = 0;
+        double keptEnergy = 0;
+        size_t rankLimit = maxRank == 0 ? svd.numColumns : std::min(maxRank, svd.numColumns);
+        while (rank < rankLimit && keptEnergy < energy * totalEnergy && singularValues[order[rank]] > 0)
+        {
+            keptEnergy += singularValues[order[rank]] * singularValues[order[rank]];
+            ++rank;
+        }
+
+        RowMatrix<ElementType> u(matrix.NumRows(), rank);
+        RowMatrix<ElementType> vTranspose(rank, matrix.NumColumns());
+        _singularValues.resize(rank);
+        for (size_t r = 0; r < rank; ++r)
+        {
+            size_t index = order[r];
+            double sigma = singularValues[index];
+            const double* pLeft = svd.columns.data() + index * svd.numRows;
+            const double* pRight = svd.rightVectors.data() + index * svd.numColumns;
+            _singularValues[r] = static_cast<ElementType>(sigma);
+            for (size_t i = 0; i < svd.numRows; ++i)
+            {
+                ElementType left = static_cast<ElementType>(pLeft[i] / sigma);
+                if (isWide)
+                {
+                    vTranspose(r, i) = left;
+                }
+                else
+                {
+                    u(i, r) = left;
+                }
+            }
+            for (size_t j = 0; j < svd.numColumns; ++j)
+            {
+                if (isWide)
+                {
+                    u(j, r) = static_cast<ElementType>(pRight[j]);
+                }
+                else
+                {
+                    vTranspose(r, j) = static_cast<ElementType>(pRight[j]);
+                }
+            }
+        }
+        _u = std::move(u);
+        _vTranspose = std::move(vTranspose);
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void LowRankMatrix<ElementType>::CopyTo(MatrixReference<ElementType, layout> matrix) const
+    {
+        if (matrix.NumRows() != NumRows() || matrix.NumColumns() != NumColumns())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The dense matrix must have the size of the low rank matrix.");
+        }
+
+        RowMatrix<ElementType> scaledU(_u);
+        Internal::ScaleColumns(scaledU.GetReference(), _singularValues);
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(ElementType{ 1 }, ConstRowMatrixReference<ElementType>(scaledU), ConstRowMatrixReference<ElementType>(_vTranspose), ElementType{ 0 }, matrix);
+    }
+
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const LowRankMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumColumns() != vectorA.Size() || matrix.NumRows() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        // t = diag(s) * transpose(V) * x, then y = scalarA * U * t + scalarB * y
+        ColumnVector<ElementType> t(matrix.GetRank());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(ElementType{ 1 }, matrix.GetV().Transpose(), vectorA, ElementType{ 0 }, t.GetReference());
+        for (size_t r = 0; r < t.Size(); ++r)
+        {
+            t[r] *= matrix.GetSingularValues()[r];
+        }
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(scalarA, matrix.GetU(), ConstColumnVectorReference<ElementType>(t), scalarB, vectorB);
+    }
+
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const LowRankMatrix<ElementType>& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vectorA.Size() || matrix.NumColumns() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        // t = x * U * diag(s), then y = scalarA * t * transpose(V) + scalarB * y
+        RowVector<ElementType> t(matrix.GetRank());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(ElementType{ 1 }, vectorA, matrix.GetU(), ElementType{ 0 }, t.GetReference());
+        for (size_t r = 0; r < t.Size(); ++r)
+        {
+            t[r] *= matrix.GetSingularValues()[r];
+        }
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(scalarA, ConstRowVectorReference<ElementType>(t), matrix.GetV().Transpose(), scalarB, vectorB);
+    }
+
+    template <typename ElementType, MatrixLayout layoutB, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const LowRankMatrix<ElementType>& matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+    {
+        DEBUG_CHECK_SIZES(matrixA.NumColumns() != matrixB.NumRows() || matrixA.NumRows() != matrixC.NumRows() || matrixB.NumColumns() != matrixC.NumColumns(), "Incompatible matrix sizes.");
+
+        // T = diag(s) * transpose(V) * B, then C = scalarA * U * T + scalarC * C
+        RowMatrix<ElementType> t(matrixA.GetRank(), matrixB.NumColumns());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(ElementType{ 1 }, matrixA.GetV().Transpose(), matrixB, ElementType{ 0 }, t.GetReference());
+        Internal::ScaleRows(t.GetReference(), matrixA.GetSingularValues());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(scalarA, matrixA.GetU(), ConstRowMatrixReference<ElementType>(t), scalarC, matrixC);
+    }
+
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, const LowRankMatrix<ElementType>& matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+    {
+        DEBUG_CHECK_SIZES(matrixA.NumColumns() != matrixB.NumRows() || matrixA.NumRows() != matrixC.NumRows() || matrixB.NumColumns() != matrixC.NumColumns(), "Incompatible matrix sizes.");
+
+        // T = A * U * diag(s), then C = scalarA * T * transpose(V) + scalarC * C
+        RowMatrix<ElementType> t(matrixA.NumRows(), matrixB.GetRank());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(ElementType{ 1 }, matrixA, matrixB.GetU(), ElementType{ 0 }, t.GetReference());
+        Internal::ScaleColumns(t.GetReference(), matrixB.GetSingularValues());
+        MultiplyScaleAddUpdate<ImplementationType::automatic>(scalarA, ConstRowMatrixReference<ElementType>(t), matrixB.GetV().Transpose(), scalarC, matrixC);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,291 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/MappedFile.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Tensor.h"
+#include "Vector.h"
+
+#include <utilities/include/Exception.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Element types that can be stored in a mapped file. </summary>
+    enum class MappedElementType : uint32_t
+    {
+        float32 = 1,
+        float64 = 2,
+        int32 = 3,
+        int16 = 4,
+        int8 = 5,
+        uint8 = 6
+    };
+
+    /// <summary> Maps a C++ element type to its MappedElementType tag. </summary>
+    template <typename ElementType>
+    struct MappedElementTypeOf;
+
+    template <>
+    struct MappedElementTypeOf<float> { static constexpr MappedElementType value = MappedElementType::float32; };
+
+    template <>
+    struct MappedElementTypeOf<double> { static constexpr MappedElementType value = MappedElementType::float64; };
+
+    template <>
+    struct MappedElementTypeOf<int32_t> { static constexpr MappedElementType value = MappedElementType::int32; };
+
+    template <>
+    struct MappedElementTypeOf<int16_t> { static constexpr MappedElementType value = MappedElementType::int16; };
+
+    template <>
+    struct MappedElementTypeOf<int8_t> { static constexpr MappedElementType value = MappedElementType::int8; };
+
+    template <>
+    struct MappedElementTypeOf<uint8_t> { static constexpr MappedElementType value = MappedElementType::uint8; };
+
+    /// <summary>
+    /// The fixed size header at the start of a mapped file. The shape is always given in logical
+    /// coordinates (row, column, channel) and the dimension order lists the dimensions from the
+    /// contiguous one to the one with the largest memory increment. A column major matrix is stored
+    /// as (row, column, channel), a row major matrix as (column, row, channel) and a vector as a
+    /// column major matrix with a single column.
+    /// </summary>
+    struct MappedFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t elementType;
+        uint32_t elementSize;
+        uint32_t dimensionOrder[3];
+        uint32_t reserved;
+        uint64_t shape[3];
+        uint64_t dataOffset;
+    };
+
+    /// <summary> Hints passed to the kernel about how a mapped file is going to be read. </summary>
+    enum class MappedFileAccess
+    {
+        normal,
+        sequential,
+        random,
+        willNeed
+    };
+
+    /// <summary> Options used when mapping a file. </summary>
+    struct MappedFileOptions
+    {
+        /// <summary> Fault all pages in up front (MAP_POPULATE), so later reads never block on disk. </summary>
+        bool populate = false;
+
+        /// <summary> The access pattern hint given to madvise. </summary>
+        MappedFileAccess access = MappedFileAccess::normal;
+    };
+
+    /// <summary>
+    /// A read only, memory mapped file that owns the mapping and exposes zero-copy vector, matrix and
+    /// tensor views over the stored elements. The mapping is shared, so several processes that map the
+    /// same file share one copy of it in the page cache. Views are only valid while the MappedFile is alive.
+    /// </summary>
+    class MappedFile
+    {
+    public:
+        /// <summary> Maps a file written by WriteMappedFile. </summary>
+        ///
+        /// <param name="filepath"> The path of the file to map. </param>
+        /// <param name="options"> The mapping options. </param>
+        MappedFile(const std::string& filepath, MappedFileOptions options = {});
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /// <summary> Gets the file header. </summary>
+        ///
+        /// <returns> The header. </returns>
+        const MappedFileHeader& GetHeader() const { return _header; }
+
+        /// <summary> Gets the element type stored in the file. </summary>
+        ///
+        /// <returns> The element type. </returns>
+        MappedElementType GetElementType() const { return static_cast<MappedElementType>(_header.elementType); }
+
+        /// <summary> Gets the logical shape of the stored array. </summary>
+        ///
+        /// <returns> The shape, in (row, column, channel) order. </returns>
+        TensorShape GetShape() const;
+
+        /// <summary> Gets the total number of stored elements. </summary>
+        ///
+        /// <returns> The number of elements. </returns>
+        size_t Size() const { return GetShape().Size(); }
+
+        /// <summary> Gets a flat view of all the stored elements, in memory order. </summary>
+        ///
+        /// <typeparam name="ElementType"> The element type, which must match the stored element type. </typeparam>
+        ///
+        /// <returns> A ConstColumnVectorReference over the mapped bytes. </returns>
+        template <typename ElementType>
+        ConstColumnVectorReference<ElementType> GetVector() const;
+
+        /// <summary> Gets a matrix view over a file that stores a matrix (or a single channel tensor) with the given layout. </summary>
+        ///
+        /// <typeparam name="ElementType"> The element type, which must match the stored element type. </typeparam>
+        /// <typeparam name="layout"> The matrix layout, which must match the stored layout. </typeparam>
+        ///
+        /// <returns> A ConstMatrixReference over the mapped bytes. </returns>
+        template <typename ElementType, MatrixLayout layout>
+        ConstMatrixReference<ElementType, layout> GetMatrix() const;
+
+        /// <summary> Gets a tensor view over a file that stores a tensor with the given dimension order. </summary>
+        ///
+        /// <typeparam name="ElementType"> The element type, which must match the stored element type. </typeparam>
+        /// <typeparam name="dimension0"> The contiguous dimension, which must match the stored order. </typeparam>
+        /// <typeparam name="dimension1"> The minor dimension, which must match the stored order. </typeparam>
+        /// <typeparam name="dimension2"> The major dimension, which must match the stored order. </typeparam>
+        ///
+        /// <returns> A ConstTensorReference over the mapped bytes. </returns>
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        ConstTensorReference<ElementType, dimension0, dimension1, dimension2> GetTensor() const;
+
+    private:
+        template <typename ElementType>
+        const ElementType* GetElements() const;
+        bool HasDimensionOrder(Dimension dimension0, Dimension dimension1, Dimension dimension2) const;
+        void Unmap();
+
+        void* _pMapping = nullptr;
+        size_t _mappingSize = 0;
+        MappedFileHeader _header;
+    };
+
+    /// <summary> Writes a vector to a file that can be mapped by MappedFile. </summary>
+    ///
+    /// <param name="filepath"> The path of the file to write. </param>
+    /// <param name="vector"> The vector to write. </param>
+    template <typename ElementType, VectorOrientation orientation>
+    void WriteMappedFile(const std::string& filepath, ConstVectorReference<ElementType, orientation> vector);
+
+    /// <summary> Writes a matrix to a file that can be mapped by MappedFile. The layout is preserved. </summary>
+    ///
+    /// <param name="filepath"> The path of the file to write. </param>
+    /// <param name="matrix"> The matrix to write. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void WriteMappedFile(const std::string& filepath, ConstMatrixReference<ElementType, layout> matrix);
+
+    /// <summary> Writes a tensor to a file that can be mapped by MappedFile. The dimension order is preserved. </summary>
+    ///
+    /// <param name="filepath"> The path of the file to write. </param>
+    /// <param name="tensor"> The tensor to write. </param>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void WriteMappedFile(const std::string& filepath, ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor);
+
+    namespace Internal
+    {
+        MappedFileHeader CreateMappedFileHeader(MappedElementType elementType, size_t elementSize, const Dimension (&order)[3], TensorShape shape);
+
+        // the number of blocks along one level of a strided layout and the distance between them in bytes
+        struct MappedFileStride
+        {
+            size_t count;
+            size_t incrementInBytes;
+        };
+
+        // writes the header followed by the contiguous blocks of a (at most) two level strided layout
+        void WriteMappedFile(const std::string& filepath, const MappedFileHeader& header, const char* pData, MappedFileStride outer, MappedFileStride inner, size_t blockSizeInBytes);
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType>
+    const ElementType* MappedFile::GetElements() const
+    {
+        if (MappedElementTypeOf<ElementType>::value != GetElementType() || sizeof(ElementType) != _header.elementSize)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "mapped file element type does not match the requested element type");
+        }
+        return reinterpret_cast<const ElementType*>(static_cast<const char*>(_pMapping) + _header.dataOffset);
+    }
+
+    template <typename ElementType>
+    ConstColumnVectorReference<ElementType> MappedFile::GetVector() const
+    {
+        return ConstColumnVectorReference<ElementType>(GetElements<ElementType>(), Size());
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    ConstMatrixReference<ElementType, layout> MappedFile::GetMatrix() const
+    {
+        auto shape = GetShape();
+        bool isColumnMajor = HasDimensionOrder(Dimension::row, Dimension::column, Dimension::channel);
+        bool isRowMajor = HasDimensionOrder(Dimension::column, Dimension::row, Dimension::channel);
+        if (shape.NumChannels() != 1 || (layout == MatrixLayout::columnMajor ? !isColumnMajor : !isRowMajor))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "mapped file does not store a matrix with the requested layout");
+        }
+        return ConstMatrixReference<ElementType, layout>(GetElements<ElementType>(), shape.NumRows(), shape.NumColumns());
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> MappedFile::GetTensor() const
+    {
+        if (!HasDimensionOrder(dimension0, dimension1, dimension2))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::typeMismatch, "mapped file does not store a tensor with the requested dimension order");
+        }
+        return ConstTensorReference<ElementType, dimension0, dimension1, dimension2>(GetElements<ElementType>(), GetShape());
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    void WriteMappedFile(const std::string& filepath, ConstVectorReference<ElementType, orientation> vector)
+    {
+        const Dimension order[3] = { Dimension::row, Dimension::column, Dimension::channel };
+        auto header = Internal::CreateMappedFileHeader(MappedElementTypeOf<ElementType>::value, sizeof(ElementType), order, { vector.Size(), 1, 1 });
+
+        // a strided vector is written one element at a time
+        Internal::WriteMappedFile(filepath, header, reinterpret_cast<const char*>(vector.GetConstDataPointer()), { 1, 0 }, { vector.Size(), vector.GetIncrement() * sizeof(ElementType) }, sizeof(ElementType));
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void WriteMappedFile(const std::string& filepath, ConstMatrixReference<ElementType, layout> matrix)
+    {
+        const Dimension columnMajorOrder[3] = { Dimension::row, Dimension::column, Dimension::channel };
+        const Dimension rowMajorOrder[3] = { Dimension::column, Dimension::row, Dimension::channel };
+        auto header = Internal::CreateMappedFileHeader(MappedElementTypeOf<ElementType>::value, sizeof(ElementType), layout == MatrixLayout::columnMajor ? columnMajorOrder : rowMajorOrder, { matrix.NumRows(), matrix.NumColumns(), 1 });
+
+        Internal::WriteMappedFile(filepath, header, reinterpret_cast<const char*>(matrix.GetConstDataPointer()), { 1, 0 }, { matrix.GetMinorSize(), matrix.GetIncrement() * sizeof(ElementType) }, matrix.GetMajorSize() * sizeof(ElementType));
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void WriteMappedFile(const std::string& filepath, ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor)
+    {
+        const Dimension order[3] = { dimension0, dimension1, dimension2 };
+        auto header = Internal::CreateMappedFileHeader(MappedElementTypeOf<ElementType>::value, sizeof(ElementType), order, tensor.GetShape());
+
+        // each vector along dimension0 is contiguous, even in a sub tensor
+        const size_t elementSize = sizeof(ElementType);
+        Internal::WriteMappedFile(filepath, header, reinterpret_cast<const char*>(tensor.GetConstDataPointer()), { tensor.GetSize2(), tensor.GetIncrement2() * elementSize }, { tensor.GetSize1(), tensor.GetIncrement1() * elementSize }, tensor.GetSize0() * elementSize);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -47,6 +47,13 @@ namespace ell
             transpose
         };
 
+        /// <summary> A triangle of a square matrix, including the diagonal. </summary>
+        enum class MatrixTriangle
+        {
+            lower,
+            upper
+        };
+
         template <MatrixLayout>
         struct TransposeMatrixLayout;
 
@@ -93,7 +100,7 @@ namespace ell
                 MatrixBase(const ElementType* pData, size_t numRows, size_t numColumns);
                 MatrixBase(const ElementType* pData, size_t numRows, size_t numColumns, size_t increment);
                 void Swap(MatrixBase<ElementType, MatrixLayout::columnMajor>& other);
-                static constexpr VectorOrientation _intervalOrientation = VectorOrientation::column;
+                static constexpr VectorOrientation _internalOrientation = VectorOrientation::column;
         };
 
         template <typename ElementType>
@@ -124,7 +131,7 @@ namespace ell
                 MatrixBase(const ElementType* pData, size_t numRows, size_t numColumns);
                 MatrixBase(const ElementType* pData, size_t numRows, size_t numColumns, size_t increment);
                 void Swap(MatrixBase<ElementType, MatrixLayout::rowMajor>& other);
-                static constexpr VectorOrientation _intervalOrientation = VectorOrientation::row;
+                static constexpr VectorOrientation _internalOrientation = VectorOrientation::row;
         };
 
         template <typename ElementType, MatrixLayout layout>
@@ -163,7 +170,7 @@ namespace ell
                 
                 auto GetMajorVector(size_t index) const
                 {
-                    return ConstVectorReference<ElementType, MatrixBase<ElementType, layout>::_intervalOrientation>(this->GetMajorVectorBegin(index), this->GetMajorSize(), 1);
+                    return ConstVectorReference<ElementType, MatrixBase<ElementType, layout>::_internalOrientation>(this->GetMajorVectorBegin(index), this->GetMajorSize(), 1);
                 }
                 auto Transpose() const -> ConstMatrixReference<ElementType, TransposeMatrixLayout<layout>::value>;
                 ConstColumnVectorReference<ElementType> ReferenceAsVector() const;
@@ -188,6 +195,13 @@ namespace ell
                 using ConstMatrixReference<ElementType, layout>::IsContigous;
                 void CopyFrom(ConstMatrixReference<ElementType, layout> other);
                 void CopyFrom(ConstMatrixReference<ElementType, TransposeMatrixLayout<layout>::value> other);
+
+                /// <summary> Copies values from a matrix with another element type, see ConvertElements. </summary>
+                ///
+                /// <param name="other"> The other matrix. </param>
+                /// <param name="options"> The conversion options. </param>
+                template <typename OtherElementType, MatrixLayout otherLayout>
+                void CopyFrom(ConstMatrixReference<OtherElementType, otherLayout> other, ConversionOptions options = {});
                 void Swap(MatrixReference<ElementType, layout>& other);
                 void Reset() {Fill(0);}
                 void Fill(ElementType value);
@@ -554,6 +568,29 @@ namespace ell
             }
         }
 
+        template <typename ElementType, MatrixLayout layout>
+        template <typename OtherElementType, MatrixLayout otherLayout>
+        void MatrixReference<ElementType, layout>::CopyFrom(ConstMatrixReference<OtherElementType, otherLayout> other, ConversionOptions options)
+        {
+            if (this->NumRows() != other.NumRows() || this->NumColumns() != other.NumColumns())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Matrix diemensions are not the same");
+            }
+
+            // convert along the major vectors of this matrix, so that the writes are contiguous
+            const bool byRows = layout == MatrixLayout::rowMajor;
+            const size_t numVectors = byRows ? this->NumRows() : this->NumColumns();
+            const size_t size = byRows ? this->NumColumns() : this->NumRows();
+            const size_t vectorIncrement = byRows ? this->GetRowIncrement() : this->GetColumnIncrement();
+            const size_t elementIncrement = byRows ? this->GetColumnIncrement() : this->GetRowIncrement();
+            const size_t otherVectorIncrement = byRows ? other.GetRowIncrement() : other.GetColumnIncrement();
+            const size_t otherElementIncrement = byRows ? other.GetColumnIncrement() : other.GetRowIncrement();
+            for (size_t i = 0; i < numVectors; ++i)
+            {
+                ConvertElements(other.GetConstDataPointer() + i * otherVectorIncrement, otherElementIncrement, GetDataPointer() + i * vectorIncrement, elementIncrement, size, options);
+            }
+        }
+
         template <typename ElementType, MatrixLayout layout>
         void MatrixReference<ElementType, layout>::Swap(MatrixReference<ElementType, layout>& other)
         {
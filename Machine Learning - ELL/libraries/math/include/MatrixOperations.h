@@ -371,12 +371,77 @@ namespace ell
             template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
             static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
         };  
+
+#if USE_BLAS
+        template <>
+        struct MatrixOperations<ImplementationType::openBlas>
+        {
+            static std::string GetImplementationName() { return "Blas"; }
+
+            template <typename ElementType, MatrixLayout layout>
+            static void RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+        };
+#else
+        // without BLAS, the openBlas implementation falls back to the native one
+        template <>
+        struct MatrixOperations<ImplementationType::openBlas> : public MatrixOperations<ImplementationType::native>
+        {};
+#endif
+
+        // cache blocked, packed and multi-threaded products, see GemmKernels.h
+        template <>
+        struct MatrixOperations<ImplementationType::blocked>
+        {
+            static std::string GetImplementationName() { return "Blocked"; }
+
+            template <typename ElementType, MatrixLayout layout>
+            static void RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+        };
+
+        // picks native, blocked or openBlas on every call, from the problem size and the thresholds in ImplementationThresholds.h
+        template <>
+        struct MatrixOperations<ImplementationType::automatic>
+        {
+            static std::string GetImplementationName() { return "Automatic"; }
+
+            template <typename ElementType, MatrixLayout layout>
+            static void RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layout>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+            template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+            static void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+        };
     } 
     }
 }
 
 #pragma region implementation 
 
+#include "GemmKernels.h"
+#include "ImplementationThresholds.h"
 #include "VectorOperations.h"
 #include <utilities/include/Debug.h>
 // #include <ellutilities/include/Exception.h>
@@ -1052,7 +1117,137 @@ namespace ell
                 }
             }
         }
+
+        //
+        // Blocked implementations of operations
+        //
+
+        template <typename ElementType, MatrixLayout layout>
+        StridedMatrixView<ElementType> GetStridedView(ConstMatrixReference<ElementType, layout> matrix)
+        {
+            return { matrix.GetConstDataPointer(), matrix.GetRowIncrement(), matrix.GetColumnIncrement() };
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        MutableStridedMatrixView<ElementType> GetStridedView(MatrixReference<ElementType, layout> matrix)
+        {
+            return { matrix.GetDataPointer(), matrix.GetRowIncrement(), matrix.GetColumnIncrement() };
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::blocked>::RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix)
+        {
+            MatrixOperations<ImplementationType::native>::RankOneUpdate(scalar, vectorA, vectorB, matrix);
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::blocked>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+        {
+            ThreadedGemv(matrix.NumRows(), matrix.NumColumns(), scalarA, GetStridedView(matrix), vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::blocked>::MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+        {
+            MultiplyScaleAddUpdate(scalarA, matrix.Transpose(), vectorA.Transpose(), scalarB, vectorB.Transpose());
+        }
+
+        template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+        void MatrixOperations<ImplementationType::blocked>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+        {
+            BlockedGemm(matrixC.NumRows(), matrixC.NumColumns(), matrixA.NumColumns(), scalarA, GetStridedView(matrixA), GetStridedView(matrixB), scalarC, GetStridedView(matrixC));
+        }
+
+        //
+        // Automatic choice of the implementation
+        //
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::automatic>::RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix)
+        {
+            if (ChooseMatrixVectorImplementation(matrix.NumRows(), matrix.NumColumns()) == ImplementationType::openBlas)
+            {
+                MatrixOperations<ImplementationType::openBlas>::RankOneUpdate(scalar, vectorA, vectorB, matrix);
+            }
+            else
+            {
+                MatrixOperations<ImplementationType::native>::RankOneUpdate(scalar, vectorA, vectorB, matrix);
+            }
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::automatic>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+        {
+            switch (ChooseMatrixVectorImplementation(matrix.NumRows(), matrix.NumColumns()))
+            {
+            case ImplementationType::openBlas:
+                MatrixOperations<ImplementationType::openBlas>::MultiplyScaleAddUpdate(scalarA, matrix, vectorA, scalarB, vectorB);
+                break;
+            case ImplementationType::blocked:
+                MatrixOperations<ImplementationType::blocked>::MultiplyScaleAddUpdate(scalarA, matrix, vectorA, scalarB, vectorB);
+                break;
+            default:
+                MatrixOperations<ImplementationType::native>::MultiplyScaleAddUpdate(scalarA, matrix, vectorA, scalarB, vectorB);
+                break;
+            }
         }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::automatic>::MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+        {
+            MultiplyScaleAddUpdate(scalarA, matrix.Transpose(), vectorA.Transpose(), scalarB, vectorB.Transpose());
+        }
+
+        template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+        void MatrixOperations<ImplementationType::automatic>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+        {
+            switch (ChooseMatrixMatrixImplementation(matrixC.NumRows(), matrixC.NumColumns(), matrixA.NumColumns()))
+            {
+            case ImplementationType::openBlas:
+                MatrixOperations<ImplementationType::openBlas>::MultiplyScaleAddUpdate(scalarA, matrixA, matrixB, scalarC, matrixC);
+                break;
+            case ImplementationType::blocked:
+                MatrixOperations<ImplementationType::blocked>::MultiplyScaleAddUpdate(scalarA, matrixA, matrixB, scalarC, matrixC);
+                break;
+            default:
+                MatrixOperations<ImplementationType::native>::MultiplyScaleAddUpdate(scalarA, matrixA, matrixB, scalarC, matrixC);
+                break;
+            }
+        }
+
+#if USE_BLAS
+        //
+        // OpenBLAS implementations of operations
+        //
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::openBlas>::RankOneUpdate(ElementType scalar, ConstColumnVectorReference<ElementType> vectorA, ConstRowVectorReference<ElementType> vectorB, MatrixReference<ElementType, layout> matrix)
+        {
+            Blas::Ger(layout, static_cast<int>(matrix.NumRows()), static_cast<int>(matrix.NumColumns()), scalar, vectorA.GetConstDataPointer(), static_cast<int>(vectorA.GetIncrement()), vectorB.GetConstDataPointer(), static_cast<int>(vectorB.GetIncrement()), matrix.GetDataPointer(), static_cast<int>(matrix.GetIncrement()));
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::openBlas>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layout> matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+        {
+            Blas::Gemv(layout, MatrixTranspose::noTranspose, static_cast<int>(matrix.NumRows()), static_cast<int>(matrix.NumColumns()), scalarA, matrix.GetConstDataPointer(), static_cast<int>(matrix.GetIncrement()), vectorA.GetConstDataPointer(), static_cast<int>(vectorA.GetIncrement()), scalarB, vectorB.GetDataPointer(), static_cast<int>(vectorB.GetIncrement()));
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void MatrixOperations<ImplementationType::openBlas>::MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, ConstMatrixReference<ElementType, layout> matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+        {
+            MultiplyScaleAddUpdate(scalarA, matrix.Transpose(), vectorA.Transpose(), scalarB, vectorB.Transpose());
+        }
+
+        template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutB, MatrixLayout layoutC>
+        void MatrixOperations<ImplementationType::openBlas>::MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, ConstMatrixReference<ElementType, layoutB> matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+        {
+            // operands stored in the other layout are handed to BLAS as the transpose of a matrix in the layout of the result
+            auto transposeA = layoutA == layoutC ? MatrixTranspose::noTranspose : MatrixTranspose::transpose;
+            auto transposeB = layoutB == layoutC ? MatrixTranspose::noTranspose : MatrixTranspose::transpose;
+            Blas::Gemm(layoutC, transposeA, transposeB, static_cast<int>(matrixC.NumRows()), static_cast<int>(matrixC.NumColumns()), static_cast<int>(matrixA.NumColumns()), scalarA, matrixA.GetConstDataPointer(), static_cast<int>(matrixA.GetIncrement()), matrixB.GetConstDataPointer(), static_cast<int>(matrixB.GetIncrement()), scalarC, matrixC.GetDataPointer(), static_cast<int>(matrixC.GetIncrement()));
+        }
+#endif
+    }
     }
 } // namespace 
 
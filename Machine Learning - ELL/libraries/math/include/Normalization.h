@@ -0,0 +1,542 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/Normalization.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+#include "Tensor.h"
+#include "Vector.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Computes the mean and the variance (normalized by the number of elements) of each row of a matrix, in one
+    /// pass over the data. The elements are read in chunks that stay in the L1 cache; the mean and the sum of
+    /// squared deviations of each chunk are computed exactly and merged into the running statistics with
+    /// Welford's update, so the result does not suffer from the cancellation of the sum-of-squares formula. Rows
+    /// are distributed over the thread pool.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="mean"> The vector used to store the mean of each row. </param>
+    /// <param name="variance"> The vector used to store the variance of each row. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseMeanAndVariance(ConstMatrixReference<ElementType, layout> matrix, ColumnVectorReference<ElementType> mean, ColumnVectorReference<ElementType> variance);
+
+    /// <summary>
+    /// Applies layer normalization to each row of a matrix: x[j] becomes (x[j] - mean) / sqrt(variance + epsilon)
+    /// * scale[j] + bias[j], where the mean and the variance are those of the row. The statistics take one pass
+    /// over the row, as in RowwiseMeanAndVariance, and the normalization, scale and shift take a second one.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="scale"> The scale of each column. </param>
+    /// <param name="bias"> The bias of each column. </param>
+    /// <param name="epsilon"> The value added to the variance. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLayerNormalizationUpdate(MatrixReference<ElementType, layout> matrix, ConstRowVectorReference<ElementType> scale, ConstRowVectorReference<ElementType> bias, ElementType epsilon);
+
+    /// <summary>
+    /// Applies RMS normalization to each row of a matrix: x[j] becomes x[j] / sqrt(mean of squares + epsilon) *
+    /// scale[j], where the mean of squares is that of the row. Each row is read twice.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="scale"> The scale of each column. </param>
+    /// <param name="epsilon"> The value added to the mean of squares. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseRMSNormalizationUpdate(MatrixReference<ElementType, layout> matrix, ConstRowVectorReference<ElementType> scale, ElementType epsilon);
+
+    /// <summary>
+    /// Computes the mean and the variance (normalized by the number of elements) of each channel of a tensor, over
+    /// its rows and columns, in one pass as in RowwiseMeanAndVariance. These are the batch normalization statistics.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Tensor and vector element type, float or double. </typeparam>
+    /// <typeparam name="dimension0"> Tensor first dimension. </typeparam>
+    /// <typeparam name="dimension1"> Tensor second dimension. </typeparam>
+    /// <typeparam name="dimension2"> Tensor third dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="mean"> The vector used to store the mean of each channel. </param>
+    /// <param name="variance"> The vector used to store the variance of each channel. </param>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ChannelwiseMeanAndVariance(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, RowVectorReference<ElementType> mean, RowVectorReference<ElementType> variance);
+
+    /// <summary>
+    /// Applies batch normalization inference to each channel of a tensor: x becomes (x - mean[k]) /
+    /// sqrt(variance[k] + epsilon) * scale[k] + bias[k] in channel k. The variance and the scale are folded into
+    /// one factor per channel, and the tensor is read and written once.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Tensor and vector element type, float or double. </typeparam>
+    /// <typeparam name="dimension0"> Tensor first dimension. </typeparam>
+    /// <typeparam name="dimension1"> Tensor second dimension. </typeparam>
+    /// <typeparam name="dimension2"> Tensor third dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="mean"> The mean of each channel. </param>
+    /// <param name="variance"> The variance of each channel. </param>
+    /// <param name="scale"> The scale of each channel. </param>
+    /// <param name="bias"> The bias of each channel. </param>
+    /// <param name="epsilon"> The value added to the variance. </param>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void BatchNormalizationUpdate(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, ConstRowVectorReference<ElementType> mean, ConstRowVectorReference<ElementType> variance, ConstRowVectorReference<ElementType> scale, ConstRowVectorReference<ElementType> bias, ElementType epsilon);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        enum class NormalizationType
+        {
+            layer,
+            rms
+        };
+
+        // the elements are summarized in chunks of this size, which stay in the L1 cache between the passes over them
+        constexpr size_t normalizationChunkSize = 256;
+
+        // the sum of transform(x) over a contiguous array, in independent partial sums that the compiler keeps in one
+        // vector register
+        template <typename ElementType, typename TransformationType>
+        ElementType SumTransformed(const ElementType* pData, size_t size, TransformationType transformation)
+        {
+            constexpr size_t lanes = 8;
+            ElementType partial[lanes] = {};
+            size_t fullSize = size - size % lanes;
+            for (size_t i = 0; i < fullSize; i += lanes)
+            {
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    partial[l] += transformation(pData[i + l]);
+                }
+            }
+            for (size_t i = fullSize; i < size; ++i)
+            {
+                partial[i - fullSize] += transformation(pData[i]);
+            }
+            ElementType sum = 0;
+            for (size_t l = 0; l < lanes; ++l)
+            {
+                sum += partial[l];
+            }
+            return sum;
+        }
+
+        // the number of elements, their mean and the sum of their squared deviations from the mean
+        template <typename ElementType>
+        struct MomentStatistics
+        {
+            size_t count = 0;
+            ElementType mean = 0;
+            ElementType sumOfSquares = 0;
+
+            // Welford's update, for a set of otherCount elements at once (Chan, Golub and LeVeque)
+            void Merge(size_t otherCount, ElementType otherMean, ElementType otherSumOfSquares)
+            {
+                if (otherCount == 0)
+                {
+                    return;
+                }
+                size_t total = count + otherCount;
+                ElementType delta = otherMean - mean;
+                ElementType otherWeight = static_cast<ElementType>(otherCount) / static_cast<ElementType>(total);
+                mean += delta * otherWeight;
+                sumOfSquares += otherSumOfSquares + delta * delta * static_cast<ElementType>(count) * otherWeight;
+                count = total;
+            }
+
+            ElementType Variance() const { return count == 0 ? 0 : sumOfSquares / static_cast<ElementType>(count); }
+        };
+
+        template <typename ElementType>
+        void AccumulateMoments(const ElementType* pData, size_t size, MomentStatistics<ElementType>& statistics)
+        {
+            for (size_t begin = 0; begin < size; begin += normalizationChunkSize)
+            {
+                size_t count = std::min(normalizationChunkSize, size - begin);
+                const ElementType* pChunk = pData + begin;
+                ElementType chunkMean = SumTransformed(pChunk, count, [](ElementType x) { return x; }) / static_cast<ElementType>(count);
+                ElementType chunkSumOfSquares = SumTransformed(pChunk, count, [chunkMean](ElementType x) { return (x - chunkMean) * (x - chunkMean); });
+                statistics.Merge(count, chunkMean, chunkSumOfSquares);
+            }
+        }
+
+        // the moments of the lanes [0, numLanes), where lane j holds the elements pData[i * increment + j] for i in
+        // [0, size), merged into count, pMean and pSumOfSquares; rows are processed in blocks that stay in the cache
+        // between the two passes over them, and the work runs across lanes
+        template <typename ElementType>
+        void AccumulateLaneMoments(const ElementType* pData, size_t size, size_t numLanes, size_t increment, size_t& count, ElementType* pMean, ElementType* pSumOfSquares, ElementType* pScratch)
+        {
+            const size_t blockSize = std::max<size_t>(1, normalizationChunkSize * 16 / std::max<size_t>(numLanes, 1));
+            ElementType* pBlockMean = pScratch;
+            ElementType* pBlockSumOfSquares = pScratch + numLanes;
+            for (size_t blockBegin = 0; blockBegin < size; blockBegin += blockSize)
+            {
+                size_t blockEnd = std::min(size, blockBegin + blockSize);
+                size_t blockCount = blockEnd - blockBegin;
+
+                std::fill(pBlockMean, pBlockMean + 2 * numLanes, ElementType{ 0 });
+                for (size_t i = blockBegin; i < blockEnd; ++i)
+                {
+                    const ElementType* pRow = pData + i * increment;
+                    for (size_t j = 0; j < numLanes; ++j)
+                    {
+                        pBlockMean[j] += pRow[j];
+                    }
+                }
+                ElementType inverseCount = 1 / static_cast<ElementType>(blockCount);
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    pBlockMean[j] *= inverseCount;
+                }
+                for (size_t i = blockBegin; i < blockEnd; ++i)
+                {
+                    const ElementType* pRow = pData + i * increment;
+                    for (size_t j = 0; j < numLanes; ++j)
+                    {
+                        ElementType deviation = pRow[j] - pBlockMean[j];
+                        pBlockSumOfSquares[j] += deviation * deviation;
+                    }
+                }
+
+                // the Merge of MomentStatistics, for every lane
+                size_t total = count + blockCount;
+                ElementType blockWeight = static_cast<ElementType>(blockCount) / static_cast<ElementType>(total);
+                ElementType mergeWeight = static_cast<ElementType>(count) * blockWeight;
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    ElementType delta = pBlockMean[j] - pMean[j];
+                    pMean[j] += delta * blockWeight;
+                    pSumOfSquares[j] += pBlockSumOfSquares[j] + delta * delta * mergeWeight;
+                }
+                count = total;
+            }
+        }
+
+        // adds the sum of squares of each lane, with lanes as in AccumulateLaneMoments, to pSumOfSquares
+        template <typename ElementType>
+        void AccumulateLaneSquares(const ElementType* pData, size_t size, size_t numLanes, size_t increment, ElementType* pSumOfSquares)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                const ElementType* pRow = pData + i * increment;
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    pSumOfSquares[j] += pRow[j] * pRow[j];
+                }
+            }
+        }
+
+        // the value subtracted from the elements of a vector and the factor they are then multiplied with
+        template <typename ElementType>
+        struct NormalizationShift
+        {
+            ElementType shift;
+            ElementType factor;
+        };
+
+        template <typename ElementType>
+        NormalizationShift<ElementType> GetNormalizationShift(NormalizationType type, const ElementType* pData, size_t size, ElementType epsilon)
+        {
+            if (type == NormalizationType::rms)
+            {
+                ElementType sumOfSquares = SumTransformed(pData, size, [](ElementType x) { return x * x; });
+                ElementType meanOfSquares = size == 0 ? 0 : sumOfSquares / static_cast<ElementType>(size);
+                return { 0, 1 / std::sqrt(meanOfSquares + epsilon) };
+            }
+
+            MomentStatistics<ElementType> statistics;
+            AccumulateMoments(pData, size, statistics);
+            return { statistics.mean, 1 / std::sqrt(statistics.Variance() + epsilon) };
+        }
+
+        // normalizes numVectors contiguous vectors of the given size, which start increment elements apart; pBias is
+        // null for RMS normalization
+        template <typename ElementType>
+        void NormalizeContiguousVectors(NormalizationType type, ElementType* pData, size_t size, size_t numVectors, size_t increment, const ElementType* pScale, const ElementType* pBias, ElementType epsilon)
+        {
+            size_t grainSize = size == 0 ? numVectors : (minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    ElementType* pVector = pData + index * increment;
+                    auto normalization = GetNormalizationShift(type, pVector, size, epsilon);
+                    if (pBias == nullptr)
+                    {
+                        for (size_t j = 0; j < size; ++j)
+                        {
+                            pVector[j] = pVector[j] * normalization.factor * pScale[j];
+                        }
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < size; ++j)
+                        {
+                            pVector[j] = (pVector[j] - normalization.shift) * normalization.factor * pScale[j] + pBias[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        // normalizes the lanes of the given size, whose elements are increment apart and whose first elements are
+        // adjacent; element i of every lane is scaled by pScale[i] and shifted by pBias[i]
+        template <typename ElementType>
+        void NormalizeStridedVectors(NormalizationType type, ElementType* pData, size_t size, size_t numLanes, size_t increment, const ElementType* pScale, const ElementType* pBias, ElementType epsilon)
+        {
+            size_t grainSize = size == 0 ? numLanes : std::max<size_t>((minElementsPerTask + size - 1) / size, 16);
+            utilities::ParallelFor(numLanes, grainSize, [&](size_t begin, size_t end) {
+                size_t count = end - begin;
+                std::vector<ElementType> shift(count);
+                std::vector<ElementType> factor(count);
+                if (type == NormalizationType::rms)
+                {
+                    AccumulateLaneSquares(pData + begin, size, count, increment, factor.data());
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        factor[j] = 1 / std::sqrt((size == 0 ? 0 : factor[j] / static_cast<ElementType>(size)) + epsilon);
+                    }
+                }
+                else
+                {
+                    size_t statisticsCount = 0;
+                    std::vector<ElementType> scratch(2 * count);
+                    AccumulateLaneMoments(pData + begin, size, count, increment, statisticsCount, shift.data(), factor.data(), scratch.data());
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        factor[j] = 1 / std::sqrt((size == 0 ? 0 : factor[j] / static_cast<ElementType>(size)) + epsilon);
+                    }
+                }
+
+                for (size_t i = 0; i < size; ++i)
+                {
+                    ElementType* pRow = pData + i * increment + begin;
+                    ElementType scale = pScale[i];
+                    ElementType bias = pBias == nullptr ? 0 : pBias[i];
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        pRow[j] = (pRow[j] - shift[j]) * factor[j] * scale + bias;
+                    }
+                }
+            });
+        }
+
+        // the matrix is viewed as GetMinorSize() contiguous vectors of GetMajorSize() elements, as in SoftmaxMatrix
+        template <typename ElementType, MatrixLayout layout>
+        void NormalizeMatrixRows(NormalizationType type, MatrixReference<ElementType, layout> matrix, ConstRowVectorReference<ElementType> scale, const ElementType* pBias, ElementType epsilon)
+        {
+            auto scaleArray = scale.ToArray();
+            ElementType* pData = matrix.GetDataPointer();
+            if (layout == MatrixLayout::rowMajor)
+            {
+                NormalizeContiguousVectors(type, pData, matrix.GetMajorSize(), matrix.GetMinorSize(), matrix.GetIncrement(), scaleArray.data(), pBias, epsilon);
+            }
+            else
+            {
+                NormalizeStridedVectors(type, pData, matrix.GetMinorSize(), matrix.GetMajorSize(), matrix.GetIncrement(), scaleArray.data(), pBias, epsilon);
+            }
+        }
+
+        // the position of the channel dimension in the memory order of a tensor
+        template <Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        constexpr size_t GetChannelPosition()
+        {
+            return dimension0 == Dimension::channel ? 0 : (dimension1 == Dimension::channel ? 1 : 2);
+        }
+    } // namespace Internal
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseMeanAndVariance(ConstMatrixReference<ElementType, layout> matrix, ColumnVectorReference<ElementType> mean, ColumnVectorReference<ElementType> variance)
+    {
+        DEBUG_CHECK_SIZES(mean.Size() != matrix.NumRows() || variance.Size() != matrix.NumRows(), "Incompatible matrix vector sizes.");
+
+        const ElementType* pData = matrix.GetConstDataPointer();
+        if (layout == MatrixLayout::rowMajor)
+        {
+            size_t size = matrix.NumColumns();
+            size_t grainSize = size == 0 ? matrix.NumRows() : (Internal::minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(matrix.NumRows(), grainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    Internal::MomentStatistics<ElementType> statistics;
+                    Internal::AccumulateMoments(pData + i * matrix.GetIncrement(), size, statistics);
+                    mean[i] = statistics.mean;
+                    variance[i] = statistics.Variance();
+                }
+            });
+            return;
+        }
+
+        size_t size = matrix.NumColumns();
+        size_t grainSize = size == 0 ? matrix.NumRows() : std::max<size_t>((Internal::minElementsPerTask + size - 1) / size, 16);
+        utilities::ParallelFor(matrix.NumRows(), grainSize, [&](size_t begin, size_t end) {
+            size_t count = end - begin;
+            size_t statisticsCount = 0;
+            std::vector<ElementType> laneMean(count);
+            std::vector<ElementType> laneSumOfSquares(count);
+            std::vector<ElementType> scratch(2 * count);
+            Internal::AccumulateLaneMoments(pData + begin, size, count, matrix.GetIncrement(), statisticsCount, laneMean.data(), laneSumOfSquares.data(), scratch.data());
+            for (size_t j = 0; j < count; ++j)
+            {
+                mean[begin + j] = laneMean[j];
+                variance[begin + j] = size == 0 ? 0 : laneSumOfSquares[j] / static_cast<ElementType>(size);
+            }
+        });
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLayerNormalizationUpdate(MatrixReference<ElementType, layout> matrix, ConstRowVectorReference<ElementType> scale, ConstRowVectorReference<ElementType> bias, ElementType epsilon)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != matrix.NumColumns() || bias.Size() != matrix.NumColumns(), "Incompatible matrix vector sizes.");
+
+        auto biasArray = bias.ToArray();
+        Internal::NormalizeMatrixRows(Internal::NormalizationType::layer, matrix, scale, biasArray.data(), epsilon);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseRMSNormalizationUpdate(MatrixReference<ElementType, layout> matrix, ConstRowVectorReference<ElementType> scale, ElementType epsilon)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != matrix.NumColumns(), "Incompatible matrix vector sizes.");
+
+        Internal::NormalizeMatrixRows(Internal::NormalizationType::rms, matrix, scale, static_cast<const ElementType*>(nullptr), epsilon);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ChannelwiseMeanAndVariance(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, RowVectorReference<ElementType> mean, RowVectorReference<ElementType> variance)
+    {
+        DEBUG_CHECK_SIZES(mean.Size() != tensor.NumChannels() || variance.Size() != tensor.NumChannels(), "Incompatible tensor vector sizes.");
+
+        const size_t channelPosition = Internal::GetChannelPosition<dimension0, dimension1, dimension2>();
+        const ElementType* pData = tensor.GetConstDataPointer();
+        const size_t size0 = tensor.GetSize0();
+        const size_t size1 = tensor.GetSize1();
+        const size_t size2 = tensor.GetSize2();
+        const size_t increment1 = tensor.GetIncrement1();
+        const size_t increment2 = tensor.GetIncrement2();
+        const size_t count = size1 * size2;
+
+        if (channelPosition == 0)
+        {
+            // the channels are the contiguous lanes of size1 x size2 vectors
+            size_t grainSize = count == 0 ? size0 : std::max<size_t>((Internal::minElementsPerTask + count - 1) / count, 16);
+            utilities::ParallelFor(size0, grainSize, [&](size_t begin, size_t end) {
+                size_t numLanes = end - begin;
+                size_t statisticsCount = 0;
+                std::vector<ElementType> laneMean(numLanes);
+                std::vector<ElementType> laneSumOfSquares(numLanes);
+                std::vector<ElementType> scratch(2 * numLanes);
+                for (size_t k = 0; k < size2; ++k)
+                {
+                    Internal::AccumulateLaneMoments(pData + k * increment2 + begin, size1, numLanes, increment1, statisticsCount, laneMean.data(), laneSumOfSquares.data(), scratch.data());
+                }
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    mean[begin + j] = laneMean[j];
+                    variance[begin + j] = count == 0 ? 0 : laneSumOfSquares[j] / static_cast<ElementType>(count);
+                }
+            });
+            return;
+        }
+
+        // each channel is a set of contiguous vectors along dimension0
+        const size_t channelIncrement = channelPosition == 1 ? increment1 : increment2;
+        const size_t numVectors = channelPosition == 1 ? size2 : size1;
+        const size_t vectorIncrement = channelPosition == 1 ? increment2 : increment1;
+        const size_t channelSize = size0 * numVectors;
+        size_t grainSize = channelSize == 0 ? tensor.NumChannels() : (Internal::minElementsPerTask + channelSize - 1) / channelSize;
+        utilities::ParallelFor(tensor.NumChannels(), grainSize, [&](size_t begin, size_t end) {
+            for (size_t channel = begin; channel < end; ++channel)
+            {
+                Internal::MomentStatistics<ElementType> statistics;
+                for (size_t i = 0; i < numVectors; ++i)
+                {
+                    Internal::AccumulateMoments(pData + channel * channelIncrement + i * vectorIncrement, size0, statistics);
+                }
+                mean[channel] = statistics.mean;
+                variance[channel] = statistics.Variance();
+            }
+        });
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void BatchNormalizationUpdate(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, ConstRowVectorReference<ElementType> mean, ConstRowVectorReference<ElementType> variance, ConstRowVectorReference<ElementType> scale, ConstRowVectorReference<ElementType> bias, ElementType epsilon)
+    {
+        const size_t numChannels = tensor.NumChannels();
+        DEBUG_CHECK_SIZES(mean.Size() != numChannels || variance.Size() != numChannels || scale.Size() != numChannels || bias.Size() != numChannels, "Incompatible tensor vector sizes.");
+
+        // x becomes (x - shift[k]) * factor[k] + offset[k]; folding the mean into the offset would save one
+        // subtraction, but cancels in float when the mean is large compared to the deviation
+        auto shift = mean.ToArray();
+        auto offset = bias.ToArray();
+        std::vector<ElementType> factor(numChannels);
+        for (size_t k = 0; k < numChannels; ++k)
+        {
+            factor[k] = scale[k] / std::sqrt(variance[k] + epsilon);
+        }
+
+        const size_t channelPosition = Internal::GetChannelPosition<dimension0, dimension1, dimension2>();
+        ElementType* pData = tensor.GetDataPointer();
+        const size_t size0 = tensor.GetSize0();
+        const size_t size1 = tensor.GetSize1();
+        const size_t increment1 = tensor.GetIncrement1();
+        const size_t increment2 = tensor.GetIncrement2();
+        const size_t numVectors = size1 * tensor.GetSize2();
+        size_t grainSize = size0 == 0 ? numVectors : (Internal::minElementsPerTask + size0 - 1) / size0;
+        utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index)
+            {
+                size_t i = index % size1;
+                size_t j = index / size1;
+                ElementType* pVector = pData + i * increment1 + j * increment2;
+                if (channelPosition == 0)
+                {
+                    for (size_t k = 0; k < size0; ++k)
+                    {
+                        pVector[k] = (pVector[k] - shift[k]) * factor[k] + offset[k];
+                    }
+                }
+                else
+                {
+                    size_t channel = channelPosition == 1 ? i : j;
+                    ElementType vectorShift = shift[channel];
+                    ElementType vectorFactor = factor[channel];
+                    ElementType vectorOffset = offset[channel];
+                    for (size_t k = 0; k < size0; ++k)
+                    {
+                        pVector[k] = (pVector[k] - vectorShift) * vectorFactor + vectorOffset;
+                    }
+                }
+            }
+        });
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,427 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/PackedMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "GemmKernels.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> How the elements of a PackedMatrix are stored. </summary>
+    enum class PackedMatrixQuantization
+    {
+        none, // the elements are stored unchanged
+        int8 // each column is stored as signed 8 bit integers times a per column scale
+    };
+
+    /// <summary>
+    /// A matrix stored once in the panel format of the blocked matrix multiplication micro-kernel, so that
+    /// products with it skip the packing step. Meant for operands that are reused many times, such as the
+    /// weights of a model: the packed matrix is the right operand of matrix-matrix products and either operand
+    /// of matrix-vector products.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class PackedMatrix
+    {
+    public:
+        /// <summary> Packs a matrix, or its transpose. </summary>
+        ///
+        /// <param name="matrix"> The matrix to pack, it is copied and not referenced afterwards. </param>
+        /// <param name="transpose"> Whether to pack the transpose of the matrix. </param>
+        /// <param name="quantization"> How to store the elements. </param>
+        template <MatrixLayout layout>
+        PackedMatrix(ConstMatrixReference<ElementType, layout> matrix, MatrixTranspose transpose = MatrixTranspose::noTranspose, PackedMatrixQuantization quantization = PackedMatrixQuantization::none);
+
+        /// <summary> Gets the number of rows of the packed matrix (after the optional transpose). </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns of the packed matrix (after the optional transpose). </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets how the elements are stored. </summary>
+        ///
+        /// <returns> The quantization. </returns>
+        PackedMatrixQuantization GetQuantization() const { return _quantization; }
+
+        /// <summary> Gets an element, as used by the products (that is, after quantization). </summary>
+        ///
+        /// <param name="row"> The row index. </param>
+        /// <param name="column"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column) const;
+
+        /// <summary> Gets the number of columns rounded up to a whole number of panels. </summary>
+        ///
+        /// <returns> The padded number of columns. </returns>
+        size_t GetPaddedColumns() const { return _paddedColumns; }
+
+        /// <summary> Gets the packed elements, when the matrix is not quantized. </summary>
+        ///
+        /// <returns> Pointer to the packed elements, in the layout expected by Internal::BlockedGemmPrepacked. </returns>
+        const ElementType* GetPackedData() const { return _packed.data(); }
+
+        /// <summary> Gets the packed quantized elements, when the matrix is quantized. </summary>
+        ///
+        /// <returns> Pointer to the packed elements, in the same layout as GetPackedData. </returns>
+        const int8_t* GetQuantizedData() const { return _quantized.data(); }
+
+        /// <summary> Gets the scale of each column of a quantized matrix, padded to GetPaddedColumns. </summary>
+        ///
+        /// <returns> Pointer to the scales. </returns>
+        const ElementType* GetColumnScales() const { return _scales.data(); }
+
+    private:
+        // the packed elements are split in blocks of depthPerBlock rows, the block that starts at row k0 begins
+        // at k0 * paddedColumns and holds panels of columnsPerTile columns, each blockDepth * columnsPerTile long
+        size_t GetPackedIndex(size_t row, size_t column) const;
+
+        size_t _numRows;
+        size_t _numColumns;
+        size_t _paddedColumns;
+        PackedMatrixQuantization _quantization;
+        std::vector<ElementType> _packed;
+        std::vector<int8_t> _quantized;
+        std::vector<ElementType> _scales;
+    };
+
+    /// <summary> Multiplies a matrix by a packed matrix, matrixC = scalarA * matrixA * matrixB + scalarC * matrixC. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrixA"> The left matrix. </param>
+    /// <param name="matrixB"> The packed right matrix. </param>
+    /// <param name="scalarC"> The scalar that multiplies matrixC, when zero matrixC is not read. </param>
+    /// <param name="matrixC"> The result matrix. </param>
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, const PackedMatrix<ElementType>& matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC);
+
+    /// <summary> Multiplies a packed matrix by a column vector, vectorB = scalarA * matrix * vectorA + scalarB * vectorB. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrix"> The packed matrix. </param>
+    /// <param name="vectorA"> The column vector. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const PackedMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+    /// <summary> Multiplies a row vector by a packed matrix, vectorB = scalarA * vectorA * matrix + scalarB * vectorB. </summary>
+    ///
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="vectorA"> The row vector. </param>
+    /// <param name="matrix"> The packed matrix. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const PackedMatrix<ElementType>& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // converts one block of quantized panels back to the element type, with the column scales applied
+        template <typename ElementType>
+        void DequantizePackedBlock(const int8_t* pQuantized, const ElementType* pScales, size_t blockDepth, size_t paddedColumns, ElementType* pOutput)
+        {
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            size_t numPanels = paddedColumns / NR;
+            utilities::ParallelFor(numPanels, std::max<size_t>(1, minElementsPerTask / (blockDepth * NR)), [&](size_t begin, size_t end) {
+                for (size_t panel = begin; panel < end; ++panel)
+                {
+                    const ElementType* pPanelScales = pScales + panel * NR;
+                    const int8_t* pIn = pQuantized + panel * blockDepth * NR;
+                    ElementType* pOut = pOutput + panel * blockDepth * NR;
+                    for (size_t k = 0; k < blockDepth; ++k)
+                    {
+                        for (size_t j = 0; j < NR; ++j)
+                        {
+                            pOut[k * NR + j] = static_cast<ElementType>(pIn[k * NR + j]) * pPanelScales[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        // y = alpha * P * x + beta * y, the rows of P are split across the threads a depth block at a time
+        template <typename ElementType, typename PackedType>
+        void PackedGemv(size_t numRows, size_t numColumns, size_t paddedColumns, ElementType alpha, const PackedType* pPacked, const ElementType* pScales, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement)
+        {
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            constexpr size_t KC = GemmBlocking<ElementType>::depthPerBlock;
+
+            // x is padded with zeros to whole panels, and folded with the column scales of a quantized matrix
+            std::vector<ElementType> paddedX(paddedColumns, 0);
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                paddedX[j] = pScales == nullptr ? pX[j * xIncrement] : pX[j * xIncrement] * pScales[j];
+            }
+
+            size_t numPanels = paddedColumns / NR;
+            size_t numBlocks = (numRows + KC - 1) / KC;
+            utilities::ParallelFor(numBlocks, std::max<size_t>(1, minElementsPerTask / std::max<size_t>(KC * paddedColumns, 1)), [&](size_t begin, size_t end) {
+                ElementType sums[KC];
+                for (size_t block = begin; block < end; ++block)
+                {
+                    size_t firstRow = block * KC;
+                    size_t blockDepth = std::min(KC, numRows - firstRow);
+                    const PackedType* pBlock = pPacked + firstRow * paddedColumns;
+                    std::fill(sums, sums + blockDepth, ElementType{ 0 });
+                    for (size_t panel = 0; panel < numPanels; ++panel)
+                    {
+                        const PackedType* pPanel = pBlock + panel * blockDepth * NR;
+                        const ElementType* pPanelX = paddedX.data() + panel * NR;
+                        for (size_t k = 0; k < blockDepth; ++k)
+                        {
+                            ElementType sum = 0;
+                            for (size_t j = 0; j < NR; ++j)
+                            {
+                                sum += static_cast<ElementType>(pPanel[k * NR + j]) * pPanelX[j];
+                            }
+                            sums[k] += sum;
+                        }
+                    }
+                    for (size_t k = 0; k < blockDepth; ++k)
+                    {
+                        ElementType& y = pY[(firstRow + k) * yIncrement];
+                        y = beta == 0 ? alpha * sums[k] : alpha * sums[k] + beta * y;
+                    }
+                }
+            });
+        }
+
+        // y = alpha * x * P + beta * y, the panels of P are split across the threads
+        template <typename ElementType, typename PackedType>
+        void PackedGevm(size_t numRows, size_t numColumns, size_t paddedColumns, ElementType alpha, const PackedType* pPacked, const ElementType* pScales, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement)
+        {
+            constexpr size_t NR = GemmBlocking<ElementType>::columnsPerTile;
+            constexpr size_t KC = GemmBlocking<ElementType>::depthPerBlock;
+
+            std::vector<ElementType> contiguousX;
+            if (xIncrement != 1)
+            {
+                contiguousX.resize(numRows);
+                for (size_t k = 0; k < numRows; ++k)
+                {
+                    contiguousX[k] = pX[k * xIncrement];
+                }
+                pX = contiguousX.data();
+            }
+
+            size_t numPanels = paddedColumns / NR;
+            utilities::ParallelFor(numPanels, std::max<size_t>(1, minElementsPerTask / std::max<size_t>(numRows * NR, 1)), [&](size_t begin, size_t end) {
+                for (size_t panel = begin; panel < end; ++panel)
+                {
+                    ElementType sums[NR] = {};
+                    for (size_t firstRow = 0; firstRow < numRows; firstRow += KC)
+                    {
+                        size_t blockDepth = std::min(KC, numRows - firstRow);
+                        const PackedType* pPanel = pPacked + firstRow * paddedColumns + panel * blockDepth * NR;
+                        for (size_t k = 0; k < blockDepth; ++k)
+                        {
+                            ElementType x = pX[firstRow + k];
+                            for (size_t j = 0; j < NR; ++j)
+                            {
+                                sums[j] += static_cast<ElementType>(pPanel[k * NR + j]) * x;
+                            }
+                        }
+                    }
+
+                    size_t panelColumns = std::min(NR, numColumns - panel * NR);
+                    for (size_t j = 0; j < panelColumns; ++j)
+                    {
+                        size_t column = panel * NR + j;
+                        ElementType sum = pScales == nullptr ? sums[j] : sums[j] * pScales[column];
+                        ElementType& y = pY[column * yIncrement];
+                        y = beta == 0 ? alpha * sum : alpha * sum + beta * y;
+                    }
+                }
+            });
+        }
+    } // namespace Internal
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    PackedMatrix<ElementType>::PackedMatrix(ConstMatrixReference<ElementType, layout> matrix, MatrixTranspose transpose, PackedMatrixQuantization quantization) :
+        _quantization(quantization)
+    {
+        using Blocking = Internal::GemmBlocking<ElementType>;
+        constexpr size_t NR = Blocking::columnsPerTile;
+        constexpr size_t KC = Blocking::depthPerBlock;
+
+        Internal::StridedMatrixView<ElementType> view{ matrix.GetConstDataPointer(), matrix.GetRowIncrement(), matrix.GetColumnIncrement() };
+        _numRows = matrix.NumRows();
+        _numColumns = matrix.NumColumns();
+        if (transpose == MatrixTranspose::transpose)
+        {
+            std::swap(view.rowIncrement, view.columnIncrement);
+            std::swap(_numRows, _numColumns);
+        }
+        _paddedColumns = (_numColumns + NR - 1) / NR * NR;
+
+        _packed.resize(_numRows * _paddedColumns);
+        size_t numBlocks = (_numRows + KC - 1) / KC;
+        utilities::ParallelFor(numBlocks, 1, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
+            {
+                size_t firstRow = block * KC;
+                size_t blockDepth = std::min(KC, _numRows - firstRow);
+                Internal::PackGemmPanels(view, firstRow, 0, blockDepth, _numColumns, _packed.data() + firstRow * _paddedColumns);
+            }
+        });
+
+        if (quantization == PackedMatrixQuantization::int8)
+        {
+            // symmetric quantization with one scale per column, so that the largest magnitude maps to 127
+            _scales.assign(_paddedColumns, 1);
+            for (size_t j = 0; j < _numColumns; ++j)
+            {
+                ElementType maximum = 0;
+                for (size_t i = 0; i < _numRows; ++i)
+                {
+                    maximum = std::max(maximum, std::abs(view(i, j)));
+                }
+                if (maximum > 0)
+                {
+                    _scales[j] = maximum / 127;
+                }
+            }
+
+            _quantized.resize(_packed.size());
+            for (size_t index = 0; index < _packed.size(); ++index)
+            {
+                // the column of a packed element is its panel times the panel width plus its position in the row
+                size_t firstRow = index / (_paddedColumns * KC) * KC;
+                size_t blockDepth = std::min(KC, _numRows - firstRow);
+                size_t offset = index - firstRow * _paddedColumns;
+                size_t column = offset / (blockDepth * NR) * NR + offset % NR;
+                auto value = std::round(_packed[index] / _scales[column]);
+                _quantized[index] = static_cast<int8_t>(std::max<ElementType>(-127, std::min<ElementType>(127, value)));
+            }
+            _packed.clear();
+            _packed.shrink_to_fit();
+        }
+    }
+
+    template <typename ElementType>
+    size_t PackedMatrix<ElementType>::GetPackedIndex(size_t row, size_t column) const
+    {
+        constexpr size_t NR = Internal::GemmBlocking<ElementType>::columnsPerTile;
+        constexpr size_t KC = Internal::GemmBlocking<ElementType>::depthPerBlock;
+        size_t firstRow = row / KC * KC;
+        size_t blockDepth = std::min(KC, _numRows - firstRow);
+        return firstRow * _paddedColumns + column / NR * blockDepth * NR + (row - firstRow) * NR + column % NR;
+    }
+
+    template <typename ElementType>
+    ElementType PackedMatrix<ElementType>::operator()(size_t row, size_t column) const
+    {
+        DEBUG_THROW(row >= _numRows || column >= _numColumns, utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "index exceeds packed matrix size."));
+
+        if (_quantization == PackedMatrixQuantization::int8)
+        {
+            return static_cast<ElementType>(_quantized[GetPackedIndex(row, column)]) * _scales[column];
+        }
+        return _packed[GetPackedIndex(row, column)];
+    }
+
+    template <typename ElementType, MatrixLayout layoutA, MatrixLayout layoutC>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstMatrixReference<ElementType, layoutA> matrixA, const PackedMatrix<ElementType>& matrixB, ElementType scalarC, MatrixReference<ElementType, layoutC> matrixC)
+    {
+        DEBUG_CHECK_SIZES(matrixA.NumColumns() != matrixB.NumRows() || matrixA.NumRows() != matrixC.NumRows() || matrixB.NumColumns() != matrixC.NumColumns(), "Incompatible matrix sizes.");
+
+        Internal::StridedMatrixView<ElementType> viewA{ matrixA.GetConstDataPointer(), matrixA.GetRowIncrement(), matrixA.GetColumnIncrement() };
+        Internal::MutableStridedMatrixView<ElementType> viewC{ matrixC.GetDataPointer(), matrixC.GetRowIncrement(), matrixC.GetColumnIncrement() };
+        size_t depth = matrixB.NumRows();
+        if (depth == 0 || matrixC.NumRows() == 0 || matrixC.NumColumns() == 0)
+        {
+            // an empty batch or an empty matrix leaves no blocks to split the work into
+            Internal::ScaleStrided(matrixC.NumRows(), matrixC.NumColumns(), scalarC, viewC);
+            return;
+        }
+
+        if (matrixB.GetQuantization() == PackedMatrixQuantization::none)
+        {
+            Internal::BlockedGemmPrepacked(matrixC.NumRows(), matrixC.NumColumns(), depth, scalarA, viewA, matrixB.GetPackedData(), scalarC, viewC);
+            return;
+        }
+
+        // a quantized matrix is expanded one depth block at a time, which reads a quarter of the memory of a
+        // float matrix and stays in cache for the micro-kernels
+        constexpr size_t KC = Internal::GemmBlocking<ElementType>::depthPerBlock;
+
+        size_t paddedColumns = matrixB.GetPaddedColumns();
+        std::vector<ElementType> block(std::min(KC, depth) * paddedColumns);
+        for (size_t firstRow = 0; firstRow < depth; firstRow += KC)
+        {
+            size_t blockDepth = std::min(KC, depth - firstRow);
+            size_t offset = firstRow * paddedColumns;
+            Internal::DequantizePackedBlock(matrixB.GetQuantizedData() + offset, matrixB.GetColumnScales(), blockDepth, paddedColumns, block.data());
+            Internal::MultiplyPackedBlock(matrixC.NumRows(), matrixC.NumColumns(), firstRow, blockDepth, scalarA, viewA, block.data(), scalarC, viewC, 0);
+        }
+    }
+
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const PackedMatrix<ElementType>& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumColumns() != vectorA.Size() || matrix.NumRows() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        if (matrix.GetQuantization() == PackedMatrixQuantization::none)
+        {
+            Internal::PackedGemv(matrix.NumRows(), matrix.NumColumns(), matrix.GetPaddedColumns(), scalarA, matrix.GetPackedData(), static_cast<const ElementType*>(nullptr), vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+        }
+        else
+        {
+            Internal::PackedGemv(matrix.NumRows(), matrix.NumColumns(), matrix.GetPaddedColumns(), scalarA, matrix.GetQuantizedData(), matrix.GetColumnScales(), vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+        }
+    }
+
+    template <typename ElementType>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const PackedMatrix<ElementType>& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vectorA.Size() || matrix.NumColumns() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        if (matrix.GetQuantization() == PackedMatrixQuantization::none)
+        {
+            Internal::PackedGevm(matrix.NumRows(), matrix.NumColumns(), matrix.GetPaddedColumns(), scalarA, matrix.GetPackedData(), static_cast<const ElementType*>(nullptr), vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+        }
+        else
+        {
+            Internal::PackedGevm(matrix.NumRows(), matrix.NumColumns(), matrix.GetPaddedColumns(), scalarA, matrix.GetQuantizedData(), matrix.GetColumnScales(), vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+        }
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
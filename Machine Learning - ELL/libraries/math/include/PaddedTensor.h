@@ -0,0 +1,220 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/PaddedTensor.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Tensor.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The numbers of zero rows and columns on each side of a padded tensor. </summary>
+    struct TensorPadding
+    {
+        /// <summary> The number of zero rows above the tensor. </summary>
+        size_t rowsBefore = 0;
+
+        /// <summary> The number of zero rows below the tensor. </summary>
+        size_t rowsAfter = 0;
+
+        /// <summary> The number of zero columns left of the tensor. </summary>
+        size_t columnsBefore = 0;
+
+        /// <summary> The number of zero columns right of the tensor. </summary>
+        size_t columnsAfter = 0;
+    };
+
+    /// <summary>
+    /// A const view of a tensor surrounded by zero rows and columns that are never stored, so that convolution and
+    /// pooling kernels can read a padded input without materializing the padding. Element access is in padded
+    /// coordinates; kernels that avoid a test per element clip their windows with ClipRows and ClipColumns and read
+    /// the clipped part from GetInterior, whose element (i, j, k) is the padded element (i + rowsBefore, j + columnsBefore, k).
+    /// </summary>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    class ConstPaddedTensorReference
+    {
+    public:
+        /// <summary> Constructs a padded view of a tensor. </summary>
+        ///
+        /// <param name="tensor"> The tensor. </param>
+        /// <param name="padding"> The padding on each side. </param>
+        ConstPaddedTensorReference(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, TensorPadding padding);
+
+        /// <summary> Constructs a padded view of a tensor with the same padding on both sides of the rows and of the columns. </summary>
+        ///
+        /// <param name="tensor"> The tensor. </param>
+        /// <param name="rowPadding"> The number of zero rows above and below the tensor. </param>
+        /// <param name="columnPadding"> The number of zero columns left and right of the tensor. </param>
+        ConstPaddedTensorReference(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t rowPadding, size_t columnPadding);
+
+        /// <summary> Gets the number of rows, padding included. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _padding.rowsBefore + _tensor.NumRows() + _padding.rowsAfter; }
+
+        /// <summary> Gets the number of columns, padding included. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _padding.columnsBefore + _tensor.NumColumns() + _padding.columnsAfter; }
+
+        /// <summary> Gets the number of channels. </summary>
+        ///
+        /// <returns> The number of channels. </returns>
+        size_t NumChannels() const { return _tensor.NumChannels(); }
+
+        /// <summary> Gets the shape, padding included. </summary>
+        ///
+        /// <returns> The shape. </returns>
+        TensorShape GetShape() const { return { NumRows(), NumColumns(), NumChannels() }; }
+
+        /// <summary> Gets the padding. </summary>
+        ///
+        /// <returns> The padding. </returns>
+        TensorPadding GetPadding() const { return _padding; }
+
+        /// <summary> Gets the padded tensor, without its padding. </summary>
+        ///
+        /// <returns> A reference to the tensor. </returns>
+        ConstTensorReference<ElementType, dimension0, dimension1, dimension2> GetInterior() const { return _tensor; }
+
+        /// <summary> Gets an element, which is zero in the padding. </summary>
+        ///
+        /// <param name="row"> The row, in padded coordinates. </param>
+        /// <param name="column"> The column, in padded coordinates. </param>
+        /// <param name="channel"> The channel. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column, size_t channel) const;
+
+        /// <summary> Checks whether a position lies in the padding. </summary>
+        ///
+        /// <param name="row"> The row, in padded coordinates. </param>
+        /// <param name="column"> The column, in padded coordinates. </param>
+        ///
+        /// <returns> True if the position is padding. </returns>
+        bool IsPadding(size_t row, size_t column) const;
+
+        /// <summary> Clips a range of rows to the rows that are not padding. </summary>
+        ///
+        /// <param name="firstRow"> The first row of the range, in padded coordinates. </param>
+        /// <param name="numRows"> The number of rows of the range. </param>
+        ///
+        /// <returns> The first row and one past the last row of the clipped range, in padded coordinates, which are equal when the range is all padding. </returns>
+        std::pair<size_t, size_t> ClipRows(size_t firstRow, size_t numRows) const;
+
+        /// <summary> Clips a range of columns to the columns that are not padding. </summary>
+        ///
+        /// <param name="firstColumn"> The first column of the range, in padded coordinates. </param>
+        /// <param name="numColumns"> The number of columns of the range. </param>
+        ///
+        /// <returns> The first column and one past the last column of the clipped range, in padded coordinates, which are equal when the range is all padding. </returns>
+        std::pair<size_t, size_t> ClipColumns(size_t firstColumn, size_t numColumns) const;
+
+        /// <summary> Materializes the padded tensor, for kernels that need the padding in memory. </summary>
+        ///
+        /// <param name="output"> The output, with the shape GetShape(). </param>
+        template <Dimension outputDimension0, Dimension outputDimension1, Dimension outputDimension2>
+        void CopyTo(TensorReference<ElementType, outputDimension0, outputDimension1, outputDimension2> output) const;
+
+    private:
+        ConstTensorReference<ElementType, dimension0, dimension1, dimension2> _tensor;
+        TensorPadding _padding;
+    };
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the part of [first, first + count) that overlaps [before, before + size)
+        inline std::pair<size_t, size_t> ClipRange(size_t first, size_t count, size_t before, size_t size)
+        {
+            size_t begin = std::max(first, before);
+            size_t end = std::max(begin, std::min(first + count, before + size));
+            return { begin, end };
+        }
+    } // namespace Internal
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::ConstPaddedTensorReference(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, TensorPadding padding) :
+        _tensor(tensor),
+        _padding(padding)
+    {
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::ConstPaddedTensorReference(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t rowPadding, size_t columnPadding) :
+        _tensor(tensor),
+        _padding{ rowPadding, rowPadding, columnPadding, columnPadding }
+    {
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ElementType ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::operator()(size_t row, size_t column, size_t channel) const
+    {
+        if (IsPadding(row, column))
+        {
+            return 0;
+        }
+        return _tensor(row - _padding.rowsBefore, column - _padding.columnsBefore, channel);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    bool ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::IsPadding(size_t row, size_t column) const
+    {
+        return row < _padding.rowsBefore || row - _padding.rowsBefore >= _tensor.NumRows() || column < _padding.columnsBefore || column - _padding.columnsBefore >= _tensor.NumColumns();
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    std::pair<size_t, size_t> ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::ClipRows(size_t firstRow, size_t numRows) const
+    {
+        return Internal::ClipRange(firstRow, numRows, _padding.rowsBefore, _tensor.NumRows());
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    std::pair<size_t, size_t> ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::ClipColumns(size_t firstColumn, size_t numColumns) const
+    {
+        return Internal::ClipRange(firstColumn, numColumns, _padding.columnsBefore, _tensor.NumColumns());
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    template <Dimension outputDimension0, Dimension outputDimension1, Dimension outputDimension2>
+    void ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2>::CopyTo(TensorReference<ElementType, outputDimension0, outputDimension1, outputDimension2> output) const
+    {
+        if (output.GetShape() != GetShape())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The output does not have the shape of the padded tensor.");
+        }
+
+        // the four borders, then the interior
+        size_t numChannels = NumChannels();
+        size_t interiorRows = _tensor.NumRows();
+        size_t interiorColumns = _tensor.NumColumns();
+        output.GetSubTensor(0, 0, 0, _padding.rowsBefore, NumColumns(), numChannels).Fill(0);
+        output.GetSubTensor(_padding.rowsBefore + interiorRows, 0, 0, _padding.rowsAfter, NumColumns(), numChannels).Fill(0);
+        output.GetSubTensor(_padding.rowsBefore, 0, 0, interiorRows, _padding.columnsBefore, numChannels).Fill(0);
+        output.GetSubTensor(_padding.rowsBefore, _padding.columnsBefore + interiorColumns, 0, interiorRows, _padding.columnsAfter, numChannels).Fill(0);
+        output.GetSubTensor(_padding.rowsBefore, _padding.columnsBefore, 0, interiorRows, interiorColumns, numChannels).CopyFrom(_tensor);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,385 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/RandomFill.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Tensor.h"
+#include "Vector.h"
+
+#include <array>
+#include <cstdint>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// The Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers: as easy
+    /// as 1, 2, 3"). Each counter is encrypted with the key into four independent 32-bit random words, so any part
+    /// of a random sequence can be computed without computing what comes before it.
+    /// </summary>
+    class Philox4x32
+    {
+    public:
+        using Block = std::array<uint32_t, 4>;
+
+        /// <summary> Constructs a generator whose key is the seed. </summary>
+        ///
+        /// <param name="seed"> The seed. </param>
+        explicit Philox4x32(uint64_t seed) :
+            _key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) } {}
+
+        /// <summary> Gets the four random words of a counter. </summary>
+        ///
+        /// <param name="counter"> The counter. </param>
+        ///
+        /// <returns> The random words. </returns>
+        Block operator()(Block counter) const;
+
+    private:
+        std::array<uint32_t, 2> _key;
+    };
+
+    /// <summary>
+    /// Fills a vector with independent uniform random numbers in [minimum, maximum). Element i of the vector is
+    /// computed from the seed and i alone, so the work is split across the thread pool and the result does not
+    /// depend on the number of threads. Floats use 24 random bits and doubles use 53.
+    /// </summary>
+    ///
+    /// <param name="vector"> The vector. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="minimum"> The lower bound. </param>
+    /// <param name="maximum"> The upper bound. </param>
+    template <typename ElementType, VectorOrientation orientation>
+    void FillUniform(VectorReference<ElementType, orientation> vector, uint64_t seed, ElementType minimum = 0, ElementType maximum = 1);
+
+    /// <summary>
+    /// Fills a matrix with independent uniform random numbers in [minimum, maximum), as the vector overload does.
+    /// Elements are numbered in the memory order of the layout, so a matrix gets the same numbers as a vector of the
+    /// same size filled with the same seed.
+    /// </summary>
+    ///
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="minimum"> The lower bound. </param>
+    /// <param name="maximum"> The upper bound. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void FillUniform(MatrixReference<ElementType, layout> matrix, uint64_t seed, ElementType minimum = 0, ElementType maximum = 1);
+
+    /// <summary>
+    /// Fills a tensor with independent uniform random numbers in [minimum, maximum), as the vector overload does.
+    /// Elements are numbered in the memory order of the tensor (dimension0 first).
+    /// </summary>
+    ///
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="minimum"> The lower bound. </param>
+    /// <param name="maximum"> The upper bound. </param>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void FillUniform(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, uint64_t seed, ElementType minimum = 0, ElementType maximum = 1);
+
+    /// <summary>
+    /// Fills a vector with independent normal random numbers, with the Box-Muller transform of the uniform
+    /// numbers of FillUniform. As with FillUniform, the result does not depend on the number of threads.
+    /// </summary>
+    ///
+    /// <param name="vector"> The vector. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="mean"> The mean. </param>
+    /// <param name="standardDeviation"> The standard deviation. </param>
+    template <typename ElementType, VectorOrientation orientation>
+    void FillNormal(VectorReference<ElementType, orientation> vector, uint64_t seed, ElementType mean = 0, ElementType standardDeviation = 1);
+
+    /// <summary> Fills a matrix with independent normal random numbers, numbered as in FillUniform. </summary>
+    ///
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="mean"> The mean. </param>
+    /// <param name="standardDeviation"> The standard deviation. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void FillNormal(MatrixReference<ElementType, layout> matrix, uint64_t seed, ElementType mean = 0, ElementType standardDeviation = 1);
+
+    /// <summary> Fills a tensor with independent normal random numbers, numbered as in FillUniform. </summary>
+    ///
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="seed"> The seed. </param>
+    /// <param name="mean"> The mean. </param>
+    /// <param name="standardDeviation"> The standard deviation. </param>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void FillNormal(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, uint64_t seed, ElementType mean = 0, ElementType standardDeviation = 1);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+#include "MathConstants.h"
+
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        constexpr uint32_t philoxMultiplier0 = 0xD2511F53u;
+        constexpr uint32_t philoxMultiplier1 = 0xCD9E8D57u;
+        constexpr uint32_t philoxWeyl0 = 0x9E3779B9u;
+        constexpr uint32_t philoxWeyl1 = 0xBB67AE85u;
+        constexpr size_t philoxRounds = 10;
+
+        // the blocks are generated this many at a time, one per vector lane, in loops that the compiler vectorizes
+        constexpr size_t philoxLanes = 8;
+
+        // the random words of philoxLanes consecutive blocks, whose first counter is firstBlock, with words[w][l]
+        // the word w of block firstBlock + l
+        inline void GeneratePhiloxBlocks(uint64_t firstBlock, uint32_t key0, uint32_t key1, uint32_t words[4][philoxLanes])
+        {
+            for (size_t l = 0; l < philoxLanes; ++l)
+            {
+                uint64_t block = firstBlock + l;
+                words[0][l] = static_cast<uint32_t>(block);
+                words[1][l] = static_cast<uint32_t>(block >> 32);
+                words[2][l] = 0;
+                words[3][l] = 0;
+            }
+
+            for (size_t round = 0; round < philoxRounds; ++round)
+            {
+                for (size_t l = 0; l < philoxLanes; ++l)
+                {
+                    uint64_t product0 = static_cast<uint64_t>(philoxMultiplier0) * words[0][l];
+                    uint64_t product1 = static_cast<uint64_t>(philoxMultiplier1) * words[2][l];
+                    uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ words[1][l] ^ key0;
+                    uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ words[3][l] ^ key1;
+                    words[1][l] = static_cast<uint32_t>(product1);
+                    words[3][l] = static_cast<uint32_t>(product0);
+                    words[0][l] = next0;
+                    words[2][l] = next2;
+                }
+                key0 += philoxWeyl0;
+                key1 += philoxWeyl1;
+            }
+        }
+
+        // how the random words turn into uniform numbers in [0, 1): floats take 24 bits of one word, doubles take
+        // 53 bits of two words
+        template <typename ElementType>
+        struct UniformConversion
+        {
+            static_assert(std::is_floating_point<ElementType>::value, "random fills need a floating point element type");
+
+            static constexpr size_t wordsPerElement = sizeof(ElementType) == 4 ? 1 : 2;
+            static constexpr size_t elementsPerBlock = 4 / wordsPerElement;
+
+            static ElementType Convert(const uint32_t words[4][philoxLanes], size_t element, size_t lane)
+            {
+                if (wordsPerElement == 1)
+                {
+                    return static_cast<ElementType>(words[element][lane] >> 8) * static_cast<ElementType>(1.0 / (1 << 24));
+                }
+                uint64_t bits = (static_cast<uint64_t>(words[2 * element][lane] >> 5) << 26) | (words[2 * element + 1][lane] >> 6);
+                return static_cast<ElementType>(static_cast<double>(bits) * (1.0 / 9007199254740992.0));
+            }
+        };
+
+        // the uniform numbers with indices [firstIndex, firstIndex + size), in chunks of philoxLanes blocks, passed
+        // to function(index, uniform) in increasing order of index
+        template <typename ElementType, typename FunctionType>
+        void ForEachUniform(uint64_t seed, uint64_t firstIndex, size_t size, FunctionType&& function)
+        {
+            using Conversion = UniformConversion<ElementType>;
+            constexpr size_t elementsPerChunk = Conversion::elementsPerBlock * philoxLanes;
+            const uint32_t key0 = static_cast<uint32_t>(seed);
+            const uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+
+            uint32_t words[4][philoxLanes];
+            ElementType uniforms[elementsPerChunk];
+            uint64_t endIndex = firstIndex + size;
+            for (uint64_t chunkBegin = firstIndex - firstIndex % elementsPerChunk; chunkBegin < endIndex; chunkBegin += elementsPerChunk)
+            {
+                GeneratePhiloxBlocks(chunkBegin / Conversion::elementsPerBlock, key0, key1, words);
+                for (size_t l = 0; l < philoxLanes; ++l)
+                {
+                    for (size_t e = 0; e < Conversion::elementsPerBlock; ++e)
+                    {
+                        uniforms[l * Conversion::elementsPerBlock + e] = Conversion::Convert(words, e, l);
+                    }
+                }
+
+                uint64_t begin = std::max(chunkBegin, firstIndex);
+                uint64_t end = std::min(chunkBegin + elementsPerChunk, endIndex);
+                for (uint64_t index = begin; index < end; ++index)
+                {
+                    function(index, uniforms[index - chunkBegin]);
+                }
+            }
+        }
+
+        // Box-Muller: the uniforms 2m and 2m + 1 give the normals 2m and 2m + 1, so index ranges are widened to pairs
+        template <typename ElementType, typename FunctionType>
+        void ForEachNormal(uint64_t seed, uint64_t firstIndex, size_t size, FunctionType&& function)
+        {
+            const ElementType twoPi = static_cast<ElementType>(2 * Constants<double>::pi);
+            uint64_t pairBegin = firstIndex - firstIndex % 2;
+            uint64_t endIndex = firstIndex + size;
+            ElementType first = 0;
+            ForEachUniform<ElementType>(seed, pairBegin, static_cast<size_t>(endIndex + endIndex % 2 - pairBegin), [&](uint64_t index, ElementType uniform) {
+                if (index % 2 == 0)
+                {
+                    first = uniform;
+                    return;
+                }
+
+                // 1 - first is in (0, 1], so its logarithm is finite
+                ElementType radius = std::sqrt(-2 * std::log(1 - first));
+                ElementType angle = twoPi * uniform;
+                if (index - 1 >= firstIndex)
+                {
+                    function(index - 1, radius * std::cos(angle));
+                }
+                if (index < endIndex)
+                {
+                    function(index, radius * std::sin(angle));
+                }
+            });
+        }
+
+        enum class RandomDistribution
+        {
+            uniform,
+            normal
+        };
+
+        // fills numVectors vectors of size elements, where element p of vector v is numbered v * size + p and stored
+        // at pData[getOffset(v) + p * increment]; the numbered elements are split across the thread pool
+        template <RandomDistribution distribution, typename ElementType, typename OffsetFunctionType>
+        void FillRandom(ElementType* pData, size_t numVectors, size_t size, size_t increment, OffsetFunctionType getOffset, uint64_t seed, ElementType shift, ElementType scale)
+        {
+            size_t count = numVectors * size;
+            utilities::ParallelFor(count, minElementsPerTask, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end;)
+                {
+                    size_t vector = index / size;
+                    size_t position = index % size;
+                    size_t segmentSize = std::min(size - position, end - index);
+                    ElementType* pSegment = pData + getOffset(vector) + position * increment;
+                    auto store = [&](uint64_t segmentIndex, ElementType value) {
+                        pSegment[(segmentIndex - index) * increment] = shift + scale * value;
+                    };
+                    if (distribution == RandomDistribution::uniform)
+                    {
+                        ForEachUniform<ElementType>(seed, index, segmentSize, store);
+                    }
+                    else
+                    {
+                        ForEachNormal<ElementType>(seed, index, segmentSize, store);
+                    }
+                    index += segmentSize;
+                }
+            });
+        }
+
+        template <RandomDistribution distribution, typename ElementType, VectorOrientation orientation>
+        void FillRandom(VectorReference<ElementType, orientation> vector, uint64_t seed, ElementType shift, ElementType scale)
+        {
+            FillRandom<distribution>(vector.GetDataPointer(), 1, vector.Size(), vector.GetIncrement(), [](size_t) { return size_t{ 0 }; }, seed, shift, scale);
+        }
+
+        template <RandomDistribution distribution, typename ElementType, MatrixLayout layout>
+        void FillRandom(MatrixReference<ElementType, layout> matrix, uint64_t seed, ElementType shift, ElementType scale)
+        {
+            // the numbering follows memory order, so contiguous storage is filled as one range rather than one
+            // short major vector at a time, each of which would generate a whole chunk of blocks
+            if (matrix.IsContigous())
+            {
+                FillRandom<distribution>(matrix.GetDataPointer(), 1, matrix.NumRows() * matrix.NumColumns(), 1, [](size_t) { return size_t{ 0 }; }, seed, shift, scale);
+                return;
+            }
+
+            size_t increment = matrix.GetIncrement();
+            FillRandom<distribution>(matrix.GetDataPointer(), matrix.GetMinorSize(), matrix.GetMajorSize(), 1, [increment](size_t vector) { return vector * increment; }, seed, shift, scale);
+        }
+
+        template <RandomDistribution distribution, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        void FillRandom(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, uint64_t seed, ElementType shift, ElementType scale)
+        {
+            // as for matrices, contiguous storage is one range
+            if (tensor.IsContiguous())
+            {
+                FillRandom<distribution>(tensor.GetDataPointer(), 1, tensor.Size(), 1, [](size_t) { return size_t{ 0 }; }, seed, shift, scale);
+                return;
+            }
+
+            size_t size1 = tensor.GetSize1();
+            size_t increment1 = tensor.GetIncrement1();
+            size_t increment2 = tensor.GetIncrement2();
+            FillRandom<distribution>(tensor.GetDataPointer(), size1 * tensor.GetSize2(), tensor.GetSize0(), 1, [=](size_t vector) { return (vector % size1) * increment1 + (vector / size1) * increment2; }, seed, shift, scale);
+        }
+    } // namespace Internal
+
+    inline Philox4x32::Block Philox4x32::operator()(Block counter) const
+    {
+        uint32_t key0 = _key[0];
+        uint32_t key1 = _key[1];
+        for (size_t round = 0; round < Internal::philoxRounds; ++round)
+        {
+            uint64_t product0 = static_cast<uint64_t>(Internal::philoxMultiplier0) * counter[0];
+            uint64_t product1 = static_cast<uint64_t>(Internal::philoxMultiplier1) * counter[2];
+            counter = { static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key0, static_cast<uint32_t>(product1), static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key1, static_cast<uint32_t>(product0) };
+            key0 += Internal::philoxWeyl0;
+            key1 += Internal::philoxWeyl1;
+        }
+        return counter;
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    void FillUniform(VectorReference<ElementType, orientation> vector, uint64_t seed, ElementType minimum, ElementType maximum)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::uniform>(vector, seed, minimum, maximum - minimum);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void FillUniform(MatrixReference<ElementType, layout> matrix, uint64_t seed, ElementType minimum, ElementType maximum)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::uniform>(matrix, seed, minimum, maximum - minimum);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void FillUniform(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, uint64_t seed, ElementType minimum, ElementType maximum)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::uniform>(tensor, seed, minimum, maximum - minimum);
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    void FillNormal(VectorReference<ElementType, orientation> vector, uint64_t seed, ElementType mean, ElementType standardDeviation)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::normal>(vector, seed, mean, standardDeviation);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void FillNormal(MatrixReference<ElementType, layout> matrix, uint64_t seed, ElementType mean, ElementType standardDeviation)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::normal>(matrix, seed, mean, standardDeviation);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void FillNormal(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, uint64_t seed, ElementType mean, ElementType standardDeviation)
+    {
+        Internal::FillRandom<Internal::RandomDistribution::normal>(tensor, seed, mean, standardDeviation);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,480 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/Softmax.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Replaces the elements of a vector with their softmax, exp(v[i] - m) / sum_j exp(v[j] - m), where m is the
+    /// largest element. The first pass over the data computes m and the sum together (rescaling the running sum
+    /// whenever the running maximum grows), the second pass writes the result, so nothing overflows.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type, float or double. </typeparam>
+    /// <typeparam name="orientation"> Vector orientation. </typeparam>
+    /// <param name="vector"> The vector. </param>
+    template <typename ElementType, VectorOrientation orientation>
+    void SoftmaxUpdate(VectorReference<ElementType, orientation> vector);
+
+    /// <summary> Replaces the elements of a vector with their log-softmax, v[i] - LogSumExp(v), in two passes. </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type, float or double. </typeparam>
+    /// <typeparam name="orientation"> Vector orientation. </typeparam>
+    /// <param name="vector"> The vector. </param>
+    template <typename ElementType, VectorOrientation orientation>
+    void LogSoftmaxUpdate(VectorReference<ElementType, orientation> vector);
+
+    /// <summary> Computes log(sum_i exp(v[i])) in one pass, without overflow. </summary>
+    ///
+    /// <typeparam name="ElementType"> Vector element type, float or double. </typeparam>
+    /// <typeparam name="orientation"> Vector orientation. </typeparam>
+    /// <param name="vector"> The vector. </param>
+    ///
+    /// <returns> The log-sum-exp of the vector, or -infinity for an empty vector. </returns>
+    template <typename ElementType, VectorOrientation orientation>
+    ElementType LogSumExp(ConstVectorReference<ElementType, orientation> vector);
+
+    /// <summary> Replaces each row of a matrix with its softmax. Rows are distributed over the thread pool. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseSoftmaxUpdate(MatrixReference<ElementType, layout> matrix);
+
+    /// <summary> Replaces each column of a matrix with its softmax. Columns are distributed over the thread pool. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseSoftmaxUpdate(MatrixReference<ElementType, layout> matrix);
+
+    /// <summary> Replaces each row of a matrix with its log-softmax. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLogSoftmaxUpdate(MatrixReference<ElementType, layout> matrix);
+
+    /// <summary> Replaces each column of a matrix with its log-softmax. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseLogSoftmaxUpdate(MatrixReference<ElementType, layout> matrix);
+
+    /// <summary> Computes the log-sum-exp of each row of a matrix and stores the results in a column vector. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="vector"> The vector used to store the result. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLogSumExp(ConstMatrixReference<ElementType, layout> matrix, ColumnVectorReference<ElementType> vector);
+
+    /// <summary> Computes the log-sum-exp of each column of a matrix and stores the results in a row vector. </summary>
+    ///
+    /// <typeparam name="ElementType"> Matrix and vector element type, float or double. </typeparam>
+    /// <typeparam name="layout"> Matrix layout. </typeparam>
+    /// <param name="matrix"> The matrix. </param>
+    /// <param name="vector"> The vector used to store the result. </param>
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseLogSumExp(ConstMatrixReference<ElementType, layout> matrix, RowVectorReference<ElementType> vector);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "TransformationKernels.h"
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        enum class SoftmaxOutput
+        {
+            softmax,
+            logSoftmax
+        };
+
+        // the elements are exponentiated in chunks of this size, which stay in the L1 cache between the passes over them
+        constexpr size_t softmaxChunkSize = 256;
+
+        // the running maximum and the sum of exp(x - maximum) over the elements seen so far
+        template <typename ElementType>
+        struct SoftmaxStatistics
+        {
+            ElementType maximum = -std::numeric_limits<ElementType>::infinity();
+            ElementType sum = 0;
+
+            // the value subtracted before exponentiating; while all the elements are -infinity, exp(x - 0) gives the correct 0
+            ElementType Shift() const { return maximum == -std::numeric_limits<ElementType>::infinity() ? 0 : maximum; }
+
+            ElementType LogSumExp() const { return maximum == -std::numeric_limits<ElementType>::infinity() ? maximum : maximum + std::log(sum); }
+        };
+
+        // statistics of a contiguous array, the scratch buffer holds softmaxChunkSize elements
+        template <typename ElementType>
+        SoftmaxStatistics<ElementType> GetSoftmaxStatistics(const ElementType* pData, size_t size, ElementType* pScratch)
+        {
+            SoftmaxStatistics<ElementType> statistics;
+            for (size_t begin = 0; begin < size; begin += softmaxChunkSize)
+            {
+                size_t count = std::min(softmaxChunkSize, size - begin);
+                const ElementType* pChunk = pData + begin;
+
+                ElementType chunkMaximum = statistics.maximum;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    chunkMaximum = pChunk[i] > chunkMaximum ? pChunk[i] : chunkMaximum;
+                }
+                if (chunkMaximum > statistics.maximum)
+                {
+                    // the sum is still zero while the maximum is -infinity
+                    if (statistics.sum != 0)
+                    {
+                        statistics.sum *= std::exp(statistics.maximum - chunkMaximum);
+                    }
+                    statistics.maximum = chunkMaximum;
+                }
+
+                ElementType shift = statistics.Shift();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    pScratch[i] = pChunk[i] - shift;
+                }
+                VectorizedExponent(pScratch, pScratch, count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    statistics.sum += pScratch[i];
+                }
+            }
+            return statistics;
+        }
+
+        template <typename ElementType>
+        void WriteSoftmax(SoftmaxOutput output, SoftmaxStatistics<ElementType> statistics, ElementType* pData, size_t size)
+        {
+            if (output == SoftmaxOutput::logSoftmax)
+            {
+                ElementType logSumExp = statistics.LogSumExp();
+                for (size_t i = 0; i < size; ++i)
+                {
+                    pData[i] -= logSumExp;
+                }
+                return;
+            }
+
+            ElementType shift = statistics.Shift();
+            for (size_t i = 0; i < size; ++i)
+            {
+                pData[i] -= shift;
+            }
+            VectorizedExponent(pData, pData, size);
+            ElementType scale = 1 / statistics.sum;
+            for (size_t i = 0; i < size; ++i)
+            {
+                pData[i] *= scale;
+            }
+        }
+
+        // softmax of numVectors contiguous vectors of the given size, which start increment elements apart
+        template <typename ElementType>
+        void SoftmaxContiguousVectors(SoftmaxOutput output, ElementType* pData, size_t size, size_t numVectors, size_t increment)
+        {
+            size_t grainSize = size == 0 ? numVectors : (minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                std::vector<ElementType> scratch(softmaxChunkSize);
+                for (size_t index = begin; index < end; ++index)
+                {
+                    ElementType* pVector = pData + index * increment;
+                    auto statistics = GetSoftmaxStatistics(pVector, size, scratch.data());
+                    WriteSoftmax(output, statistics, pVector, size);
+                }
+            });
+        }
+
+        // statistics of the lanes [0, numLanes), where lane j holds the elements pData[i * increment + j] for i in [0, size);
+        // rows are processed in blocks, so that each block is read from memory once, and the work runs across lanes
+        template <typename ElementType>
+        void GetLaneSoftmaxStatistics(const ElementType* pData, size_t size, size_t numLanes, size_t increment, ElementType* pMaximum, ElementType* pSum, ElementType* pScratch)
+        {
+            const ElementType negativeInfinity = -std::numeric_limits<ElementType>::infinity();
+            const size_t blockSize = std::max<size_t>(1, softmaxChunkSize * 16 / std::max<size_t>(numLanes, 1));
+            std::fill(pMaximum, pMaximum + numLanes, negativeInfinity);
+            std::fill(pSum, pSum + numLanes, ElementType{ 0 });
+
+            for (size_t blockBegin = 0; blockBegin < size; blockBegin += blockSize)
+            {
+                size_t blockEnd = std::min(size, blockBegin + blockSize);
+
+                // pScratch[j] = new maximum, pScratch[numLanes + j] = the factor that rescales the old sum
+                ElementType* pNewMaximum = pScratch;
+                ElementType* pRescale = pScratch + numLanes;
+                std::copy(pMaximum, pMaximum + numLanes, pNewMaximum);
+                for (size_t i = blockBegin; i < blockEnd; ++i)
+                {
+                    const ElementType* pRow = pData + i * increment;
+                    for (size_t j = 0; j < numLanes; ++j)
+                    {
+                        pNewMaximum[j] = pRow[j] > pNewMaximum[j] ? pRow[j] : pNewMaximum[j];
+                    }
+                }
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    pRescale[j] = pNewMaximum[j] == pMaximum[j] ? 0 : pMaximum[j] - pNewMaximum[j];
+                    pMaximum[j] = pNewMaximum[j];
+                    pNewMaximum[j] = pMaximum[j] == negativeInfinity ? 0 : pMaximum[j];
+                }
+                VectorizedExponent(pRescale, pRescale, numLanes);
+                for (size_t j = 0; j < numLanes; ++j)
+                {
+                    pSum[j] *= pRescale[j];
+                }
+
+                // pNewMaximum now holds the shifts
+                ElementType* pExponent = pScratch + numLanes;
+                for (size_t i = blockBegin; i < blockEnd; ++i)
+                {
+                    const ElementType* pRow = pData + i * increment;
+                    for (size_t j = 0; j < numLanes; ++j)
+                    {
+                        pExponent[j] = pRow[j] - pNewMaximum[j];
+                    }
+                    VectorizedExponent(pExponent, pExponent, numLanes);
+                    for (size_t j = 0; j < numLanes; ++j)
+                    {
+                        pSum[j] += pExponent[j];
+                    }
+                }
+            }
+        }
+
+        // softmax along the strided direction: numLanes vectors of the given size, whose elements are increment apart
+        // and whose first elements are adjacent; lanes are distributed over the thread pool
+        template <typename ElementType>
+        void SoftmaxStridedVectors(SoftmaxOutput output, ElementType* pData, size_t size, size_t numLanes, size_t increment)
+        {
+            const ElementType negativeInfinity = -std::numeric_limits<ElementType>::infinity();
+            size_t grainSize = size == 0 ? numLanes : std::max<size_t>((minElementsPerTask + size - 1) / size, 16);
+            utilities::ParallelFor(numLanes, grainSize, [&](size_t begin, size_t end) {
+                size_t count = end - begin;
+                std::vector<ElementType> maximum(count);
+                std::vector<ElementType> sum(count);
+                std::vector<ElementType> scratch(2 * count);
+                GetLaneSoftmaxStatistics(pData + begin, size, count, increment, maximum.data(), sum.data(), scratch.data());
+
+                // scratch[j] = the value subtracted from lane j, sum[j] = the factor it is multiplied with
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (output == SoftmaxOutput::logSoftmax)
+                    {
+                        scratch[j] = maximum[j] == negativeInfinity ? maximum[j] : maximum[j] + std::log(sum[j]);
+                    }
+                    else
+                    {
+                        scratch[j] = maximum[j] == negativeInfinity ? 0 : maximum[j];
+                        sum[j] = 1 / sum[j];
+                    }
+                }
+
+                for (size_t i = 0; i < size; ++i)
+                {
+                    ElementType* pRow = pData + i * increment + begin;
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        pRow[j] -= scratch[j];
+                    }
+                    if (output == SoftmaxOutput::softmax)
+                    {
+                        VectorizedExponent(pRow, pRow, count);
+                        for (size_t j = 0; j < count; ++j)
+                        {
+                            pRow[j] *= sum[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        template <typename ElementType>
+        void LogSumExpContiguousVectors(const ElementType* pData, size_t size, size_t numVectors, size_t increment, ElementType* pOutput, size_t outputIncrement)
+        {
+            size_t grainSize = size == 0 ? numVectors : (minElementsPerTask + size - 1) / size;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                std::vector<ElementType> scratch(softmaxChunkSize);
+                for (size_t index = begin; index < end; ++index)
+                {
+                    pOutput[index * outputIncrement] = GetSoftmaxStatistics(pData + index * increment, size, scratch.data()).LogSumExp();
+                }
+            });
+        }
+
+        template <typename ElementType>
+        void LogSumExpStridedVectors(const ElementType* pData, size_t size, size_t numLanes, size_t increment, ElementType* pOutput, size_t outputIncrement)
+        {
+            size_t grainSize = size == 0 ? numLanes : std::max<size_t>((minElementsPerTask + size - 1) / size, 16);
+            utilities::ParallelFor(numLanes, grainSize, [&](size_t begin, size_t end) {
+                size_t count = end - begin;
+                std::vector<ElementType> maximum(count);
+                std::vector<ElementType> sum(count);
+                std::vector<ElementType> scratch(2 * count);
+                GetLaneSoftmaxStatistics(pData + begin, size, count, increment, maximum.data(), sum.data(), scratch.data());
+                for (size_t j = 0; j < count; ++j)
+                {
+                    SoftmaxStatistics<ElementType> statistics;
+                    statistics.maximum = maximum[j];
+                    statistics.sum = sum[j];
+                    pOutput[(begin + j) * outputIncrement] = statistics.LogSumExp();
+                }
+            });
+        }
+
+        template <typename ElementType>
+        void SoftmaxVector(SoftmaxOutput output, ElementType* pData, size_t size, size_t increment)
+        {
+            if (increment == 1)
+            {
+                SoftmaxContiguousVectors(output, pData, size, 1, size);
+                return;
+            }
+
+            // a strided vector is copied to a contiguous buffer, which is faster than exponentiating one element at a time
+            std::vector<ElementType> buffer(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                buffer[i] = pData[i * increment];
+            }
+            SoftmaxContiguousVectors(output, buffer.data(), size, 1, size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                pData[i * increment] = buffer[i];
+            }
+        }
+
+        // the matrix is viewed as GetMinorSize() contiguous vectors of GetMajorSize() elements, so normalizing along
+        // the vectors (alongMajor) is the contiguous case and normalizing across them is the strided case
+        template <typename ElementType, MatrixLayout layout>
+        void SoftmaxMatrix(SoftmaxOutput output, MatrixReference<ElementType, layout> matrix, bool alongMajor)
+        {
+            ElementType* pData = matrix.GetDataPointer();
+            if (alongMajor)
+            {
+                SoftmaxContiguousVectors(output, pData, matrix.GetMajorSize(), matrix.GetMinorSize(), matrix.GetIncrement());
+            }
+            else
+            {
+                SoftmaxStridedVectors(output, pData, matrix.GetMinorSize(), matrix.GetMajorSize(), matrix.GetIncrement());
+            }
+        }
+
+        template <typename ElementType, MatrixLayout layout>
+        void LogSumExpMatrix(ConstMatrixReference<ElementType, layout> matrix, bool alongMajor, ElementType* pOutput, size_t outputIncrement)
+        {
+            const ElementType* pData = matrix.GetConstDataPointer();
+            if (alongMajor)
+            {
+                LogSumExpContiguousVectors(pData, matrix.GetMajorSize(), matrix.GetMinorSize(), matrix.GetIncrement(), pOutput, outputIncrement);
+            }
+            else
+            {
+                LogSumExpStridedVectors(pData, matrix.GetMinorSize(), matrix.GetMajorSize(), matrix.GetIncrement(), pOutput, outputIncrement);
+            }
+        }
+    } // namespace Internal
+
+    template <typename ElementType, VectorOrientation orientation>
+    void SoftmaxUpdate(VectorReference<ElementType, orientation> vector)
+    {
+        Internal::SoftmaxVector(Internal::SoftmaxOutput::softmax, vector.GetDataPointer(), vector.Size(), vector.GetIncrement());
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    void LogSoftmaxUpdate(VectorReference<ElementType, orientation> vector)
+    {
+        Internal::SoftmaxVector(Internal::SoftmaxOutput::logSoftmax, vector.GetDataPointer(), vector.Size(), vector.GetIncrement());
+    }
+
+    template <typename ElementType, VectorOrientation orientation>
+    ElementType LogSumExp(ConstVectorReference<ElementType, orientation> vector)
+    {
+        ElementType result;
+        if (vector.IsContiguous())
+        {
+            Internal::LogSumExpContiguousVectors(vector.GetConstDataPointer(), vector.Size(), 1, vector.Size(), &result, 1);
+        }
+        else
+        {
+            auto buffer = vector.ToArray();
+            Internal::LogSumExpContiguousVectors(buffer.data(), buffer.size(), 1, buffer.size(), &result, 1);
+        }
+        return result;
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseSoftmaxUpdate(MatrixReference<ElementType, layout> matrix)
+    {
+        Internal::SoftmaxMatrix(Internal::SoftmaxOutput::softmax, matrix, layout == MatrixLayout::rowMajor);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseSoftmaxUpdate(MatrixReference<ElementType, layout> matrix)
+    {
+        Internal::SoftmaxMatrix(Internal::SoftmaxOutput::softmax, matrix, layout == MatrixLayout::columnMajor);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLogSoftmaxUpdate(MatrixReference<ElementType, layout> matrix)
+    {
+        Internal::SoftmaxMatrix(Internal::SoftmaxOutput::logSoftmax, matrix, layout == MatrixLayout::rowMajor);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseLogSoftmaxUpdate(MatrixReference<ElementType, layout> matrix)
+    {
+        Internal::SoftmaxMatrix(Internal::SoftmaxOutput::logSoftmax, matrix, layout == MatrixLayout::columnMajor);
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void RowwiseLogSumExp(ConstMatrixReference<ElementType, layout> matrix, ColumnVectorReference<ElementType> vector)
+    {
+        DEBUG_CHECK_SIZES(vector.Size() != matrix.NumRows(), "Incompatible matrix vector sizes.");
+        Internal::LogSumExpMatrix(matrix, layout == MatrixLayout::rowMajor, vector.GetDataPointer(), vector.GetIncrement());
+    }
+
+    template <typename ElementType, MatrixLayout layout>
+    void ColumnwiseLogSumExp(ConstMatrixReference<ElementType, layout> matrix, RowVectorReference<ElementType> vector)
+    {
+        DEBUG_CHECK_SIZES(vector.Size() != matrix.NumColumns(), "Incompatible matrix vector sizes.");
+        Internal::LogSumExpMatrix(matrix, layout == MatrixLayout::columnMajor, vector.GetDataPointer(), vector.GetIncrement());
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
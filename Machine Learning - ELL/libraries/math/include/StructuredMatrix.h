@@ -0,0 +1,836 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/StructuredMatrix.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    //
+    // Matrices that store only their structural nonzeros. Each row i stores the contiguous range of columns
+    // [GetRowBegin(i), GetRowEnd(i)), starting at GetRowPointer(i); the kernels below read and write nothing else.
+    // Dense matrices convert to these types with the explicit constructors, which drop the elements outside the
+    // structure, and back with CopyTo, which writes the structural zeros too.
+    //
+
+    /// <summary> A diagonal matrix, stored as its diagonal. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class DiagonalMatrix
+    {
+    public:
+        /// <summary> Constructs a zero diagonal matrix. </summary>
+        ///
+        /// <param name="size"> The number of rows and columns. </param>
+        DiagonalMatrix(size_t size);
+
+        /// <summary> Constructs a diagonal matrix from its diagonal. </summary>
+        ///
+        /// <param name="diagonal"> The diagonal. </param>
+        DiagonalMatrix(std::vector<ElementType> diagonal);
+
+        /// <summary> Constructs a diagonal matrix from the diagonal of a square matrix. </summary>
+        ///
+        /// <param name="matrix"> The matrix. </param>
+        template <MatrixLayout layout>
+        explicit DiagonalMatrix(ConstMatrixReference<ElementType, layout> matrix);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _diagonal.size(); }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _diagonal.size(); }
+
+        /// <summary> Gets the number of stored elements. </summary>
+        ///
+        /// <returns> The number of stored elements. </returns>
+        size_t NumStoredElements() const { return _diagonal.size(); }
+
+        /// <summary> Gets an element, zero outside the diagonal. </summary>
+        ///
+        /// <param name="row"> The row index. </param>
+        /// <param name="column"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column) const { return row == column ? _diagonal[row] : 0; }
+
+        /// <summary> Gets the first stored column of a row. </summary>
+        size_t GetRowBegin(size_t row) const { return row; }
+
+        /// <summary> Gets one past the last stored column of a row. </summary>
+        size_t GetRowEnd(size_t row) const { return row + 1; }
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        const ElementType* GetRowPointer(size_t row) const { return _diagonal.data() + row; }
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        ElementType* GetRowPointer(size_t row) { return _diagonal.data() + row; }
+
+        /// <summary> Copies the matrix to a dense matrix of the same size, zeros included. </summary>
+        ///
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout layout>
+        void CopyTo(MatrixReference<ElementType, layout> matrix) const;
+
+    private:
+        std::vector<ElementType> _diagonal;
+    };
+
+    /// <summary> A square triangular matrix, with the rows of the triangle packed one after the other. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class TriangularMatrix
+    {
+    public:
+        /// <summary> Constructs a zero triangular matrix. </summary>
+        ///
+        /// <param name="size"> The number of rows and columns. </param>
+        /// <param name="triangle"> The triangle that holds the nonzeros. </param>
+        TriangularMatrix(size_t size, MatrixTriangle triangle);
+
+        /// <summary> Constructs a triangular matrix from a triangle of a square matrix. </summary>
+        ///
+        /// <param name="matrix"> The matrix. </param>
+        /// <param name="triangle"> The triangle that is kept. </param>
+        template <MatrixLayout layout>
+        explicit TriangularMatrix(ConstMatrixReference<ElementType, layout> matrix, MatrixTriangle triangle);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _size; }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _size; }
+
+        /// <summary> Gets the number of stored elements, size * (size + 1) / 2. </summary>
+        ///
+        /// <returns> The number of stored elements. </returns>
+        size_t NumStoredElements() const { return _data.size(); }
+
+        /// <summary> Gets the triangle that holds the nonzeros. </summary>
+        ///
+        /// <returns> The triangle. </returns>
+        MatrixTriangle GetTriangle() const { return _triangle; }
+
+        /// <summary> Gets an element, zero outside the triangle. </summary>
+        ///
+        /// <param name="row"> The row index. </param>
+        /// <param name="column"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column) const;
+
+        /// <summary> Gets the first stored column of a row. </summary>
+        size_t GetRowBegin(size_t row) const { return _triangle == MatrixTriangle::lower ? 0 : row; }
+
+        /// <summary> Gets one past the last stored column of a row. </summary>
+        size_t GetRowEnd(size_t row) const { return _triangle == MatrixTriangle::lower ? row + 1 : _size; }
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        const ElementType* GetRowPointer(size_t row) const { return _data.data() + GetRowOffset(row); }
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        ElementType* GetRowPointer(size_t row) { return _data.data() + GetRowOffset(row); }
+
+        /// <summary> Copies the matrix to a dense matrix of the same size, zeros included. </summary>
+        ///
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout layout>
+        void CopyTo(MatrixReference<ElementType, layout> matrix) const;
+
+    private:
+        size_t GetRowOffset(size_t row) const;
+
+        size_t _size;
+        MatrixTriangle _triangle;
+        std::vector<ElementType> _data;
+    };
+
+    /// <summary>
+    /// A banded matrix, with lowerBandwidth nonzero diagonals below the main diagonal and upperBandwidth above it.
+    /// Each row stores lowerBandwidth + upperBandwidth + 1 elements, padded where the band leaves the matrix.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    template <typename ElementType>
+    class BandedMatrix
+    {
+    public:
+        /// <summary> Constructs a zero banded matrix. </summary>
+        ///
+        /// <param name="numRows"> The number of rows. </param>
+        /// <param name="numColumns"> The number of columns. </param>
+        /// <param name="lowerBandwidth"> The number of diagonals below the main diagonal. </param>
+        /// <param name="upperBandwidth"> The number of diagonals above the main diagonal. </param>
+        BandedMatrix(size_t numRows, size_t numColumns, size_t lowerBandwidth, size_t upperBandwidth);
+
+        /// <summary> Constructs a banded matrix from the band of a matrix. </summary>
+        ///
+        /// <param name="matrix"> The matrix. </param>
+        /// <param name="lowerBandwidth"> The number of diagonals below the main diagonal. </param>
+        /// <param name="upperBandwidth"> The number of diagonals above the main diagonal. </param>
+        template <MatrixLayout layout>
+        explicit BandedMatrix(ConstMatrixReference<ElementType, layout> matrix, size_t lowerBandwidth, size_t upperBandwidth);
+
+        /// <summary> Gets the number of rows. </summary>
+        ///
+        /// <returns> The number of rows. </returns>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of columns. </summary>
+        ///
+        /// <returns> The number of columns. </returns>
+        size_t NumColumns() const { return _numColumns; }
+
+        /// <summary> Gets the number of stored elements, padding included. </summary>
+        ///
+        /// <returns> The number of stored elements. </returns>
+        size_t NumStoredElements() const { return _data.size(); }
+
+        /// <summary> Gets the number of diagonals below the main diagonal. </summary>
+        ///
+        /// <returns> The lower bandwidth. </returns>
+        size_t GetLowerBandwidth() const { return _lowerBandwidth; }
+
+        /// <summary> Gets the number of diagonals above the main diagonal. </summary>
+        ///
+        /// <returns> The upper bandwidth. </returns>
+        size_t GetUpperBandwidth() const { return _upperBandwidth; }
+
+        /// <summary> Gets an element, zero outside the band. </summary>
+        ///
+        /// <param name="row"> The row index. </param>
+        /// <param name="column"> The column index. </param>
+        ///
+        /// <returns> The element. </returns>
+        ElementType operator()(size_t row, size_t column) const;
+
+        /// <summary> Gets the first stored column of a row. </summary>
+        size_t GetRowBegin(size_t row) const { return row > _lowerBandwidth ? row - _lowerBandwidth : 0; }
+
+        /// <summary> Gets one past the last stored column of a row. </summary>
+        size_t GetRowEnd(size_t row) const;
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        const ElementType* GetRowPointer(size_t row) const { return _data.data() + GetRowOffset(row); }
+
+        /// <summary> Gets the stored elements of a row. </summary>
+        ElementType* GetRowPointer(size_t row) { return _data.data() + GetRowOffset(row); }
+
+        /// <summary> Gets the transpose, whose bandwidths are swapped. </summary>
+        ///
+        /// <returns> The transpose. </returns>
+        BandedMatrix<ElementType> Transpose() const;
+
+        /// <summary> Copies the matrix to a dense matrix of the same size, zeros included. </summary>
+        ///
+        /// <param name="matrix"> The dense matrix. </param>
+        template <MatrixLayout layout>
+        void CopyTo(MatrixReference<ElementType, layout> matrix) const;
+
+    private:
+        size_t GetRowOffset(size_t row) const { return row * (_lowerBandwidth + _upperBandwidth + 1) + GetRowBegin(row) + _lowerBandwidth - row; }
+
+        size_t _numRows;
+        size_t _numColumns;
+        size_t _lowerBandwidth;
+        size_t _upperBandwidth;
+        std::vector<ElementType> _data;
+    };
+
+    /// <summary> Whether a type is one of the structured matrix types above. </summary>
+    template <typename MatrixType>
+    struct IsStructuredMatrixType : std::false_type
+    {};
+
+    template <typename ElementType>
+    struct IsStructuredMatrixType<DiagonalMatrix<ElementType>> : std::true_type
+    {};
+
+    template <typename ElementType>
+    struct IsStructuredMatrixType<TriangularMatrix<ElementType>> : std::true_type
+    {};
+
+    template <typename ElementType>
+    struct IsStructuredMatrixType<BandedMatrix<ElementType>> : std::true_type
+    {};
+
+    template <typename MatrixType>
+    using IsStructuredMatrix = std::enable_if_t<IsStructuredMatrixType<MatrixType>::value, bool>;
+
+    /// <summary> Multiplies a structured matrix by a column vector, vectorB = scalarA * matrix * vectorA + scalarB * vectorB. </summary>
+    ///
+    /// <typeparam name="StructuredMatrixType"> DiagonalMatrix, TriangularMatrix or BandedMatrix. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="matrix"> The structured matrix. </param>
+    /// <param name="vectorA"> The column vector. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept = true>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const StructuredMatrixType& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB);
+
+    /// <summary> Multiplies a row vector by a structured matrix, vectorB = scalarA * vectorA * matrix + scalarB * vectorB. </summary>
+    ///
+    /// <typeparam name="StructuredMatrixType"> DiagonalMatrix, TriangularMatrix or BandedMatrix. </typeparam>
+    /// <param name="scalarA"> The scalar that multiplies the product. </param>
+    /// <param name="vectorA"> The row vector. </param>
+    /// <param name="matrix"> The structured matrix. </param>
+    /// <param name="scalarB"> The scalar that multiplies vectorB, when zero vectorB is not read. </param>
+    /// <param name="vectorB"> The result vector. </param>
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept = true>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const StructuredMatrixType& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB);
+
+    /// <summary> Multiplies a structured matrix by a scalar in place, matrix *= scalar. </summary>
+    ///
+    /// <typeparam name="StructuredMatrixType"> DiagonalMatrix, TriangularMatrix or BandedMatrix. </typeparam>
+    /// <param name="scalar"> The scalar. </param>
+    /// <param name="matrix"> The structured matrix. </param>
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept = true>
+    void ScaleUpdate(ElementType scalar, StructuredMatrixType& matrix);
+
+    /// <summary> Solves matrix * x = vector in place, with a division per element. </summary>
+    ///
+    /// <param name="matrix"> The diagonal matrix. </param>
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    template <typename ElementType>
+    void SolveUpdate(const DiagonalMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector);
+
+    /// <summary> Solves x * matrix = vector in place, with a division per element. </summary>
+    ///
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    /// <param name="matrix"> The diagonal matrix. </param>
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const DiagonalMatrix<ElementType>& matrix);
+
+    /// <summary> Solves matrix * x = vector in place, by forward (lower) or backward (upper) substitution. </summary>
+    ///
+    /// <param name="matrix"> The triangular matrix. </param>
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    template <typename ElementType>
+    void SolveUpdate(const TriangularMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector);
+
+    /// <summary>
+    /// Solves x * matrix = vector in place, that is transpose(matrix) * x = vector, by substitution along the packed
+    /// rows of the matrix.
+    /// </summary>
+    ///
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    /// <param name="matrix"> The triangular matrix. </param>
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const TriangularMatrix<ElementType>& matrix);
+
+    /// <summary>
+    /// Solves matrix * x = vector in place for a square banded matrix, by Gaussian elimination with partial pivoting
+    /// inside the band. Pivoting widens the upper band by lowerBandwidth, so the work is proportional to
+    /// size * lowerBandwidth * (lowerBandwidth + upperBandwidth).
+    /// </summary>
+    ///
+    /// <param name="matrix"> The banded matrix. </param>
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    template <typename ElementType>
+    void SolveUpdate(const BandedMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector);
+
+    /// <summary> Solves x * matrix = vector in place for a square banded matrix, as the column vector overload does for the transpose. </summary>
+    ///
+    /// <param name="vector"> The right hand side, replaced by the solution. </param>
+    /// <param name="matrix"> The banded matrix. </param>
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const BandedMatrix<ElementType>& matrix);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        template <typename StructuredMatrixType, typename ElementType, MatrixLayout layout>
+        void CopyStructuredFrom(StructuredMatrixType& target, ConstMatrixReference<ElementType, layout> matrix)
+        {
+            for (size_t i = 0; i < target.NumRows(); ++i)
+            {
+                ElementType* pRow = target.GetRowPointer(i);
+                for (size_t j = target.GetRowBegin(i); j < target.GetRowEnd(i); ++j)
+                {
+                    pRow[j - target.GetRowBegin(i)] = matrix(i, j);
+                }
+            }
+        }
+
+        template <typename StructuredMatrixType, typename ElementType, MatrixLayout layout>
+        void CopyStructuredTo(const StructuredMatrixType& source, MatrixReference<ElementType, layout> matrix)
+        {
+            if (matrix.NumRows() != source.NumRows() || matrix.NumColumns() != source.NumColumns())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The dense matrix must have the size of the structured matrix.");
+            }
+            matrix.Fill(0);
+            for (size_t i = 0; i < source.NumRows(); ++i)
+            {
+                const ElementType* pRow = source.GetRowPointer(i);
+                for (size_t j = source.GetRowBegin(i); j < source.GetRowEnd(i); ++j)
+                {
+                    matrix(i, j) = pRow[j - source.GetRowBegin(i)];
+                }
+            }
+        }
+
+        template <typename StructuredMatrixType>
+        size_t GetStructuredRowGrainSize(const StructuredMatrixType& matrix)
+        {
+            size_t averageRowSize = matrix.NumStoredElements() / std::max<size_t>(matrix.NumRows(), 1);
+            return std::max<size_t>(1, minElementsPerTask / std::max<size_t>(averageRowSize, 1));
+        }
+
+        inline void CheckSquare(size_t numRows, size_t numColumns)
+        {
+            if (numRows != numColumns)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "Only square matrices can be solved.");
+            }
+        }
+
+        template <typename ElementType>
+        ElementType CheckPivot(ElementType pivot)
+        {
+            if (pivot == 0)
+            {
+                throw utilities::NumericException(utilities::NumericExceptionErrors::divideByZero, "The matrix is singular.");
+            }
+            return pivot;
+        }
+
+        // y = alpha * M * x + beta * y, one dot product per row, rows split across the thread pool
+        template <typename StructuredMatrixType, typename ElementType>
+        void MultiplyStructuredRows(ElementType alpha, const StructuredMatrixType& matrix, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement)
+        {
+            utilities::ParallelFor(matrix.NumRows(), GetStructuredRowGrainSize(matrix), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const ElementType* pRow = matrix.GetRowPointer(i);
+                    size_t rowBegin = matrix.GetRowBegin(i);
+                    size_t rowSize = matrix.GetRowEnd(i) - rowBegin;
+                    const ElementType* pRowX = pX + rowBegin * xIncrement;
+                    ElementType sum = 0;
+                    for (size_t j = 0; j < rowSize; ++j)
+                    {
+                        sum += pRow[j] * pRowX[j * xIncrement];
+                    }
+                    ElementType& y = pY[i * yIncrement];
+                    y = beta == 0 ? alpha * sum : alpha * sum + beta * y;
+                }
+            });
+        }
+
+        // the rows [first, last) of a matrix that store elements in the columns [begin, end)
+        template <typename ElementType>
+        std::pair<size_t, size_t> GetRowsInColumns(const DiagonalMatrix<ElementType>& matrix, size_t begin, size_t end)
+        {
+            return { std::min(begin, matrix.NumRows()), std::min(end, matrix.NumRows()) };
+        }
+
+        template <typename ElementType>
+        std::pair<size_t, size_t> GetRowsInColumns(const TriangularMatrix<ElementType>& matrix, size_t begin, size_t end)
+        {
+            // row i of a lower triangle ends at column i + 1, and row i of an upper triangle starts at column i
+            size_t numRows = matrix.NumRows();
+            if (matrix.GetTriangle() == MatrixTriangle::lower)
+            {
+                return { std::min(begin, numRows), numRows };
+            }
+            return { 0, std::min(end, numRows) };
+        }
+
+        template <typename ElementType>
+        std::pair<size_t, size_t> GetRowsInColumns(const BandedMatrix<ElementType>& matrix, size_t begin, size_t end)
+        {
+            // row i stores the columns [i - lowerBandwidth, i + upperBandwidth]
+            size_t numRows = matrix.NumRows();
+            size_t upper = matrix.GetUpperBandwidth();
+            size_t first = begin > upper ? begin - upper : 0;
+            return { std::min(first, numRows), std::min(end + matrix.GetLowerBandwidth(), numRows) };
+        }
+
+        // y = alpha * transpose(M) * x + beta * y; each task owns a range of elements of y and adds the part of every
+        // row that falls in it, so that no two tasks write the same element; it only visits the rows that reach its
+        // range, so the work is proportional to the stored elements
+        template <typename StructuredMatrixType, typename ElementType>
+        void MultiplyStructuredColumns(ElementType alpha, const StructuredMatrixType& matrix, const ElementType* pX, size_t xIncrement, ElementType beta, ElementType* pY, size_t yIncrement)
+        {
+            size_t numColumns = matrix.NumColumns();
+            size_t averageColumnSize = matrix.NumStoredElements() / std::max<size_t>(numColumns, 1);
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(averageColumnSize, 1));
+            utilities::ParallelFor(numColumns, grainSize, [&](size_t begin, size_t end) {
+                for (size_t j = begin; j < end; ++j)
+                {
+                    ElementType& y = pY[j * yIncrement];
+                    y = beta == 0 ? 0 : beta * y;
+                }
+                auto rows = GetRowsInColumns(matrix, begin, end);
+                for (size_t i = rows.first; i < rows.second; ++i)
+                {
+                    size_t rowBegin = matrix.GetRowBegin(i);
+                    size_t first = std::max(begin, rowBegin);
+                    size_t last = std::min(end, matrix.GetRowEnd(i));
+                    ElementType x = alpha * pX[i * xIncrement];
+                    const ElementType* pRow = matrix.GetRowPointer(i) - rowBegin;
+                    for (size_t j = first; j < last; ++j)
+                    {
+                        pY[j * yIncrement] += pRow[j] * x;
+                    }
+                }
+            });
+        }
+    } // namespace Internal
+
+    //
+    // DiagonalMatrix
+    //
+
+    template <typename ElementType>
+    DiagonalMatrix<ElementType>::DiagonalMatrix(size_t size) :
+        _diagonal(size)
+    {}
+
+    template <typename ElementType>
+    DiagonalMatrix<ElementType>::DiagonalMatrix(std::vector<ElementType> diagonal) :
+        _diagonal(std::move(diagonal))
+    {}
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    DiagonalMatrix<ElementType>::DiagonalMatrix(ConstMatrixReference<ElementType, layout> matrix) :
+        _diagonal(matrix.NumRows())
+    {
+        Internal::CheckSquare(matrix.NumRows(), matrix.NumColumns());
+        Internal::CopyStructuredFrom(*this, matrix);
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void DiagonalMatrix<ElementType>::CopyTo(MatrixReference<ElementType, layout> matrix) const
+    {
+        Internal::CopyStructuredTo(*this, matrix);
+    }
+
+    //
+    // TriangularMatrix
+    //
+
+    template <typename ElementType>
+    TriangularMatrix<ElementType>::TriangularMatrix(size_t size, MatrixTriangle triangle) :
+        _size(size),
+        _triangle(triangle),
+        _data(size * (size + 1) / 2)
+    {}
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    TriangularMatrix<ElementType>::TriangularMatrix(ConstMatrixReference<ElementType, layout> matrix, MatrixTriangle triangle) :
+        TriangularMatrix(matrix.NumRows(), triangle)
+    {
+        Internal::CheckSquare(matrix.NumRows(), matrix.NumColumns());
+        Internal::CopyStructuredFrom(*this, matrix);
+    }
+
+    template <typename ElementType>
+    ElementType TriangularMatrix<ElementType>::operator()(size_t row, size_t column) const
+    {
+        if (column < GetRowBegin(row) || column >= GetRowEnd(row))
+        {
+            return 0;
+        }
+        return GetRowPointer(row)[column - GetRowBegin(row)];
+    }
+
+    template <typename ElementType>
+    size_t TriangularMatrix<ElementType>::GetRowOffset(size_t row) const
+    {
+        // lower rows hold 1, 2, ... elements and upper rows hold size, size - 1, ... elements
+        return _triangle == MatrixTriangle::lower ? row * (row + 1) / 2 : row * _size - row * (row - 1) / 2;
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void TriangularMatrix<ElementType>::CopyTo(MatrixReference<ElementType, layout> matrix) const
+    {
+        Internal::CopyStructuredTo(*this, matrix);
+    }
+
+    //
+    // BandedMatrix
+    //
+
+    template <typename ElementType>
+    BandedMatrix<ElementType>::BandedMatrix(size_t numRows, size_t numColumns, size_t lowerBandwidth, size_t upperBandwidth) :
+        _numRows(numRows),
+        _numColumns(numColumns),
+        _lowerBandwidth(lowerBandwidth),
+        _upperBandwidth(upperBandwidth),
+        _data(numRows * (lowerBandwidth + upperBandwidth + 1))
+    {}
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    BandedMatrix<ElementType>::BandedMatrix(ConstMatrixReference<ElementType, layout> matrix, size_t lowerBandwidth, size_t upperBandwidth) :
+        BandedMatrix(matrix.NumRows(), matrix.NumColumns(), lowerBandwidth, upperBandwidth)
+    {
+        Internal::CopyStructuredFrom(*this, matrix);
+    }
+
+    template <typename ElementType>
+    ElementType BandedMatrix<ElementType>::operator()(size_t row, size_t column) const
+    {
+        if (column < GetRowBegin(row) || column >= GetRowEnd(row))
+        {
+            return 0;
+        }
+        return GetRowPointer(row)[column - GetRowBegin(row)];
+    }
+
+    template <typename ElementType>
+    size_t BandedMatrix<ElementType>::GetRowEnd(size_t row) const
+    {
+        // rows below the last column have an empty band
+        return std::max(GetRowBegin(row), std::min(_numColumns, row + _upperBandwidth + 1));
+    }
+
+    template <typename ElementType>
+    BandedMatrix<ElementType> BandedMatrix<ElementType>::Transpose() const
+    {
+        BandedMatrix<ElementType> transpose(_numColumns, _numRows, _upperBandwidth, _lowerBandwidth);
+        for (size_t i = 0; i < _numRows; ++i)
+        {
+            const ElementType* pRow = GetRowPointer(i);
+            for (size_t j = GetRowBegin(i); j < GetRowEnd(i); ++j)
+            {
+                transpose.GetRowPointer(j)[i - transpose.GetRowBegin(j)] = pRow[j - GetRowBegin(i)];
+            }
+        }
+        return transpose;
+    }
+
+    template <typename ElementType>
+    template <MatrixLayout layout>
+    void BandedMatrix<ElementType>::CopyTo(MatrixReference<ElementType, layout> matrix) const
+    {
+        Internal::CopyStructuredTo(*this, matrix);
+    }
+
+    //
+    // Kernels
+    //
+
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept>
+    void MultiplyScaleAddUpdate(ElementType scalarA, const StructuredMatrixType& matrix, ConstColumnVectorReference<ElementType> vectorA, ElementType scalarB, ColumnVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumColumns() != vectorA.Size() || matrix.NumRows() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        Internal::MultiplyStructuredRows(scalarA, matrix, vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+    }
+
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept>
+    void MultiplyScaleAddUpdate(ElementType scalarA, ConstRowVectorReference<ElementType> vectorA, const StructuredMatrixType& matrix, ElementType scalarB, RowVectorReference<ElementType> vectorB)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vectorA.Size() || matrix.NumColumns() != vectorB.Size(), "Incompatible matrix vector sizes.");
+
+        Internal::MultiplyStructuredColumns(scalarA, matrix, vectorA.GetConstDataPointer(), vectorA.GetIncrement(), scalarB, vectorB.GetDataPointer(), vectorB.GetIncrement());
+    }
+
+    template <typename ElementType, typename StructuredMatrixType, IsStructuredMatrix<StructuredMatrixType> concept>
+    void ScaleUpdate(ElementType scalar, StructuredMatrixType& matrix)
+    {
+        utilities::ParallelFor(matrix.NumRows(), Internal::GetStructuredRowGrainSize(matrix), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                ElementType* pRow = matrix.GetRowPointer(i);
+                size_t rowSize = matrix.GetRowEnd(i) - matrix.GetRowBegin(i);
+                for (size_t j = 0; j < rowSize; ++j)
+                {
+                    pRow[j] *= scalar;
+                }
+            }
+        });
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(const DiagonalMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vector.Size(), "Incompatible matrix vector sizes.");
+
+        for (size_t i = 0; i < vector.Size(); ++i)
+        {
+            vector[i] /= Internal::CheckPivot(*matrix.GetRowPointer(i));
+        }
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const DiagonalMatrix<ElementType>& matrix)
+    {
+        SolveUpdate(matrix, vector.Transpose());
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(const TriangularMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vector.Size(), "Incompatible matrix vector sizes.");
+
+        // x[i] = (b[i] - row i . x) / diagonal, where the row excludes the diagonal and only covers solved elements
+        const size_t size = matrix.NumRows();
+        const bool isLower = matrix.GetTriangle() == MatrixTriangle::lower;
+        for (size_t step = 0; step < size; ++step)
+        {
+            size_t i = isLower ? step : size - 1 - step;
+            const ElementType* pRow = matrix.GetRowPointer(i) - matrix.GetRowBegin(i);
+            size_t first = isLower ? 0 : i + 1;
+            size_t last = isLower ? i : size;
+            ElementType sum = vector[i];
+            for (size_t j = first; j < last; ++j)
+            {
+                sum -= pRow[j] * vector[j];
+            }
+            vector[i] = sum / Internal::CheckPivot(pRow[i]);
+        }
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const TriangularMatrix<ElementType>& matrix)
+    {
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vector.Size(), "Incompatible matrix vector sizes.");
+
+        // transpose(lower) is upper, so the rows are taken last to first; each solved x[i] is removed from the right
+        // hand side of the remaining elements along row i
+        const size_t size = matrix.NumRows();
+        const bool isLower = matrix.GetTriangle() == MatrixTriangle::lower;
+        for (size_t step = 0; step < size; ++step)
+        {
+            size_t i = isLower ? size - 1 - step : step;
+            const ElementType* pRow = matrix.GetRowPointer(i) - matrix.GetRowBegin(i);
+            ElementType x = vector[i] / Internal::CheckPivot(pRow[i]);
+            vector[i] = x;
+            size_t first = isLower ? 0 : i + 1;
+            size_t last = isLower ? i : size;
+            for (size_t j = first; j < last; ++j)
+            {
+                vector[j] -= pRow[j] * x;
+            }
+        }
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(const BandedMatrix<ElementType>& matrix, ColumnVectorReference<ElementType> vector)
+    {
+        Internal::CheckSquare(matrix.NumRows(), matrix.NumColumns());
+        DEBUG_CHECK_SIZES(matrix.NumRows() != vector.Size(), "Incompatible matrix vector sizes.");
+
+        // a working copy whose rows cover columns [i - lower, i + lower + upper], the room that row swaps need
+        const size_t size = matrix.NumRows();
+        const size_t lower = matrix.GetLowerBandwidth();
+        const size_t upper = matrix.GetUpperBandwidth() + lower;
+        const size_t width = 2 * lower + matrix.GetUpperBandwidth() + 1;
+        std::vector<ElementType> work(size * width);
+        auto W = [&](size_t i, size_t j) -> ElementType& { return work[i * width + j + lower - i]; };
+        for (size_t i = 0; i < size; ++i)
+        {
+            const ElementType* pRow = matrix.GetRowPointer(i);
+            for (size_t j = matrix.GetRowBegin(i); j < matrix.GetRowEnd(i); ++j)
+            {
+                W(i, j) = pRow[j - matrix.GetRowBegin(i)];
+            }
+        }
+
+        // forward elimination with partial pivoting among the rows that reach column k
+        for (size_t k = 0; k < size; ++k)
+        {
+            size_t lastRow = std::min(size - 1, k + lower);
+            size_t lastColumn = std::min(size - 1, k + upper);
+            size_t pivotRow = k;
+            for (size_t i = k + 1; i <= lastRow; ++i)
+            {
+                if (std::abs(W(i, k)) > std::abs(W(pivotRow, k)))
+                {
+                    pivotRow = i;
+                }
+            }
+            if (pivotRow != k)
+            {
+                for (size_t j = k; j <= lastColumn; ++j)
+                {
+                    std::swap(W(k, j), W(pivotRow, j));
+                }
+                std::swap(vector[k], vector[pivotRow]);
+            }
+
+            ElementType pivot = Internal::CheckPivot(W(k, k));
+            for (size_t i = k + 1; i <= lastRow; ++i)
+            {
+                ElementType factor = W(i, k) / pivot;
+                if (factor == 0)
+                {
+                    continue;
+                }
+                for (size_t j = k + 1; j <= lastColumn; ++j)
+                {
+                    W(i, j) -= factor * W(k, j);
+                }
+                vector[i] -= factor * vector[k];
+            }
+        }
+
+        // back substitution with the widened upper band
+        for (size_t step = 0; step < size; ++step)
+        {
+            size_t i = size - 1 - step;
+            size_t lastColumn = std::min(size - 1, i + upper);
+            ElementType sum = vector[i];
+            for (size_t j = i + 1; j <= lastColumn; ++j)
+            {
+                sum -= W(i, j) * vector[j];
+            }
+            vector[i] = sum / W(i, i);
+        }
+    }
+
+    template <typename ElementType>
+    void SolveUpdate(RowVectorReference<ElementType> vector, const BandedMatrix<ElementType>& matrix)
+    {
+        SolveUpdate(matrix.Transpose(), vector.Transpose());
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
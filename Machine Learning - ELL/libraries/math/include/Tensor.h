@@ -560,6 +560,21 @@ namespace ell
         template <Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
         void CopyFrom(ConstTensorReference<ElementType, otherDimension0, otherDimension1, otherDimension2> other);
 
+        /// <summary>
+        /// Copies values from a tensor with another element type into this tensor, converting each element as
+        /// ConvertElements does. The conversion is fused with the change of memory layout, so that, for example, an
+        /// 8-bit channel-major image becomes a normalized floating point tensor in any layout in one pass.
+        /// </summary>
+        ///
+        /// <typeparam name="OtherElementType"> The element type of the other Tensor. </typeparam>
+        /// <typeparam name="otherDimension0"> Dimension 0 of the other Tensor. </typeparam>
+        /// <typeparam name="otherDimension1"> Dimension 1 of the other Tensor. </typeparam>
+        /// <typeparam name="otherDimension2"> Dimension 2 of the other Tensor. </typeparam>
+        /// <param name="other"> The other tensor. </param>
+        /// <param name="options"> The scale and saturation of the conversion. </param>
+        template <typename OtherElementType, Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
+        void CopyFrom(ConstTensorReference<OtherElementType, otherDimension0, otherDimension1, otherDimension2> other, ConversionOptions options = {});
+
         /// <summary> Sets all Tensor elements to zero. </summary>
         void Reset() { Fill(0); }
 
@@ -910,12 +925,39 @@ namespace ell
 
 #pragma region implementation
 
+#include "TensorPermutationKernels.h"
+
 #include <algorithm>
 
 namespace ell
 {
 namespace math
 {
+    namespace Internal
+    {
+        // the memory increments of a tensor layout, indexed by row, column and channel
+        template <Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        LogicalTriplet GetLogicalIncrements(size_t increment1, size_t increment2)
+        {
+            LogicalTriplet increments;
+            increments[static_cast<size_t>(dimension0)] = 1;
+            increments[static_cast<size_t>(dimension1)] = increment1;
+            increments[static_cast<size_t>(dimension2)] = increment2;
+            return increments;
+        }
+
+        template <typename OtherElementType, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
+        void CopyTensor(ConstTensorReference<OtherElementType, otherDimension0, otherDimension1, otherDimension2> source, TensorReference<ElementType, dimension0, dimension1, dimension2> target, ConversionOptions options = {})
+        {
+            PermuteCopy(source.GetConstDataPointer(),
+                        GetLogicalIncrements<otherDimension0, otherDimension1, otherDimension2>(source.GetIncrement1(), source.GetIncrement2()),
+                        target.GetDataPointer(),
+                        GetLogicalIncrements<dimension0, dimension1, dimension2>(target.GetIncrement1(), target.GetIncrement2()),
+                        LogicalTriplet{ target.NumRows(), target.NumColumns(), target.NumChannels() },
+                        options);
+        }
+    } // namespace Internal
+
     //
     // TensorMatrixSlicers
     //
@@ -1437,11 +1479,7 @@ namespace math
         DEBUG_CHECK_SIZES(this->NumColumns() != other.NumColumns(), "Tensors must have the same number of columns");
         DEBUG_CHECK_SIZES(this->NumChannels() != other.NumChannels(), "Tensors must have the same number of channels");
 
-        for (size_t i = 0; i < this->NumPrimarySlices(); ++i)
-        {
-            auto slice = other.GetPrimarySlice(i);
-            GetPrimarySlice(i).CopyFrom(slice);
-        }
+        Internal::CopyTensor(other, *this);
     }
 
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
@@ -1451,10 +1489,7 @@ namespace math
         DEBUG_CHECK_SIZES(this->NumColumns() != other.NumColumns(), "Tensors must have the same number of columns");
         DEBUG_CHECK_SIZES(this->NumChannels() != other.NumChannels(), "Tensors must have the same number of channels");
 
-        for (size_t i = 0; i < NumSlices<dimension0, dimension1>(*this); ++i)
-        {
-            this->template GetSlice<dimension0, dimension1>(i).CopyFrom(GetSlice<dimension0, dimension1>(other, i));
-        }
+        Internal::CopyTensor(other, *this);
     }
 
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
@@ -1465,12 +1500,18 @@ namespace math
         DEBUG_CHECK_SIZES(this->NumColumns() != other.NumColumns(), "Tensors must have the same number of columns");
         DEBUG_CHECK_SIZES(this->NumChannels() != other.NumChannels(), "Tensors must have the same number of channels");
 
-        for (size_t i = 0; i < math::NumSlices<dimension0, otherDimension0>(*this); ++i)
-        {
-            auto thisSlice = this->template GetSlice<dimension0, otherDimension0>(i);
-            auto otherSlice = other.template GetSlice<dimension0, otherDimension0>(i);
-            thisSlice.CopyFrom(otherSlice);
-        }
+        Internal::CopyTensor(other, *this);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    template <typename OtherElementType, Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
+    void TensorReference<ElementType, dimension0, dimension1, dimension2>::CopyFrom(ConstTensorReference<OtherElementType, otherDimension0, otherDimension1, otherDimension2> other, ConversionOptions options)
+    {
+        DEBUG_CHECK_SIZES(this->NumRows() != other.NumRows(), "Tensors must have the same number of rows");
+        DEBUG_CHECK_SIZES(this->NumColumns() != other.NumColumns(), "Tensors must have the same number of columns");
+        DEBUG_CHECK_SIZES(this->NumChannels() != other.NumChannels(), "Tensors must have the same number of channels");
+
+        Internal::CopyTensor(other, *this, options);
     }
 
     template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
@@ -0,0 +1,392 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TensorBatch.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Tensor.h"
+
+#include <utilities/include/Debug.h>
+#include <utilities/include/Exception.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// A const reference to a batch of tensors of the same shape and layout, stored one after the other in a
+    /// single buffer: the batch is the outermost (fourth) dimension. A ConstTensorBatchReference does not own
+    /// its memory.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> Tensor element type. </typeparam>
+    /// <typeparam name="dimension0"> The contiguous dimension of each tensor. </typeparam>
+    /// <typeparam name="dimension1"> The dimension of each tensor with a minor memory increment. </typeparam>
+    /// <typeparam name="dimension2"> The dimension of each tensor with a major memory increment. </typeparam>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    class ConstTensorBatchReference
+    {
+    public:
+        /// <summary> Constructs a reference to a batch of contiguous tensors stored back to back. </summary>
+        ///
+        /// <param name="pData"> A pointer to the first element of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        /// <param name="shape"> The shape of each tensor (in logical coordinates: row, column, channel). </param>
+        ConstTensorBatchReference(const ElementType* pData, size_t batchSize, TensorShape shape);
+
+        /// <summary> Constructs a reference to a batch of contiguous tensors with a gap between them. </summary>
+        ///
+        /// <param name="pData"> A pointer to the first element of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        /// <param name="shape"> The shape of each tensor (in logical coordinates: row, column, channel). </param>
+        /// <param name="batchIncrement"> The memory offset between consecutive tensors, at least shape.Size(). </param>
+        ConstTensorBatchReference(const ElementType* pData, size_t batchSize, TensorShape shape, size_t batchIncrement);
+
+        /// <summary> Gets the number of tensors in the batch. </summary>
+        ///
+        /// <returns> The batch size. </returns>
+        size_t BatchSize() const { return _batchSize; }
+
+        /// <summary> Gets the shape of each tensor. </summary>
+        ///
+        /// <returns> The tensor shape. </returns>
+        TensorShape GetShape() const { return _shape; }
+
+        /// <summary> Gets the total number of elements in the batch. </summary>
+        ///
+        /// <returns> The number of elements. </returns>
+        size_t Size() const { return _batchSize * _shape.Size(); }
+
+        /// <summary> Gets the memory offset between consecutive tensors. </summary>
+        ///
+        /// <returns> The memory offset. </returns>
+        size_t GetBatchIncrement() const { return _batchIncrement; }
+
+        /// <summary> Gets a const pointer to the underlying data storage. </summary>
+        ///
+        /// <returns> Const pointer to the data. </returns>
+        const ElementType* GetConstDataPointer() const { return _pData; }
+
+        /// <summary> Determines if the whole batch is stored in contiguous memory. </summary>
+        ///
+        /// <returns> True if contiguous, false if not. </returns>
+        bool IsContiguous() const { return _batchSize <= 1 || _batchIncrement == _shape.Size(); }
+
+        /// <summary> Element access operator. </summary>
+        ///
+        /// <param name="index"> The index of the tensor in the batch. </param>
+        /// <param name="row"> The row. </param>
+        /// <param name="column"> The column. </param>
+        /// <param name="channel"> The channel. </param>
+        ///
+        /// <returns> A copy of the element. </returns>
+        ElementType operator()(size_t index, size_t row, size_t column, size_t channel) const { return GetTensor(index)(row, column, channel); }
+
+        /// <summary> Gets a const reference to one tensor of the batch. </summary>
+        ///
+        /// <param name="index"> The index of the tensor in the batch. </param>
+        ///
+        /// <returns> The tensor. </returns>
+        ConstTensorReference<ElementType, dimension0, dimension1, dimension2> GetTensor(size_t index) const;
+
+        /// <summary> Gets a const reference to a range of consecutive tensors of the batch. </summary>
+        ///
+        /// <param name="firstIndex"> The index of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        ///
+        /// <returns> The sub-batch. </returns>
+        ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2> GetSubBatch(size_t firstIndex, size_t batchSize) const;
+
+        /// <summary> Gets a const reference to this batch. </summary>
+        ///
+        /// <returns> A const reference to this batch. </returns>
+        ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2> GetConstReference() const { return *this; }
+
+        /// <summary> Determines if two batches have the same shape and equal elements. </summary>
+        ///
+        /// <param name="other"> The other batch. </param>
+        /// <param name="tolerance"> The element comparison tolerance. </param>
+        ///
+        /// <returns> true if the two batches are equivalent. </returns>
+        bool IsEqual(ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2> other, ElementType tolerance = 1.0e-8) const;
+
+    protected:
+        const ElementType* _pData;
+        size_t _batchSize;
+        TensorShape _shape;
+        size_t _batchIncrement;
+    };
+
+    /// <summary> A reference to a batch of tensors stored in a single buffer, see ConstTensorBatchReference. </summary>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    class TensorBatchReference : public ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>
+    {
+    public:
+        using ConstTensorBatchRef = ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>;
+
+        /// <summary> Constructs a reference to a batch of contiguous tensors stored back to back. </summary>
+        ///
+        /// <param name="pData"> A pointer to the first element of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        /// <param name="shape"> The shape of each tensor (in logical coordinates: row, column, channel). </param>
+        TensorBatchReference(ElementType* pData, size_t batchSize, TensorShape shape);
+
+        /// <summary> Constructs a reference to a batch of contiguous tensors with a gap between them. </summary>
+        ///
+        /// <param name="pData"> A pointer to the first element of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        /// <param name="shape"> The shape of each tensor (in logical coordinates: row, column, channel). </param>
+        /// <param name="batchIncrement"> The memory offset between consecutive tensors, at least shape.Size(). </param>
+        TensorBatchReference(ElementType* pData, size_t batchSize, TensorShape shape, size_t batchIncrement);
+
+        using ConstTensorBatchRef::operator();
+        using ConstTensorBatchRef::GetSubBatch;
+        using ConstTensorBatchRef::GetTensor;
+
+        /// <summary> Gets a pointer to the underlying data storage. </summary>
+        ///
+        /// <returns> Pointer to the data. </returns>
+        ElementType* GetDataPointer() { return const_cast<ElementType*>(this->_pData); }
+
+        /// <summary> Element access operator. </summary>
+        ///
+        /// <param name="index"> The index of the tensor in the batch. </param>
+        /// <param name="row"> The row. </param>
+        /// <param name="column"> The column. </param>
+        /// <param name="channel"> The channel. </param>
+        ///
+        /// <returns> A reference to the element. </returns>
+        ElementType& operator()(size_t index, size_t row, size_t column, size_t channel) { return GetTensor(index)(row, column, channel); }
+
+        /// <summary> Gets a reference to one tensor of the batch. </summary>
+        ///
+        /// <param name="index"> The index of the tensor in the batch. </param>
+        ///
+        /// <returns> The tensor. </returns>
+        TensorReference<ElementType, dimension0, dimension1, dimension2> GetTensor(size_t index);
+
+        /// <summary> Gets a reference to a range of consecutive tensors of the batch. </summary>
+        ///
+        /// <param name="firstIndex"> The index of the first tensor. </param>
+        /// <param name="batchSize"> The number of tensors. </param>
+        ///
+        /// <returns> The sub-batch. </returns>
+        TensorBatchReference<ElementType, dimension0, dimension1, dimension2> GetSubBatch(size_t firstIndex, size_t batchSize);
+
+        /// <summary> Gets a reference to this batch. </summary>
+        ///
+        /// <returns> A reference to this batch. </returns>
+        TensorBatchReference<ElementType, dimension0, dimension1, dimension2> GetReference() { return *this; }
+
+        /// <summary> Sets all the elements of the batch to a value. </summary>
+        ///
+        /// <param name="value"> The value. </param>
+        void Fill(ElementType value);
+
+        /// <summary> Copies one tensor into the batch. </summary>
+        ///
+        /// <param name="index"> The index of the tensor in the batch. </param>
+        /// <param name="tensor"> The tensor to copy, with the shape of the batch. </param>
+        template <Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
+        void CopyTensor(size_t index, ConstTensorReference<ElementType, otherDimension0, otherDimension1, otherDimension2> tensor);
+    };
+
+    /// <summary> A batch of tensors that owns one contiguous buffer, see ConstTensorBatchReference. </summary>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    class TensorBatch : public TensorBatchReference<ElementType, dimension0, dimension1, dimension2>
+    {
+    public:
+        /// <summary> Constructs a batch of zero tensors. </summary>
+        ///
+        /// <param name="batchSize"> The number of tensors. </param>
+        /// <param name="shape"> The shape of each tensor (in logical coordinates: row, column, channel). </param>
+        TensorBatch(size_t batchSize, TensorShape shape);
+
+        /// <summary> Copy constructor. </summary>
+        ///
+        /// <param name="other"> The other batch. </param>
+        TensorBatch(const TensorBatch<ElementType, dimension0, dimension1, dimension2>& other);
+
+        /// <summary> Assignment operator. </summary>
+        ///
+        /// <param name="other"> The other batch. </param>
+        ///
+        /// <returns> A reference to this batch. </returns>
+        TensorBatch<ElementType, dimension0, dimension1, dimension2>& operator=(TensorBatch<ElementType, dimension0, dimension1, dimension2> other);
+
+        /// <summary> Returns a copy of the contents of the batch. </summary>
+        ///
+        /// <returns> A std::vector with the elements of all the tensors, one tensor after the other. </returns>
+        std::vector<ElementType> ToArray() const { return _data; }
+
+    private:
+        std::vector<ElementType> _data;
+    };
+
+    template <typename ElementType>
+    using ChannelColumnRowTensorBatch = TensorBatch<ElementType, Dimension::channel, Dimension::column, Dimension::row>;
+
+    template <typename ElementType>
+    using ColumnRowChannelTensorBatch = TensorBatch<ElementType, Dimension::column, Dimension::row, Dimension::channel>;
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <algorithm>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>::ConstTensorBatchReference(const ElementType* pData, size_t batchSize, TensorShape shape) :
+        ConstTensorBatchReference(pData, batchSize, shape, shape.Size())
+    {}
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>::ConstTensorBatchReference(const ElementType* pData, size_t batchSize, TensorShape shape, size_t batchIncrement) :
+        _pData(pData),
+        _batchSize(batchSize),
+        _shape(shape),
+        _batchIncrement(batchIncrement)
+    {
+        if (batchIncrement < shape.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "batch increment is smaller than the tensor size.");
+        }
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>::GetTensor(size_t index) const
+    {
+        DEBUG_THROW(index >= _batchSize, utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "index exceeds batch size."));
+
+        return { _pData + index * _batchIncrement, _shape };
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2> ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>::GetSubBatch(size_t firstIndex, size_t batchSize) const
+    {
+        DEBUG_THROW(firstIndex + batchSize > _batchSize, utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "sub-batch exceeds batch size."));
+
+        return { _pData + firstIndex * _batchIncrement, batchSize, _shape, _batchIncrement };
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    bool ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2>::IsEqual(ConstTensorBatchReference<ElementType, dimension0, dimension1, dimension2> other, ElementType tolerance) const
+    {
+        if (_batchSize != other._batchSize || _shape != other._shape)
+        {
+            return false;
+        }
+        for (size_t index = 0; index < _batchSize; ++index)
+        {
+            if (!GetTensor(index).IsEqual(other.GetTensor(index), tolerance))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::TensorBatchReference(ElementType* pData, size_t batchSize, TensorShape shape) :
+        ConstTensorBatchRef(pData, batchSize, shape)
+    {}
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::TensorBatchReference(ElementType* pData, size_t batchSize, TensorShape shape, size_t batchIncrement) :
+        ConstTensorBatchRef(pData, batchSize, shape, batchIncrement)
+    {}
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::GetTensor(size_t index)
+    {
+        DEBUG_THROW(index >= this->_batchSize, utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "index exceeds batch size."));
+
+        auto shape = this->_shape;
+        return { GetDataPointer() + index * this->_batchIncrement, shape.NumRows(), shape.NumColumns(), shape.NumChannels() };
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatchReference<ElementType, dimension0, dimension1, dimension2> TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::GetSubBatch(size_t firstIndex, size_t batchSize)
+    {
+        DEBUG_THROW(firstIndex + batchSize > this->_batchSize, utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "sub-batch exceeds batch size."));
+
+        return { GetDataPointer() + firstIndex * this->_batchIncrement, batchSize, this->_shape, this->_batchIncrement };
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::Fill(ElementType value)
+    {
+        size_t tensorSize = this->_shape.Size();
+        for (size_t index = 0; index < this->_batchSize; ++index)
+        {
+            ElementType* pTensor = GetDataPointer() + index * this->_batchIncrement;
+            std::fill(pTensor, pTensor + tensorSize, value);
+        }
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    template <Dimension otherDimension0, Dimension otherDimension1, Dimension otherDimension2>
+    void TensorBatchReference<ElementType, dimension0, dimension1, dimension2>::CopyTensor(size_t index, ConstTensorReference<ElementType, otherDimension0, otherDimension1, otherDimension2> tensor)
+    {
+        DEBUG_CHECK_SIZES(tensor.GetShape() != this->_shape, "tensor and batch shapes must be the same");
+
+        auto target = GetTensor(index);
+        for (size_t row = 0; row < tensor.NumRows(); ++row)
+        {
+            for (size_t column = 0; column < tensor.NumColumns(); ++column)
+            {
+                for (size_t channel = 0; channel < tensor.NumChannels(); ++channel)
+                {
+                    target(row, column, channel) = tensor(row, column, channel);
+                }
+            }
+        }
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatch<ElementType, dimension0, dimension1, dimension2>::TensorBatch(size_t batchSize, TensorShape shape) :
+        TensorBatchReference<ElementType, dimension0, dimension1, dimension2>(nullptr, batchSize, shape),
+        _data(batchSize * shape.Size())
+    {
+        this->_pData = _data.data();
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatch<ElementType, dimension0, dimension1, dimension2>::TensorBatch(const TensorBatch<ElementType, dimension0, dimension1, dimension2>& other) :
+        TensorBatchReference<ElementType, dimension0, dimension1, dimension2>(nullptr, other.BatchSize(), other.GetShape()),
+        _data(other.Size())
+    {
+        this->_pData = _data.data();
+        for (size_t index = 0; index < other.BatchSize(); ++index)
+        {
+            const ElementType* pTensor = other.GetConstDataPointer() + index * other.GetBatchIncrement();
+            std::copy(pTensor, pTensor + other.GetShape().Size(), _data.data() + index * this->_batchIncrement);
+        }
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorBatch<ElementType, dimension0, dimension1, dimension2>& TensorBatch<ElementType, dimension0, dimension1, dimension2>::operator=(TensorBatch<ElementType, dimension0, dimension1, dimension2> other)
+    {
+        std::swap(this->_batchSize, other._batchSize);
+        std::swap(this->_shape, other._shape);
+        std::swap(this->_batchIncrement, other._batchIncrement);
+        std::swap(_data, other._data);
+        this->_pData = _data.data();
+        return *this;
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,224 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TensorConcatenation.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Tensor.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Plans the concatenation of tensors along one dimension, so that the parts never have to be copied: the
+    /// output is allocated once with GetOutputShape, and each producer writes its part directly into the sub-tensor
+    /// that GetPart returns. Applied to a const tensor, GetPart splits it into the same parts, again without copying.
+    /// The parts are contiguous blocks when the dimension is the outermost one of the tensor layout, for example
+    /// the channels of a ColumnRowChannelTensor, and strided otherwise. The plan only holds shapes, so one plan serves
+    /// every element type and layout, and the output can itself be a part of a larger concatenation.
+    /// </summary>
+    ///
+    /// <typeparam name="dimension"> The dimension along which the parts are concatenated. </typeparam>
+    template <Dimension dimension>
+    class TensorConcatenationPlan
+    {
+    public:
+        /// <summary> Constructs a plan without parts. </summary>
+        TensorConcatenationPlan() = default;
+
+        /// <summary> Constructs a plan for parts of the given shapes, in order. </summary>
+        ///
+        /// <param name="partShapes"> The shapes of the parts, which must agree in the other two dimensions. </param>
+        TensorConcatenationPlan(const std::vector<TensorShape>& partShapes);
+
+        /// <summary> Appends a part to the plan. </summary>
+        ///
+        /// <param name="shape"> The shape of the part, which must agree with the other parts in the other two dimensions. </param>
+        ///
+        /// <returns> The index of the part. </returns>
+        size_t AddPart(TensorShape shape);
+
+        /// <summary> Gets the number of parts. </summary>
+        ///
+        /// <returns> The number of parts. </returns>
+        size_t NumParts() const { return _shapes.size(); }
+
+        /// <summary> Gets the shape of the concatenated output, which is all zeros when there are no parts. </summary>
+        ///
+        /// <returns> The shape of the output. </returns>
+        TensorShape GetOutputShape() const;
+
+        /// <summary> Gets the shape of a part. </summary>
+        ///
+        /// <param name="index"> The index of the part. </param>
+        ///
+        /// <returns> The shape of the part. </returns>
+        TensorShape GetPartShape(size_t index) const { return _shapes[index]; }
+
+        /// <summary> Gets the position of a part along the concatenated dimension of the output. </summary>
+        ///
+        /// <param name="index"> The index of the part. </param>
+        ///
+        /// <returns> The position of the first element of the part along the dimension. </returns>
+        size_t GetPartOffset(size_t index) const { return _offsets[index]; }
+
+        /// <summary> Gets the sub-tensor of the output that holds a part, for its producer to write into. </summary>
+        ///
+        /// <param name="output"> The output, with the shape GetOutputShape(). </param>
+        /// <param name="index"> The index of the part. </param>
+        ///
+        /// <returns> A reference to the part. </returns>
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        TensorReference<ElementType, dimension0, dimension1, dimension2> GetPart(TensorReference<ElementType, dimension0, dimension1, dimension2> output, size_t index) const;
+
+        /// <summary> Gets the sub-tensor of a concatenated tensor that holds a part, which splits the tensor. </summary>
+        ///
+        /// <param name="output"> The concatenated tensor, with the shape GetOutputShape(). </param>
+        /// <param name="index"> The index of the part. </param>
+        ///
+        /// <returns> A reference to the part. </returns>
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        ConstTensorReference<ElementType, dimension0, dimension1, dimension2> GetPart(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> output, size_t index) const;
+
+        /// <summary> Gets the sub-tensors of the output that hold all the parts, in order. </summary>
+        ///
+        /// <param name="output"> The output, with the shape GetOutputShape(). </param>
+        ///
+        /// <returns> References to the parts. </returns>
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        std::vector<TensorReference<ElementType, dimension0, dimension1, dimension2>> GetParts(TensorReference<ElementType, dimension0, dimension1, dimension2> output) const;
+
+        /// <summary> Gets the sub-tensors of a concatenated tensor that hold all the parts, in order. </summary>
+        ///
+        /// <param name="output"> The concatenated tensor, with the shape GetOutputShape(). </param>
+        ///
+        /// <returns> References to the parts. </returns>
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        std::vector<ConstTensorReference<ElementType, dimension0, dimension1, dimension2>> GetParts(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> output) const;
+
+    private:
+        void CheckOutputShape(TensorShape shape) const;
+
+        std::vector<TensorShape> _shapes;
+        std::vector<size_t> _offsets;
+        size_t _size = 0;
+    };
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/Exception.h>
+
+namespace ell
+{
+namespace math
+{
+    template <Dimension dimension>
+    TensorConcatenationPlan<dimension>::TensorConcatenationPlan(const std::vector<TensorShape>& partShapes)
+    {
+        for (const auto& shape : partShapes)
+        {
+            AddPart(shape);
+        }
+    }
+
+    template <Dimension dimension>
+    size_t TensorConcatenationPlan<dimension>::AddPart(TensorShape shape)
+    {
+        if (!_shapes.empty())
+        {
+            IntegerTriplet first = _shapes.front();
+            IntegerTriplet next = shape;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                if (d != static_cast<size_t>(dimension) && first[d] != next[d])
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The parts of a concatenation must agree in the other dimensions.");
+                }
+            }
+        }
+        _shapes.push_back(shape);
+        _offsets.push_back(_size);
+        _size += shape.GetValue<dimension>();
+        return _shapes.size() - 1;
+    }
+
+    template <Dimension dimension>
+    TensorShape TensorConcatenationPlan<dimension>::GetOutputShape() const
+    {
+        if (_shapes.empty())
+        {
+            return { 0, 0, 0 };
+        }
+        IntegerTriplet shape = _shapes.front();
+        shape[static_cast<size_t>(dimension)] = _size;
+        return shape;
+    }
+
+    template <Dimension dimension>
+    void TensorConcatenationPlan<dimension>::CheckOutputShape(TensorShape shape) const
+    {
+        if (shape != GetOutputShape())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The tensor does not have the shape of the concatenation.");
+        }
+    }
+
+    template <Dimension dimension>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> TensorConcatenationPlan<dimension>::GetPart(TensorReference<ElementType, dimension0, dimension1, dimension2> output, size_t index) const
+    {
+        CheckOutputShape(output.GetShape());
+        IntegerTriplet first = { 0, 0, 0 };
+        first[static_cast<size_t>(dimension)] = _offsets[index];
+        return output.GetSubTensor(first, _shapes[index]);
+    }
+
+    template <Dimension dimension>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> TensorConcatenationPlan<dimension>::GetPart(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> output, size_t index) const
+    {
+        CheckOutputShape(output.GetShape());
+        IntegerTriplet first = { 0, 0, 0 };
+        first[static_cast<size_t>(dimension)] = _offsets[index];
+        return output.GetSubTensor(first, _shapes[index]);
+    }
+
+    template <Dimension dimension>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    std::vector<TensorReference<ElementType, dimension0, dimension1, dimension2>> TensorConcatenationPlan<dimension>::GetParts(TensorReference<ElementType, dimension0, dimension1, dimension2> output) const
+    {
+        std::vector<TensorReference<ElementType, dimension0, dimension1, dimension2>> parts;
+        parts.reserve(NumParts());
+        for (size_t index = 0; index < NumParts(); ++index)
+        {
+            parts.push_back(GetPart(output, index));
+        }
+        return parts;
+    }
+
+    template <Dimension dimension>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    std::vector<ConstTensorReference<ElementType, dimension0, dimension1, dimension2>> TensorConcatenationPlan<dimension>::GetParts(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> output) const
+    {
+        std::vector<ConstTensorReference<ElementType, dimension0, dimension1, dimension2>> parts;
+        parts.reserve(NumParts());
+        for (size_t index = 0; index < NumParts(); ++index)
+        {
+            parts.push_back(GetPart(output, index));
+        }
+        return parts;
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -10,6 +10,7 @@
 
 #include "Common.h"
 #include "Tensor.h"
+#include "TensorBatch.h"
 #include "Vector.h"
 
 #include <utilities/include/Debug.h>
@@ -227,6 +228,145 @@ namespace math
     /// <param name="tensor"> The tensor. </param>
     template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1>
     void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, dimension1, vectorOrientation> tensor);
+
+    /// <summary>
+    /// Applies the transformation M = activation(scale[i] * M + bias[i]), where M is the i'th Tensor slice, in a
+    /// single traversal of the tensor. Every contiguous vector is scaled, shifted and activated while it is in cache,
+    /// and the vectors are processed in parallel.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vectors. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="ActivationType"> The activation type, for example RectifiedLinearTransformation. </typeparam>
+    /// <param name="scale"> The vector of elements that multiply the Tensor slices </param>
+    /// <param name="bias"> The vector of elements to add to the Tensor slices </param>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="activation"> The activation applied to every element after the scale and bias. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension1, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, vectorOrientation, dimension1, dimension2> tensor, ActivationType activation);
+
+    /// <summary>
+    /// Applies the transformation M = activation(scale[i] * M + bias[i]), where M is the i'th Tensor slice, in a
+    /// single traversal of the tensor.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vectors. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="ActivationType"> The activation type, for example RectifiedLinearTransformation. </typeparam>
+    /// <param name="scale"> The vector of elements that multiply the Tensor slices </param>
+    /// <param name="bias"> The vector of elements to add to the Tensor slices </param>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="activation"> The activation applied to every element after the scale and bias. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, vectorOrientation, dimension2> tensor, ActivationType activation);
+
+    /// <summary>
+    /// Applies the transformation M = activation(scale[i] * M + bias[i]), where M is the i'th Tensor slice, in a
+    /// single traversal of the tensor.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vectors. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="ActivationType"> The activation type, for example RectifiedLinearTransformation. </typeparam>
+    /// <param name="scale"> The vector of elements that multiply the Tensor slices </param>
+    /// <param name="bias"> The vector of elements to add to the Tensor slices </param>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="activation"> The activation applied to every element after the scale and bias. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, dimension1, vectorOrientation> tensor, ActivationType activation);
+
+    /// <summary>
+    /// Multiplies every tensor of a batch by a scalar. The whole batch is processed in one call, with its
+    /// contiguous vectors split across the threads.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <param name="scalar"> The scalar that multiplies the tensors. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    template <ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleUpdate(ElementType scalar, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch);
+
+    /// <summary> Adds a scalar to every tensor of a batch, in one parallel traversal of the batch. </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <param name="scalar"> The scalar added to the tensors. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    template <ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void AddUpdate(ElementType scalar, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch);
+
+    /// <summary>
+    /// Multiplies the i'th slice of every tensor of a batch by vector[i], in one parallel traversal of the batch.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vector, any of the tensor dimensions. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <param name="vector"> The vector of elements that multiply the slices. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleUpdate(UnorientedConstVectorBase<ElementType> vector, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch);
+
+    /// <summary>
+    /// Adds vector[i] to the i'th slice of every tensor of a batch, in one parallel traversal of the batch.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vector, any of the tensor dimensions. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <param name="vector"> The vector of elements added to the slices. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void AddUpdate(UnorientedConstVectorBase<ElementType> vector, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch);
+
+    /// <summary>
+    /// Applies the transformation M = scale[i] * M + bias[i], where M is the i'th slice of a tensor, to every
+    /// tensor of a batch, in one parallel traversal of the batch.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vectors, any of the tensor dimensions. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <param name="scale"> The vector of elements that multiply the slices. </param>
+    /// <param name="bias"> The vector of elements added to the slices. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch);
+
+    /// <summary>
+    /// Applies the transformation M = activation(scale[i] * M + bias[i]), where M is the i'th slice of a tensor,
+    /// to every tensor of a batch, in one parallel traversal of the batch.
+    /// </summary>
+    ///
+    /// <typeparam name="vectorOrientation"> The orientation in which to apply the vectors, any of the tensor dimensions. </typeparam>
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="dimension0"> The first dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension1"> The second dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="dimension2"> The third dimension in the Tensor layout. </typeparam>
+    /// <typeparam name="ActivationType"> The activation type, for example RectifiedLinearTransformation. </typeparam>
+    /// <param name="scale"> The vector of elements that multiply the slices. </param>
+    /// <param name="bias"> The vector of elements added to the slices. </param>
+    /// <param name="batch"> The batch of tensors. </param>
+    /// <param name="activation"> The activation applied to every element after the scale and bias. </param>
+    template <Dimension vectorOrientation, ImplementationType implementation = ImplementationType::openBlas, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch, ActivationType activation);
 } // namespace math
 } // namespace ell
 
@@ -235,6 +375,10 @@ namespace math
 #include "MatrixOperations.h"
 
 #include <utilities/include/Logger.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <vector>
 
 namespace ell
 {
@@ -443,6 +587,233 @@ namespace math
             }
         }
     }
+
+    namespace Internal
+    {
+        // applies activation(scale * x + bias) to a tensor, where scale and bias are indexed by the position
+        // along the tensor dimension given by vectorPosition (0 for the contiguous dimension)
+        template <size_t vectorPosition, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, typename ActivationType>
+        void ScaleAddActivationUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, ActivationType activation)
+        {
+            const size_t size0 = tensor.GetSize0();
+            const size_t size1 = tensor.GetSize1();
+            const size_t increment1 = tensor.GetIncrement1();
+            const size_t increment2 = tensor.GetIncrement2();
+            ElementType* pData = tensor.GetDataPointer();
+
+            // along the contiguous dimension, scale and bias are read with unit stride
+            std::vector<ElementType> contiguousScale;
+            std::vector<ElementType> contiguousBias;
+            if (vectorPosition == 0)
+            {
+                contiguousScale = scale.ToArray();
+                contiguousBias = bias.ToArray();
+            }
+
+            size_t numVectors = size1 * tensor.GetSize2();
+            size_t grainSize = size0 == 0 ? numVectors : (minElementsPerTask + size0 - 1) / size0;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    size_t i1 = index % size1;
+                    size_t i2 = index / size1;
+                    ElementType* pVector = pData + i1 * increment1 + i2 * increment2;
+
+                    if (vectorPosition == 0)
+                    {
+                        const ElementType* pScale = contiguousScale.data();
+                        const ElementType* pBias = contiguousBias.data();
+                        for (size_t k = 0; k < size0; ++k)
+                        {
+                            pVector[k] = pScale[k] * pVector[k] + pBias[k];
+                        }
+                    }
+                    else
+                    {
+                        size_t i = vectorPosition == 1 ? i1 : i2;
+                        const ElementType scaleValue = scale[i];
+                        const ElementType biasValue = bias[i];
+                        for (size_t k = 0; k < size0; ++k)
+                        {
+                            pVector[k] = scaleValue * pVector[k] + biasValue;
+                        }
+                    }
+
+                    TransformContiguous(activation, pVector, pVector, size0);
+                }
+            });
+        }
+    } // namespace Internal
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension1, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, vectorOrientation, dimension1, dimension2> tensor, ActivationType activation)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != tensor.GetSize0() || bias.Size() != tensor.GetSize0(), "vectors and tensor dimensions must be the same");
+        Internal::ScaleAddActivationUpdate<0>(scale, bias, tensor, activation);
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, vectorOrientation, dimension2> tensor, ActivationType activation)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != tensor.GetSize1() || bias.Size() != tensor.GetSize1(), "vectors and tensor dimensions must be the same");
+        Internal::ScaleAddActivationUpdate<1>(scale, bias, tensor, activation);
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorReference<ElementType, dimension0, dimension1, vectorOrientation> tensor, ActivationType activation)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != tensor.GetSize2() || bias.Size() != tensor.GetSize2(), "vectors and tensor dimensions must be the same");
+        Internal::ScaleAddActivationUpdate<2>(scale, bias, tensor, activation);
+    }
+
+    namespace Internal
+    {
+        // the position (0, 1 or 2) of a dimension in a tensor layout
+        template <Dimension dimension, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        constexpr size_t GetDimensionPosition()
+        {
+            static_assert(dimension == dimension0 || dimension == dimension1 || dimension == dimension2, "dimension is not part of the tensor layout");
+            return dimension == dimension0 ? 0 : (dimension == dimension1 ? 1 : 2);
+        }
+
+        // calls operation(pVector, size0, i1, i2) on every contiguous vector of every tensor of a batch, where i1
+        // and i2 are the positions of the vector along dimension1 and dimension2; the vectors of all the tensors
+        // are split across the threads together, so a large batch of small tensors is a single parallel loop
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, typename OperationType>
+        void ForEachBatchVector(TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch, OperationType operation)
+        {
+            const auto shape = batch.GetShape();
+            const size_t size0 = shape.template GetValue<dimension0>();
+            const size_t size1 = shape.template GetValue<dimension1>();
+            const size_t size2 = shape.template GetValue<dimension2>();
+            const size_t batchIncrement = batch.GetBatchIncrement();
+            ElementType* pData = batch.GetDataPointer();
+
+            size_t numVectors = batch.BatchSize() * size2 * size1;
+            size_t grainSize = size0 == 0 ? std::max<size_t>(numVectors, 1) : (minElementsPerTask + size0 - 1) / size0;
+            utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    size_t i1 = index % size1;
+                    size_t i2 = (index / size1) % size2;
+                    size_t item = index / (size1 * size2);
+                    operation(pData + item * batchIncrement + (i2 * size1 + i1) * size0, size0, i1, i2);
+                }
+            });
+        }
+
+        // marks the batched updates that apply no activation
+        struct NoActivation
+        {};
+
+        template <typename ElementType, typename ActivationType>
+        void ActivateContiguous(ActivationType activation, ElementType* pVector, size_t size)
+        {
+            TransformContiguous(activation, pVector, pVector, size);
+        }
+
+        template <typename ElementType>
+        void ActivateContiguous(NoActivation, ElementType*, size_t)
+        {}
+
+        // applies activation(scale * x + bias) to a batch, where scale and bias are indexed by the position along
+        // the tensor dimension given by vectorPosition, and an empty scale or bias stands for ones or zeros
+        template <size_t vectorPosition, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, typename ActivationType>
+        void BatchScaleAddUpdate(const std::vector<ElementType>& scale, const std::vector<ElementType>& bias, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch, ActivationType activation)
+        {
+            const bool hasScale = !scale.empty();
+            const bool hasBias = !bias.empty();
+            ForEachBatchVector(batch, [&](ElementType* pVector, size_t size0, size_t i1, size_t i2) {
+                if (vectorPosition == 0)
+                {
+                    if (hasScale && hasBias)
+                    {
+                        for (size_t k = 0; k < size0; ++k)
+                        {
+                            pVector[k] = scale[k] * pVector[k] + bias[k];
+                        }
+                    }
+                    else if (hasScale)
+                    {
+                        for (size_t k = 0; k < size0; ++k)
+                        {
+                            pVector[k] *= scale[k];
+                        }
+                    }
+                    else if (hasBias)
+                    {
+                        for (size_t k = 0; k < size0; ++k)
+                        {
+                            pVector[k] += bias[k];
+                        }
+                    }
+                }
+                else
+                {
+                    size_t i = vectorPosition == 1 ? i1 : i2;
+                    const ElementType scaleValue = hasScale ? scale[i] : 1;
+                    const ElementType biasValue = hasBias ? bias[i] : 0;
+                    for (size_t k = 0; k < size0; ++k)
+                    {
+                        pVector[k] = scaleValue * pVector[k] + biasValue;
+                    }
+                }
+                ActivateContiguous(activation, pVector, size0);
+            });
+        }
+    } // namespace Internal
+
+    template <ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleUpdate(ElementType scalar, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch)
+    {
+        Internal::ForEachBatchVector(batch, [scalar](ElementType* pVector, size_t size0, size_t, size_t) {
+            for (size_t k = 0; k < size0; ++k)
+            {
+                pVector[k] *= scalar;
+            }
+        });
+    }
+
+    template <ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void AddUpdate(ElementType scalar, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch)
+    {
+        Internal::ForEachBatchVector(batch, [scalar](ElementType* pVector, size_t size0, size_t, size_t) {
+            for (size_t k = 0; k < size0; ++k)
+            {
+                pVector[k] += scalar;
+            }
+        });
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleUpdate(UnorientedConstVectorBase<ElementType> vector, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch)
+    {
+        DEBUG_CHECK_SIZES(vector.Size() != batch.GetShape().template GetValue<vectorOrientation>(), "vector and tensor dimensions must be the same");
+        constexpr size_t position = Internal::GetDimensionPosition<vectorOrientation, dimension0, dimension1, dimension2>();
+        Internal::BatchScaleAddUpdate<position>(vector.ToArray(), {}, batch, Internal::NoActivation{});
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void AddUpdate(UnorientedConstVectorBase<ElementType> vector, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch)
+    {
+        DEBUG_CHECK_SIZES(vector.Size() != batch.GetShape().template GetValue<vectorOrientation>(), "vector and tensor dimensions must be the same");
+        constexpr size_t position = Internal::GetDimensionPosition<vectorOrientation, dimension0, dimension1, dimension2>();
+        Internal::BatchScaleAddUpdate<position>({}, vector.ToArray(), batch, Internal::NoActivation{});
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch)
+    {
+        ScaleAddUpdate<vectorOrientation, implementation>(scale, bias, batch, Internal::NoActivation{});
+    }
+
+    template <Dimension vectorOrientation, ImplementationType implementation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, typename ActivationType>
+    void ScaleAddUpdate(UnorientedConstVectorBase<ElementType> scale, UnorientedConstVectorBase<ElementType> bias, TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch, ActivationType activation)
+    {
+        DEBUG_CHECK_SIZES(scale.Size() != batch.GetShape().template GetValue<vectorOrientation>() || bias.Size() != scale.Size(), "vectors and tensor dimensions must be the same");
+        constexpr size_t position = Internal::GetDimensionPosition<vectorOrientation, dimension0, dimension1, dimension2>();
+        Internal::BatchScaleAddUpdate<position>(scale.ToArray(), bias.ToArray(), batch, activation);
+    }
 } // namespace math
 } // namespace ell
 
@@ -0,0 +1,224 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TensorPermutationKernels.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "ElementConversion.h"
+
+#include <array>
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        /// <summary> The sizes, or the memory increments, of a tensor indexed by row, column and channel. </summary>
+        using LogicalTriplet = std::array<size_t, 3>;
+
+        /// <summary> Tile sizes of the permutation kernel. </summary>
+        template <typename ElementType>
+        struct PermutationBlocking
+        {
+            /// <summary> The side of the square blocks transposed through registers. </summary>
+            static constexpr size_t blockSize = 32 / sizeof(ElementType) < 4 ? 4 : 32 / sizeof(ElementType);
+
+            /// <summary>
+            /// The tile size along the target's contiguous dimension. The source rows of a tile are far apart (often a
+            /// power of two apart), so few of them are read at a time to stay within the cache associativity.
+            /// </summary>
+            static constexpr size_t tileSizeA = blockSize < 8 ? 8 : blockSize;
+
+            /// <summary> The tile size along the source's contiguous dimension, a few cache lines per source row. </summary>
+            static constexpr size_t tileSizeB = 64;
+        };
+
+        /// <summary>
+        /// Copies a tensor into another tensor with the same sizes and any memory layout: target element
+        /// (r, c, k) = pTarget[r * targetIncrements[0] + c * targetIncrements[1] + k * targetIncrements[2]] is set to
+        /// the source element at the same logical coordinates. When the two layouts share their contiguous
+        /// dimension, the copy streams contiguous vectors; otherwise the two contiguous dimensions, whose increments
+        /// differ the most, are tiled and each tile is transposed in square blocks. Either way, the work is split
+        /// across the thread pool. The elements are converted to the target type on the way, as ConvertElements
+        /// does. The two tensors must not overlap.
+        /// </summary>
+        ///
+        /// <param name="pSource"> The first element of the source tensor. </param>
+        /// <param name="sourceIncrements"> The memory increments of the source rows, columns and channels. </param>
+        /// <param name="pTarget"> The first element of the target tensor. </param>
+        /// <param name="targetIncrements"> The memory increments of the target rows, columns and channels. </param>
+        /// <param name="sizes"> The number of rows, columns and channels. </param>
+        /// <param name="options"> The element conversion options. </param>
+        template <typename SourceType, typename TargetType>
+        void PermuteCopy(const SourceType* pSource, LogicalTriplet sourceIncrements, TargetType* pTarget, LogicalTriplet targetIncrements, LogicalTriplet sizes, ConversionOptions options = {});
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the logical dimension with the smallest increment among those with more than one element, which is the
+        // contiguous dimension of a dense layout
+        inline size_t GetInnermostDimension(const LogicalTriplet& increments, const LogicalTriplet& sizes)
+        {
+            size_t innermost = 3;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                if (sizes[d] > 1 && (innermost == 3 || increments[d] < increments[innermost]))
+                {
+                    innermost = d;
+                }
+            }
+            return innermost == 3 ? 0 : innermost;
+        }
+
+        // transposes a full block: the source is contiguous along b and the target is contiguous along a, so the
+        // block is loaded (and converted) row by row and stored column by column, in vector registers
+        template <size_t blockSize, typename SourceType, typename TargetType, typename ConverterType>
+        inline void TransposeBlock(const SourceType* pSource, size_t sourceIncrementA, TargetType* pTarget, size_t targetIncrementB, ConverterType converter)
+        {
+            TargetType block[blockSize][blockSize];
+            for (size_t a = 0; a < blockSize; ++a)
+            {
+                for (size_t b = 0; b < blockSize; ++b)
+                {
+                    block[b][a] = converter(pSource[a * sourceIncrementA + b]);
+                }
+            }
+            for (size_t b = 0; b < blockSize; ++b)
+            {
+                for (size_t a = 0; a < blockSize; ++a)
+                {
+                    pTarget[b * targetIncrementB + a] = block[b][a];
+                }
+            }
+        }
+
+        // transposes a sizeA x sizeB tile with a source that is contiguous along b and a target that is contiguous along a
+        template <typename SourceType, typename TargetType, typename ConverterType>
+        void TransposeTile(const SourceType* pSource, size_t sourceIncrementA, TargetType* pTarget, size_t targetIncrementB, size_t sizeA, size_t sizeB, ConverterType converter)
+        {
+            constexpr size_t blockSize = PermutationBlocking<TargetType>::blockSize;
+            size_t fullA = sizeA - sizeA % blockSize;
+            size_t fullB = sizeB - sizeB % blockSize;
+            for (size_t b = 0; b < fullB; b += blockSize)
+            {
+                for (size_t a = 0; a < fullA; a += blockSize)
+                {
+                    TransposeBlock<blockSize>(pSource + a * sourceIncrementA + b, sourceIncrementA, pTarget + b * targetIncrementB + a, targetIncrementB, converter);
+                }
+            }
+
+            // the ragged edges
+            for (size_t b = 0; b < sizeB; ++b)
+            {
+                size_t firstA = b < fullB ? fullA : 0;
+                ConvertElements(pSource + firstA * sourceIncrementA + b, sourceIncrementA, pTarget + b * targetIncrementB + firstA, 1, sizeA - firstA, converter);
+            }
+        }
+
+        template <typename SourceType, typename TargetType, typename ConverterType>
+        void PermuteConvert(const SourceType* pSource, LogicalTriplet sourceIncrements, TargetType* pTarget, LogicalTriplet targetIncrements, LogicalTriplet sizes, ConverterType converter)
+        {
+            size_t size = sizes[0] * sizes[1] * sizes[2];
+            if (size == 0)
+            {
+                return;
+            }
+
+            size_t targetInner = GetInnermostDimension(targetIncrements, sizes);
+            size_t sourceInner = GetInnermostDimension(sourceIncrements, sizes);
+
+            if (targetInner == sourceInner)
+            {
+                // the layouts share their contiguous dimension: copy vectors along it, in the target's memory order
+                size_t inner = targetInner;
+                size_t middle = (inner + 1) % 3;
+                size_t outer = (inner + 2) % 3;
+                if (targetIncrements[middle] > targetIncrements[outer])
+                {
+                    std::swap(middle, outer);
+                }
+
+                size_t numVectors = sizes[middle] * sizes[outer];
+                size_t grainSize = (minElementsPerTask + sizes[inner] - 1) / sizes[inner];
+                utilities::ParallelFor(numVectors, grainSize, [&](size_t begin, size_t end) {
+                    for (size_t index = begin; index < end; ++index)
+                    {
+                        size_t i = index % sizes[middle];
+                        size_t j = index / sizes[middle];
+                        ConvertElements(pSource + i * sourceIncrements[middle] + j * sourceIncrements[outer], sourceIncrements[inner], pTarget + i * targetIncrements[middle] + j * targetIncrements[outer], targetIncrements[inner], sizes[inner], converter);
+                    }
+                });
+                return;
+            }
+
+            // the target is contiguous along a and the source along b: tile the (a, b) plane and loop over c outside
+            size_t a = targetInner;
+            size_t b = sourceInner;
+            size_t c = 3 - a - b;
+            constexpr size_t tileSizeA = PermutationBlocking<TargetType>::tileSizeA;
+            constexpr size_t tileSizeB = PermutationBlocking<TargetType>::tileSizeB;
+            size_t numTilesA = (sizes[a] + tileSizeA - 1) / tileSizeA;
+            size_t numTilesB = (sizes[b] + tileSizeB - 1) / tileSizeB;
+            size_t numTiles = sizes[c] * numTilesB * numTilesA;
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / (tileSizeA * tileSizeB));
+            bool isUnitStride = sourceIncrements[b] == 1 && targetIncrements[a] == 1;
+
+            utilities::ParallelFor(numTiles, grainSize, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    size_t tileA = index % numTilesA;
+                    size_t tileB = (index / numTilesA) % numTilesB;
+                    size_t k = index / (numTilesA * numTilesB);
+                    size_t firstA = tileA * tileSizeA;
+                    size_t firstB = tileB * tileSizeB;
+                    size_t sizeA = std::min(tileSizeA, sizes[a] - firstA);
+                    size_t sizeB = std::min(tileSizeB, sizes[b] - firstB);
+                    const SourceType* pSourceTile = pSource + k * sourceIncrements[c] + firstA * sourceIncrements[a] + firstB * sourceIncrements[b];
+                    TargetType* pTargetTile = pTarget + k * targetIncrements[c] + firstA * targetIncrements[a] + firstB * targetIncrements[b];
+
+                    if (isUnitStride)
+                    {
+                        TransposeTile(pSourceTile, sourceIncrements[a], pTargetTile, targetIncrements[b], sizeA, sizeB, converter);
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < sizeB; ++j)
+                        {
+                            ConvertElements(pSourceTile + j * sourceIncrements[b], sourceIncrements[a], pTargetTile + j * targetIncrements[b], targetIncrements[a], sizeA, converter);
+                        }
+                    }
+                }
+            });
+        }
+
+        template <typename SourceType, typename TargetType>
+        void PermuteCopy(const SourceType* pSource, LogicalTriplet sourceIncrements, TargetType* pTarget, LogicalTriplet targetIncrements, LogicalTriplet sizes, ConversionOptions options)
+        {
+            WithElementConverter<SourceType, TargetType>(options, [&](auto converter) {
+                PermuteConvert(pSource, sourceIncrements, pTarget, targetIncrements, sizes, converter);
+            });
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
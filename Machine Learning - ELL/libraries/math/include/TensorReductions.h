@@ -0,0 +1,479 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TensorReductions.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "Matrix.h"
+#include "Tensor.h"
+#include "Vector.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The reductions that Reduce computes. </summary>
+    enum class TensorReduction
+    {
+        sum,
+        mean,
+        maximum,
+        minimum
+    };
+
+    /// <summary>
+    /// Reduces a tensor along one dimension. The output matrix is indexed by the two remaining dimensions, in
+    /// the order row, column, channel: reducing the channels gives a rows x columns matrix, reducing the columns
+    /// a rows x channels matrix and reducing the rows a columns x channels matrix. The loop order follows the
+    /// memory order of the tensor, so the innermost loop is always contiguous, and the output is split across
+    /// the thread pool.
+    /// </summary>
+    ///
+    /// <typeparam name="reduction"> The reduction. </typeparam>
+    /// <typeparam name="dimension"> The reduced dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="output"> The output matrix. </param>
+    template <TensorReduction reduction, Dimension dimension, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, MatrixLayout layout>
+    void Reduce(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, MatrixReference<ElementType, layout> output);
+
+    /// <summary>
+    /// Reduces a tensor along two dimensions, for example the rows and columns of each channel for global
+    /// average pooling. The output vector is indexed by the remaining dimension.
+    /// </summary>
+    ///
+    /// <typeparam name="reduction"> The reduction. </typeparam>
+    /// <typeparam name="dimensionA"> The first reduced dimension. </typeparam>
+    /// <typeparam name="dimensionB"> The second reduced dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="output"> The output vector. </param>
+    template <TensorReduction reduction, Dimension dimensionA, Dimension dimensionB, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, VectorOrientation orientation>
+    void Reduce(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, VectorReference<ElementType, orientation> output);
+
+    /// <summary>
+    /// Finds the position of the largest element along one dimension of a tensor, with the output arranged as
+    /// in Reduce. Ties go to the smallest position.
+    /// </summary>
+    ///
+    /// <typeparam name="dimension"> The reduced dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="output"> The output matrix of positions along the reduced dimension. </param>
+    template <Dimension dimension, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, MatrixLayout layout>
+    void ArgMax(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, MatrixReference<size_t, layout> output);
+
+    /// <summary>
+    /// Finds the position of the largest element along two dimensions of a tensor. The position of the element
+    /// at index a along dimensionA and index b along dimensionB is a * (size of dimensionB) + b. Ties go to the
+    /// smallest position.
+    /// </summary>
+    ///
+    /// <typeparam name="dimensionA"> The first reduced dimension. </typeparam>
+    /// <typeparam name="dimensionB"> The second reduced dimension. </typeparam>
+    /// <param name="tensor"> The tensor. </param>
+    /// <param name="output"> The output vector of positions. </param>
+    template <Dimension dimensionA, Dimension dimensionB, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, VectorOrientation orientation>
+    void ArgMax(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, VectorReference<size_t, orientation> output);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "TensorPermutationKernels.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // -infinity, or the lowest value of types without infinity
+        template <typename ElementType>
+        constexpr ElementType SmallestValue()
+        {
+            return std::numeric_limits<ElementType>::has_infinity ? -std::numeric_limits<ElementType>::infinity() : std::numeric_limits<ElementType>::lowest();
+        }
+
+        // infinity, or the largest value of types without infinity
+        template <typename ElementType>
+        constexpr ElementType LargestValue()
+        {
+            return std::numeric_limits<ElementType>::has_infinity ? std::numeric_limits<ElementType>::infinity() : std::numeric_limits<ElementType>::max();
+        }
+
+        // Each reducer has an accumulator that starts at Initial(), takes one element at a time with Accumulate
+        // (which gets the position of the element among the reduced elements) or a strided vector of elements
+        // with AccumulateVector (which gets the position of the first element and the distance between
+        // positions), and turns into the output with Finish.
+
+        template <typename ElementType>
+        struct SumReducer
+        {
+            using AccumulatorType = ElementType;
+            using OutputType = ElementType;
+
+            static AccumulatorType Initial() { return 0; }
+            static void Accumulate(AccumulatorType& accumulator, ElementType value, size_t) { accumulator += value; }
+            static OutputType Finish(AccumulatorType accumulator, size_t) { return accumulator; }
+
+            static void AccumulateVector(AccumulatorType& accumulator, const ElementType* pData, size_t increment, size_t size, size_t, size_t)
+            {
+                if (increment != 1)
+                {
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        accumulator += pData[i * increment];
+                    }
+                    return;
+                }
+
+                // independent partial sums, which the compiler keeps in one vector register
+                constexpr size_t lanes = 8;
+                ElementType partial[lanes] = {};
+                size_t fullSize = size - size % lanes;
+                for (size_t i = 0; i < fullSize; i += lanes)
+                {
+                    for (size_t l = 0; l < lanes; ++l)
+                    {
+                        partial[l] += pData[i + l];
+                    }
+                }
+                for (size_t i = fullSize; i < size; ++i)
+                {
+                    partial[i - fullSize] += pData[i];
+                }
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    accumulator += partial[l];
+                }
+            }
+        };
+
+        template <typename ElementType>
+        struct MeanReducer : SumReducer<ElementType>
+        {
+            static ElementType Finish(ElementType accumulator, size_t count) { return count == 0 ? accumulator : accumulator / static_cast<ElementType>(count); }
+        };
+
+        // the maximum when isMaximum is true, the minimum otherwise
+        template <typename ElementType, bool isMaximum>
+        struct ExtremumReducer
+        {
+            using AccumulatorType = ElementType;
+            using OutputType = ElementType;
+
+            static AccumulatorType Initial() { return isMaximum ? SmallestValue<ElementType>() : LargestValue<ElementType>(); }
+            static void Accumulate(AccumulatorType& accumulator, ElementType value, size_t) { accumulator = (isMaximum ? accumulator < value : value < accumulator) ? value : accumulator; }
+            static OutputType Finish(AccumulatorType accumulator, size_t) { return accumulator; }
+
+            static void AccumulateVector(AccumulatorType& accumulator, const ElementType* pData, size_t increment, size_t size, size_t, size_t)
+            {
+                constexpr size_t lanes = 8;
+                AccumulatorType partial[lanes];
+                std::fill(partial, partial + lanes, accumulator);
+                size_t fullSize = increment == 1 ? size - size % lanes : 0;
+                for (size_t i = 0; i < fullSize; i += lanes)
+                {
+                    for (size_t l = 0; l < lanes; ++l)
+                    {
+                        Accumulate(partial[l], pData[i + l], 0);
+                    }
+                }
+                for (size_t i = fullSize; i < size; ++i)
+                {
+                    Accumulate(accumulator, pData[i * increment], 0);
+                }
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    Accumulate(accumulator, partial[l], 0);
+                }
+            }
+        };
+
+        template <typename ElementType>
+        struct ArgMaxReducer
+        {
+            struct AccumulatorType
+            {
+                ElementType value;
+                size_t index;
+            };
+            using OutputType = size_t;
+
+            static AccumulatorType Initial() { return { SmallestValue<ElementType>(), std::numeric_limits<size_t>::max() }; }
+            static void Accumulate(AccumulatorType& accumulator, ElementType value, size_t index)
+            {
+                // the elements are visited in memory order, which is not always the order of their positions
+                if (accumulator.value < value || (value == accumulator.value && index < accumulator.index))
+                {
+                    accumulator = { value, index };
+                }
+            }
+            static OutputType Finish(AccumulatorType accumulator, size_t) { return accumulator.index; }
+
+            static void AccumulateVector(AccumulatorType& accumulator, const ElementType* pData, size_t increment, size_t size, size_t firstPosition, size_t positionIncrement)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    Accumulate(accumulator, pData[i * increment], firstPosition + i * positionIncrement);
+                }
+            }
+        };
+
+        template <TensorReduction reduction, typename ElementType>
+        struct GetReducer;
+
+        template <typename ElementType>
+        struct GetReducer<TensorReduction::sum, ElementType>
+        {
+            using Type = SumReducer<ElementType>;
+        };
+
+        template <typename ElementType>
+        struct GetReducer<TensorReduction::mean, ElementType>
+        {
+            using Type = MeanReducer<ElementType>;
+        };
+
+        template <typename ElementType>
+        struct GetReducer<TensorReduction::maximum, ElementType>
+        {
+            using Type = ExtremumReducer<ElementType, true>;
+        };
+
+        template <typename ElementType>
+        struct GetReducer<TensorReduction::minimum, ElementType>
+        {
+            using Type = ExtremumReducer<ElementType, false>;
+        };
+
+        // Reduces the tensor dimensions with a nonzero positionIncrement: the reduced position of an element is
+        // the dot product of its coordinates with positionIncrements. The output element of coordinates
+        // (r, c, k) is at pOutput + r * outputIncrements[0] + c * outputIncrements[1] + k * outputIncrements[2],
+        // where the increments of the reduced dimensions are zero.
+        template <typename ReducerType, typename ElementType>
+        void ReduceTensor(const ElementType* pData, LogicalTriplet sizes, LogicalTriplet increments, LogicalTriplet positionIncrements, typename ReducerType::OutputType* pOutput, LogicalTriplet outputIncrements)
+        {
+            using AccumulatorType = typename ReducerType::AccumulatorType;
+
+            size_t count = 1;
+            for (size_t d = 0; d < 3; ++d)
+            {
+                count *= positionIncrements[d] != 0 ? sizes[d] : 1;
+            }
+
+            // the dimensions in the memory order of the tensor, innermost first
+            std::array<size_t, 3> order = { 0, 1, 2 };
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return increments[a] < increments[b]; });
+            size_t inner = GetInnermostDimension(increments, sizes);
+            std::rotate(order.begin(), std::find(order.begin(), order.end(), inner), std::find(order.begin(), order.end(), inner) + 1);
+
+            std::vector<size_t> kept;
+            std::vector<size_t> reduced;
+            for (auto d : order)
+            {
+                (positionIncrements[d] != 0 ? reduced : kept).push_back(d);
+            }
+            size_t outputSize = 1;
+            for (auto d : kept)
+            {
+                outputSize *= sizes[d];
+            }
+            if (outputSize == 0)
+            {
+                return;
+            }
+
+            if (positionIncrements[inner] != 0)
+            {
+                // the contiguous dimension is reduced: each output element reduces contiguous vectors
+                size_t middle = reduced.size() > 1 ? reduced[1] : inner;
+                size_t numVectors = reduced.size() > 1 ? sizes[middle] : 1;
+                size_t keptInner = kept[0];
+                size_t keptOuter = kept.size() > 1 ? kept[1] : keptInner;
+                size_t keptInnerSize = sizes[keptInner];
+                size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(1, count));
+                utilities::ParallelFor(outputSize, grainSize, [&](size_t begin, size_t end) {
+                    for (size_t index = begin; index < end; ++index)
+                    {
+                        size_t i = index % keptInnerSize;
+                        size_t j = kept.size() > 1 ? index / keptInnerSize : 0;
+                        const ElementType* pElement = pData + i * increments[keptInner] + (kept.size() > 1 ? j * increments[keptOuter] : 0);
+                        AccumulatorType accumulator = ReducerType::Initial();
+                        for (size_t m = 0; m < numVectors; ++m)
+                        {
+                            size_t middleOffset = reduced.size() > 1 ? m * increments[middle] : 0;
+                            size_t middlePosition = reduced.size() > 1 ? m * positionIncrements[middle] : 0;
+                            ReducerType::AccumulateVector(accumulator, pElement + middleOffset, increments[inner], sizes[inner], middlePosition, positionIncrements[inner]);
+                        }
+                        pOutput[i * outputIncrements[keptInner] + (kept.size() > 1 ? j * outputIncrements[keptOuter] : 0)] = ReducerType::Finish(accumulator, count);
+                    }
+                });
+                return;
+            }
+
+            // the contiguous dimension is kept: accumulate whole vectors of output elements at once, by chunks
+            constexpr size_t chunkSize = 256;
+            size_t keptOuter = kept.size() > 1 ? kept[1] : inner;
+            size_t keptOuterSize = kept.size() > 1 ? sizes[keptOuter] : 1;
+            size_t numChunks = (sizes[inner] + chunkSize - 1) / chunkSize;
+            size_t reducedInner = reduced[0];
+            size_t reducedOuter = reduced.size() > 1 ? reduced[1] : reducedInner;
+            size_t reducedOuterSize = reduced.size() > 1 ? sizes[reducedOuter] : 1;
+            size_t grainSize = std::max<size_t>(1, minElementsPerTask / std::max<size_t>(1, count * chunkSize));
+            utilities::ParallelFor(keptOuterSize * numChunks, grainSize, [&](size_t begin, size_t end) {
+                AccumulatorType accumulators[chunkSize];
+                for (size_t index = begin; index < end; ++index)
+                {
+                    size_t chunk = index % numChunks;
+                    size_t j = index / numChunks;
+                    size_t first = chunk * chunkSize;
+                    size_t size = std::min(chunkSize, sizes[inner] - first);
+                    const ElementType* pChunk = pData + first * increments[inner] + (kept.size() > 1 ? j * increments[keptOuter] : 0);
+                    std::fill(accumulators, accumulators + size, ReducerType::Initial());
+                    for (size_t r2 = 0; r2 < reducedOuterSize; ++r2)
+                    {
+                        for (size_t r1 = 0; r1 < sizes[reducedInner]; ++r1)
+                        {
+                            size_t offset = r1 * increments[reducedInner] + (reduced.size() > 1 ? r2 * increments[reducedOuter] : 0);
+                            size_t position = r1 * positionIncrements[reducedInner] + (reduced.size() > 1 ? r2 * positionIncrements[reducedOuter] : 0);
+                            const ElementType* pVector = pChunk + offset;
+                            if (increments[inner] == 1)
+                            {
+                                for (size_t k = 0; k < size; ++k)
+                                {
+                                    ReducerType::Accumulate(accumulators[k], pVector[k], position);
+                                }
+                            }
+                            else
+                            {
+                                for (size_t k = 0; k < size; ++k)
+                                {
+                                    ReducerType::Accumulate(accumulators[k], pVector[k * increments[inner]], position);
+                                }
+                            }
+                        }
+                    }
+
+                    auto pOutputChunk = pOutput + first * outputIncrements[inner] + (kept.size() > 1 ? j * outputIncrements[keptOuter] : 0);
+                    for (size_t k = 0; k < size; ++k)
+                    {
+                        pOutputChunk[k * outputIncrements[inner]] = ReducerType::Finish(accumulators[k], count);
+                    }
+                }
+            });
+        }
+
+        template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+        void GetReductionArguments(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, LogicalTriplet& sizes, LogicalTriplet& increments)
+        {
+            sizes = { tensor.NumRows(), tensor.NumColumns(), tensor.NumChannels() };
+            increments = GetLogicalIncrements<dimension0, dimension1, dimension2>(tensor.GetIncrement1(), tensor.GetIncrement2());
+        }
+
+        // the logical increments of a matrix that holds the dimensions other than the reduced one
+        template <Dimension dimension, typename OutputElementType, MatrixLayout layout>
+        LogicalTriplet GetReductionOutputIncrements(const LogicalTriplet& sizes, MatrixReference<OutputElementType, layout> output)
+        {
+            constexpr size_t reduced = static_cast<size_t>(dimension);
+            constexpr size_t first = reduced == 0 ? 1 : 0;
+            constexpr size_t second = reduced == 2 ? 1 : 2;
+            if (output.NumRows() != sizes[first] || output.NumColumns() != sizes[second])
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "output matrix must have the sizes of the dimensions that are not reduced");
+            }
+
+            LogicalTriplet outputIncrements = { 0, 0, 0 };
+            outputIncrements[first] = output.GetRowIncrement();
+            outputIncrements[second] = output.GetColumnIncrement();
+            return outputIncrements;
+        }
+
+        // the logical increments of a vector that holds the dimension that is not reduced
+        template <Dimension dimensionA, Dimension dimensionB, typename OutputElementType, VectorOrientation orientation>
+        LogicalTriplet GetReductionOutputIncrements(const LogicalTriplet& sizes, VectorReference<OutputElementType, orientation> output)
+        {
+            static_assert(dimensionA != dimensionB, "the two reduced dimensions must be different");
+            constexpr size_t kept = 3 - static_cast<size_t>(dimensionA) - static_cast<size_t>(dimensionB);
+            if (output.Size() != sizes[kept])
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "output vector must have the size of the dimension that is not reduced");
+            }
+
+            LogicalTriplet outputIncrements = { 0, 0, 0 };
+            outputIncrements[kept] = output.GetIncrement();
+            return outputIncrements;
+        }
+
+        template <Dimension dimension>
+        LogicalTriplet GetPositionIncrements(const LogicalTriplet&)
+        {
+            LogicalTriplet positionIncrements = { 0, 0, 0 };
+            positionIncrements[static_cast<size_t>(dimension)] = 1;
+            return positionIncrements;
+        }
+
+        template <Dimension dimensionA, Dimension dimensionB>
+        LogicalTriplet GetPositionIncrements(const LogicalTriplet& sizes)
+        {
+            LogicalTriplet positionIncrements = { 0, 0, 0 };
+            positionIncrements[static_cast<size_t>(dimensionA)] = std::max<size_t>(1, sizes[static_cast<size_t>(dimensionB)]);
+            positionIncrements[static_cast<size_t>(dimensionB)] = 1;
+            return positionIncrements;
+        }
+    } // namespace Internal
+
+    template <TensorReduction reduction, Dimension dimension, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, MatrixLayout layout>
+    void Reduce(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, MatrixReference<ElementType, layout> output)
+    {
+        Internal::LogicalTriplet sizes, increments;
+        Internal::GetReductionArguments(tensor, sizes, increments);
+        auto outputIncrements = Internal::GetReductionOutputIncrements<dimension>(sizes, output);
+        using ReducerType = typename Internal::GetReducer<reduction, ElementType>::Type;
+        Internal::ReduceTensor<ReducerType>(tensor.GetConstDataPointer(), sizes, increments, Internal::GetPositionIncrements<dimension>(sizes), output.GetDataPointer(), outputIncrements);
+    }
+
+    template <TensorReduction reduction, Dimension dimensionA, Dimension dimensionB, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, VectorOrientation orientation>
+    void Reduce(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, VectorReference<ElementType, orientation> output)
+    {
+        Internal::LogicalTriplet sizes, increments;
+        Internal::GetReductionArguments(tensor, sizes, increments);
+        auto outputIncrements = Internal::GetReductionOutputIncrements<dimensionA, dimensionB>(sizes, output);
+        using ReducerType = typename Internal::GetReducer<reduction, ElementType>::Type;
+        Internal::ReduceTensor<ReducerType>(tensor.GetConstDataPointer(), sizes, increments, Internal::GetPositionIncrements<dimensionA, dimensionB>(sizes), output.GetDataPointer(), outputIncrements);
+    }
+
+    template <Dimension dimension, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, MatrixLayout layout>
+    void ArgMax(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, MatrixReference<size_t, layout> output)
+    {
+        Internal::LogicalTriplet sizes, increments;
+        Internal::GetReductionArguments(tensor, sizes, increments);
+        auto outputIncrements = Internal::GetReductionOutputIncrements<dimension>(sizes, output);
+        Internal::ReduceTensor<Internal::ArgMaxReducer<ElementType>>(tensor.GetConstDataPointer(), sizes, increments, Internal::GetPositionIncrements<dimension>(sizes), output.GetDataPointer(), outputIncrements);
+    }
+
+    template <Dimension dimensionA, Dimension dimensionB, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2, VectorOrientation orientation>
+    void ArgMax(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, VectorReference<size_t, orientation> output)
+    {
+        Internal::LogicalTriplet sizes, increments;
+        Internal::GetReductionArguments(tensor, sizes, increments);
+        auto outputIncrements = Internal::GetReductionOutputIncrements<dimensionA, dimensionB>(sizes, output);
+        Internal::ReduceTensor<Internal::ArgMaxReducer<ElementType>>(tensor.GetConstDataPointer(), sizes, increments, Internal::GetPositionIncrements<dimensionA, dimensionB>(sizes), output.GetDataPointer(), outputIncrements);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,350 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TensorResize.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Tensor.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> The interpolations that Resize computes. </summary>
+    enum class ResizeInterpolation
+    {
+        nearest,
+        bilinear
+    };
+
+    /// <summary>
+    /// Resizes the rows and columns of an image tensor to the shape of the output, with the same channels. Output
+    /// pixel (i, j) samples the input at ((i + 0.5) * inputRows / outputRows - 0.5, (j + 0.5) * inputColumns / outputColumns - 0.5),
+    /// so that the pixel centers line up; nearest takes the input pixel that contains that point and bilinear
+    /// interpolates the four pixels around it, repeating the edge pixels outside the image. The input positions
+    /// and weights are computed once per output row and column. Each input row that is needed is resampled along
+    /// the columns once, into a buffer ordered like the output rows, and each output row is then a contiguous
+    /// blend of two buffers, which the compiler vectorizes across the channels and columns. The output rows are
+    /// split across the thread pool. The input and output can be sub-tensors, for example a crop of the input.
+    /// </summary>
+    ///
+    /// <typeparam name="interpolation"> The interpolation. </typeparam>
+    /// <typeparam name="ElementType"> The element type, float or double. </typeparam>
+    /// <param name="input"> The input image, which must not be empty. </param>
+    /// <param name="output"> The output image, with the same number of channels. </param>
+    template <ResizeInterpolation interpolation = ResizeInterpolation::bilinear, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Resize(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> input, TensorReference<ElementType, dimension0, dimension1, dimension2> output);
+
+    /// <summary> Crops the rows and columns of an image tensor, keeping all its channels, without copying. </summary>
+    ///
+    /// <param name="tensor"> The image. </param>
+    /// <param name="firstRow"> The first row of the crop. </param>
+    /// <param name="firstColumn"> The first column of the crop. </param>
+    /// <param name="numRows"> The number of rows of the crop. </param>
+    /// <param name="numColumns"> The number of columns of the crop. </param>
+    ///
+    /// <returns> A reference to the crop. </returns>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> Crop(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t firstRow, size_t firstColumn, size_t numRows, size_t numColumns);
+
+    /// <summary> Crops the rows and columns of an image tensor, keeping all its channels, without copying. </summary>
+    ///
+    /// <param name="tensor"> The image. </param>
+    /// <param name="firstRow"> The first row of the crop. </param>
+    /// <param name="firstColumn"> The first column of the crop. </param>
+    /// <param name="numRows"> The number of rows of the crop. </param>
+    /// <param name="numColumns"> The number of columns of the crop. </param>
+    ///
+    /// <returns> A reference to the crop. </returns>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> Crop(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t firstRow, size_t firstColumn, size_t numRows, size_t numColumns);
+
+    /// <summary>
+    /// Crops the center of an image tensor without copying. When the margin is odd, the extra row or column is
+    /// dropped at the bottom or right.
+    /// </summary>
+    ///
+    /// <param name="tensor"> The image. </param>
+    /// <param name="numRows"> The number of rows of the crop. </param>
+    /// <param name="numColumns"> The number of columns of the crop. </param>
+    ///
+    /// <returns> A reference to the crop. </returns>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> CenterCrop(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t numRows, size_t numColumns);
+
+    /// <summary>
+    /// Crops the center of an image tensor without copying. When the margin is odd, the extra row or column is
+    /// dropped at the bottom or right.
+    /// </summary>
+    ///
+    /// <param name="tensor"> The image. </param>
+    /// <param name="numRows"> The number of rows of the crop. </param>
+    /// <param name="numColumns"> The number of columns of the crop. </param>
+    ///
+    /// <returns> A reference to the crop. </returns>
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> CenterCrop(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t numRows, size_t numColumns);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // for each output position along one dimension, the memory offsets of the two input positions around the
+        // sampled point and the weight of the second one
+        template <typename ElementType>
+        struct ResizeTable
+        {
+            std::vector<size_t> firstIndex;
+            std::vector<size_t> secondIndex;
+            std::vector<size_t> firstOffset;
+            std::vector<size_t> secondOffset;
+            std::vector<ElementType> weight;
+        };
+
+        template <ResizeInterpolation interpolation, typename ElementType>
+        ResizeTable<ElementType> GetResizeTable(size_t inputSize, size_t outputSize, size_t increment)
+        {
+            ResizeTable<ElementType> table;
+            table.firstIndex.resize(outputSize);
+            table.secondIndex.resize(outputSize);
+            table.firstOffset.resize(outputSize);
+            table.secondOffset.resize(outputSize);
+            table.weight.resize(outputSize);
+            double scale = static_cast<double>(inputSize) / static_cast<double>(outputSize);
+            for (size_t i = 0; i < outputSize; ++i)
+            {
+                size_t first = 0;
+                size_t second = 0;
+                double weight = 0;
+                if (interpolation == ResizeInterpolation::nearest)
+                {
+                    first = std::min(static_cast<size_t>((i + 0.5) * scale), inputSize - 1);
+                    second = first;
+                }
+                else
+                {
+                    double position = std::max(0.0, (i + 0.5) * scale - 0.5);
+                    first = std::min(static_cast<size_t>(position), inputSize - 1);
+                    second = std::min(first + 1, inputSize - 1);
+                    weight = second == first ? 0.0 : position - static_cast<double>(first);
+                }
+                table.firstIndex[i] = first;
+                table.secondIndex[i] = second;
+                table.firstOffset[i] = first * increment;
+                table.secondOffset[i] = second * increment;
+                table.weight[i] = static_cast<ElementType>(weight);
+            }
+            return table;
+        }
+
+        // resamples one input row along the columns into a buffer, which holds element (column j, channel k) at
+        // j * numChannels + k when the channels are innermost and at k * numColumns + j otherwise
+        template <ResizeInterpolation interpolation, typename ElementType>
+        void ResampleRow(const ElementType* pRow, const ResizeTable<ElementType>& columns, size_t channelIncrement, size_t numChannels, bool channelsInnermost, ElementType* pBuffer)
+        {
+            size_t numColumns = columns.weight.size();
+            if (channelsInnermost)
+            {
+                for (size_t j = 0; j < numColumns; ++j)
+                {
+                    const ElementType* pFirst = pRow + columns.firstOffset[j];
+                    const ElementType* pSecond = pRow + columns.secondOffset[j];
+                    ElementType weight = columns.weight[j];
+                    ElementType* pOut = pBuffer + j * numChannels;
+                    for (size_t k = 0; k < numChannels; ++k)
+                    {
+                        ElementType first = pFirst[k * channelIncrement];
+                        pOut[k] = interpolation == ResizeInterpolation::nearest ? first : first + weight * (pSecond[k * channelIncrement] - first);
+                    }
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < numChannels; ++k)
+                {
+                    const ElementType* pChannel = pRow + k * channelIncrement;
+                    ElementType* pOut = pBuffer + k * numColumns;
+                    for (size_t j = 0; j < numColumns; ++j)
+                    {
+                        ElementType first = pChannel[columns.firstOffset[j]];
+                        pOut[j] = interpolation == ResizeInterpolation::nearest ? first : first + columns.weight[j] * (pChannel[columns.secondOffset[j]] - first);
+                    }
+                }
+            }
+        }
+
+        // writes the blend first + weight * (second - first) of two buffers ordered as in ResampleRow to an output row,
+        // or a copy of the first buffer when the weight is zero
+        template <typename ElementType>
+        void BlendRows(const ElementType* pFirst, const ElementType* pSecond, ElementType weight, const LogicalTriplet& increments, size_t numColumns, size_t numChannels, bool channelsInnermost, ElementType* pRow)
+        {
+            size_t columnIncrement = increments[static_cast<size_t>(Dimension::column)];
+            size_t channelIncrement = increments[static_cast<size_t>(Dimension::channel)];
+
+            // the runs along which both the buffers and the output row are contiguous
+            size_t numRuns = channelsInnermost ? numColumns : numChannels;
+            size_t runLength = channelsInnermost ? numChannels : numColumns;
+            size_t runIncrement = channelsInnermost ? columnIncrement : channelIncrement;
+            size_t elementIncrement = channelsInnermost ? channelIncrement : columnIncrement;
+            if (elementIncrement == 1 && runIncrement == runLength)
+            {
+                runLength *= numRuns;
+                numRuns = 1;
+            }
+            for (size_t r = 0; r < numRuns; ++r)
+            {
+                const ElementType* pA = pFirst + r * runLength;
+                const ElementType* pB = pSecond + r * runLength;
+                ElementType* pOut = pRow + r * runIncrement;
+                if (weight == 0)
+                {
+                    for (size_t e = 0; e < runLength; ++e)
+                    {
+                        pOut[e * elementIncrement] = pA[e];
+                    }
+                }
+                else if (elementIncrement == 1)
+                {
+                    for (size_t e = 0; e < runLength; ++e)
+                    {
+                        pOut[e] = pA[e] + weight * (pB[e] - pA[e]);
+                    }
+                }
+                else
+                {
+                    for (size_t e = 0; e < runLength; ++e)
+                    {
+                        pOut[e * elementIncrement] = pA[e] + weight * (pB[e] - pA[e]);
+                    }
+                }
+            }
+        }
+
+        inline void CheckCrop(TensorShape shape, size_t firstRow, size_t firstColumn, size_t numRows, size_t numColumns)
+        {
+            if (firstRow + numRows > shape.NumRows() || firstColumn + numColumns > shape.NumColumns())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "The crop exceeds the image.");
+            }
+        }
+    } // namespace Internal
+
+    template <ResizeInterpolation interpolation, typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    void Resize(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> input, TensorReference<ElementType, dimension0, dimension1, dimension2> output)
+    {
+        if (input.NumChannels() != output.NumChannels())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The input and output must have the same number of channels.");
+        }
+        size_t numRows = output.NumRows();
+        size_t numColumns = output.NumColumns();
+        size_t numChannels = output.NumChannels();
+        if (numRows == 0 || numColumns == 0 || numChannels == 0)
+        {
+            return;
+        }
+        if (input.NumRows() == 0 || input.NumColumns() == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The input image must not be empty.");
+        }
+
+        auto inputIncrements = Internal::GetLogicalIncrements<dimension0, dimension1, dimension2>(input.GetIncrement1(), input.GetIncrement2());
+        auto outputIncrements = Internal::GetLogicalIncrements<dimension0, dimension1, dimension2>(output.GetIncrement1(), output.GetIncrement2());
+        size_t inputRowIncrement = inputIncrements[static_cast<size_t>(Dimension::row)];
+        size_t inputChannelIncrement = inputIncrements[static_cast<size_t>(Dimension::channel)];
+        size_t outputRowIncrement = outputIncrements[static_cast<size_t>(Dimension::row)];
+        bool channelsInnermost = dimension0 == Dimension::channel;
+
+        auto rows = Internal::GetResizeTable<interpolation, ElementType>(input.NumRows(), numRows, inputRowIncrement);
+        auto columns = Internal::GetResizeTable<interpolation, ElementType>(input.NumColumns(), numColumns, inputIncrements[static_cast<size_t>(Dimension::column)]);
+        const ElementType* pInput = input.GetConstDataPointer();
+        ElementType* pOutput = output.GetDataPointer();
+
+        size_t rowSize = numColumns * numChannels;
+        size_t grainSize = std::max<size_t>(1, Internal::minElementsPerTask / rowSize);
+        utilities::ParallelFor(numRows, grainSize, [&](size_t begin, size_t end) {
+            // the resampled input rows, which consecutive output rows often share when enlarging
+            const size_t none = std::numeric_limits<size_t>::max();
+            std::vector<ElementType> buffers[2] = { std::vector<ElementType>(rowSize), std::vector<ElementType>(rowSize) };
+            size_t bufferedRows[2] = { none, none };
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t first = rows.firstIndex[i];
+                size_t second = rows.secondIndex[i];
+                ElementType weight = rows.weight[i];
+                if (bufferedRows[0] != first)
+                {
+                    if (bufferedRows[1] == first)
+                    {
+                        std::swap(buffers[0], buffers[1]);
+                        std::swap(bufferedRows[0], bufferedRows[1]);
+                    }
+                    else
+                    {
+                        Internal::ResampleRow<interpolation>(pInput + rows.firstOffset[i], columns, inputChannelIncrement, numChannels, channelsInnermost, buffers[0].data());
+                        bufferedRows[0] = first;
+                    }
+                }
+                if (weight != 0 && bufferedRows[1] != second)
+                {
+                    Internal::ResampleRow<interpolation>(pInput + rows.secondOffset[i], columns, inputChannelIncrement, numChannels, channelsInnermost, buffers[1].data());
+                    bufferedRows[1] = second;
+                }
+                Internal::BlendRows(buffers[0].data(), buffers[1].data(), weight, outputIncrements, numColumns, numChannels, channelsInnermost, pOutput + i * outputRowIncrement);
+            }
+        });
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> Crop(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t firstRow, size_t firstColumn, size_t numRows, size_t numColumns)
+    {
+        Internal::CheckCrop(tensor.GetShape(), firstRow, firstColumn, numRows, numColumns);
+        return tensor.GetSubTensor(firstRow, firstColumn, 0, numRows, numColumns, tensor.NumChannels());
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> Crop(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t firstRow, size_t firstColumn, size_t numRows, size_t numColumns)
+    {
+        Internal::CheckCrop(tensor.GetShape(), firstRow, firstColumn, numRows, numColumns);
+        return tensor.GetSubTensor(firstRow, firstColumn, 0, numRows, numColumns, tensor.NumChannels());
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    ConstTensorReference<ElementType, dimension0, dimension1, dimension2> CenterCrop(ConstTensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t numRows, size_t numColumns)
+    {
+        Internal::CheckCrop(tensor.GetShape(), 0, 0, numRows, numColumns);
+        return Crop(tensor, (tensor.NumRows() - numRows) / 2, (tensor.NumColumns() - numColumns) / 2, numRows, numColumns);
+    }
+
+    template <typename ElementType, Dimension dimension0, Dimension dimension1, Dimension dimension2>
+    TensorReference<ElementType, dimension0, dimension1, dimension2> CenterCrop(TensorReference<ElementType, dimension0, dimension1, dimension2> tensor, size_t numRows, size_t numColumns)
+    {
+        Internal::CheckCrop(tensor.GetShape(), 0, 0, numRows, numColumns);
+        return Crop(tensor, (tensor.NumRows() - numRows) / 2, (tensor.NumColumns() - numColumns) / 2, numRows, numColumns);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
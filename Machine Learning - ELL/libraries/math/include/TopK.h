@@ -0,0 +1,318 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TopK.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary> Which elements a top-k selection keeps. </summary>
+    enum class TopKOrder
+    {
+        largest,
+        smallest
+    };
+
+    namespace Internal
+    {
+        /// <summary> An element of a top-k selection and its position. </summary>
+        template <typename ElementType>
+        struct TopKCandidate
+        {
+            ElementType value;
+            size_t index;
+        };
+    } // namespace Internal
+
+    /// <summary>
+    /// Selects the k best elements of each row of a stream of tiles, such as the tiles of StreamPairwiseDistances,
+    /// so that the full matrix never has to exist. Each row keeps a heap of its k best elements; the elements of
+    /// a tile are compared with the worst of them in a vectorized filter, and only those that pass reach the heap.
+    /// Rows of a tile are distributed over the thread pool. Among equal elements, the one with the smallest column
+    /// index is kept, provided that the tiles of each row arrive in increasing order of columns.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="order"> Whether the largest or the smallest elements are kept. </typeparam>
+    template <typename ElementType, TopKOrder order = TopKOrder::largest>
+    class RowwiseTopKSelector
+    {
+    public:
+        /// <summary> Constructs a selector for a matrix with the given number of rows. </summary>
+        ///
+        /// <param name="numRows"> The number of rows. </param>
+        /// <param name="k"> The number of elements kept per row. </param>
+        RowwiseTopKSelector(size_t numRows, size_t k);
+
+        /// <summary> Gets the number of rows. </summary>
+        size_t NumRows() const { return _numRows; }
+
+        /// <summary> Gets the number of elements kept per row. </summary>
+        size_t GetK() const { return _k; }
+
+        /// <summary> Adds the elements of a tile to the selection. </summary>
+        ///
+        /// <param name="firstRow"> The row of the matrix that the first row of the tile belongs to. </param>
+        /// <param name="firstColumn"> The column index of the first column of the tile. </param>
+        /// <param name="tile"> The tile. </param>
+        template <MatrixLayout layout>
+        void operator()(size_t firstRow, size_t firstColumn, ConstMatrixReference<ElementType, layout> tile);
+
+        /// <summary>
+        /// Gets the selected elements of each row, best first. Throws if a row has received fewer than k elements.
+        /// </summary>
+        ///
+        /// <param name="values"> The matrix used to store the values, with k columns. </param>
+        /// <param name="indices"> The matrix used to store the column indices, with k columns. </param>
+        template <MatrixLayout layout>
+        void GetResult(MatrixReference<ElementType, layout> values, MatrixReference<size_t, layout> indices) const;
+
+    private:
+        size_t _numRows;
+        size_t _k;
+        std::vector<Internal::TopKCandidate<ElementType>> _candidates;
+        std::vector<size_t> _sizes;
+    };
+
+    /// <summary>
+    /// Selects the k best elements of a vector, where k is the size of the output vectors, and stores them best
+    /// first. Among equal elements, the one with the smallest index comes first.
+    /// </summary>
+    ///
+    /// <typeparam name="order"> Whether the largest or the smallest elements are selected. </typeparam>
+    /// <param name="vector"> The vector, with at least k elements. </param>
+    /// <param name="values"> The vector used to store the values. </param>
+    /// <param name="indices"> The vector used to store the indices. </param>
+    template <TopKOrder order = TopKOrder::largest, typename ElementType, VectorOrientation orientation, VectorOrientation outputOrientation>
+    void TopK(ConstVectorReference<ElementType, orientation> vector, VectorReference<ElementType, outputOrientation> values, VectorReference<size_t, outputOrientation> indices);
+
+    /// <summary>
+    /// Selects the k best elements of each row of a matrix, where k is the number of columns of the outputs, and
+    /// stores them best first, as RowwiseTopKSelector does. Rows are distributed over the thread pool.
+    /// </summary>
+    ///
+    /// <typeparam name="order"> Whether the largest or the smallest elements are selected. </typeparam>
+    /// <param name="matrix"> The matrix, with at least k columns. </param>
+    /// <param name="values"> The matrix used to store the values. </param>
+    /// <param name="indices"> The matrix used to store the column indices. </param>
+    template <TopKOrder order = TopKOrder::largest, typename ElementType, MatrixLayout layout, MatrixLayout outputLayout>
+    void RowwiseTopK(ConstMatrixReference<ElementType, layout> matrix, MatrixReference<ElementType, outputLayout> values, MatrixReference<size_t, outputLayout> indices);
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+#include "Common.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+
+namespace ell
+{
+namespace math
+{
+    namespace Internal
+    {
+        // the elements are filtered in chunks of this size, and the heap is only visited by chunks with a candidate
+        constexpr size_t topKChunkSize = 64;
+
+        template <typename ElementType, TopKOrder order>
+        struct TopKComparer
+        {
+            static bool IsBetter(ElementType a, ElementType b) { return order == TopKOrder::largest ? a > b : a < b; }
+
+            // a comes before b in the result
+            bool operator()(const TopKCandidate<ElementType>& a, const TopKCandidate<ElementType>& b) const
+            {
+                return IsBetter(a.value, b.value) || (a.value == b.value && a.index < b.index);
+            }
+        };
+
+        // adds a contiguous array of elements, whose indices start at firstIndex, to a heap of at most k candidates,
+        // whose front is the worst of them
+        template <TopKOrder order, typename ElementType>
+        void AccumulateTopK(const ElementType* pData, size_t size, size_t firstIndex, TopKCandidate<ElementType>* pHeap, size_t k, size_t& heapSize)
+        {
+            if (k == 0)
+            {
+                return;
+            }
+
+            using Comparer = TopKComparer<ElementType, order>;
+            Comparer comparer;
+            size_t i = 0;
+            for (; i < size && heapSize < k; ++i)
+            {
+                pHeap[heapSize++] = { pData[i], firstIndex + i };
+                std::push_heap(pHeap, pHeap + heapSize, comparer);
+            }
+            if (i == size)
+            {
+                return;
+            }
+
+            ElementType threshold = pHeap[0].value;
+            for (; i < size; i += topKChunkSize)
+            {
+                size_t count = std::min(topKChunkSize, size - i);
+                const ElementType* pChunk = pData + i;
+
+                // counted without branches, so that the compiler vectorizes the loop
+                size_t numCandidates = 0;
+                for (size_t j = 0; j < count; ++j)
+                {
+                    numCandidates += Comparer::IsBetter(pChunk[j], threshold) ? 1 : 0;
+                }
+                if (numCandidates == 0)
+                {
+                    continue;
+                }
+
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (Comparer::IsBetter(pChunk[j], threshold))
+                    {
+                        std::pop_heap(pHeap, pHeap + k, comparer);
+                        pHeap[k - 1] = { pChunk[j], firstIndex + i + j };
+                        std::push_heap(pHeap, pHeap + k, comparer);
+                        threshold = pHeap[0].value;
+                    }
+                }
+            }
+        }
+
+        // adds a strided array of elements to a heap, through a contiguous buffer of topKChunkSize elements
+        template <TopKOrder order, typename ElementType>
+        void AccumulateTopK(const ElementType* pData, size_t size, size_t increment, size_t firstIndex, TopKCandidate<ElementType>* pHeap, size_t k, size_t& heapSize, ElementType* pBuffer)
+        {
+            if (increment == 1)
+            {
+                AccumulateTopK<order>(pData, size, firstIndex, pHeap, k, heapSize);
+                return;
+            }
+
+            for (size_t begin = 0; begin < size; begin += topKChunkSize)
+            {
+                size_t count = std::min(topKChunkSize, size - begin);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    pBuffer[j] = pData[(begin + j) * increment];
+                }
+                AccumulateTopK<order>(pBuffer, count, firstIndex + begin, pHeap, k, heapSize);
+            }
+        }
+
+        // sorts the candidates of a heap, best first, and stores them in two strided arrays
+        template <TopKOrder order, typename ElementType>
+        void WriteTopK(TopKCandidate<ElementType>* pHeap, size_t k, ElementType* pValues, size_t* pIndices, size_t valuesIncrement, size_t indicesIncrement)
+        {
+            std::sort(pHeap, pHeap + k, TopKComparer<ElementType, order>{});
+            for (size_t j = 0; j < k; ++j)
+            {
+                pValues[j * valuesIncrement] = pHeap[j].value;
+                pIndices[j * indicesIncrement] = pHeap[j].index;
+            }
+        }
+    } // namespace Internal
+
+    template <typename ElementType, TopKOrder order>
+    RowwiseTopKSelector<ElementType, order>::RowwiseTopKSelector(size_t numRows, size_t k) :
+        _numRows(numRows),
+        _k(k),
+        _candidates(numRows * k),
+        _sizes(numRows, 0)
+    {}
+
+    template <typename ElementType, TopKOrder order>
+    template <MatrixLayout layout>
+    void RowwiseTopKSelector<ElementType, order>::operator()(size_t firstRow, size_t firstColumn, ConstMatrixReference<ElementType, layout> tile)
+    {
+        if (firstRow + tile.NumRows() > _numRows)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::indexOutOfRange, "The tile exceeds the rows of the selector.");
+        }
+
+        const size_t size = tile.NumColumns();
+        const size_t increment = tile.GetColumnIncrement();
+        size_t grainSize = size == 0 ? tile.NumRows() : (Internal::minElementsPerTask + size - 1) / size;
+        utilities::ParallelFor(tile.NumRows(), grainSize, [&](size_t begin, size_t end) {
+            ElementType buffer[Internal::topKChunkSize];
+            for (size_t i = begin; i < end; ++i)
+            {
+                size_t row = firstRow + i;
+                const ElementType* pRow = tile.GetConstDataPointer() + i * tile.GetRowIncrement();
+                Internal::AccumulateTopK<order>(pRow, size, increment, firstColumn, _candidates.data() + row * _k, _k, _sizes[row], buffer);
+            }
+        });
+    }
+
+    template <typename ElementType, TopKOrder order>
+    template <MatrixLayout layout>
+    void RowwiseTopKSelector<ElementType, order>::GetResult(MatrixReference<ElementType, layout> values, MatrixReference<size_t, layout> indices) const
+    {
+        if (values.NumRows() != _numRows || indices.NumRows() != _numRows || values.NumColumns() != _k || indices.NumColumns() != _k)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The outputs must have one row per row of the selector and k columns.");
+        }
+        if (std::any_of(_sizes.begin(), _sizes.end(), [this](size_t size) { return size < _k; }))
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "A row has received fewer than k elements.");
+        }
+
+        size_t grainSize = _k == 0 ? _numRows : (Internal::minElementsPerTask + _k - 1) / _k;
+        utilities::ParallelFor(_numRows, grainSize, [&](size_t begin, size_t end) {
+            std::vector<Internal::TopKCandidate<ElementType>> heap(_k);
+            for (size_t i = begin; i < end; ++i)
+            {
+                std::copy(_candidates.begin() + i * _k, _candidates.begin() + (i + 1) * _k, heap.begin());
+                Internal::WriteTopK<order>(heap.data(), _k, values.GetDataPointer() + i * values.GetRowIncrement(), indices.GetDataPointer() + i * indices.GetRowIncrement(), values.GetColumnIncrement(), indices.GetColumnIncrement());
+            }
+        });
+    }
+
+    template <TopKOrder order, typename ElementType, VectorOrientation orientation, VectorOrientation outputOrientation>
+    void TopK(ConstVectorReference<ElementType, orientation> vector, VectorReference<ElementType, outputOrientation> values, VectorReference<size_t, outputOrientation> indices)
+    {
+        const size_t k = values.Size();
+        if (indices.Size() != k || vector.Size() < k)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The outputs must have the same size, which cannot exceed the size of the vector.");
+        }
+
+        std::vector<Internal::TopKCandidate<ElementType>> heap(k);
+        ElementType buffer[Internal::topKChunkSize];
+        size_t heapSize = 0;
+        Internal::AccumulateTopK<order>(vector.GetConstDataPointer(), vector.Size(), vector.GetIncrement(), 0, heap.data(), k, heapSize, buffer);
+        Internal::WriteTopK<order>(heap.data(), k, values.GetDataPointer(), indices.GetDataPointer(), values.GetIncrement(), indices.GetIncrement());
+    }
+
+    template <TopKOrder order, typename ElementType, MatrixLayout layout, MatrixLayout outputLayout>
+    void RowwiseTopK(ConstMatrixReference<ElementType, layout> matrix, MatrixReference<ElementType, outputLayout> values, MatrixReference<size_t, outputLayout> indices)
+    {
+        if (matrix.NumColumns() < values.NumColumns())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "k cannot exceed the number of columns of the matrix.");
+        }
+
+        RowwiseTopKSelector<ElementType, order> selector(matrix.NumRows(), values.NumColumns());
+        selector(0, 0, matrix);
+        selector.GetResult(values, indices);
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
@@ -0,0 +1,173 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/include/TransformationKernels.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include "Transformations.h"
+
+#include <cstddef>
+
+namespace ell
+{
+namespace math
+{
+    /// <summary>
+    /// Bulk transformation kernels. Each kernel is a branch free polynomial (or rational) approximation that
+    /// the compiler turns into SIMD code over contiguous arrays, and each one has a scalar overload that
+    /// computes exactly the same values, so that the Vectorized*Transformation function pointers can be
+    /// used anywhere a Transformation is expected.
+    ///
+    /// Maximum error against the exact result, measured on a dense sample of the finite input range:
+    ///
+    ///     kernel            float      double
+    ///     exp               1 ULP      1 ULP
+    ///     log               1 ULP      1 ULP
+    ///     tanh              1.5 ULP    1.5 ULP
+    ///     sigmoid           3 ULP      3 ULP
+    ///     erf               8 ULP      2 ULP    (the float error is below 5e-7 absolute, near |x| = 3.6)
+    ///     sqrt              0.5 ULP    0.5 ULP  (IEEE square root)
+    ///
+    /// exp flushes to zero below the smallest subnormal and returns infinity above the largest finite result,
+    /// log returns -infinity for zero and NaN for negative inputs; all kernels propagate NaN.
+    /// </summary>
+    ///
+    /// <param name="pInput"> The input elements. </param>
+    /// <param name="pOutput"> The output elements, which may be the same array as the input. </param>
+    /// <param name="size"> The number of elements. </param>
+    void VectorizedExponent(const float* pInput, float* pOutput, size_t size);
+    void VectorizedExponent(const double* pInput, double* pOutput, size_t size);
+    void VectorizedNaturalLog(const float* pInput, float* pOutput, size_t size);
+    void VectorizedNaturalLog(const double* pInput, double* pOutput, size_t size);
+    void VectorizedHyperbolicTangent(const float* pInput, float* pOutput, size_t size);
+    void VectorizedHyperbolicTangent(const double* pInput, double* pOutput, size_t size);
+    void VectorizedSigmoid(const float* pInput, float* pOutput, size_t size);
+    void VectorizedSigmoid(const double* pInput, double* pOutput, size_t size);
+    void VectorizedErrorFunction(const float* pInput, float* pOutput, size_t size);
+    void VectorizedErrorFunction(const double* pInput, double* pOutput, size_t size);
+    void VectorizedSquareRoot(const float* pInput, float* pOutput, size_t size);
+    void VectorizedSquareRoot(const double* pInput, double* pOutput, size_t size);
+    void VectorizedRectifiedLinear(const float* pInput, float* pOutput, size_t size);
+    void VectorizedRectifiedLinear(const double* pInput, double* pOutput, size_t size);
+
+    /// <summary> Scalar versions of the bulk kernels, which return exactly what the bulk kernels return. </summary>
+    ///
+    /// <param name="x"> The input. </param>
+    ///
+    /// <returns> The transformed input. </returns>
+    float VectorizedExponent(float x);
+    double VectorizedExponent(double x);
+    float VectorizedNaturalLog(float x);
+    double VectorizedNaturalLog(double x);
+    float VectorizedHyperbolicTangent(float x);
+    double VectorizedHyperbolicTangent(double x);
+    float VectorizedSigmoid(float x);
+    double VectorizedSigmoid(double x);
+    float VectorizedErrorFunction(float x);
+    double VectorizedErrorFunction(double x);
+
+    template <typename ElementType>
+    constexpr auto VectorizedExponentTransformation = static_cast<Transformation<ElementType>>(VectorizedExponent);
+
+    template <typename ElementType>
+    constexpr auto VectorizedNaturalLogTransformation = static_cast<Transformation<ElementType>>(VectorizedNaturalLog);
+
+    template <typename ElementType>
+    constexpr auto VectorizedHyperbolicTangentTransformation = static_cast<Transformation<ElementType>>(VectorizedHyperbolicTangent);
+
+    template <typename ElementType>
+    constexpr auto VectorizedSigmoidTransformation = static_cast<Transformation<ElementType>>(VectorizedSigmoid);
+
+    template <typename ElementType>
+    constexpr auto VectorizedErrorFunctionTransformation = static_cast<Transformation<ElementType>>(VectorizedErrorFunction);
+
+    /// <summary> A transformation applied to a whole contiguous array at once. </summary>
+    template <typename ElementType>
+    using BulkTransformation = void (*)(const ElementType*, ElementType*, size_t);
+
+    /// <summary>
+    /// Finds the bulk kernel that computes the same values as a transformation. The Vectorized*Transformation
+    /// function pointers, SquareRootTransformation and RectifiedLinearTransformation have bulk kernels.
+    /// </summary>
+    ///
+    /// <typeparam name="ElementType"> The element type. </typeparam>
+    /// <typeparam name="TransformationType"> The transformation type. </typeparam>
+    /// <param name="transformation"> The transformation. </param>
+    ///
+    /// <returns> The bulk kernel, or nullptr if the transformation does not have one. </returns>
+    template <typename ElementType, typename TransformationType>
+    BulkTransformation<ElementType> GetBulkTransformation(TransformationType transformation);
+
+    /// <summary>
+    /// Applies a transformation to a contiguous array, with its bulk kernel when it has one and element by
+    /// element otherwise.
+    /// </summary>
+    ///
+    /// <param name="transformation"> The transformation. </param>
+    /// <param name="pInput"> The input elements. </param>
+    /// <param name="pOutput"> The output elements, which may be the same array as the input. </param>
+    /// <param name="size"> The number of elements. </param>
+    template <typename ElementType, typename TransformationType>
+    void TransformContiguous(TransformationType transformation, const ElementType* pInput, ElementType* pOutput, size_t size);
+
+    namespace Internal
+    {
+        BulkTransformation<float> FindBulkTransformation(Transformation<float> transformation);
+        BulkTransformation<double> FindBulkTransformation(Transformation<double> transformation);
+
+        template <typename ElementType, typename TransformationType>
+        struct BulkTransformationFinder
+        {
+            static BulkTransformation<ElementType> Find(TransformationType) { return nullptr; }
+        };
+
+        template <>
+        struct BulkTransformationFinder<float, Transformation<float>>
+        {
+            static BulkTransformation<float> Find(Transformation<float> transformation) { return FindBulkTransformation(transformation); }
+        };
+
+        template <>
+        struct BulkTransformationFinder<double, Transformation<double>>
+        {
+            static BulkTransformation<double> Find(Transformation<double> transformation) { return FindBulkTransformation(transformation); }
+        };
+    } // namespace Internal
+} // namespace math
+} // namespace ell
+
+#pragma region implementation
+
+namespace ell
+{
+namespace math
+{
+    template <typename ElementType, typename TransformationType>
+    BulkTransformation<ElementType> GetBulkTransformation(TransformationType transformation)
+    {
+        return Internal::BulkTransformationFinder<ElementType, TransformationType>::Find(transformation);
+    }
+
+    template <typename ElementType, typename TransformationType>
+    void TransformContiguous(TransformationType transformation, const ElementType* pInput, ElementType* pOutput, size_t size)
+    {
+        auto bulkTransformation = GetBulkTransformation<ElementType>(transformation);
+        if (bulkTransformation != nullptr)
+        {
+            bulkTransformation(pInput, pOutput, size);
+            return;
+        }
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            pOutput[i] = transformation(pInput[i]);
+        }
+    }
+} // namespace math
+} // namespace ell
+
+#pragma endregion implementation
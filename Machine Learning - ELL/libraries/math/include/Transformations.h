@@ -99,5 +99,29 @@ namespace ell
 
         template <typename ElementType>
         constexpr auto SquareTransformation = static_cast<Transformation<ElementType>>(SquareTransformationImplementation);
+
+        template <typename ElementType, utilities::IsFundamental<ElementType> concept = true>
+        ElementType RectifiedLinearTransformationImplementation(ElementType x)
+        {
+            return x > 0 ? x : 0;
+        }
+
+        template <typename ElementType>
+        constexpr auto RectifiedLinearTransformation = static_cast<Transformation<ElementType>>(RectifiedLinearTransformationImplementation);
+
+        /* The logistic sigmoid 1/(1+exp(-x)), evaluated so that exp never overflows */
+        template <typename ElementType, utilities::IsFundamental<ElementType> concept = true>
+        ElementType SigmoidTransformationImplementation(ElementType x)
+        {
+            if (x >= 0)
+            {
+                return 1 / (1 + std::exp(-x));
+            }
+            auto expX = std::exp(x);
+            return expX / (1 + expX);
+        }
+
+        template <typename ElementType>
+        constexpr auto SigmoidTransformation = static_cast<Transformation<ElementType>>(SigmoidTransformationImplementation);
     }
 } 
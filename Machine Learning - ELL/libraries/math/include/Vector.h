@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "ElementConversion.h"
+
 #include <utilities/include/IArchivable.h>
 #include <utilities/include/StlStridedIterator.h>
 
@@ -85,7 +87,6 @@ namespace ell
             bool operator!=(const ConstVectorReference<ElementType, orientation>& other) const;
             bool operator!=(const ConstVectorReference<ElementType, TransposeVectorOrientation<orientation>::value>&) const {return true;}
 
-            ConstVectorReference<ElementType, orientation> GetConstDataPointer() const {return *this;}
             ConstVectorReference<ElementType, orientation> GetSubVector(size_t offset, size_t size) const;
             auto Transpose() const -> ConstVectorReference<ElementType, TransposeVectorOrientation<orientation>::value>
             {
@@ -108,7 +109,7 @@ namespace ell
                 void Swap(VectorReference<ElementType, orientation>& other);
                 
                 template <typename OtherElementType>
-                void CopyFrom(ConstVectorReference<OtherElementType, orientation> other);
+                void CopyFrom(ConstVectorReference<OtherElementType, orientation> other, ConversionOptions options = {});
                 
                 void Reset();
                 void Fill(ElementType value);
@@ -409,36 +410,14 @@ namespace ell
 
         template <typename ElementType, VectorOrientation orientation>
         template <typename OtherElementType>
-        void VectorReference<ElementType, orientation>::CopyFrom(ConstVectorReference<OtherElementType, orientation> other)
+        void VectorReference<ElementType, orientation>::CopyFrom(ConstVectorReference<OtherElementType, orientation> other, ConversionOptions options)
         {
             if (this->Size() != other.Size())
             {
                 throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "this vector and other vector are not the same size.");
             }
 
-            ElementType* pData = GetDataPointer();
-            const OtherElementType* pOtherData = other.GetConstDataPointer();
-            const size_t otherIncrement = other.GetIncrement();
-            const OtherElementType* pOtherEnd = pOtherData + otherIncrement * other.Size();
-
-            if (this->GetIncrement() == 1 && otherIncrement == 1)
-            {
-                while (pOtherData < pOtherEnd)
-                {
-                    (*pData) = static_cast<ElementType>(*pOtherData);
-                    ++pData;
-                    ++pOtherData;
-                }
-            }
-            else
-            {
-                while(pOtherData < pOtherEnd)
-                {
-                    (*pData) = static_cast<ElementType>(*pOtherData);
-                    pData += this->GetIncrement();
-                    pOtherData += otherIncrement;
-                }
-            }
+            ConvertElements(other.GetConstDataPointer(), other.GetIncrement(), GetDataPointer(), this->GetIncrement(), this->Size(), options);
         }
 
         template <typename ElementType, VectorOrientation orientation>
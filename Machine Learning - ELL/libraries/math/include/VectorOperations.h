@@ -11,6 +11,7 @@
 #include "BlasWrapper.h"
 #include "Common.h"
 #include "Matrix.h"
+#include "TransformationKernels.h"
 #include "Transformations.h"
 #include "Vector.h"
 #include <utilities/include/TypeTraits.h>
@@ -136,7 +137,7 @@ namespace ell
         
         template <ImplementationType implementation = ImplementationType::openBlas,
                   typename ElementType, VectorOrientation orientation>
-        void ScaleUpdate(ElementType scalar, ConstVectorReference<ElementType, orientation> vector);
+        void ScaleUpdate(ElementType scalar, VectorReference<ElementType, orientation> vector);
 
         template <ImplementationType implementation = ImplementationType::openBlas, 
                   typename ElementType, VectorOrientation orientation>
@@ -204,7 +205,7 @@ namespace ell
 
         template <ImplementationType implementation = ImplementationType::openBlas, typename ElementType>
         void InnerProduct (ConstRowVectorReference<ElementType> vectorA, 
-                           ConstRowVectorReference<ElementType> vectorB, 
+                           ConstColumnVectorReference<ElementType> vectorB, 
                            ElementType& result);
 
         template <typename ElementType>
@@ -313,6 +314,15 @@ namespace ell
             template <>
             struct VectorOperations<ImplementationType::openBlas> : public VectorOperations<ImplementationType::native>
             {};
+
+            // vector operations are bound by memory bandwidth, so every implementation shares the native loops
+            template <>
+            struct VectorOperations<ImplementationType::blocked> : public VectorOperations<ImplementationType::native>
+            {};
+
+            template <>
+            struct VectorOperations<ImplementationType::automatic> : public VectorOperations<ImplementationType::native>
+            {};
         }        
     }
 }
@@ -735,6 +745,14 @@ namespace ell
             }
         }
 
+        template <ImplementationType implementation, typename ElementType>
+        void InnerProduct(ConstRowVectorReference<ElementType> vectorA, ConstColumnVectorReference<ElementType> vectorB, ElementType& result)
+        {
+            DEBUG_CHECK_SIZES(vectorA.Size() != vectorB.Size(), "Incompatible vector sizes.");
+
+            Internal::VectorOperations<implementation>::InnerProduct(vectorA, vectorB, result);
+        }
+
         template <typename ElementType>
         ElementType Dot(UnorientedConstVectorBase<ElementType> vectorA, UnorientedConstVectorBase<ElementType> vectorB)
         {
@@ -787,10 +805,15 @@ namespace ell
         }
 
         template <typename ElementType, VectorOrientation orientation, typename TransformationType>
-    void TransformUpdate(TransformationType transformation, VectorReference<ElementType, orientation> vector)
-    {
-        vector.Transform(transformation);
-}
+        void TransformUpdate(TransformationType transformation, VectorReference<ElementType, orientation> vector)
+        {
+            if (vector.IsContiguous())
+            {
+                TransformContiguous(transformation, vector.GetConstDataPointer(), vector.GetDataPointer(), vector.Size());
+                return;
+            }
+            vector.Transform(transformation);
+        }
 
         template <typename ElementType, VectorOrientation orientation, typename TransformationType>
         void TransformSet(TransformationType transformation, ConstVectorReference<ElementType, orientation> vector, 
@@ -798,7 +821,13 @@ namespace ell
         {
             DEBUG_CHECK_SIZES(vector.Size() != output.Size(), "Incompatible vector sizes");
 
-            ElementType *pOutputData = output.GetConstDataPointer();
+            if (vector.IsContiguous() && output.IsContiguous())
+            {
+                TransformContiguous(transformation, vector.GetConstDataPointer(), output.GetDataPointer(), output.Size());
+                return;
+            }
+
+            ElementType *pOutputData = output.GetDataPointer();
             const ElementType *pVectorData = vector.GetConstDataPointer();
             const ElementType *pOutputEnd = pOutputData + output.Size() * output.GetIncrement();
             while (pOutputData < pOutputEnd)
@@ -0,0 +1,308 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/src/BinaryMatrix.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "BinaryMatrix.h"
+
+#include <utilities/include/Exception.h>
+
+// The library is built for the baseline instruction set, so the kernels that need POPCNT or AVX-512 VPOPCNTDQ
+// are compiled for them one function at a time, with target attributes, and are only called after checking
+// that the host supports them. Each kernel counts one row against four rows at once, so that the words of the
+// first row are loaded once per four products.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ELL_X86_POPCOUNT_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        //
+        // portable kernels
+        //
+
+        inline uint64_t PortablePopcount(uint64_t x)
+        {
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return (x * 0x0101010101010101ull) >> 56;
+        }
+
+        uint64_t PortableXorPopcount(const uint64_t* pA, const uint64_t* pB, size_t numWords)
+        {
+            uint64_t count = 0;
+            for (size_t w = 0; w < numWords; ++w)
+            {
+                count += PortablePopcount(pA[w] ^ pB[w]);
+            }
+            return count;
+        }
+
+        void PortablePairwiseXorPopcount(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement)
+        {
+            for (size_t i = 0; i < numRowsA; ++i)
+            {
+                const uint64_t* a = pA + i * numWords;
+                uint32_t* output = pOutput + i * outputRowIncrement;
+                size_t j = 0;
+                for (; j + 4 <= numRowsB; j += 4)
+                {
+                    const uint64_t* b = pB + j * numWords;
+                    uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                    for (size_t w = 0; w < numWords; ++w)
+                    {
+                        uint64_t word = a[w];
+                        c0 += PortablePopcount(word ^ b[w]);
+                        c1 += PortablePopcount(word ^ b[numWords + w]);
+                        c2 += PortablePopcount(word ^ b[2 * numWords + w]);
+                        c3 += PortablePopcount(word ^ b[3 * numWords + w]);
+                    }
+                    output[j] = static_cast<uint32_t>(c0);
+                    output[j + 1] = static_cast<uint32_t>(c1);
+                    output[j + 2] = static_cast<uint32_t>(c2);
+                    output[j + 3] = static_cast<uint32_t>(c3);
+                }
+                for (; j < numRowsB; ++j)
+                {
+                    output[j] = static_cast<uint32_t>(PortableXorPopcount(a, pB + j * numWords, numWords));
+                }
+            }
+        }
+
+#if ELL_X86_POPCOUNT_KERNELS
+        //
+        // POPCNT kernels
+        //
+
+        __attribute__((target("popcnt"))) uint64_t PopcntXorPopcount(const uint64_t* pA, const uint64_t* pB, size_t numWords)
+        {
+            uint64_t count = 0;
+            for (size_t w = 0; w < numWords; ++w)
+            {
+                count += static_cast<uint64_t>(__builtin_popcountll(pA[w] ^ pB[w]));
+            }
+            return count;
+        }
+
+        __attribute__((target("popcnt"))) void PopcntPairwiseXorPopcount(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement)
+        {
+            for (size_t i = 0; i < numRowsA; ++i)
+            {
+                const uint64_t* a = pA + i * numWords;
+                uint32_t* output = pOutput + i * outputRowIncrement;
+                size_t j = 0;
+                for (; j + 4 <= numRowsB; j += 4)
+                {
+                    const uint64_t* b = pB + j * numWords;
+                    uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                    for (size_t w = 0; w < numWords; ++w)
+                    {
+                        uint64_t word = a[w];
+                        c0 += static_cast<uint64_t>(__builtin_popcountll(word ^ b[w]));
+                        c1 += static_cast<uint64_t>(__builtin_popcountll(word ^ b[numWords + w]));
+                        c2 += static_cast<uint64_t>(__builtin_popcountll(word ^ b[2 * numWords + w]));
+                        c3 += static_cast<uint64_t>(__builtin_popcountll(word ^ b[3 * numWords + w]));
+                    }
+                    output[j] = static_cast<uint32_t>(c0);
+                    output[j + 1] = static_cast<uint32_t>(c1);
+                    output[j + 2] = static_cast<uint32_t>(c2);
+                    output[j + 3] = static_cast<uint32_t>(c3);
+                }
+                for (; j < numRowsB; ++j)
+                {
+                    output[j] = static_cast<uint32_t>(PopcntXorPopcount(a, pB + j * numWords, numWords));
+                }
+            }
+        }
+
+        //
+        // AVX-512 VPOPCNTDQ kernels, eight words per instruction; the last words of a row are read with a masked load
+        //
+
+        __attribute__((target("avx512f,avx512vpopcntdq"))) inline __m512i Avx512LoadTail(const uint64_t* p, size_t count)
+        {
+            return _mm512_maskz_loadu_epi64(static_cast<__mmask8>((1u << count) - 1), p);
+        }
+
+        __attribute__((target("avx512f,avx512vpopcntdq"))) uint64_t Avx512XorPopcount(const uint64_t* pA, const uint64_t* pB, size_t numWords)
+        {
+            __m512i sum = _mm512_setzero_si512();
+            size_t w = 0;
+            for (; w + 8 <= numWords; w += 8)
+            {
+                __m512i x = _mm512_xor_si512(_mm512_loadu_si512(pA + w), _mm512_loadu_si512(pB + w));
+                sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+            }
+            if (w < numWords)
+            {
+                __m512i x = _mm512_xor_si512(Avx512LoadTail(pA + w, numWords - w), Avx512LoadTail(pB + w, numWords - w));
+                sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+            }
+            return static_cast<uint64_t>(_mm512_reduce_add_epi64(sum));
+        }
+
+        // the four sums of the lanes of c0, c1, c2 and c3, with one reduction instead of four
+        __attribute__((target("avx512f,avx512vpopcntdq"))) inline void Avx512StoreSums(__m512i c0, __m512i c1, __m512i c2, __m512i c3, uint32_t* pOutput)
+        {
+            __m512i c01 = _mm512_add_epi64(_mm512_unpacklo_epi64(c0, c1), _mm512_unpackhi_epi64(c0, c1));
+            __m512i c23 = _mm512_add_epi64(_mm512_unpacklo_epi64(c2, c3), _mm512_unpackhi_epi64(c2, c3));
+            __m512i sums = _mm512_add_epi64(_mm512_shuffle_i64x2(c01, c23, _MM_SHUFFLE(2, 0, 2, 0)), _mm512_shuffle_i64x2(c01, c23, _MM_SHUFFLE(3, 1, 3, 1)));
+            sums = _mm512_add_epi64(sums, _mm512_shuffle_i64x2(sums, sums, _MM_SHUFFLE(2, 3, 0, 1)));
+            alignas(16) uint64_t values[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(values), _mm512_castsi512_si128(sums));
+            _mm_store_si128(reinterpret_cast<__m128i*>(values + 2), _mm512_extracti32x4_epi32(sums, 2));
+            for (size_t k = 0; k < 4; ++k)
+            {
+                pOutput[k] = static_cast<uint32_t>(values[k]);
+            }
+        }
+
+        __attribute__((target("avx512f,avx512vpopcntdq"))) void Avx512PairwiseXorPopcount(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement)
+        {
+            // rows shorter than a register leave lanes idle, and scalar POPCNT is faster
+            if (numWords < 8)
+            {
+                PopcntPairwiseXorPopcount(pA, numRowsA, pB, numRowsB, numWords, pOutput, outputRowIncrement);
+                return;
+            }
+
+            for (size_t i = 0; i < numRowsA; ++i)
+            {
+                const uint64_t* a = pA + i * numWords;
+                uint32_t* output = pOutput + i * outputRowIncrement;
+                size_t j = 0;
+                for (; j + 4 <= numRowsB; j += 4)
+                {
+                    const uint64_t* b = pB + j * numWords;
+                    __m512i c0 = _mm512_setzero_si512();
+                    __m512i c1 = _mm512_setzero_si512();
+                    __m512i c2 = _mm512_setzero_si512();
+                    __m512i c3 = _mm512_setzero_si512();
+                    for (size_t w = 0; w < numWords; w += 8)
+                    {
+                        size_t count = numWords - w < 8 ? numWords - w : 8;
+                        __m512i word = Avx512LoadTail(a + w, count);
+                        c0 = _mm512_add_epi64(c0, _mm512_popcnt_epi64(_mm512_xor_si512(word, Avx512LoadTail(b + w, count))));
+                        c1 = _mm512_add_epi64(c1, _mm512_popcnt_epi64(_mm512_xor_si512(word, Avx512LoadTail(b + numWords + w, count))));
+                        c2 = _mm512_add_epi64(c2, _mm512_popcnt_epi64(_mm512_xor_si512(word, Avx512LoadTail(b + 2 * numWords + w, count))));
+                        c3 = _mm512_add_epi64(c3, _mm512_popcnt_epi64(_mm512_xor_si512(word, Avx512LoadTail(b + 3 * numWords + w, count))));
+                    }
+                    Avx512StoreSums(c0, c1, c2, c3, output + j);
+                }
+                for (; j < numRowsB; ++j)
+                {
+                    output[j] = static_cast<uint32_t>(Avx512XorPopcount(a, pB + j * numWords, numWords));
+                }
+            }
+        }
+#endif
+
+        std::vector<Internal::PopcountKernels> FindSupportedPopcountKernels()
+        {
+            std::vector<Internal::PopcountKernels> kernels{ { "portable", PortableXorPopcount, PortablePairwiseXorPopcount } };
+#if ELL_X86_POPCOUNT_KERNELS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("popcnt"))
+            {
+                kernels.push_back({ "popcnt", PopcntXorPopcount, PopcntPairwiseXorPopcount });
+
+                // the AVX-512 kernels fall back to the POPCNT ones for short rows
+                if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq"))
+                {
+                    kernels.push_back({ "avx512vpopcntdq", Avx512XorPopcount, Avx512PairwiseXorPopcount });
+                }
+            }
+#endif
+            return kernels;
+        }
+
+        const Internal::PopcountKernels& GetPopcountKernels()
+        {
+            return Internal::GetSupportedPopcountKernels().back();
+        }
+    } // namespace
+
+    namespace Internal
+    {
+        const std::vector<PopcountKernels>& GetSupportedPopcountKernels()
+        {
+            static const std::vector<PopcountKernels> kernels = FindSupportedPopcountKernels();
+            return kernels;
+        }
+
+        uint64_t XorPopcount(const uint64_t* pA, const uint64_t* pB, size_t numWords)
+        {
+            return GetPopcountKernels().xorPopcount(pA, pB, numWords);
+        }
+
+        void PairwiseXorPopcount(const uint64_t* pA, size_t numRowsA, const uint64_t* pB, size_t numRowsB, size_t numWords, uint32_t* pOutput, size_t outputRowIncrement)
+        {
+            GetPopcountKernels().pairwiseXorPopcount(pA, numRowsA, pB, numRowsB, numWords, pOutput, outputRowIncrement);
+        }
+
+        const char* GetPopcountImplementationName()
+        {
+            return GetPopcountKernels().name;
+        }
+    } // namespace Internal
+
+    //
+    // BinaryVector
+    //
+
+    BinaryVector::BinaryVector(size_t size) :
+        _size(size),
+        _words((size + 63) / 64, 0)
+    {}
+
+    void BinaryVector::Set(size_t index, bool value)
+    {
+        uint64_t mask = uint64_t{ 1 } << (index % 64);
+        _words[index / 64] = value ? _words[index / 64] | mask : _words[index / 64] & ~mask;
+    }
+
+    //
+    // BinaryMatrix
+    //
+
+    BinaryMatrix::BinaryMatrix(size_t numRows, size_t numColumns) :
+        _numRows(numRows),
+        _numColumns(numColumns),
+        _words(numRows * ((numColumns + 63) / 64), 0)
+    {}
+
+    void BinaryMatrix::Set(size_t rowIndex, size_t columnIndex, bool value)
+    {
+        uint64_t mask = uint64_t{ 1 } << (columnIndex % 64);
+        uint64_t& word = _words[rowIndex * NumWordsPerRow() + columnIndex / 64];
+        word = value ? word | mask : word & ~mask;
+    }
+
+    //
+    // Free functions
+    //
+
+    size_t HammingDistance(ConstBinaryVectorReference vectorA, ConstBinaryVectorReference vectorB)
+    {
+        if (vectorA.Size() != vectorB.Size())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::sizeMismatch, "The binary vectors must have the same size.");
+        }
+        return static_cast<size_t>(Internal::XorPopcount(vectorA.GetConstDataPointer(), vectorB.GetConstDataPointer(), vectorA.NumWords()));
+    }
+
+    int64_t XnorDot(ConstBinaryVectorReference vectorA, ConstBinaryVectorReference vectorB)
+    {
+        return static_cast<int64_t>(vectorA.Size()) - 2 * static_cast<int64_t>(HammingDistance(vectorA, vectorB));
+    }
+} // namespace math
+} // namespace ell
@@ -0,0 +1,221 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/src/FFT.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "FFT.h"
+
+#include <vector>
+
+// The butterflies below work on plain real and imaginary parts instead of std::complex, whose multiplication
+// has to handle infinities and NaN with a library call, so that the auto-vectorizer can turn the loop over the
+// side by side transforms into SIMD code.
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        template <typename ElementType>
+        struct Value
+        {
+            ElementType re;
+            ElementType im;
+        };
+
+        template <typename ElementType>
+        inline Value<ElementType> Load(const std::complex<ElementType>* pData, size_t index)
+        {
+            const ElementType* p = reinterpret_cast<const ElementType*>(pData) + 2 * index;
+            return { p[0], p[1] };
+        }
+
+        template <typename ElementType>
+        inline void Store(std::complex<ElementType>* pData, size_t index, Value<ElementType> value)
+        {
+            ElementType* p = reinterpret_cast<ElementType*>(pData) + 2 * index;
+            p[0] = value.re;
+            p[1] = value.im;
+        }
+
+        template <typename ElementType>
+        inline Value<ElementType> Multiply(Value<ElementType> a, Value<ElementType> b)
+        {
+            return { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+        }
+
+        template <typename ElementType>
+        inline Value<ElementType> Add(Value<ElementType> a, Value<ElementType> b)
+        {
+            return { a.re + b.re, a.im + b.im };
+        }
+
+        template <typename ElementType>
+        inline Value<ElementType> Subtract(Value<ElementType> a, Value<ElementType> b)
+        {
+            return { a.re - b.re, a.im - b.im };
+        }
+
+        // multiplication by -i
+        template <typename ElementType>
+        inline Value<ElementType> RotateClockwise(Value<ElementType> a)
+        {
+            return { a.im, -a.re };
+        }
+
+        // The element r of input transform q at frequency t is pInput[r + stride * (q + radix * t)], and the element r
+        // of the output transform at frequency t + length * s is pOutput[r + stride * (t + length * s)]. Butterfly
+        // (t, r) reads the radix inputs at t, multiplies input q by twiddle (q, t) and writes their radix point DFT
+        // to the radix outputs t + length * s. The inner loop runs over the side by side transforms r when there
+        // are enough of them, and over the frequencies t otherwise.
+        template <typename ElementType, typename ButterflyType>
+        void ForEachButterfly(size_t length, size_t stride, ButterflyType&& butterfly)
+        {
+            if (stride >= 4)
+            {
+                for (size_t t = 0; t < length; ++t)
+                {
+                    for (size_t r = 0; r < stride; ++r)
+                    {
+                        butterfly(t, r);
+                    }
+                }
+            }
+            else
+            {
+                for (size_t r = 0; r < stride; ++r)
+                {
+                    for (size_t t = 0; t < length; ++t)
+                    {
+                        butterfly(t, r);
+                    }
+                }
+            }
+        }
+
+        template <typename ElementType>
+        void Radix2Pass(const std::complex<ElementType>* pInput, std::complex<ElementType>* pOutput, size_t length, size_t stride, const std::complex<ElementType>* pTwiddles)
+        {
+            ForEachButterfly<ElementType>(length, stride, [=](size_t t, size_t r) {
+                size_t in = r + stride * 2 * t;
+                size_t out = r + stride * t;
+                auto a0 = Load(pInput, in);
+                auto a1 = Multiply(Load(pInput, in + stride), Load(pTwiddles, t));
+                Store(pOutput, out, Add(a0, a1));
+                Store(pOutput, out + stride * length, Subtract(a0, a1));
+            });
+        }
+
+        template <typename ElementType>
+        void Radix3Pass(const std::complex<ElementType>* pInput, std::complex<ElementType>* pOutput, size_t length, size_t stride, const std::complex<ElementType>* pTwiddles)
+        {
+            // exp(-2 pi i / 3) = -1/2 - i sqrt(3)/2
+            const ElementType sine = static_cast<ElementType>(0.86602540378443864676);
+            ForEachButterfly<ElementType>(length, stride, [=](size_t t, size_t r) {
+                size_t in = r + stride * 3 * t;
+                size_t out = r + stride * t;
+                auto a0 = Load(pInput, in);
+                auto a1 = Multiply(Load(pInput, in + stride), Load(pTwiddles, t));
+                auto a2 = Multiply(Load(pInput, in + 2 * stride), Load(pTwiddles, length + t));
+                auto sum = Add(a1, a2);
+                auto difference = Subtract(a1, a2);
+                Value<ElementType> middle = { a0.re - sum.re / 2, a0.im - sum.im / 2 };
+                Value<ElementType> rotated = { sine * difference.im, -sine * difference.re };
+                Store(pOutput, out, Add(a0, sum));
+                Store(pOutput, out + stride * length, Add(middle, rotated));
+                Store(pOutput, out + 2 * stride * length, Subtract(middle, rotated));
+            });
+        }
+
+        template <typename ElementType>
+        void Radix4Pass(const std::complex<ElementType>* pInput, std::complex<ElementType>* pOutput, size_t length, size_t stride, const std::complex<ElementType>* pTwiddles)
+        {
+            ForEachButterfly<ElementType>(length, stride, [=](size_t t, size_t r) {
+                size_t in = r + stride * 4 * t;
+                size_t out = r + stride * t;
+                auto a0 = Load(pInput, in);
+                auto a1 = Multiply(Load(pInput, in + stride), Load(pTwiddles, t));
+                auto a2 = Multiply(Load(pInput, in + 2 * stride), Load(pTwiddles, length + t));
+                auto a3 = Multiply(Load(pInput, in + 3 * stride), Load(pTwiddles, 2 * length + t));
+                auto t0 = Add(a0, a2);
+                auto t1 = Subtract(a0, a2);
+                auto t2 = Add(a1, a3);
+                auto t3 = RotateClockwise(Subtract(a1, a3));
+                Store(pOutput, out, Add(t0, t2));
+                Store(pOutput, out + stride * length, Add(t1, t3));
+                Store(pOutput, out + 2 * stride * length, Subtract(t0, t2));
+                Store(pOutput, out + 3 * stride * length, Subtract(t1, t3));
+            });
+        }
+
+        // any radix, with a DFT of radix * radix operations per butterfly
+        template <typename ElementType>
+        void GenericPass(const std::complex<ElementType>* pInput, std::complex<ElementType>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<ElementType>* pTwiddles)
+        {
+            const std::complex<ElementType>* pRoots = pTwiddles + (radix - 1) * length;
+            std::vector<Value<ElementType>> inputs(radix);
+            for (size_t t = 0; t < length; ++t)
+            {
+                for (size_t r = 0; r < stride; ++r)
+                {
+                    size_t in = r + stride * radix * t;
+                    size_t out = r + stride * t;
+                    inputs[0] = Load(pInput, in);
+                    for (size_t q = 1; q < radix; ++q)
+                    {
+                        inputs[q] = Multiply(Load(pInput, in + q * stride), Load(pTwiddles, (q - 1) * length + t));
+                    }
+                    for (size_t s = 0; s < radix; ++s)
+                    {
+                        Value<ElementType> sum = inputs[0];
+                        size_t rootIndex = 0;
+                        for (size_t q = 1; q < radix; ++q)
+                        {
+                            rootIndex = rootIndex + s < radix ? rootIndex + s : rootIndex + s - radix;
+                            sum = Add(sum, Multiply(inputs[q], Load(pRoots, rootIndex)));
+                        }
+                        Store(pOutput, out + s * stride * length, sum);
+                    }
+                }
+            }
+        }
+
+        template <typename ElementType>
+        void Pass(const std::complex<ElementType>* pInput, std::complex<ElementType>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<ElementType>* pTwiddles)
+        {
+            switch (radix)
+            {
+            case 2:
+                Radix2Pass(pInput, pOutput, length, stride, pTwiddles);
+                break;
+            case 3:
+                Radix3Pass(pInput, pOutput, length, stride, pTwiddles);
+                break;
+            case 4:
+                Radix4Pass(pInput, pOutput, length, stride, pTwiddles);
+                break;
+            default:
+                GenericPass(pInput, pOutput, radix, length, stride, pTwiddles);
+                break;
+            }
+        }
+    } // namespace
+
+    namespace Internal
+    {
+        void FFTPass(const std::complex<float>* pInput, std::complex<float>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<float>* pTwiddles)
+        {
+            Pass(pInput, pOutput, radix, length, stride, pTwiddles);
+        }
+
+        void FFTPass(const std::complex<double>* pInput, std::complex<double>* pOutput, size_t radix, size_t length, size_t stride, const std::complex<double>* pTwiddles)
+        {
+            Pass(pInput, pOutput, radix, length, stride, pTwiddles);
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
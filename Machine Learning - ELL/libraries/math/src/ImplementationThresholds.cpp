@@ -0,0 +1,222 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/src/ImplementationThresholds.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "ImplementationThresholds.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        struct ThresholdField
+        {
+            const char* name;
+            size_t ImplementationThresholds::*member;
+        };
+
+        const ThresholdField c_thresholdFields[] = {
+            { "matrixMatrixBlocked", &ImplementationThresholds::matrixMatrixBlocked },
+            { "matrixMatrixBlas", &ImplementationThresholds::matrixMatrixBlas },
+            { "matrixVectorBlocked", &ImplementationThresholds::matrixVectorBlocked },
+            { "matrixVectorBlas", &ImplementationThresholds::matrixVectorBlas },
+            { "convolutionFFT", &ImplementationThresholds::convolutionFFT }
+        };
+
+        std::string Trim(const std::string& text)
+        {
+            auto begin = text.find_first_not_of(" \t\r");
+            if (begin == std::string::npos)
+            {
+                return "";
+            }
+            auto end = text.find_last_not_of(" \t\r");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        size_t ParseThreshold(const std::string& text, const std::string& filepath)
+        {
+            if (text == "never")
+            {
+                return ImplementationThresholds::never;
+            }
+
+            size_t length = 0;
+            unsigned long long value = 0;
+            try
+            {
+                value = std::stoull(text, &length);
+            }
+            catch (const std::exception&)
+            {
+                length = 0;
+            }
+            if (length == 0 || length != text.size())
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "invalid threshold value '" + text + "' in " + filepath);
+            }
+            return static_cast<size_t>(value);
+        }
+
+        // the thresholds are published as immutable snapshots, so that a product reads them once and is not
+        // affected by a later Set; a snapshot is freed when the last reader releases it
+        class ThresholdsState
+        {
+        public:
+            ThresholdsState()
+            {
+                ImplementationThresholds thresholds;
+                const char* filepath = std::getenv(implementationThresholdsVariable);
+                if (filepath != nullptr && *filepath != '\0')
+                {
+                    thresholds = ReadImplementationThresholds(filepath);
+                }
+                Set(thresholds);
+            }
+
+            std::shared_ptr<const ImplementationThresholds> Get() const
+            {
+                return std::atomic_load(&_current);
+            }
+
+            void Set(const ImplementationThresholds& thresholds)
+            {
+                std::atomic_store(&_current, std::shared_ptr<const ImplementationThresholds>(std::make_shared<ImplementationThresholds>(thresholds)));
+            }
+
+        private:
+            std::shared_ptr<const ImplementationThresholds> _current;
+        };
+
+        ThresholdsState& GetThresholdsState()
+        {
+            static ThresholdsState state;
+            return state;
+        }
+
+        bool IsBlasAvailable()
+        {
+#if USE_BLAS
+            return true;
+#else
+            return false;
+#endif
+        }
+    } // namespace
+
+    ImplementationThresholds GetImplementationThresholds()
+    {
+        return *GetThresholdsState().Get();
+    }
+
+    void SetImplementationThresholds(const ImplementationThresholds& thresholds)
+    {
+        GetThresholdsState().Set(thresholds);
+    }
+
+    ImplementationThresholds ReadImplementationThresholds(const std::string& filepath)
+    {
+        auto stream = utilities::OpenIfstream(filepath);
+        ImplementationThresholds thresholds;
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            line = Trim(line);
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            auto separator = line.find('=');
+            if (separator == std::string::npos)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "expected 'name = value' in " + filepath + ", got '" + line + "'");
+            }
+
+            auto name = Trim(line.substr(0, separator));
+            auto value = Trim(line.substr(separator + 1));
+            bool found = false;
+            for (const auto& field : c_thresholdFields)
+            {
+                if (name == field.name)
+                {
+                    thresholds.*field.member = ParseThreshold(value, filepath);
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "unknown threshold '" + name + "' in " + filepath);
+            }
+        }
+        return thresholds;
+    }
+
+    void WriteImplementationThresholds(const std::string& filepath, const ImplementationThresholds& thresholds)
+    {
+        auto stream = utilities::OpenOfstream(filepath);
+        stream << "# ELL math implementation thresholds, read at startup from the file named by " << implementationThresholdsVariable << "\n";
+        for (const auto& field : c_thresholdFields)
+        {
+            auto value = thresholds.*field.member;
+            stream << field.name << " = ";
+            if (value == ImplementationThresholds::never)
+            {
+                stream << "never\n";
+            }
+            else
+            {
+                stream << value << "\n";
+            }
+        }
+
+        if (!stream)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "error writing file " + filepath);
+        }
+    }
+
+    ImplementationType ChooseMatrixMatrixImplementation(size_t numRows, size_t numColumns, size_t depth)
+    {
+        auto thresholds = GetThresholdsState().Get();
+        size_t size = numRows * numColumns * depth;
+        if (IsBlasAvailable() && size >= thresholds->matrixMatrixBlas)
+        {
+            return ImplementationType::openBlas;
+        }
+        return size >= thresholds->matrixMatrixBlocked ? ImplementationType::blocked : ImplementationType::native;
+    }
+
+    ImplementationType ChooseMatrixVectorImplementation(size_t numRows, size_t numColumns)
+    {
+        auto thresholds = GetThresholdsState().Get();
+        size_t size = numRows * numColumns;
+        if (IsBlasAvailable() && size >= thresholds->matrixVectorBlas)
+        {
+            return ImplementationType::openBlas;
+        }
+        return size >= thresholds->matrixVectorBlocked ? ImplementationType::blocked : ImplementationType::native;
+    }
+
+    ConvolutionMethod ChooseConvolutionMethod(size_t signalSize, size_t kernelSize)
+    {
+        // convolution is symmetric in its arguments, and the direct method costs the product of their sizes
+        auto thresholds = GetThresholdsState().Get();
+        return std::min(signalSize, kernelSize) >= thresholds->convolutionFFT ? ConvolutionMethod::fft : ConvolutionMethod::direct;
+    }
+} // namespace math
+} // namespace ell
@@ -0,0 +1,288 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/src/MappedFile.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "MappedFile.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        const char c_mappedFileMagic[4] = { 'E', 'L', 'L', 'M' };
+        const uint32_t c_mappedFileVersion = 1;
+
+        // the data starts on a cache line boundary, so that aligned loads work on the mapped elements
+        const uint64_t c_mappedFileDataOffset = 64;
+
+        static_assert(sizeof(MappedFileHeader) <= c_mappedFileDataOffset, "mapped file header does not fit before the data offset");
+
+        size_t GetElementSize(MappedElementType elementType)
+        {
+            switch (elementType)
+            {
+            case MappedElementType::float32:
+            case MappedElementType::int32:
+                return 4;
+            case MappedElementType::float64:
+                return 8;
+            case MappedElementType::int16:
+                return 2;
+            case MappedElementType::int8:
+            case MappedElementType::uint8:
+                return 1;
+            }
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, "unknown mapped file element type");
+        }
+
+        // sets product = a * b, unless the product does not fit in 64 bits
+        bool MultiplyWithoutOverflow(uint64_t a, uint64_t b, uint64_t& product)
+        {
+            if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+            {
+                return false;
+            }
+            product = a * b;
+            return true;
+        }
+
+        void CheckHeader(const MappedFileHeader& header, size_t fileSize)
+        {
+            if (std::memcmp(header.magic, c_mappedFileMagic, sizeof(c_mappedFileMagic)) != 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "not a mapped matrix file");
+            }
+            if (header.version != c_mappedFileVersion)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::versionMismatch, "unsupported mapped file version");
+            }
+            if (GetElementSize(static_cast<MappedElementType>(header.elementType)) != header.elementSize)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "mapped file element size does not match its element type");
+            }
+
+            bool used[3] = { false, false, false };
+            for (auto dimension : header.dimensionOrder)
+            {
+                if (dimension > 2 || used[dimension])
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::badData, "mapped file has an invalid dimension order");
+                }
+                used[dimension] = true;
+            }
+
+            // the header is untrusted, so every size is computed without wrapping around
+            uint64_t dataSize = header.elementSize;
+            for (auto size : header.shape)
+            {
+                if (!MultiplyWithoutOverflow(dataSize, size, dataSize))
+                {
+                    throw utilities::InputException(utilities::InputExceptionErrors::badData, "mapped file shape is too large");
+                }
+            }
+            if (header.dataOffset < sizeof(MappedFileHeader) || header.dataOffset > fileSize || dataSize > fileSize - header.dataOffset)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "mapped file is truncated");
+            }
+
+            // the views reinterpret the data as elements, which must be aligned
+            if (header.dataOffset % header.elementSize != 0)
+            {
+                throw utilities::InputException(utilities::InputExceptionErrors::badData, "mapped file data offset is not aligned to its element size");
+            }
+        }
+    } // namespace
+
+    //
+    // MappedFile
+    //
+
+#ifndef WIN32
+    MappedFile::MappedFile(const std::string& filepath, MappedFileOptions options)
+    {
+        int fileDescriptor = open(filepath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "error opening file " + filepath);
+        }
+
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<size_t>(fileStatus.st_size) < sizeof(MappedFileHeader))
+        {
+            close(fileDescriptor);
+            throw utilities::InputException(utilities::InputExceptionErrors::badData, "file " + filepath + " is too small to be a mapped matrix file");
+        }
+        _mappingSize = static_cast<size_t>(fileStatus.st_size);
+
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (options.populate)
+        {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        _pMapping = mmap(nullptr, _mappingSize, PROT_READ, flags, fileDescriptor, 0);
+
+        // the mapping keeps its own reference to the file
+        close(fileDescriptor);
+        if (_pMapping == MAP_FAILED)
+        {
+            _pMapping = nullptr;
+            throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotFound, "error mapping file " + filepath);
+        }
+
+        int advice = MADV_NORMAL;
+        switch (options.access)
+        {
+        case MappedFileAccess::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case MappedFileAccess::random:
+            advice = MADV_RANDOM;
+            break;
+        case MappedFileAccess::willNeed:
+            advice = MADV_WILLNEED;
+            break;
+        default:
+            break;
+        }
+        if (advice != MADV_NORMAL)
+        {
+            // advice is only a hint, failing to apply it is not an error
+            madvise(_pMapping, _mappingSize, advice);
+        }
+
+        std::memcpy(&_header, _pMapping, sizeof(_header));
+        try
+        {
+            CheckHeader(_header, _mappingSize);
+        }
+        catch (...)
+        {
+            Unmap();
+            throw;
+        }
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (_pMapping != nullptr)
+        {
+            munmap(_pMapping, _mappingSize);
+            _pMapping = nullptr;
+            _mappingSize = 0;
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::string&, MappedFileOptions)
+    {
+        throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, "memory mapped files are not implemented on this platform");
+    }
+
+    void MappedFile::Unmap()
+    {}
+#endif
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        _pMapping(other._pMapping),
+        _mappingSize(other._mappingSize),
+        _header(other._header)
+    {
+        other._pMapping = nullptr;
+        other._mappingSize = 0;
+        other._header = {};
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Unmap();
+            std::swap(_pMapping, other._pMapping);
+            std::swap(_mappingSize, other._mappingSize);
+            _header = other._header;
+            other._header = {};
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Unmap();
+    }
+
+    TensorShape MappedFile::GetShape() const
+    {
+        return { static_cast<size_t>(_header.shape[0]), static_cast<size_t>(_header.shape[1]), static_cast<size_t>(_header.shape[2]) };
+    }
+
+    bool MappedFile::HasDimensionOrder(Dimension dimension0, Dimension dimension1, Dimension dimension2) const
+    {
+        return _header.dimensionOrder[0] == static_cast<uint32_t>(dimension0) &&
+               _header.dimensionOrder[1] == static_cast<uint32_t>(dimension1) &&
+               _header.dimensionOrder[2] == static_cast<uint32_t>(dimension2);
+    }
+
+    namespace Internal
+    {
+        MappedFileHeader CreateMappedFileHeader(MappedElementType elementType, size_t elementSize, const Dimension (&order)[3], TensorShape shape)
+        {
+            MappedFileHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, c_mappedFileMagic, sizeof(c_mappedFileMagic));
+            header.version = c_mappedFileVersion;
+            header.elementType = static_cast<uint32_t>(elementType);
+            header.elementSize = static_cast<uint32_t>(elementSize);
+            for (int i = 0; i < 3; ++i)
+            {
+                header.dimensionOrder[i] = static_cast<uint32_t>(order[i]);
+            }
+            header.shape[0] = shape.NumRows();
+            header.shape[1] = shape.NumColumns();
+            header.shape[2] = shape.NumChannels();
+            header.dataOffset = c_mappedFileDataOffset;
+            return header;
+        }
+
+        void WriteMappedFile(const std::string& filepath, const MappedFileHeader& header, const char* pData, MappedFileStride outer, MappedFileStride inner, size_t blockSizeInBytes)
+        {
+            auto stream = utilities::OpenBinaryOfstream(filepath);
+
+            char paddedHeader[c_mappedFileDataOffset] = {};
+            std::memcpy(paddedHeader, &header, sizeof(header));
+            stream.write(paddedHeader, sizeof(paddedHeader));
+
+            for (size_t i = 0; i < outer.count; ++i)
+            {
+                for (size_t j = 0; j < inner.count; ++j)
+                {
+                    stream.write(pData + i * outer.incrementInBytes + j * inner.incrementInBytes, static_cast<std::streamsize>(blockSizeInBytes));
+                }
+            }
+
+            if (!stream)
+            {
+                throw utilities::SystemException(utilities::SystemExceptionErrors::fileNotWritable, "error writing file " + filepath);
+            }
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
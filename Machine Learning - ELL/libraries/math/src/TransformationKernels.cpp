@@ -0,0 +1,483 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/src/TransformationKernels.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "TransformationKernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// The kernels below are written as straight line code on one element: no calls, no branches (conditionals
+// are selects), bit casts through memcpy. Inlined into the bulk loops, that is what the auto-vectorizer needs
+// to turn every loop into SIMD code.
+
+namespace ell
+{
+namespace math
+{
+    namespace
+    {
+        inline uint32_t AsBits(float x)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return bits;
+        }
+
+        inline uint64_t AsBits(double x)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return bits;
+        }
+
+        inline float AsFloat(uint32_t bits)
+        {
+            float x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+
+        inline double AsDouble(uint64_t bits)
+        {
+            double x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+
+        inline float CopySign(float magnitude, float sign)
+        {
+            return AsFloat(AsBits(magnitude) | (AsBits(sign) & 0x80000000u));
+        }
+
+        inline double CopySign(double magnitude, double sign)
+        {
+            return AsDouble(AsBits(magnitude) | (AsBits(sign) & 0x8000000000000000ull));
+        }
+
+        inline float Clamp(float x, float low, float high)
+        {
+            // written so that NaN passes through
+            x = x < low ? low : x;
+            return x > high ? high : x;
+        }
+
+        inline double Clamp(double x, double low, double high)
+        {
+            x = x < low ? low : x;
+            return x > high ? high : x;
+        }
+
+        //
+        // exp: x = n ln2 + r with |r| <= ln2 / 2, exp(x) = 2^n exp(r). The scaling by 2^n is split into two
+        // factors, so that subnormal and overflowing results come out of ordinary multiplications.
+        //
+
+        inline float ExpKernel(float x)
+        {
+            const float roundingConstant = 12582912.0f; // 1.5 * 2^23
+            float clamped = Clamp(x, -104.0f, 89.0f);
+            float shifted = clamped * 1.44269504088896341f + roundingConstant;
+            float n = shifted - roundingConstant;
+            int32_t integerN = static_cast<int32_t>(AsBits(shifted) - AsBits(roundingConstant));
+
+            float r = clamped - n * 0.693359375f;
+            r = r - n * -2.12194440e-4f;
+
+            float p = 1.9875691500e-4f;
+            p = p * r + 1.3981999507e-3f;
+            p = p * r + 8.3334519073e-3f;
+            p = p * r + 4.1665795894e-2f;
+            p = p * r + 1.6666665459e-1f;
+            p = p * r + 5.0000001201e-1f;
+            p = p * r * r + r + 1.0f;
+
+            int32_t n1 = integerN / 2;
+            int32_t n2 = integerN - n1;
+            float scale1 = AsFloat(static_cast<uint32_t>(n1 + 127) << 23);
+            float scale2 = AsFloat(static_cast<uint32_t>(n2 + 127) << 23);
+            float result = p * scale1 * scale2;
+            return x != x ? x : result;
+        }
+
+        inline double ExpKernel(double x)
+        {
+            const double roundingConstant = 6755399441055744.0; // 1.5 * 2^52
+            double clamped = Clamp(x, -746.0, 710.0);
+            double shifted = clamped * 1.4426950408889634074 + roundingConstant;
+            double n = shifted - roundingConstant;
+            // the high part of ln2 has trailing zero bits, so n * ln2High is exact
+            double r = clamped - n * 6.93147180369123816490e-01;
+            r = r - n * 1.90821492927058770002e-10;
+
+            // Taylor series of exp(r) - 1, the truncation error is below 2^-57 for |r| <= ln2 / 2
+            double p = 1.0 / 6227020800.0;
+            p = p * r + 1.0 / 479001600.0;
+            p = p * r + 1.0 / 39916800.0;
+            p = p * r + 1.0 / 3628800.0;
+            p = p * r + 1.0 / 362880.0;
+            p = p * r + 1.0 / 40320.0;
+            p = p * r + 1.0 / 5040.0;
+            p = p * r + 1.0 / 720.0;
+            p = p * r + 1.0 / 120.0;
+            p = p * r + 1.0 / 24.0;
+            p = p * r + 1.0 / 6.0;
+            p = p * r + 0.5;
+            p = p * r * r + r + 1.0;
+
+            // the exponent bits are built with unsigned 64 bit additions and shifts only, because SSE2 has no
+            // signed 64 bit shifts or 64 bit integer conversions
+            double n1 = (n * 0.5 + roundingConstant) - roundingConstant;
+            double n2 = n - n1;
+            double scale1 = AsDouble((AsBits(n1 + roundingConstant) - AsBits(roundingConstant) + 1023) << 52);
+            double scale2 = AsDouble((AsBits(n2 + roundingConstant) - AsBits(roundingConstant) + 1023) << 52);
+            double result = p * scale1 * scale2;
+            return x != x ? x : result;
+        }
+
+        //
+        // log: x = 2^k m with sqrt(2)/2 <= m < sqrt(2), f = m - 1, s = f / (2 + f) and
+        // log(1 + f) = f - s (f - R(s^2)), with R a minimax polynomial (the classic fdlibm reduction).
+        //
+
+        inline float LogKernel(float x)
+        {
+            bool isSubnormal = x < 1.17549435e-38f;
+            float scaled = isSubnormal ? x * 8388608.0f : x;
+            int32_t exponentAdjustment = isSubnormal ? -23 : 0;
+
+            uint32_t bits = AsBits(scaled);
+            int32_t k = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + exponentAdjustment;
+            float m = AsFloat((bits & 0x007fffffu) | 0x3f800000u);
+            bool isLarge = m > 1.41421356f;
+            m = isLarge ? m * 0.5f : m;
+            k = isLarge ? k + 1 : k;
+
+            float f = m - 1.0f;
+            float s = f / (2.0f + f);
+            float z = s * s;
+            float R = z * (0.66666662693f + z * (0.40000972152f + z * (0.28498786688f + z * 0.24279078841f)));
+            float hfsq = 0.5f * f * f;
+            float dk = static_cast<float>(k);
+            float result = dk * 6.9313812256e-01f - ((hfsq - (s * (hfsq + R) + dk * 9.0580006145e-06f)) - f);
+
+            result = x == 0.0f ? -INFINITY : result;
+            result = x < 0.0f ? NAN : result;
+            result = x == INFINITY ? x : result;
+            return x != x ? x : result;
+        }
+
+        inline double LogKernel(double x)
+        {
+            bool isSubnormal = x < 2.2250738585072014e-308;
+            double scaled = isSubnormal ? x * 18014398509481984.0 : x; // 2^54
+            int64_t exponentAdjustment = isSubnormal ? -54 : 0;
+
+            uint64_t bits = AsBits(scaled);
+            int64_t k = static_cast<int64_t>((bits >> 52) & 0x7ff) - 1023 + exponentAdjustment;
+            double m = AsDouble((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+            bool isLarge = m > 1.4142135623730951;
+            m = isLarge ? m * 0.5 : m;
+            k = isLarge ? k + 1 : k;
+
+            double f = m - 1.0;
+            double s = f / (2.0 + f);
+            double z = s * s;
+            double R = 1.479819860511658591e-01;
+            R = R * z + 1.531383769920937332e-01;
+            R = R * z + 1.818357216161805012e-01;
+            R = R * z + 2.222219843214978396e-01;
+            R = R * z + 2.857142874366239149e-01;
+            R = R * z + 3.999999999940941908e-01;
+            R = R * z + 6.666666666666735130e-01;
+            R = R * z;
+            double hfsq = 0.5 * f * f;
+            double dk = static_cast<double>(k);
+            double result = dk * 6.93147180369123816490e-01 - ((hfsq - (s * (hfsq + R) + dk * 1.90821492927058770002e-10)) - f);
+
+            result = x == 0.0 ? -INFINITY : result;
+            result = x < 0.0 ? NAN : result;
+            result = x == INFINITY ? x : result;
+            return x != x ? x : result;
+        }
+
+        //
+        // tanh: an odd polynomial (float) or rational function (double) for |x| < 0.625,
+        // 1 - 2 / (exp(2|x|) + 1) with the sign of x otherwise
+        //
+
+        inline float TanhKernel(float x)
+        {
+            float z = x * x;
+            float p = -5.70498872745e-3f;
+            p = p * z + 2.06390887954e-2f;
+            p = p * z - 5.37397155531e-2f;
+            p = p * z + 1.33314422036e-1f;
+            p = p * z - 3.33332819422e-1f;
+            float small = p * z * x + x;
+
+            float absX = std::fabs(x);
+            float e = ExpKernel(2.0f * Clamp(absX, 0.0f, 9.0f));
+            float large = CopySign(1.0f - 2.0f / (e + 1.0f), x);
+            return absX < 0.625f ? small : large;
+        }
+
+        inline double TanhKernel(double x)
+        {
+            double z = x * x;
+            double p = -9.64399179425052238628e-1;
+            p = p * z - 9.92877231001918586564e1;
+            p = p * z - 1.61468768441708447952e3;
+            double q = z + 1.12811678491632931402e2;
+            q = q * z + 2.23548839060100448583e3;
+            q = q * z + 4.84406305325125486048e3;
+            double small = x + x * z * (p / q);
+
+            double absX = std::fabs(x);
+            double e = ExpKernel(2.0 * Clamp(absX, 0.0, 20.0));
+            double large = CopySign(1.0 - 2.0 / (e + 1.0), x);
+            return absX < 0.625 ? small : large;
+        }
+
+        //
+        // sigmoid: with e = exp(-|x|), 1 / (1 + e) for x >= 0 and e / (1 + e) otherwise, so nothing overflows
+        // and tiny results keep their relative accuracy
+        //
+
+        template <typename ElementType>
+        inline ElementType SigmoidKernel(ElementType x)
+        {
+            ElementType e = ExpKernel(-std::fabs(x));
+            ElementType r = 1 / (1 + e);
+            return x >= 0 ? r : e * r;
+        }
+
+        //
+        // erf (float): a rational approximation x P(x^2) / Q(x^2) on [-4, 4], where erf is +/-1 in float
+        //
+
+        inline float ErfKernel(float x)
+        {
+            float clamped = Clamp(x, -4.0f, 4.0f);
+            float z = clamped * clamped;
+
+            float p = -2.72614225801306e-10f;
+            p = p * z + 2.77068142495902e-08f;
+            p = p * z - 2.10102402082508e-06f;
+            p = p * z - 5.69250639462346e-05f;
+            p = p * z - 7.34990630326855e-04f;
+            p = p * z - 2.95459980854025e-03f;
+            p = p * z - 1.60960333262415e-02f;
+
+            float q = -1.45660718464996e-05f;
+            q = q * z - 2.13374055278905e-04f;
+            q = q * z - 1.68282697438203e-03f;
+            q = q * z - 7.37332916720468e-03f;
+            q = q * z - 1.42647390514189e-02f;
+
+            return clamped * (p / q);
+        }
+
+        //
+        // erf (double): erf(x) = x S(x^2) for |x| < 1 and erf(x) = 1 - exp(-x^2) G(1/x) for 1 <= |x| < 6, where
+        // erf is 1 in double beyond 6. S and G are Chebyshev interpolants of erf(sqrt(z)) / sqrt(z) on [0, 1] and
+        // of erfc(1/u) exp(1/u^2) on [1/6, 1], fitted in extended precision and converted to polynomials in the
+        // interval variable t in [-1, 1].
+        //
+
+        constexpr double c_erfSmallCoefficients[] = {
+            0.96546873866986727, -0.14053608902271714, 0.019852496688983701, -0.0022854855611439536,
+            0.000217517156041658, -1.7537169442308297e-05, 1.2233827381533461e-06, -7.5115688841220768e-08,
+            4.1158008889929935e-09, -2.03529643832967e-10, 9.1674223767768129e-12, -3.7523595342037195e-13,
+            1.4588330543574558e-14, -1.7430501486614957e-15
+        };
+
+        constexpr double c_erfLargeCoefficients[] = {
+            0.28972211632346417, 0.16536269001261486, -0.030831050508422053, 0.0028211318978462042,
+            0.001034432225964742, -0.00073838674176798737, 0.00026560547375478467, -5.5286514220613409e-05,
+            -4.0466675244969026e-06, 1.0882795984229535e-05, -6.4978484970437907e-06, 2.5824208903582613e-06,
+            -6.6420949627378949e-07, 3.3216635766016485e-09, 1.2825795209966036e-07, -9.8249657957497991e-08,
+            4.4465136883609092e-08, -1.4544849428569744e-08, 7.9063308492758698e-09, -2.8269274328825609e-09,
+            -3.2558200283953436e-09, 2.8394595119607404e-09, -1.846710044143644e-10, -2.3340097262310643e-10
+        };
+
+        // Horner's rule, unrolled at compile time so that the element loop around it stays vectorizable
+        template <size_t index, size_t size>
+        struct Horner
+        {
+            static double Evaluate(const double (&coefficients)[size], double t)
+            {
+                return coefficients[index] + t * Horner<index + 1, size>::Evaluate(coefficients, t);
+            }
+        };
+
+        template <size_t size>
+        struct Horner<size, size>
+        {
+            static double Evaluate(const double (&)[size], double) { return 0; }
+        };
+
+        template <size_t size>
+        inline double EvaluatePolynomial(const double (&coefficients)[size], double t)
+        {
+            return Horner<0, size>::Evaluate(coefficients, t);
+        }
+
+        inline double ErfKernel(double x)
+        {
+            double absX = std::fabs(x);
+            double z = x * x;
+            double smallResult = x * EvaluatePolynomial(c_erfSmallCoefficients, 2.0 * (z > 1.0 ? 1.0 : z) - 1.0);
+
+            double clamped = Clamp(absX, 1.0, 6.0);
+            double u = 1.0 / clamped;
+            double g = EvaluatePolynomial(c_erfLargeCoefficients, (2.0 * u - (1.0 / 6.0 + 1.0)) * 1.2);
+            double largeResult = 1.0 - ExpKernel(-clamped * clamped) * g;
+            largeResult = CopySign(absX >= 6.0 ? 1.0 : largeResult, x);
+            return absX < 1.0 ? smallResult : largeResult;
+        }
+
+        template <typename ElementType, typename KernelType>
+        void ApplyKernel(const ElementType* pInput, ElementType* pOutput, size_t size, KernelType kernel)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                pOutput[i] = kernel(pInput[i]);
+            }
+        }
+    } // namespace
+
+    void VectorizedExponent(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return ExpKernel(x); });
+    }
+
+    void VectorizedExponent(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return ExpKernel(x); });
+    }
+
+    void VectorizedNaturalLog(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return LogKernel(x); });
+    }
+
+    void VectorizedNaturalLog(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return LogKernel(x); });
+    }
+
+    void VectorizedHyperbolicTangent(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return TanhKernel(x); });
+    }
+
+    void VectorizedHyperbolicTangent(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return TanhKernel(x); });
+    }
+
+    void VectorizedSigmoid(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return SigmoidKernel(x); });
+    }
+
+    void VectorizedSigmoid(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return SigmoidKernel(x); });
+    }
+
+    void VectorizedErrorFunction(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return ErfKernel(x); });
+    }
+
+    void VectorizedErrorFunction(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return ErfKernel(x); });
+    }
+
+    void VectorizedSquareRoot(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return std::sqrt(x); });
+    }
+
+    void VectorizedSquareRoot(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return std::sqrt(x); });
+    }
+
+    void VectorizedRectifiedLinear(const float* pInput, float* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](float x) { return x > 0 ? x : 0.0f; });
+    }
+
+    void VectorizedRectifiedLinear(const double* pInput, double* pOutput, size_t size)
+    {
+        ApplyKernel(pInput, pOutput, size, [](double x) { return x > 0 ? x : 0.0; });
+    }
+
+    float VectorizedExponent(float x) { return ExpKernel(x); }
+    double VectorizedExponent(double x) { return ExpKernel(x); }
+    float VectorizedNaturalLog(float x) { return LogKernel(x); }
+    double VectorizedNaturalLog(double x) { return LogKernel(x); }
+    float VectorizedHyperbolicTangent(float x) { return TanhKernel(x); }
+    double VectorizedHyperbolicTangent(double x) { return TanhKernel(x); }
+    float VectorizedSigmoid(float x) { return SigmoidKernel(x); }
+    double VectorizedSigmoid(double x) { return SigmoidKernel(x); }
+    float VectorizedErrorFunction(float x) { return ErfKernel(x); }
+    double VectorizedErrorFunction(double x) { return ErfKernel(x); }
+
+    namespace Internal
+    {
+        template <typename ElementType>
+        BulkTransformation<ElementType> FindBulkTransformationImplementation(Transformation<ElementType> transformation)
+        {
+            if (transformation == VectorizedExponentTransformation<ElementType>)
+            {
+                return VectorizedExponent;
+            }
+            if (transformation == VectorizedNaturalLogTransformation<ElementType>)
+            {
+                return VectorizedNaturalLog;
+            }
+            if (transformation == VectorizedHyperbolicTangentTransformation<ElementType>)
+            {
+                return VectorizedHyperbolicTangent;
+            }
+            if (transformation == VectorizedSigmoidTransformation<ElementType>)
+            {
+                return VectorizedSigmoid;
+            }
+            if (transformation == VectorizedErrorFunctionTransformation<ElementType>)
+            {
+                return VectorizedErrorFunction;
+            }
+            if (transformation == SquareRootTransformation<ElementType>)
+            {
+                return VectorizedSquareRoot;
+            }
+            if (transformation == RectifiedLinearTransformation<ElementType>)
+            {
+                return VectorizedRectifiedLinear;
+            }
+            return nullptr;
+        }
+
+        BulkTransformation<float> FindBulkTransformation(Transformation<float> transformation)
+        {
+            return FindBulkTransformationImplementation<float>(transformation);
+        }
+
+        BulkTransformation<double> FindBulkTransformation(Transformation<double> transformation)
+        {
+            return FindBulkTransformationImplementation<double>(transformation);
+        }
+    } // namespace Internal
+} // namespace math
+} // namespace ell
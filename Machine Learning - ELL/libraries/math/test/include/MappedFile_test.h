@@ -0,0 +1,147 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/test/include/MappedFile_test.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include <testing/include/testing.h>
+#include <math/include/MappedFile.h>
+
+using namespace ell;
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMappedFileMatrix();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestMappedFileTensor();
+
+template <typename ElementType>
+void TestMappedFileCorruptHeader();
+
+#pragma region implementation
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMappedFileMatrix()
+{
+    const std::string filepath = "MappedFile_test_matrix.bin";
+    math::Matrix<ElementType, layout> M{
+        { 1, 2, 3, 4 },
+        { 5, 6, 7, 8 },
+        { 9, 10, 11, 12 }
+    };
+    auto N = M.GetSubMatrix(1, 1, 2, 3);
+    math::WriteMappedFile(filepath, N.GetConstReference());
+
+    bool success = false;
+    {
+        math::MappedFile file(filepath, { true, math::MappedFileAccess::sequential });
+        auto R = file.GetMatrix<ElementType, layout>();
+        auto v = file.GetVector<ElementType>();
+        success = R == N && v.Size() == 6;
+
+        // asking for the wrong layout must fail
+        try
+        {
+            file.GetMatrix<ElementType, math::TransposeMatrixLayout<layout>::value>();
+            success = false;
+        }
+        catch (const utilities::InputException&)
+        {}
+    }
+    std::remove(filepath.c_str());
+
+    testing::ProcessTest("MappedFile::GetMatrix", success);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestMappedFileTensor()
+{
+    const std::string filepath = "MappedFile_test_tensor.bin";
+    auto T = math::Tensor<ElementType, dimension0, dimension1, dimension2>{
+        { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 9, 10, 11, 12 } },
+        { { 13, 14, 15, 16 }, { 17, 18, 19, 20 }, { 21, 22, 23, 24 } }
+    };
+    auto S = T.GetSubTensor({ 0, 1, 1 }, { 2, 2, 3 });
+    math::WriteMappedFile(filepath, S);
+
+    bool success = false;
+    {
+        math::MappedFile file(filepath);
+        auto R = file.template GetTensor<ElementType, dimension0, dimension1, dimension2>();
+        success = R == S && file.GetShape() == S.GetShape();
+    }
+    std::remove(filepath.c_str());
+
+    testing::ProcessTest("MappedFile::GetTensor", success);
+}
+
+template <typename ElementType>
+void TestMappedFileCorruptHeader()
+{
+    const std::string filepath = "MappedFile_test_corrupt.bin";
+    math::ColumnVector<ElementType> v{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    // rewrites the header of a valid file and checks that mapping it fails
+    auto rejects = [&](auto corrupt) {
+        math::WriteMappedFile(filepath, v);
+        math::MappedFileHeader header;
+        {
+            std::fstream stream(filepath, std::ios::in | std::ios::out | std::ios::binary);
+            stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+            corrupt(header);
+            stream.seekp(0);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+        bool rejected = false;
+        try
+        {
+            math::MappedFile file(filepath);
+        }
+        catch (const utilities::InputException&)
+        {
+            rejected = true;
+        }
+        std::remove(filepath.c_str());
+        return rejected;
+    };
+
+    const uint64_t maximum = std::numeric_limits<uint64_t>::max();
+    bool success = rejects([](math::MappedFileHeader& header) {
+        // the number of bytes wraps around to a small number
+        header.shape[0] = uint64_t{ 1 } << 32;
+        header.shape[1] = uint64_t{ 1 } << 32;
+    });
+    success = success && rejects([&](math::MappedFileHeader& header) {
+        // the end of the data wraps around to a small offset
+        header.dataOffset = maximum - 7;
+    });
+    success = success && rejects([](math::MappedFileHeader& header) {
+        header.dataOffset += 1;
+        header.shape[0] -= 1;
+    });
+    success = success && rejects([](math::MappedFileHeader& header) {
+        header.shape[0] += 1;
+    });
+
+    // the valid file is accepted, and a moved-from file describes nothing
+    math::WriteMappedFile(filepath, v);
+    {
+        math::MappedFile file(filepath);
+        math::MappedFile moved(std::move(file));
+        success = success && moved.GetVector<ElementType>() == v && file.GetShape() == math::TensorShape(0, 0, 0);
+    }
+    std::remove(filepath.c_str());
+
+    testing::ProcessTest("MappedFile rejects corrupt headers", success);
+}
+
+#pragma endregion implementation
@@ -10,18 +10,118 @@
 
 #include <testing/include/testing.h>
 
+#include <math/include/BinaryMatrix.h>
+#include <math/include/BlockSparseMatrix.h>
+#include <math/include/Broadcast.h>
+#include <math/include/Distances.h>
+#include <math/include/GramMatrix.h>
+#include <math/include/ImplementationThresholds.h>
+#include <math/include/KMeans.h>
+#include <math/include/LowRankMatrix.h>
 #include <math/include/Matrix.h>
 #include <math/include/MatrixOperations.h>
+#include <math/include/Normalization.h>
+#include <math/include/PackedMatrix.h>
+#include <math/include/Softmax.h>
+#include <math/include/StructuredMatrix.h>
+#include <math/include/TopK.h>
 #include <math/include/Vector.h>
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace ell;
 
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixNumRows();
 
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixSoftmax();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixMultiplyScaleAddUpdateImplementations();
+
+void TestImplementationThresholds();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestPackedMatrix();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixBroadcast();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixNormalization();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixPairwiseDistances();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixTopK();
+
+template <typename ElementType>
+void TestKMeans();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixMultiplyTransposeScaleAddUpdate();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestStructuredMatrices();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestBlockSparseMatrix();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestLowRankMatrix();
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestBinaryMatrix();
+
+void TestPopcountKernels();
+
 #pragma region implementation 
 
+// element (i, j) of a fixed pattern of multiples of 1/4 between -5/4 and 5/4; products and sums of a few hundred of
+// them are exact even in float, so every implementation of a product agrees bit for bit
+template <typename ElementType>
+ElementType ExactValue(size_t i, size_t j)
+{
+    return static_cast<ElementType>((static_cast<int>(i * 7 + j * 3) % 11 - 5) / 4.0);
+}
+
+// fills a matrix with the pattern of ExactValue, from (rowOffset, columnOffset) on
+template <typename ElementType, math::MatrixLayout layout>
+void FillExactly(math::MatrixReference<ElementType, layout> matrix, size_t rowOffset = 0, size_t columnOffset = 0)
+{
+    for (size_t i = 0; i < matrix.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < matrix.NumColumns(); ++j)
+        {
+            matrix(i, j) = ExactValue<ElementType>(i + rowOffset, j + columnOffset);
+        }
+    }
+}
+
+// the scalars of the products of matrices filled by FillExactly, which keep the products exact
+template <typename ElementType>
+const ElementType exactAlpha = static_cast<ElementType>(0.5);
+
+template <typename ElementType>
+const ElementType exactBeta = static_cast<ElementType>(-1.5);
+
+// a matrix with the other layout, to check products of mixed layouts
+template <typename ElementType, math::MatrixLayout layout>
+using TransposedLayoutMatrix = math::Matrix<ElementType, math::TransposeMatrixLayout<layout>::value>;
+
 template <typename ElementType, math::MatrixLayout layout>
 void TestMatrixNumRows() 
 {
@@ -35,4 +135,1177 @@ void TestMatrixNumRows()
     testing::ProcessTest("Matrix::Operator", M.NumRows() == 3 && N.NumRows() == 2);
 }
 
-#pragma endregion implementation
\ No newline at end of file
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixSoftmax()
+{
+    // large logits overflow exp without the maximum subtraction, and 600 columns span several chunks
+    const size_t numRows = 7;
+    const size_t numColumns = 600;
+    math::Matrix<ElementType, layout> M(numRows, numColumns);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            M(i, j) = static_cast<ElementType>(100.0 * i + 0.05 * j - 3.0 * std::sin(0.1 * (i + 1) * j));
+        }
+    }
+
+    // reference values of the row-wise log-sum-exp, computed in double
+    std::vector<double> rowLogSumExp(numRows);
+    std::vector<double> columnLogSumExp(numColumns);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        double maximum = M(i, 0);
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            maximum = std::max(maximum, static_cast<double>(M(i, j)));
+        }
+        double sum = 0;
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            sum += std::exp(M(i, j) - maximum);
+        }
+        rowLogSumExp[i] = maximum + std::log(sum);
+    }
+    for (size_t j = 0; j < numColumns; ++j)
+    {
+        double maximum = M(0, j);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            maximum = std::max(maximum, static_cast<double>(M(i, j)));
+        }
+        double sum = 0;
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            sum += std::exp(M(i, j) - maximum);
+        }
+        columnLogSumExp[j] = maximum + std::log(sum);
+    }
+
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-10;
+    auto isClose = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::ColumnVector<ElementType> rowResult(numRows);
+    math::RowVector<ElementType> columnResult(numColumns);
+    math::RowwiseLogSumExp(M, rowResult);
+    math::ColumnwiseLogSumExp(M, columnResult);
+    bool logSumExpOk = true;
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        logSumExpOk = logSumExpOk && isClose(rowResult[i], rowLogSumExp[i]);
+    }
+    for (size_t j = 0; j < numColumns; ++j)
+    {
+        logSumExpOk = logSumExpOk && isClose(columnResult[j], columnLogSumExp[j]);
+    }
+
+    math::Matrix<ElementType, layout> R(M);
+    math::Matrix<ElementType, layout> C(M);
+    math::Matrix<ElementType, layout> logR(M);
+    math::Matrix<ElementType, layout> logC(M);
+    math::RowwiseSoftmaxUpdate(R);
+    math::ColumnwiseSoftmaxUpdate(C);
+    math::RowwiseLogSoftmaxUpdate(logR);
+    math::ColumnwiseLogSoftmaxUpdate(logC);
+    bool softmaxOk = true;
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            softmaxOk = softmaxOk && isClose(R(i, j), std::exp(M(i, j) - rowLogSumExp[i])) &&
+                        isClose(C(i, j), std::exp(M(i, j) - columnLogSumExp[j])) &&
+                        isClose(logR(i, j), M(i, j) - rowLogSumExp[i]) &&
+                        isClose(logC(i, j), M(i, j) - columnLogSumExp[j]);
+        }
+    }
+
+    // a submatrix has an increment larger than its major size, and the elements around it stay untouched
+    math::Matrix<ElementType, layout> N(M);
+    auto S = N.GetSubMatrix(1, 3, 4, 5);
+    math::Matrix<ElementType, layout> T(S);
+    math::RowwiseSoftmaxUpdate(S);
+    math::RowwiseSoftmaxUpdate(T.GetReference());
+    math::ColumnwiseLogSoftmaxUpdate(S);
+    math::ColumnwiseLogSoftmaxUpdate(T.GetReference());
+    bool subMatrixOk = N(0, 3) == M(0, 3) && N(1, 2) == M(1, 2) && N(1, 8) == M(1, 8) && N(5, 3) == M(5, 3);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 5; ++j)
+        {
+            subMatrixOk = subMatrixOk && S(i, j) == T(i, j);
+        }
+    }
+
+    testing::ProcessTest("Matrix::LogSumExp", logSumExpOk);
+    testing::ProcessTest("Matrix::SoftmaxUpdate", softmaxOk && subMatrixOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixMultiplyScaleAddUpdateImplementations()
+{
+    // a depth of 301 spans two depth blocks and the odd sizes leave partial tiles on every edge
+    const size_t numRows = 37;
+    const size_t numColumns = 53;
+    const size_t depth = 301;
+
+    math::Matrix<ElementType, layout> A(numRows, depth);
+    TransposedLayoutMatrix<ElementType, layout> B(depth, numColumns);
+    math::Matrix<ElementType, layout> C(numRows + 2, numColumns + 3);
+    FillExactly(A);
+    FillExactly(B, 1, 0);
+    FillExactly(C, 0, 5);
+    math::ColumnVector<ElementType> x(depth);
+    math::ColumnVector<ElementType> y(numRows);
+    math::RowVector<ElementType> u(numRows);
+    math::RowVector<ElementType> v(depth);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        y[i] = ExactValue<ElementType>(i, 1);
+        u[i] = ExactValue<ElementType>(i, 2);
+    }
+    for (size_t k = 0; k < depth; ++k)
+    {
+        x[k] = ExactValue<ElementType>(k, 3);
+    }
+
+    // the result is a submatrix of C, so its increment is larger than its major size
+    auto expectedC = C;
+    auto expectedY = y;
+    auto expectedV = v;
+    auto expectedBeta0 = C;
+    const ElementType alpha = exactAlpha<ElementType>;
+    const ElementType beta = exactBeta<ElementType>;
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A, B, beta, expectedC.GetSubMatrix(1, 2, numRows, numColumns));
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A, B, static_cast<ElementType>(0), expectedBeta0.GetSubMatrix(1, 2, numRows, numColumns));
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A, x, beta, expectedY);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, u, A, beta, expectedV);
+
+    auto check = [&](auto implementationTag) {
+        const math::ImplementationType implementation = decltype(implementationTag)::value;
+        auto resultC = C;
+        auto resultY = y;
+        auto resultV = v;
+        auto resultBeta0 = C;
+        auto subMatrix = resultBeta0.GetSubMatrix(1, 2, numRows, numColumns);
+        subMatrix.Fill(std::numeric_limits<ElementType>::quiet_NaN()); // beta == 0 must not read the output
+        math::MultiplyScaleAddUpdate<implementation>(alpha, A, B, beta, resultC.GetSubMatrix(1, 2, numRows, numColumns));
+        math::MultiplyScaleAddUpdate<implementation>(alpha, A, B, static_cast<ElementType>(0), subMatrix);
+        math::MultiplyScaleAddUpdate<implementation>(alpha, A, x, beta, resultY);
+        math::MultiplyScaleAddUpdate<implementation>(alpha, u, A, beta, resultV);
+        return resultC == expectedC && resultBeta0 == expectedBeta0 && resultY == expectedY && resultV == expectedV;
+    };
+
+    auto savedThresholds = math::GetImplementationThresholds();
+    bool blockedOk = check(std::integral_constant<math::ImplementationType, math::ImplementationType::blocked>());
+
+    // a product without rows or without columns leaves no blocks to split the work into
+    math::Matrix<ElementType, layout> noRowsA(0, depth);
+    math::Matrix<ElementType, layout> noRowsC(0, numColumns);
+    TransposedLayoutMatrix<ElementType, layout> noColumnsB(depth, 0);
+    math::Matrix<ElementType, layout> noColumnsC(numRows, 0);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::blocked>(alpha, noRowsA, B, beta, noRowsC);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::blocked>(alpha, A, noColumnsB, beta, noColumnsC);
+
+    math::ImplementationThresholds thresholds;
+    thresholds.matrixMatrixBlocked = 0;
+    thresholds.matrixVectorBlocked = 0;
+    math::SetImplementationThresholds(thresholds);
+    bool automaticBlockedOk = check(std::integral_constant<math::ImplementationType, math::ImplementationType::automatic>());
+    thresholds.matrixMatrixBlocked = math::ImplementationThresholds::never;
+    thresholds.matrixVectorBlocked = math::ImplementationThresholds::never;
+    math::SetImplementationThresholds(thresholds);
+    bool automaticNativeOk = check(std::integral_constant<math::ImplementationType, math::ImplementationType::automatic>());
+    math::SetImplementationThresholds(savedThresholds);
+
+    testing::ProcessTest("Matrix::MultiplyScaleAddUpdate<blocked>", blockedOk);
+    testing::ProcessTest("Matrix::MultiplyScaleAddUpdate<automatic>", automaticBlockedOk && automaticNativeOk);
+}
+
+void TestImplementationThresholds()
+{
+    const std::string filepath = "ImplementationThresholds_test.txt";
+    math::ImplementationThresholds thresholds;
+    thresholds.matrixMatrixBlocked = 12345;
+    thresholds.matrixMatrixBlas = 1 << 20;
+    thresholds.matrixVectorBlocked = math::ImplementationThresholds::never;
+    thresholds.convolutionFFT = 100;
+    math::WriteImplementationThresholds(filepath, thresholds);
+    auto readThresholds = math::ReadImplementationThresholds(filepath);
+    bool roundTripOk = readThresholds.matrixMatrixBlocked == 12345 && readThresholds.matrixMatrixBlas == (1 << 20) &&
+                       readThresholds.matrixVectorBlocked == math::ImplementationThresholds::never &&
+                       readThresholds.matrixVectorBlas == thresholds.matrixVectorBlas && readThresholds.convolutionFFT == 100;
+
+    auto saved = math::GetImplementationThresholds();
+    math::SetImplementationThresholds(readThresholds);
+    bool chooseOk = math::ChooseMatrixMatrixImplementation(20, 20, 20) == math::ImplementationType::native &&
+                    math::ChooseMatrixMatrixImplementation(30, 30, 30) != math::ImplementationType::native &&
+                    math::ChooseMatrixVectorImplementation(4096, 4096) == math::ImplementationType::native &&
+                    math::ChooseConvolutionMethod(10000, 99) == math::ConvolutionMethod::direct &&
+                    math::ChooseConvolutionMethod(100, 10000) == math::ConvolutionMethod::fft;
+    math::SetImplementationThresholds(saved);
+
+    bool badFileThrows = false;
+    {
+        auto stream = utilities::OpenOfstream(filepath);
+        stream << "matrixMatrixBlocked = many\n";
+    }
+    try
+    {
+        math::ReadImplementationThresholds(filepath);
+    }
+    catch (const utilities::InputException&)
+    {
+        badFileThrows = true;
+    }
+    std::remove(filepath.c_str());
+
+    testing::ProcessTest("ImplementationThresholds::Read/Write", roundTripOk && badFileThrows);
+    testing::ProcessTest("ImplementationThresholds::Choose", chooseOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestPackedMatrix()
+{
+    // 300 rows span two depth blocks and 45 columns end in a partial panel
+    const size_t numRows = 300;
+    const size_t numColumns = 45;
+
+    math::Matrix<ElementType, layout> W(numRows, numColumns);
+    TransposedLayoutMatrix<ElementType, layout> WT(numColumns, numRows);
+    FillExactly(W);
+    WT.CopyFrom(W.Transpose());
+    math::Matrix<ElementType, layout> A(5, numRows);
+    FillExactly(A, 2, 0);
+    math::ColumnVector<ElementType> x(numColumns);
+    math::RowVector<ElementType> u(numRows);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        u[i] = ExactValue<ElementType>(i, 1);
+    }
+    for (size_t j = 0; j < numColumns; ++j)
+    {
+        x[j] = ExactValue<ElementType>(j, 4);
+    }
+
+    const ElementType alpha = exactAlpha<ElementType>;
+    const ElementType beta = exactBeta<ElementType>;
+    auto initial = [&](auto& result) {
+        for (size_t i = 0; i < result.Size(); ++i)
+        {
+            result[i] = ExactValue<ElementType>(i, 9);
+        }
+    };
+
+    // the reference products use the packed matrix as seen through operator(), so quantization errors cancel out
+    auto check = [&](const math::PackedMatrix<ElementType>& P, double tolerance) {
+        math::Matrix<ElementType, layout> reference(P.NumRows(), P.NumColumns());
+        for (size_t i = 0; i < P.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < P.NumColumns(); ++j)
+            {
+                reference(i, j) = P(i, j);
+            }
+        }
+        auto isClose = [tolerance](const auto& a, const auto& b) { return a.IsEqual(b, static_cast<ElementType>(tolerance)); };
+
+        math::Matrix<ElementType, layout> expectedC(A.NumRows(), numColumns);
+        TransposedLayoutMatrix<ElementType, layout> resultC(A.NumRows(), numColumns);
+        FillExactly(expectedC, 0, 3);
+        FillExactly(resultC, 0, 3);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A, reference, beta, expectedC);
+        math::MultiplyScaleAddUpdate(alpha, A, P, beta, resultC);
+
+        math::ColumnVector<ElementType> expectedY(numRows);
+        math::ColumnVector<ElementType> resultY(numRows);
+        initial(expectedY);
+        resultY.Fill(std::numeric_limits<ElementType>::quiet_NaN()); // beta == 0 must not read the output
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, reference, x, static_cast<ElementType>(0), expectedY);
+        math::MultiplyScaleAddUpdate(alpha, P, x, static_cast<ElementType>(0), resultY);
+
+        math::RowVector<ElementType> expectedV(numColumns);
+        math::RowVector<ElementType> resultV(numColumns);
+        initial(expectedV);
+        initial(resultV);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, u, reference, beta, expectedV);
+        math::MultiplyScaleAddUpdate(alpha, u, P, beta, resultV);
+
+        return isClose(expectedC, resultC) && isClose(expectedY, resultY) && isClose(expectedV, resultV);
+    };
+
+    math::PackedMatrix<ElementType> packed(W);
+    math::PackedMatrix<ElementType> packedTranspose(WT, math::MatrixTranspose::transpose);
+    bool layoutOk = packed.NumRows() == numRows && packed.NumColumns() == numColumns && packedTranspose.NumRows() == numRows;
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            layoutOk = layoutOk && packed(i, j) == W(i, j) && packedTranspose(i, j) == W(i, j);
+        }
+    }
+
+    // quantization keeps every element within half a step of its column scale
+    math::PackedMatrix<ElementType> quantized(W, math::MatrixTranspose::noTranspose, math::PackedMatrixQuantization::int8);
+    bool quantizationOk = true;
+    for (size_t j = 0; j < numColumns; ++j)
+    {
+        ElementType maximum = 0;
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            maximum = std::max(maximum, std::abs(W(i, j)));
+        }
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            quantizationOk = quantizationOk && std::abs(quantized(i, j) - W(i, j)) <= maximum / 254 * 1.0001;
+        }
+    }
+
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-10;
+    testing::ProcessTest("PackedMatrix::operator()", layoutOk && quantizationOk);
+    testing::ProcessTest("PackedMatrix::MultiplyScaleAddUpdate", check(packed, 0) && check(packedTranspose, 0));
+    testing::ProcessTest("PackedMatrix::MultiplyScaleAddUpdate quantized", check(quantized, tolerance));
+
+    // an empty batch has nothing to multiply, and a matrix without columns only scales y
+    math::Matrix<ElementType, layout> emptyBatch(0, numRows);
+    math::Matrix<ElementType, layout> emptyResult(0, numColumns);
+    math::MultiplyScaleAddUpdate(alpha, emptyBatch, packed, beta, emptyResult);
+    math::MultiplyScaleAddUpdate(alpha, emptyBatch, quantized, beta, emptyResult);
+    math::Matrix<ElementType, layout> noColumns(5, 0);
+    math::ColumnVector<ElementType> emptyX(0);
+    math::ColumnVector<ElementType> scaledY(5);
+    math::ColumnVector<ElementType> scaledQuantizedY(5);
+    scaledY.Fill(1);
+    scaledQuantizedY.Fill(1);
+    math::MultiplyScaleAddUpdate(alpha, math::PackedMatrix<ElementType>(noColumns), emptyX, beta, scaledY);
+    math::MultiplyScaleAddUpdate(alpha, math::PackedMatrix<ElementType>(noColumns, math::MatrixTranspose::noTranspose, math::PackedMatrixQuantization::int8), emptyX, beta, scaledQuantizedY);
+    bool emptyOk = true;
+    for (size_t i = 0; i < scaledY.Size(); ++i)
+    {
+        emptyOk = emptyOk && scaledY[i] == beta && scaledQuantizedY[i] == beta;
+    }
+    testing::ProcessTest("PackedMatrix::MultiplyScaleAddUpdate empty", emptyOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixBroadcast()
+{
+    using math::BroadcastOperation;
+    math::Matrix<ElementType, layout> A{ { 1, -2, 3, 0 }, { 4, 5, -6, 2 }, { -7, 8, 9, 1 } };
+    math::RowVector<ElementType> rowVector{ 2, 0, -1, 4 };
+    math::ColumnVector<ElementType> columnVector{ 3, -5, 1 };
+    math::RowMatrix<ElementType> rowMatrix{ { 1, 2, 3, 4 } };
+
+    math::Matrix<ElementType, layout> minimum(3, 4);
+    math::Matrix<ElementType, layout> difference(3, 4);
+    math::ColumnMatrix<ElementType> outer(3, 4);
+    math::Matrix<ElementType, layout> product(3, 4);
+    math::Broadcast<BroadcastOperation::minimum>(A, rowVector, minimum);
+    math::Broadcast<BroadcastOperation::subtract>(columnVector, A, difference);
+    math::Broadcast<BroadcastOperation::multiply>(columnVector, rowMatrix, outer);
+    math::Broadcast<BroadcastOperation::multiply>(A, A, product);
+
+    auto sum = A;
+    math::Broadcast<BroadcastOperation::add>(sum, rowVector, sum);
+
+    bool success = true;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            success = success && minimum(i, j) == std::min(A(i, j), rowVector[j]);
+            success = success && difference(i, j) == columnVector[i] - A(i, j);
+            success = success && outer(i, j) == columnVector[i] * rowMatrix(0, j);
+            success = success && product(i, j) == A(i, j) * A(i, j);
+            success = success && sum(i, j) == A(i, j) + rowVector[j];
+        }
+    }
+
+    testing::ProcessTest("MatrixOperations::Broadcast", success);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixNormalization()
+{
+    // rows longer than a chunk, and a large offset that the sum-of-squares formula would cancel in float
+    const size_t numRows = 37;
+    const size_t numColumns = 600;
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-3 : 1.0e-10;
+    auto isClose = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::Matrix<ElementType, layout> A(numRows, numColumns);
+    math::RowVector<ElementType> scale(numColumns);
+    math::RowVector<ElementType> bias(numColumns);
+    for (size_t j = 0; j < numColumns; ++j)
+    {
+        scale[j] = static_cast<ElementType>(1 + 0.01 * (j % 7));
+        bias[j] = static_cast<ElementType>(0.1 * (j % 5));
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            A(i, j) = static_cast<ElementType>(1000 + i + std::sin(0.1 * (i + 3 * j)));
+        }
+    }
+
+    math::ColumnVector<ElementType> mean(numRows);
+    math::ColumnVector<ElementType> variance(numRows);
+    math::RowwiseMeanAndVariance(A, mean, variance);
+
+    auto layerNormalized = A;
+    auto rmsNormalized = A;
+    ElementType epsilon = static_cast<ElementType>(1.0e-5);
+    math::RowwiseLayerNormalizationUpdate(layerNormalized, scale, bias, epsilon);
+    math::RowwiseRMSNormalizationUpdate(rmsNormalized, scale, epsilon);
+
+    bool statisticsOk = true;
+    bool layerOk = true;
+    bool rmsOk = true;
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        double sum = 0;
+        double sumOfSquares = 0;
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            sum += A(i, j);
+            sumOfSquares += static_cast<double>(A(i, j)) * A(i, j);
+        }
+        double expectedMean = sum / numColumns;
+        double expectedVariance = 0;
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            expectedVariance += (A(i, j) - expectedMean) * (A(i, j) - expectedMean);
+        }
+        expectedVariance /= numColumns;
+        statisticsOk = statisticsOk && isClose(mean[i], expectedMean) && isClose(variance[i], expectedVariance);
+
+        double inverseDeviation = 1 / std::sqrt(expectedVariance + epsilon);
+        double inverseRms = 1 / std::sqrt(sumOfSquares / numColumns + epsilon);
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            layerOk = layerOk && isClose(layerNormalized(i, j), (A(i, j) - expectedMean) * inverseDeviation * scale[j] + bias[j]);
+            rmsOk = rmsOk && isClose(rmsNormalized(i, j), A(i, j) * inverseRms * scale[j]);
+        }
+    }
+
+    testing::ProcessTest("Normalization::RowwiseMeanAndVariance", statisticsOk);
+    testing::ProcessTest("Normalization::RowwiseLayerNormalizationUpdate", layerOk);
+    testing::ProcessTest("Normalization::RowwiseRMSNormalizationUpdate", rmsOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout, math::DistanceMetric metric>
+bool TestMatrixPairwiseDistances(math::ConstMatrixReference<ElementType, layout> A, math::ConstMatrixReference<ElementType, layout> B)
+{
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-10;
+    auto isClose = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::Matrix<ElementType, layout> distances(A.NumRows(), B.NumRows());
+    math::PairwiseDistances<metric>(A, B, distances);
+
+    // tiles that do not divide the output, copied into place
+    math::ColumnMatrix<ElementType> streamed(A.NumRows(), B.NumRows());
+    size_t numTiles = 0;
+    math::StreamPairwiseDistances<metric>(A, B, [&](size_t firstRow, size_t firstColumn, math::ConstRowMatrixReference<ElementType> tile) {
+        streamed.GetSubMatrix(firstRow, firstColumn, tile.NumRows(), tile.NumColumns()).CopyFrom(tile);
+        ++numTiles;
+    }, 3, 4);
+
+    bool success = numTiles == 9;
+    for (size_t i = 0; i < A.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < B.NumRows(); ++j)
+        {
+            double dot = 0;
+            double squaredNormA = 0;
+            double squaredNormB = 0;
+            for (size_t k = 0; k < A.NumColumns(); ++k)
+            {
+                dot += A(i, k) * B(j, k);
+                squaredNormA += A(i, k) * A(i, k);
+                squaredNormB += B(j, k) * B(j, k);
+            }
+
+            double expected = dot;
+            if (metric == math::DistanceMetric::squaredEuclidean)
+            {
+                expected = squaredNormA + squaredNormB - 2 * dot;
+            }
+            else if (metric == math::DistanceMetric::cosine)
+            {
+                expected = squaredNormA == 0 || squaredNormB == 0 ? 1 : 1 - dot / std::sqrt(squaredNormA * squaredNormB);
+            }
+            success = success && isClose(distances(i, j), expected) && isClose(streamed(i, j), expected);
+        }
+    }
+    return success;
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixPairwiseDistances()
+{
+    // the last row of A is zero, and the first row of B equals the first row of A
+    math::Matrix<ElementType, layout> A(7, 5);
+    math::Matrix<ElementType, layout> B(9, 5);
+    for (size_t k = 0; k < 5; ++k)
+    {
+        for (size_t i = 0; i < 6; ++i)
+        {
+            A(i, k) = static_cast<ElementType>(std::sin(1.0 + i + 2.0 * k));
+        }
+        B(0, k) = A(0, k);
+        for (size_t j = 1; j < 9; ++j)
+        {
+            B(j, k) = static_cast<ElementType>(std::cos(0.5 * j - k));
+        }
+    }
+
+    bool success = TestMatrixPairwiseDistances<ElementType, layout, math::DistanceMetric::squaredEuclidean>(A, B) &&
+                   TestMatrixPairwiseDistances<ElementType, layout, math::DistanceMetric::cosine>(A, B) &&
+                   TestMatrixPairwiseDistances<ElementType, layout, math::DistanceMetric::innerProduct>(A, B);
+
+    math::Matrix<ElementType, layout> distances(7, 9);
+    math::PairwiseDistances<math::DistanceMetric::squaredEuclidean>(A, B, distances);
+    success = success && distances(0, 0) >= 0 && distances(0, 0) < 1.0e-5;
+
+    testing::ProcessTest("Distances::PairwiseDistances and StreamPairwiseDistances", success);
+}
+
+template <typename ElementType, math::MatrixLayout layout, math::TopKOrder order>
+bool TestMatrixTopK(math::ConstMatrixReference<ElementType, layout> M, size_t k)
+{
+    math::Matrix<ElementType, layout> values(M.NumRows(), k);
+    math::Matrix<size_t, layout> indices(M.NumRows(), k);
+    math::RowwiseTopK<order>(M, values, indices);
+
+    // the same selection from tiles
+    math::RowwiseTopKSelector<ElementType, order> selector(M.NumRows(), k);
+    for (size_t firstRow = 0; firstRow < M.NumRows(); firstRow += 2)
+    {
+        for (size_t firstColumn = 0; firstColumn < M.NumColumns(); firstColumn += 70)
+        {
+            selector(firstRow, firstColumn, M.GetSubMatrix(firstRow, firstColumn, std::min<size_t>(2, M.NumRows() - firstRow), std::min<size_t>(70, M.NumColumns() - firstColumn)));
+        }
+    }
+    math::Matrix<ElementType, layout> tileValues(M.NumRows(), k);
+    math::Matrix<size_t, layout> tileIndices(M.NumRows(), k);
+    selector.GetResult(tileValues, tileIndices);
+
+    bool success = true;
+    for (size_t i = 0; i < M.NumRows(); ++i)
+    {
+        std::vector<std::pair<ElementType, size_t>> expected;
+        for (size_t j = 0; j < M.NumColumns(); ++j)
+        {
+            expected.emplace_back(order == math::TopKOrder::largest ? -M(i, j) : M(i, j), j);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        math::RowVector<ElementType> vectorValues(k);
+        math::RowVector<size_t> vectorIndices(k);
+        math::TopK<order>(M.GetRow(i), vectorValues, vectorIndices);
+        for (size_t j = 0; j < k; ++j)
+        {
+            success = success && indices(i, j) == expected[j].second && values(i, j) == M(i, expected[j].second);
+            success = success && tileIndices(i, j) == indices(i, j) && tileValues(i, j) == values(i, j);
+            success = success && vectorIndices[j] == indices(i, j) && vectorValues[j] == values(i, j);
+        }
+    }
+    return success;
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixTopK()
+{
+    // many repeated values, so that ties decide the order
+    math::Matrix<ElementType, layout> M(5, 300);
+    for (size_t i = 0; i < M.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < M.NumColumns(); ++j)
+        {
+            M(i, j) = static_cast<ElementType>((i * 37 + j * 101) % 97);
+        }
+    }
+    bool selectionOk = TestMatrixTopK<ElementType, layout, math::TopKOrder::largest>(M, 7) && TestMatrixTopK<ElementType, layout, math::TopKOrder::smallest>(M, 7);
+
+    // nearest neighbors: the rows of B are rows of A, so each one is its own nearest neighbor
+    math::Matrix<ElementType, layout> A(40, 3);
+    for (size_t i = 0; i < A.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < A.NumColumns(); ++j)
+        {
+            A(i, j) = static_cast<ElementType>(std::sin(1.0 + 3.0 * i + j));
+        }
+    }
+    auto B = A.GetSubMatrix(10, 0, 20, 3);
+    math::RowwiseTopKSelector<ElementType, math::TopKOrder::smallest> nearest(B.NumRows(), 2);
+    math::StreamPairwiseDistances<math::DistanceMetric::squaredEuclidean>(B, A, nearest, 8, 16);
+    math::RowMatrix<ElementType> distances(B.NumRows(), 2);
+    math::RowMatrix<size_t> neighbors(B.NumRows(), 2);
+    nearest.GetResult(distances, neighbors);
+    bool nearestOk = true;
+    for (size_t i = 0; i < B.NumRows(); ++i)
+    {
+        nearestOk = nearestOk && neighbors(i, 0) == i + 10 && distances(i, 0) < 1.0e-5 && distances(i, 1) > distances(i, 0);
+    }
+
+    testing::ProcessTest("TopK::RowwiseTopK, TopK and RowwiseTopKSelector", selectionOk);
+    testing::ProcessTest("TopK::RowwiseTopKSelector as a distance tile consumer", nearestOk);
+}
+
+template <typename ElementType>
+void TestKMeans()
+{
+    // three separated blobs of 200 points each, interleaved, around the centers (10 * b, -5 * b, 3, ...)
+    const size_t numBlobs = 3;
+    const size_t numPoints = 600;
+    const size_t dimension = 8;
+    math::RowMatrix<ElementType> data(numPoints, dimension);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        size_t blob = i % numBlobs;
+        for (size_t j = 0; j < dimension; ++j)
+        {
+            double center = j == 0 ? 10.0 * blob : (j == 1 ? -5.0 * blob : 3);
+            data(i, j) = static_cast<ElementType>(center + 0.5 * std::sin(1.7 * i + 2.3 * j));
+        }
+    }
+
+    auto isClustered = [&](const math::KMeansResult<ElementType>& result) {
+        bool success = result.centroids.NumRows() == numBlobs && result.assignments.size() == numPoints;
+        for (size_t i = 0; success && i < numPoints; ++i)
+        {
+            // each point shares its cluster with the points of its blob, and only with them
+            success = result.assignments[i] == result.assignments[i % numBlobs] && (i % numBlobs == 0 || result.assignments[i] != result.assignments[0]);
+        }
+        for (size_t blob = 0; success && blob < numBlobs; ++blob)
+        {
+            auto centroid = result.centroids.GetRow(result.assignments[blob]);
+            success = std::abs(centroid[0] - 10.0 * blob) < 0.1 && std::abs(centroid[1] + 5.0 * blob) < 0.1;
+        }
+        return success;
+    };
+
+    math::KMeansParameters parameters;
+    parameters.numClusters = numBlobs;
+    parameters.seed = 7;
+    auto lloyd = math::KMeans(data, parameters);
+    auto again = math::KMeans(data, parameters);
+    bool lloydOk = isClustered(lloyd) && lloyd.converged && lloyd.inertia < 0.15 * numPoints * dimension; // each coordinate has variance 0.125 around its center
+    bool deterministic = again.centroids == lloyd.centroids && again.assignments == lloyd.assignments && again.numIterations == lloyd.numIterations;
+
+    parameters.batchSize = 64;
+    parameters.maxIterations = 50;
+    auto miniBatch = math::KMeans(data, parameters);
+    bool miniBatchOk = isClustered(miniBatch);
+
+    testing::ProcessTest("KMeans with Lloyd iterations", lloydOk && deterministic);
+    testing::ProcessTest("KMeans with mini-batches", miniBatchOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestMatrixMultiplyTransposeScaleAddUpdate()
+{
+    // 150 columns span two row blocks of the blocked kernel and a depth of 301 spans two depth blocks
+    const size_t numRows = 301;
+    const size_t numColumns = 150;
+
+    math::Matrix<ElementType, layout> A(numRows, numColumns);
+    TransposedLayoutMatrix<ElementType, layout> C(numColumns, numColumns);
+    FillExactly(A);
+    FillExactly(C, 2, 0);
+
+    const ElementType alpha = exactAlpha<ElementType>;
+    const ElementType beta = exactBeta<ElementType>;
+    auto expected = C;
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A.Transpose(), math::ConstMatrixReference<ElementType, layout>(A), beta, expected.GetReference());
+
+    // one triangle is computed and the other is either left alone or mirrored
+    auto check = [&](auto implementationTag, math::MatrixTriangle triangle, bool mirror) {
+        const math::ImplementationType implementation = decltype(implementationTag)::value;
+        auto result = C;
+        math::MultiplyTransposeScaleAddUpdate<implementation>(alpha, A, beta, result.GetReference(), triangle, mirror);
+        bool ok = true;
+        for (size_t i = 0; i < numColumns; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                bool isComputed = triangle == math::MatrixTriangle::lower ? i >= j : i <= j;
+                ElementType target = isComputed ? expected(i, j) : (mirror ? expected(j, i) : C(i, j));
+                ok = ok && result(i, j) == target;
+            }
+        }
+        return ok;
+    };
+    std::integral_constant<math::ImplementationType, math::ImplementationType::native> native;
+    std::integral_constant<math::ImplementationType, math::ImplementationType::blocked> blocked;
+    bool nativeOk = check(native, math::MatrixTriangle::lower, false) && check(native, math::MatrixTriangle::upper, true);
+    bool blockedOk = check(blocked, math::MatrixTriangle::lower, false) && check(blocked, math::MatrixTriangle::upper, false) &&
+                     check(blocked, math::MatrixTriangle::lower, true) && check(blocked, math::MatrixTriangle::upper, true);
+
+    // streaming over uneven blocks of rows gives the full Gram matrix
+    math::GramMatrixAccumulator<ElementType> accumulator(numColumns);
+    for (size_t firstRow = 0; firstRow < numRows; firstRow += 97)
+    {
+        accumulator.Accumulate(A.GetSubMatrix(firstRow, 0, std::min<size_t>(97, numRows - firstRow), numColumns));
+    }
+    math::RowMatrix<ElementType> gram(numColumns, numColumns);
+    math::MultiplyScaleAddUpdate<math::ImplementationType::native>(ElementType{ 1 }, A.Transpose(), math::ConstMatrixReference<ElementType, layout>(A), ElementType{ 0 }, gram.GetReference());
+    bool streamOk = accumulator.NumRows() == numRows && accumulator.GetGramMatrix() == gram;
+    accumulator.Reset();
+    streamOk = streamOk && accumulator.NumRows() == 0 && accumulator.GetGramMatrix() == math::RowMatrix<ElementType>(numColumns, numColumns);
+
+    testing::ProcessTest("Matrix::MultiplyTransposeScaleAddUpdate<native>", nativeOk);
+    testing::ProcessTest("Matrix::MultiplyTransposeScaleAddUpdate<blocked>", blockedOk);
+    testing::ProcessTest("GramMatrixAccumulator", streamOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestStructuredMatrices()
+{
+    // 300 rows are enough to split the triangular products across tasks; the diagonal dominates every row, so the
+    // solves are well conditioned
+    const size_t size = 300;
+    const ElementType tolerance = std::is_same<ElementType, float>::value ? static_cast<ElementType>(1.0e-3) : static_cast<ElementType>(1.0e-10);
+    math::Matrix<ElementType, layout> dense(size, size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        for (size_t j = 0; j < size; ++j)
+        {
+            dense(i, j) = static_cast<ElementType>((static_cast<int>(i * 7 + j * 3) % 11 - 5) / 40.0) + (i == j ? 4 : 0);
+        }
+    }
+    math::ColumnVector<ElementType> x(size);
+    math::RowVector<ElementType> u(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        x[i] = static_cast<ElementType>(static_cast<int>(i % 13) - 6);
+        u[i] = static_cast<ElementType>(static_cast<int>(i % 5) - 2);
+    }
+    auto isClose = [&](auto& a, auto& b) {
+        ElementType error = 0;
+        for (size_t i = 0; i < a.Size(); ++i)
+        {
+            error = std::max(error, std::abs(a[i] - b[i]));
+        }
+        return error < tolerance * 10;
+    };
+
+    // products, solves and conversions of a structured matrix, checked against its dense copy
+    auto check = [&](auto& structured) {
+        const ElementType alpha = static_cast<ElementType>(0.5);
+        const ElementType beta = static_cast<ElementType>(-1.5);
+        math::Matrix<ElementType, layout> copy(size, size);
+        structured.CopyTo(copy.GetReference());
+        bool ok = true;
+        for (size_t i = 0; i < size; ++i)
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                ok = ok && copy(i, j) == structured(i, j) && (structured(i, j) == 0 || structured(i, j) == dense(i, j));
+            }
+        }
+
+        math::ColumnVector<ElementType> y(size);
+        math::ColumnVector<ElementType> expectedY(size);
+        y.Fill(1);
+        expectedY.Fill(1);
+        math::MultiplyScaleAddUpdate(alpha, structured, x, beta, y);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, copy, x, beta, expectedY);
+        math::RowVector<ElementType> v(size);
+        math::RowVector<ElementType> expectedV(size);
+        v.Fill(1);
+        expectedV.Fill(1);
+        math::MultiplyScaleAddUpdate(alpha, u, structured, beta, v);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, u, copy, beta, expectedV);
+        ok = ok && isClose(y, expectedY) && isClose(v, expectedV);
+
+        // a task of the row vector product visits every row that stores elements in its columns
+        for (size_t begin = 0; begin < size; begin += 37)
+        {
+            size_t end = std::min(size, begin + 50);
+            auto rows = math::Internal::GetRowsInColumns(structured, begin, end);
+            for (size_t i = 0; i < size; ++i)
+            {
+                bool reaches = structured.GetRowBegin(i) < end && structured.GetRowEnd(i) > begin;
+                ok = ok && (!reaches || (i >= rows.first && i < rows.second));
+            }
+        }
+
+        // solving for the products gives back the vectors
+        math::MultiplyScaleAddUpdate(ElementType{ 1 }, structured, x, ElementType{ 0 }, y);
+        math::MultiplyScaleAddUpdate(ElementType{ 1 }, u, structured, ElementType{ 0 }, v);
+        math::SolveUpdate(structured, y);
+        math::SolveUpdate(v, structured);
+        return ok && isClose(y, x) && isClose(v, u);
+    };
+
+    math::DiagonalMatrix<ElementType> diagonal(dense);
+    math::TriangularMatrix<ElementType> lower(dense, math::MatrixTriangle::lower);
+    math::TriangularMatrix<ElementType> upper(dense, math::MatrixTriangle::upper);
+    math::BandedMatrix<ElementType> banded(dense, 3, 1);
+    bool diagonalOk = check(diagonal);
+    bool triangularOk = check(lower) && check(upper) && lower.NumStoredElements() == size * (size + 1) / 2;
+    bool bandedOk = check(banded);
+
+    // long band and diagonal matrices, whose row vector products split the columns across many tasks when there are
+    // several threads; small integers keep the products exact
+    auto checkColumnTasks = [&](auto& structured) {
+        const size_t longSize = structured.NumRows();
+        math::RowVector<ElementType> longU(longSize);
+        math::RowVector<ElementType> expected(longSize);
+        for (size_t i = 0; i < longSize; ++i)
+        {
+            longU[i] = static_cast<ElementType>(static_cast<int>(i % 7) - 3);
+            const ElementType* pRow = structured.GetRowPointer(i);
+            for (size_t j = structured.GetRowBegin(i); j < structured.GetRowEnd(i); ++j)
+            {
+                expected[j] += pRow[j - structured.GetRowBegin(i)] * longU[i];
+            }
+        }
+        math::RowVector<ElementType> result(longSize);
+        math::MultiplyScaleAddUpdate(ElementType{ 1 }, longU, structured, ElementType{ 0 }, result);
+        return result == expected;
+    };
+    const size_t longSize = 50000;
+    math::BandedMatrix<ElementType> longBanded(longSize, longSize, 3, 1);
+    std::vector<ElementType> longDiagonal(longSize);
+    for (size_t i = 0; i < longSize; ++i)
+    {
+        for (size_t j = longBanded.GetRowBegin(i); j < longBanded.GetRowEnd(i); ++j)
+        {
+            longBanded.GetRowPointer(i)[j - longBanded.GetRowBegin(i)] = static_cast<ElementType>(static_cast<int>((i + 2 * j) % 5) - 2);
+        }
+        longDiagonal[i] = static_cast<ElementType>(static_cast<int>(i % 3) + 1);
+    }
+    math::DiagonalMatrix<ElementType> longDiagonalMatrix(longDiagonal);
+    diagonalOk = diagonalOk && checkColumnTasks(longDiagonalMatrix);
+    bandedOk = bandedOk && checkColumnTasks(longBanded);
+
+    // a band whose diagonal is small everywhere needs row swaps; the widened upper band must hold their fill-in
+    math::BandedMatrix<ElementType> pivoting(6, 6, 2, 1);
+    math::ColumnVector<ElementType> solution{ 1, -2, 3, -4, 5, -6 };
+    for (size_t i = 0; i < 6; ++i)
+    {
+        for (size_t j = pivoting.GetRowBegin(i); j < pivoting.GetRowEnd(i); ++j)
+        {
+            pivoting.GetRowPointer(i)[j - pivoting.GetRowBegin(i)] = i == j ? static_cast<ElementType>(0.01) : static_cast<ElementType>(1 + (i + 2 * j) % 3);
+        }
+    }
+    math::ColumnVector<ElementType> rightHandSide(6);
+    math::MultiplyScaleAddUpdate(ElementType{ 1 }, pivoting, solution, ElementType{ 0 }, rightHandSide);
+    math::SolveUpdate(pivoting, rightHandSide);
+    bandedOk = bandedOk && isClose(rightHandSide, solution);
+
+    // scaling touches only the stored elements
+    math::ScaleUpdate(ElementType{ 2 }, upper);
+    bool scaleOk = upper(3, 5) == 2 * dense(3, 5) && upper(5, 3) == 0;
+    bool singularThrows = false;
+    try
+    {
+        math::DiagonalMatrix<ElementType> singular(std::vector<ElementType>{ 1, 0, 2 });
+        math::ColumnVector<ElementType> b{ 1, 1, 1 };
+        math::SolveUpdate(singular, b);
+    }
+    catch (const utilities::NumericException&)
+    {
+        singularThrows = true;
+    }
+
+    testing::ProcessTest("DiagonalMatrix", diagonalOk && singularThrows);
+    testing::ProcessTest("TriangularMatrix", triangularOk && scaleOk);
+    testing::ProcessTest("BandedMatrix", bandedOk);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestBlockSparseMatrix()
+{
+    // sizes that are not multiples of the blocks, with two blocks out of three zeroed and some tiny blocks pruned
+    const size_t numRows = 70;
+    const size_t numColumns = 45;
+    const size_t numOutputColumns = 300;
+
+    math::Matrix<ElementType, layout> B(numColumns, numOutputColumns);
+    TransposedLayoutMatrix<ElementType, layout> otherB(numColumns, numOutputColumns);
+    FillExactly(B, 3, 0);
+    otherB.CopyFrom(B);
+    math::ColumnVector<ElementType> x(numColumns);
+    for (size_t i = 0; i < numColumns; ++i)
+    {
+        x[i] = ExactValue<ElementType>(i, 5);
+    }
+
+    auto check = [&](size_t blockRows, size_t blockColumns) {
+        math::Matrix<ElementType, layout> dense(numRows, numColumns);
+        math::Matrix<ElementType, layout> pruned(numRows, numColumns);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                size_t block = i / blockRows + j / blockColumns;
+                dense(i, j) = block % 3 == 0 ? ExactValue<ElementType>(i, j) : (block % 3 == 1 ? static_cast<ElementType>(1.0 / 1024) : 0);
+                pruned(i, j) = block % 3 == 0 ? ExactValue<ElementType>(i, j) : 0;
+            }
+        }
+        math::BlockSparseMatrix<ElementType> sparse(dense, blockRows, blockColumns, static_cast<ElementType>(0.1));
+        math::Matrix<ElementType, layout> copy(numRows, numColumns);
+        sparse.CopyTo(copy.GetReference());
+        bool ok = copy == pruned && sparse.GetBlockDensity() < 0.4 && sparse(1, 2) == pruned(1, 2);
+
+        const ElementType alpha = exactAlpha<ElementType>;
+        const ElementType beta = exactBeta<ElementType>;
+        math::ColumnVector<ElementType> y(numRows);
+        math::ColumnVector<ElementType> expectedY(numRows);
+        y.Fill(1);
+        expectedY.Fill(1);
+        math::MultiplyScaleAddUpdate(alpha, sparse, x, beta, y);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, pruned, x, beta, expectedY);
+
+        math::Matrix<ElementType, layout> C(numRows + 1, numOutputColumns);
+        C.Fill(1);
+        auto expectedC = C;
+        auto otherC = C;
+        math::MultiplyScaleAddUpdate(alpha, sparse, B, beta, C.GetSubMatrix(1, 0, numRows, numOutputColumns));
+        math::MultiplyScaleAddUpdate(alpha, sparse, otherB, beta, otherC.GetSubMatrix(1, 0, numRows, numOutputColumns));
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, pruned, B, beta, expectedC.GetSubMatrix(1, 0, numRows, numOutputColumns));
+
+        // an empty product, which has no column panels
+        math::Matrix<ElementType, layout> emptyB(numColumns, 0);
+        math::Matrix<ElementType, layout> emptyC(numRows, 0);
+        math::MultiplyScaleAddUpdate(alpha, sparse, emptyB, beta, emptyC);
+        return ok && y == expectedY && C == expectedC && otherC == expectedC;
+    };
+
+    testing::ProcessTest("BlockSparseMatrix with 4 x 4 blocks", check(4, 4));
+    testing::ProcessTest("BlockSparseMatrix with 8 x 1 blocks", check(8, 1));
+    testing::ProcessTest("BlockSparseMatrix with 3 x 5 blocks", check(3, 5));
+}
+
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestLowRankMatrix()
+{
+    // a matrix of rank 3 with singular values far apart, tall and wide
+    const ElementType tolerance = static_cast<ElementType>(std::is_same<ElementType, float>::value ? 1.0e-3 : 1.0e-9);
+    auto makeMatrix = [](size_t numRows, size_t numColumns) {
+        math::Matrix<ElementType, layout> matrix(numRows, numColumns);
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                double value = 4 * std::sin(0.3 * i + 0.1) * std::cos(0.2 * j) + 2 * std::cos(0.7 * i) * std::sin(0.5 * j + 1.0) + 0.5 * std::sin(1.1 * i) * std::cos(0.9 * j + 0.3);
+                matrix(i, j) = static_cast<ElementType>(value);
+            }
+        }
+        return matrix;
+    };
+
+    auto check = [&](size_t numRows, size_t numColumns) {
+        auto dense = makeMatrix(numRows, numColumns);
+        math::LowRankMatrix<ElementType> lowRank(dense, 0.999999);
+        math::Matrix<ElementType, layout> copy(numRows, numColumns);
+        lowRank.CopyTo(copy.GetReference());
+        const auto& singularValues = lowRank.GetSingularValues();
+        bool ok = lowRank.GetRank() == 3 && copy.IsEqual(dense, tolerance) && std::is_sorted(singularValues.rbegin(), singularValues.rend());
+
+        // the factors are orthonormal
+        math::RowMatrix<ElementType> gram(3, 3);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(ElementType{ 1 }, lowRank.GetU().Transpose(), lowRank.GetU(), ElementType{ 0 }, gram.GetReference());
+        math::RowMatrix<ElementType> identity(3, 3);
+        identity.GetDiagonal().Fill(1);
+        ok = ok && gram.IsEqual(identity, tolerance);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(ElementType{ 1 }, lowRank.GetV().Transpose(), lowRank.GetV(), ElementType{ 0 }, gram.GetReference());
+        ok = ok && gram.IsEqual(identity, tolerance);
+
+        // the rank follows the energy and the cap
+        math::LowRankMatrix<ElementType> rankOne(dense, 0.5);
+        math::LowRankMatrix<ElementType> capped(dense, 1.0, 2);
+        ok = ok && rankOne.GetRank() == 1 && capped.GetRank() == 2;
+
+        const ElementType alpha = static_cast<ElementType>(0.5);
+        const ElementType beta = static_cast<ElementType>(-1.5);
+        math::ColumnVector<ElementType> x(numColumns);
+        math::ColumnVector<ElementType> y(numRows);
+        x.Generate([i = 0]() mutable { return static_cast<ElementType>(++i % 5) - 2; });
+        y.Fill(1);
+        auto expectedY = y;
+        math::MultiplyScaleAddUpdate(alpha, lowRank, x, beta, y);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, dense, x, beta, expectedY);
+
+        math::RowVector<ElementType> u(numRows);
+        math::RowVector<ElementType> v(numColumns);
+        u.Generate([i = 0]() mutable { return static_cast<ElementType>(++i % 3) - 1; });
+        v.Fill(1);
+        auto expectedV = v;
+        math::MultiplyScaleAddUpdate(alpha, u, lowRank, beta, v);
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, u, dense, beta, expectedV);
+
+        auto B = makeMatrix(numColumns, 7);
+        math::Matrix<ElementType, layout> C(numRows, 7);
+        C.Fill(1);
+        auto expectedC = C;
+        math::MultiplyScaleAddUpdate(alpha, lowRank, B, beta, C.GetReference());
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, dense, B, beta, expectedC.GetReference());
+
+        auto A = makeMatrix(5, numRows);
+        math::Matrix<ElementType, layout> D(5, numColumns);
+        D.Fill(1);
+        auto expectedD = D;
+        math::MultiplyScaleAddUpdate(alpha, A, lowRank, beta, D.GetReference());
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, A, dense, beta, expectedD.GetReference());
+
+        ElementType productTolerance = 100 * tolerance;
+        return ok && y.IsEqual(expectedY, productTolerance) && v.IsEqual(expectedV, productTolerance) && C.IsEqual(expectedC, productTolerance) && D.IsEqual(expectedD, productTolerance);
+    };
+
+    bool energyThrows = false;
+    try
+    {
+        math::LowRankMatrix<ElementType> lowRank(makeMatrix(4, 4), 1.5);
+    }
+    catch (const utilities::InputException&)
+    {
+        energyThrows = true;
+    }
+
+    testing::ProcessTest("LowRankMatrix of a tall matrix", check(40, 25));
+    testing::ProcessTest("LowRankMatrix of a wide matrix", check(25, 40));
+    testing::ProcessTest("LowRankMatrix energy check", energyThrows);
+}
+
+template <typename ElementType, math::MatrixLayout layout>
+void TestBinaryMatrix()
+{
+    // row lengths with a partial last word, and longer than one 512 bit register
+    auto check = [](size_t numColumns) {
+        const size_t numRowsA = 13;
+        const size_t numRowsB = 22;
+        auto value = [](size_t i, size_t j) { return static_cast<ElementType>(std::sin(1.7 * i + 0.31 * j * j + 0.5)); };
+        math::Matrix<ElementType, layout> A(numRowsA, numColumns);
+        math::Matrix<ElementType, layout> B(numRowsB, numColumns);
+        for (size_t i = 0; i < numRowsA; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                A(i, j) = value(i, j);
+            }
+        }
+        for (size_t i = 0; i < numRowsB; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                B(i, j) = value(i + 100, j);
+            }
+        }
+        A(0, 0) = 0; // zero counts as +1
+
+        // the same matrices as +1/-1 elements
+        math::Matrix<ElementType, layout> signsA(numRowsA, numColumns);
+        math::Matrix<ElementType, layout> signsB(numRowsB, numColumns);
+        for (size_t i = 0; i < numRowsA; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                signsA(i, j) = A(i, j) >= 0 ? ElementType{ 1 } : ElementType{ -1 };
+            }
+        }
+        for (size_t i = 0; i < numRowsB; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                signsB(i, j) = B(i, j) >= 0 ? ElementType{ 1 } : ElementType{ -1 };
+            }
+        }
+
+        math::BinaryMatrix binaryA(A);
+        math::BinaryMatrix binaryB(B);
+        bool ok = binaryA.NumWordsPerRow() == (numColumns + 63) / 64 && binaryA(0, 0);
+        for (size_t i = 0; i < numRowsA; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                ok = ok && binaryA(i, j) == (signsA(i, j) > 0);
+            }
+        }
+
+        math::ColumnVector<ElementType> row(numColumns);
+        row.CopyFrom(A.GetRow(1).Transpose());
+        math::BinaryVector binaryRow(row);
+        size_t distance = 0;
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            distance += signsA(1, j) != signsB(2, j);
+        }
+        ok = ok && math::HammingDistance(binaryRow, binaryB.GetRow(2)) == distance && math::XnorDot(binaryA.GetRow(1), binaryB.GetRow(2)) == static_cast<int64_t>(numColumns) - 2 * static_cast<int64_t>(distance);
+        binaryRow.Set(3, !binaryRow[3]);
+        ok = ok && math::HammingDistance(binaryRow, binaryA.GetRow(1)) == 1;
+
+        math::Matrix<ElementType, layout> distances(numRowsA, numRowsB);
+        math::PairwiseHammingDistances(binaryA, binaryB, distances.GetReference());
+        for (size_t i = 0; i < numRowsA; ++i)
+        {
+            for (size_t j = 0; j < numRowsB; ++j)
+            {
+                size_t expected = 0;
+                for (size_t k = 0; k < numColumns; ++k)
+                {
+                    expected += signsA(i, k) != signsB(j, k);
+                }
+                ok = ok && distances(i, j) == static_cast<ElementType>(expected);
+            }
+        }
+
+        // small integers, so the float products are exact
+        const ElementType alpha = static_cast<ElementType>(0.5);
+        const ElementType beta = static_cast<ElementType>(-2);
+        math::Matrix<ElementType, layout> C(numRowsA, numRowsB);
+        C.Fill(1);
+        auto expectedC = C;
+        math::XnorMultiplyScaleAddUpdate(alpha, binaryA, binaryB, beta, C.GetReference());
+        math::MultiplyScaleAddUpdate<math::ImplementationType::native>(alpha, signsA, signsB.Transpose(), beta, expectedC);
+        return ok && C == expectedC;
+    };
+
+    testing::ProcessTest(std::string("BinaryMatrix (") + math::Internal::GetPopcountImplementationName() + ")", check(150) && check(600) && check(64));
+}
+
+void TestPopcountKernels()
+{
+    // rows shorter than, as long as, and not a multiple of one 512 bit register, with a last block of fewer than four rows
+    const size_t numRowsA = 5;
+    const size_t numRowsB = 11;
+    const size_t outputRowIncrement = numRowsB + 3;
+    const auto& kernels = math::Internal::GetSupportedPopcountKernels();
+    const auto& portable = kernels.front();
+    for (size_t k = 1; k < kernels.size(); ++k)
+    {
+        bool ok = true;
+        for (size_t numWords : { 1, 3, 7, 8, 13, 16, 21 })
+        {
+            std::vector<uint64_t> A(numRowsA * numWords);
+            std::vector<uint64_t> B(numRowsB * numWords);
+            uint64_t state = 0x9e3779b97f4a7c15ull * numWords;
+            for (auto& word : A)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                word = state;
+            }
+            for (auto& word : B)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                word = state;
+            }
+
+            std::vector<uint32_t> expected(numRowsA * outputRowIncrement, 0);
+            std::vector<uint32_t> output(numRowsA * outputRowIncrement, 0);
+            portable.pairwiseXorPopcount(A.data(), numRowsA, B.data(), numRowsB, numWords, expected.data(), outputRowIncrement);
+            kernels[k].pairwiseXorPopcount(A.data(), numRowsA, B.data(), numRowsB, numWords, output.data(), outputRowIncrement);
+            ok = ok && output == expected;
+            for (size_t i = 0; i < numRowsA; ++i)
+            {
+                for (size_t j = 0; j < numRowsB; ++j)
+                {
+                    ok = ok && kernels[k].xorPopcount(A.data() + i * numWords, B.data() + j * numWords, numWords) == portable.xorPopcount(A.data() + i * numWords, B.data() + j * numWords, numWords);
+                }
+            }
+        }
+        testing::ProcessTest(std::string("Popcount kernel ") + kernels[k].name + " against portable", ok);
+    }
+}
+
+#pragma endregion implementation
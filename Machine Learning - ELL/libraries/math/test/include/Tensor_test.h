@@ -16,11 +16,53 @@ using namespace ell;
 template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
 void TestTensorIndexer();
 
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorScaleAddActivationUpdate();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBatchOperations();
+
+template <typename ElementType>
+void TestTensorCopyFromPermutations();
+
+template <typename ElementType>
+void TestTensorConversions();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBroadcast();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorReductions();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBatchNormalization();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorResize();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorConcatenation();
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestPaddedTensor();
+
 #pragma region implementation 
 
+#include <math/include/Broadcast.h>
+#include <math/include/Normalization.h>
+#include <math/include/PaddedTensor.h>
+#include <math/include/TensorBatch.h>
+#include <math/include/TensorConcatenation.h>
 #include <math/include/TensorOperations.h>
+#include <math/include/TensorReductions.h>
+#include <math/include/TensorResize.h>
+#include <math/include/Transformations.h>
 #include <testing/include/testing.h>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
 void TestTensorIndexer()
@@ -48,4 +90,679 @@ void TestTensorIndexer()
     testing::ProcessTest("Tensor::operator()", T == R1 && S == R2);
 }
 
-#pragma endregion implementation 
\ No newline at end of file
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorScaleAddActivationUpdate()
+{
+    auto T = math::Tensor<ElementType, dimension0, dimension1, dimension2>{
+        { { 1, -2, 3, -4 }, { -1, 2, -3, 4 }, { 1, 2, 3, 4 } },
+        { { -1, -2, -3, -4 }, { 1, 2, 3, 4 }, { 5, -6, 7, -8 } }
+    };
+    auto S = T.GetSubTensor({ 0, 1, 1 }, { 2, 2, 3 });
+    math::Vector<ElementType, math::VectorOrientation::column> channelScale{ 2, -1, 3 };
+    math::Vector<ElementType, math::VectorOrientation::column> channelBias{ 1, 0, -2 };
+    math::Vector<ElementType, math::VectorOrientation::column> rowScale{ 1, 2 };
+    math::Vector<ElementType, math::VectorOrientation::column> rowBias{ -1, 1 };
+
+    auto channelExpected = T;
+    auto rowExpected = T;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 2; ++j)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                auto x = S(i, j, k);
+                channelExpected(i, j + 1, k + 1) = std::max<ElementType>(channelScale[k] * x + channelBias[k], 0);
+                rowExpected(i, j + 1, k + 1) = std::max<ElementType>(rowScale[i] * x + rowBias[i], 0);
+            }
+        }
+    }
+
+    auto channelResult = T;
+    math::ScaleAddUpdate<math::Dimension::channel>(channelScale, channelBias, channelResult.GetSubTensor({ 0, 1, 1 }, { 2, 2, 3 }), math::RectifiedLinearTransformation<ElementType>);
+    auto rowResult = T;
+    math::ScaleAddUpdate<math::Dimension::row>(rowScale, rowBias, rowResult.GetSubTensor({ 0, 1, 1 }, { 2, 2, 3 }), math::RectifiedLinearTransformation<ElementType>);
+
+    testing::ProcessTest("TensorOperations::ScaleAddUpdate with activation", channelResult == channelExpected && rowResult == rowExpected);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBatchOperations()
+{
+    const size_t batchSize = 5;
+    const math::TensorShape shape{ 2, 3, 4 };
+    math::Vector<ElementType, math::VectorOrientation::column> channelScale{ 2, -1, 3, 1 };
+    math::Vector<ElementType, math::VectorOrientation::column> channelBias{ 1, 0, -2, 4 };
+    math::Vector<ElementType, math::VectorOrientation::column> rowScale{ 3, -2 };
+    math::Vector<ElementType, math::VectorOrientation::column> columnBias{ -1, 1, 2 };
+
+    // the batch is strided: one padding tensor sits between consecutive tensors
+    std::vector<ElementType> data(2 * batchSize * shape.Size(), 100);
+    math::TensorBatchReference<ElementType, dimension0, dimension1, dimension2> batch(data.data(), batchSize, shape, 2 * shape.Size());
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        for (size_t i = 0; i < 2; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    batch(index, i, j, k) = static_cast<ElementType>(static_cast<int>((index * 7 + i * 5 + j * 3 + k) % 9) - 4);
+                }
+            }
+        }
+    }
+
+    math::TensorBatch<ElementType, dimension0, dimension1, dimension2> expected(batchSize, shape);
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        for (size_t i = 0; i < 2; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    auto x = std::max<ElementType>(channelScale[k] * batch(index, i, j, k) + channelBias[k], 0);
+                    if (index >= 1 && index < 4)
+                    {
+                        x = rowScale[i] * x + columnBias[j];
+                    }
+                    expected(index, i, j, k) = 2 * x + 1;
+                }
+            }
+        }
+    }
+
+    math::ScaleAddUpdate<math::Dimension::channel>(channelScale, channelBias, batch, math::RectifiedLinearTransformation<ElementType>);
+    auto subBatch = batch.GetSubBatch(1, 3);
+    math::ScaleUpdate<math::Dimension::row>(rowScale, subBatch);
+    math::AddUpdate<math::Dimension::column>(columnBias, subBatch);
+    math::ScaleUpdate(static_cast<ElementType>(2), batch);
+    math::AddUpdate(static_cast<ElementType>(1), batch);
+
+    bool isPaddingUnchanged = true;
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        for (size_t offset = shape.Size(); offset < 2 * shape.Size(); ++offset)
+        {
+            isPaddingUnchanged = isPaddingUnchanged && data[2 * index * shape.Size() + offset] == 100;
+        }
+    }
+
+    testing::ProcessTest("TensorOperations::batched ScaleUpdate, AddUpdate and ScaleAddUpdate", batch.IsEqual(expected) && isPaddingUnchanged);
+}
+
+template <typename ElementType, math::Dimension sourceDimension0, math::Dimension sourceDimension1, math::Dimension sourceDimension2, math::Dimension targetDimension0, math::Dimension targetDimension1, math::Dimension targetDimension2>
+bool TestTensorCopyFromPermutation(math::TensorShape shape)
+{
+    // copy from a sub-tensor, so that the source is not contiguous, into a tensor and into a sub-tensor
+    math::TensorShape paddedShape{ shape.NumRows() + 2, shape.NumColumns() + 3, shape.NumChannels() + 1 };
+    math::Tensor<ElementType, sourceDimension0, sourceDimension1, sourceDimension2> source(paddedShape);
+    source.Generate([n = 0]() mutable { return static_cast<ElementType>(n++ % 1000); });
+    auto sourceView = source.GetSubTensor({ 1, 2, 1 }, shape);
+
+    math::Tensor<ElementType, targetDimension0, targetDimension1, targetDimension2> target(shape);
+    target.CopyFrom(sourceView);
+    math::Tensor<ElementType, targetDimension0, targetDimension1, targetDimension2> paddedTarget(paddedShape);
+    auto targetView = paddedTarget.GetSubTensor({ 2, 1, 0 }, shape);
+    targetView.CopyFrom(sourceView);
+
+    bool isEqual = true;
+    for (size_t i = 0; i < shape.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < shape.NumColumns(); ++j)
+        {
+            for (size_t k = 0; k < shape.NumChannels(); ++k)
+            {
+                isEqual = isEqual && target(i, j, k) == sourceView(i, j, k) && targetView(i, j, k) == sourceView(i, j, k);
+            }
+        }
+    }
+    return isEqual && paddedTarget(0, 0, 0) == 0 && paddedTarget(paddedShape.NumRows() - 1, paddedShape.NumColumns() - 1, paddedShape.NumChannels() - 1) == 0;
+}
+
+template <typename ElementType, math::Dimension sourceDimension0, math::Dimension sourceDimension1, math::Dimension sourceDimension2>
+bool TestTensorCopyFromPermutations(math::TensorShape shape)
+{
+    using math::Dimension;
+    return TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::row, Dimension::column, Dimension::channel>(shape) &&
+           TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::row, Dimension::channel, Dimension::column>(shape) &&
+           TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::column, Dimension::row, Dimension::channel>(shape) &&
+           TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::column, Dimension::channel, Dimension::row>(shape) &&
+           TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::channel, Dimension::row, Dimension::column>(shape) &&
+           TestTensorCopyFromPermutation<ElementType, sourceDimension0, sourceDimension1, sourceDimension2, Dimension::channel, Dimension::column, Dimension::row>(shape);
+}
+
+template <typename ElementType>
+void TestTensorCopyFromPermutations()
+{
+    using math::Dimension;
+    bool success = true;
+
+    // a small shape, and one with full tiles, ragged tiles and enough work for several threads
+    for (auto shape : { math::TensorShape{ 3, 5, 2 }, math::TensorShape{ 70, 37, 19 } })
+    {
+        success = success &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::row, Dimension::column, Dimension::channel>(shape) &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::row, Dimension::channel, Dimension::column>(shape) &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::column, Dimension::row, Dimension::channel>(shape) &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::column, Dimension::channel, Dimension::row>(shape) &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::channel, Dimension::row, Dimension::column>(shape) &&
+                  TestTensorCopyFromPermutations<ElementType, Dimension::channel, Dimension::column, Dimension::row>(shape);
+    }
+
+    testing::ProcessTest("Tensor::CopyFrom for all 36 layout pairs", success);
+}
+
+template <typename ElementType>
+void TestTensorConversions()
+{
+    using math::Dimension;
+
+    // an 8-bit image with interleaved channels becomes a normalized, channel-major tensor, in both the
+    // streaming and the transposing paths of the copy
+    bool success = true;
+    for (auto shape : { math::TensorShape{ 3, 5, 3 }, math::TensorShape{ 45, 70, 3 } })
+    {
+        math::Tensor<uint8_t, Dimension::channel, Dimension::column, Dimension::row> image(shape);
+        for (size_t i = 0; i < shape.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < shape.NumColumns(); ++j)
+            {
+                for (size_t k = 0; k < shape.NumChannels(); ++k)
+                {
+                    image(i, j, k) = static_cast<uint8_t>((i * 7 + j * 3 + k * 101) % 256);
+                }
+            }
+        }
+
+        math::Tensor<ElementType, Dimension::column, Dimension::row, Dimension::channel> planar(shape);
+        math::Tensor<ElementType, Dimension::channel, Dimension::column, Dimension::row> interleaved(shape);
+        planar.CopyFrom(image, { 1.0 / 255 });
+        interleaved.CopyFrom(image, { 1.0 / 255 });
+
+        math::Tensor<uint8_t, Dimension::column, Dimension::row, Dimension::channel> roundTrip(shape);
+        roundTrip.CopyFrom(planar, { 255, true });
+
+        for (size_t i = 0; i < shape.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < shape.NumColumns(); ++j)
+            {
+                for (size_t k = 0; k < shape.NumChannels(); ++k)
+                {
+                    double expected = image(i, j, k) / 255.0;
+                    success = success && std::abs(planar(i, j, k) - expected) < 1.0e-6 && std::abs(interleaved(i, j, k) - expected) < 1.0e-6 && roundTrip(i, j, k) == image(i, j, k);
+                }
+            }
+        }
+    }
+
+    testing::ProcessTest("Tensor::CopyFrom with element conversion", success);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBroadcast()
+{
+    using math::BroadcastOperation;
+    const size_t numRows = 4;
+    const size_t numColumns = 5;
+    const size_t numChannels = 3;
+    math::ChannelColumnRowTensor<ElementType> T(numRows, numColumns, numChannels);
+    T.Generate([n = 0]() mutable { return static_cast<ElementType>(n++ % 7 + 1); });
+    math::ColumnRowChannelTensor<ElementType> perColumn(1, numColumns, 1);
+    perColumn.Generate([n = 0]() mutable { return static_cast<ElementType>(n++ + 2); });
+    math::ColumnMatrix<ElementType> M(numColumns, numChannels);
+    M.Generate([n = 0]() mutable { return static_cast<ElementType>(n++ % 4); });
+    math::RowVector<ElementType> channelVector{ 1, 4, 2 };
+    math::ColumnVector<ElementType> columnVector{ 5, 3, 8, 1, 2 };
+
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> sum(numRows, numColumns, numChannels);
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> quotient(numRows, numColumns, numChannels);
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> difference(numRows, numColumns, numChannels);
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> maximum(numRows, numColumns, numChannels);
+    math::Broadcast<BroadcastOperation::add>(T, perColumn, sum);
+    math::Broadcast<BroadcastOperation::divide>(T, M, quotient);
+    math::Broadcast<BroadcastOperation::subtract>(channelVector, T, difference);
+    math::Broadcast<BroadcastOperation::maximum>(T, columnVector, maximum);
+
+    // in place, on a sub-tensor
+    auto product = T;
+    math::Broadcast<BroadcastOperation::multiply>(product.GetSubTensor({ 1, 0, 1 }, { 3, 5, 2 }), channelVector.GetSubVector(1, 2), product.GetSubTensor({ 1, 0, 1 }, { 3, 5, 2 }));
+
+    bool success = true;
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                auto x = T(i, j, k);
+                success = success && sum(i, j, k) == x + perColumn(0, j, 0);
+                success = success && quotient(i, j, k) == x / M(j, k);
+                success = success && difference(i, j, k) == channelVector[k] - x;
+                success = success && maximum(i, j, k) == std::max(x, columnVector[j]);
+                success = success && product(i, j, k) == (i >= 1 && k >= 1 ? x * channelVector[k] : x);
+            }
+        }
+    }
+
+    bool threwOnMismatch = false;
+    try
+    {
+        math::Broadcast<BroadcastOperation::add>(T, math::ColumnVector<ElementType>(numRows), sum);
+    }
+    catch (const utilities::InputException&)
+    {
+        threwOnMismatch = true;
+    }
+
+    testing::ProcessTest("TensorOperations::Broadcast", success && threwOnMismatch);
+}
+
+// checks Reduce and ArgMax along one dimension against a direct computation
+template <math::Dimension dimension, typename TensorType>
+bool TestTensorReduction(TensorType tensor)
+{
+    using math::TensorReduction;
+    const size_t sizes[] = { tensor.NumRows(), tensor.NumColumns(), tensor.NumChannels() };
+    const size_t reduced = static_cast<size_t>(dimension);
+    const size_t first = reduced == 0 ? 1 : 0;
+    const size_t second = reduced == 2 ? 1 : 2;
+    using ElementType = typename std::remove_reference<decltype(tensor(0, 0, 0))>::type;
+
+    math::RowMatrix<ElementType> sum(sizes[first], sizes[second]);
+    math::ColumnMatrix<ElementType> mean(sizes[first], sizes[second]);
+    math::RowMatrix<ElementType> maximum(sizes[first], sizes[second]);
+    math::ColumnMatrix<ElementType> minimum(sizes[first], sizes[second]);
+    math::RowMatrix<size_t> argMax(sizes[first], sizes[second]);
+    math::Reduce<TensorReduction::sum, dimension>(tensor, sum);
+    math::Reduce<TensorReduction::mean, dimension>(tensor, mean);
+    math::Reduce<TensorReduction::maximum, dimension>(tensor, maximum);
+    math::Reduce<TensorReduction::minimum, dimension>(tensor, minimum);
+    math::ArgMax<dimension>(tensor, argMax);
+
+    bool success = true;
+    for (size_t i = 0; i < sizes[first]; ++i)
+    {
+        for (size_t j = 0; j < sizes[second]; ++j)
+        {
+            ElementType expectedSum = 0;
+            ElementType expectedMaximum = std::numeric_limits<ElementType>::lowest();
+            ElementType expectedMinimum = std::numeric_limits<ElementType>::max();
+            size_t expectedArgMax = 0;
+            for (size_t r = 0; r < sizes[reduced]; ++r)
+            {
+                size_t coordinates[3];
+                coordinates[first] = i;
+                coordinates[second] = j;
+                coordinates[reduced] = r;
+                auto x = tensor(coordinates[0], coordinates[1], coordinates[2]);
+                expectedSum += x;
+                if (x > expectedMaximum)
+                {
+                    expectedMaximum = x;
+                    expectedArgMax = r;
+                }
+                expectedMinimum = std::min(expectedMinimum, x);
+            }
+            success = success && sum(i, j) == expectedSum && maximum(i, j) == expectedMaximum && minimum(i, j) == expectedMinimum && argMax(i, j) == expectedArgMax;
+            success = success && std::abs(mean(i, j) - expectedSum / static_cast<ElementType>(sizes[reduced])) < 1e-5;
+        }
+    }
+    return success;
+}
+
+// checks Reduce and ArgMax along two dimensions against a direct computation
+template <math::Dimension dimensionA, math::Dimension dimensionB, typename TensorType>
+bool TestTensorReduction(TensorType tensor)
+{
+    using math::TensorReduction;
+    const size_t sizes[] = { tensor.NumRows(), tensor.NumColumns(), tensor.NumChannels() };
+    const size_t a = static_cast<size_t>(dimensionA);
+    const size_t b = static_cast<size_t>(dimensionB);
+    const size_t kept = 3 - a - b;
+    using ElementType = typename std::remove_reference<decltype(tensor(0, 0, 0))>::type;
+
+    math::ColumnVector<ElementType> sum(sizes[kept]);
+    math::RowVector<ElementType> maximum(sizes[kept]);
+    math::ColumnVector<size_t> argMax(sizes[kept]);
+    math::Reduce<TensorReduction::sum, dimensionA, dimensionB>(tensor, sum);
+    math::Reduce<TensorReduction::maximum, dimensionA, dimensionB>(tensor, maximum);
+    math::ArgMax<dimensionA, dimensionB>(tensor, argMax);
+
+    bool success = true;
+    for (size_t k = 0; k < sizes[kept]; ++k)
+    {
+        ElementType expectedSum = 0;
+        ElementType expectedMaximum = std::numeric_limits<ElementType>::lowest();
+        size_t expectedArgMax = 0;
+        for (size_t i = 0; i < sizes[a]; ++i)
+        {
+            for (size_t j = 0; j < sizes[b]; ++j)
+            {
+                size_t coordinates[3];
+                coordinates[a] = i;
+                coordinates[b] = j;
+                coordinates[kept] = k;
+                auto x = tensor(coordinates[0], coordinates[1], coordinates[2]);
+                expectedSum += x;
+                if (x > expectedMaximum)
+                {
+                    expectedMaximum = x;
+                    expectedArgMax = i * sizes[b] + j;
+                }
+            }
+        }
+        success = success && sum[k] == expectedSum && maximum[k] == expectedMaximum && argMax[k] == expectedArgMax;
+    }
+    return success;
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorReductions()
+{
+    using math::Dimension;
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> T(9, 70, 300);
+    T.Generate([n = 0]() mutable { return static_cast<ElementType>(((n++ * 7919) % 1013) / 8); });
+    auto S = T.GetSubTensor({ 1, 3, 5 }, { 7, 60, 290 });
+
+    bool success = true;
+    for (auto tensor : { T.GetConstReference(), S.GetConstReference() })
+    {
+        success = success &&
+                  TestTensorReduction<Dimension::row>(tensor) &&
+                  TestTensorReduction<Dimension::column>(tensor) &&
+                  TestTensorReduction<Dimension::channel>(tensor) &&
+                  TestTensorReduction<Dimension::row, Dimension::column>(tensor) &&
+                  TestTensorReduction<Dimension::column, Dimension::row>(tensor) &&
+                  TestTensorReduction<Dimension::row, Dimension::channel>(tensor) &&
+                  TestTensorReduction<Dimension::channel, Dimension::column>(tensor);
+    }
+
+    testing::ProcessTest("TensorReductions::Reduce and ArgMax", success);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorBatchNormalization()
+{
+    const size_t numRows = 13;
+    const size_t numColumns = 11;
+    const size_t numChannels = 5;
+    // the channel means are large, so in float they are rounded by about 1e-5, which the scale amplifies
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-3 : 1.0e-10;
+    auto isClose = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::Tensor<ElementType, dimension0, dimension1, dimension2> T(numRows, numColumns, numChannels);
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        for (size_t j = 0; j < numColumns; ++j)
+        {
+            for (size_t k = 0; k < numChannels; ++k)
+            {
+                T(i, j, k) = static_cast<ElementType>(100 * k + std::cos(0.3 * i + 0.7 * j + k));
+            }
+        }
+    }
+
+    math::RowVector<ElementType> mean(numChannels);
+    math::RowVector<ElementType> variance(numChannels);
+    math::ChannelwiseMeanAndVariance(T, mean, variance);
+
+    math::RowVector<ElementType> scale{ 1, 2, 0.5, -1, 3 };
+    math::RowVector<ElementType> bias{ 0, 1, -1, 2, 0.25 };
+    auto normalized = T;
+    ElementType epsilon = static_cast<ElementType>(1.0e-3);
+    math::BatchNormalizationUpdate(normalized, mean, variance, scale, bias, epsilon);
+
+    bool statisticsOk = true;
+    bool normalizedOk = true;
+    const double count = static_cast<double>(numRows * numColumns);
+    for (size_t k = 0; k < numChannels; ++k)
+    {
+        double sum = 0;
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                sum += T(i, j, k);
+            }
+        }
+        double expectedMean = sum / count;
+        double expectedVariance = 0;
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                expectedVariance += (T(i, j, k) - expectedMean) * (T(i, j, k) - expectedMean);
+            }
+        }
+        expectedVariance /= count;
+        statisticsOk = statisticsOk && isClose(mean[k], expectedMean) && isClose(variance[k], expectedVariance);
+
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            for (size_t j = 0; j < numColumns; ++j)
+            {
+                double expected = (T(i, j, k) - expectedMean) / std::sqrt(expectedVariance + epsilon) * scale[k] + bias[k];
+                normalizedOk = normalizedOk && isClose(normalized(i, j, k), expected);
+            }
+        }
+    }
+
+    testing::ProcessTest("Normalization::ChannelwiseMeanAndVariance", statisticsOk);
+    testing::ProcessTest("Normalization::BatchNormalizationUpdate", normalizedOk);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorResize()
+{
+    using TensorType = math::Tensor<ElementType, dimension0, dimension1, dimension2>;
+    const ElementType tolerance = static_cast<ElementType>(std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-10);
+    auto value = [](size_t i, size_t j, size_t k) { return static_cast<ElementType>(std::sin(0.3 * i + 0.7 * j) + 0.5 * k); };
+
+    // the reference samples each output pixel separately, in double
+    auto sample = [](double position, size_t size, bool nearest, size_t& first, size_t& second) {
+        if (nearest)
+        {
+            first = second = std::min(static_cast<size_t>(position + 0.5), size - 1);
+            return 0.0;
+        }
+        position = std::max(0.0, position);
+        first = std::min(static_cast<size_t>(std::floor(position)), size - 1);
+        second = std::min(first + 1, size - 1);
+        return first == second ? 0.0 : position - first;
+    };
+    auto check = [&](auto input, auto& output, bool nearest) {
+        bool ok = true;
+        double rowScale = static_cast<double>(input.NumRows()) / output.NumRows();
+        double columnScale = static_cast<double>(input.NumColumns()) / output.NumColumns();
+        for (size_t i = 0; i < output.NumRows(); ++i)
+        {
+            size_t i0, i1, j0, j1;
+            double wi = sample((i + 0.5) * rowScale - 0.5, input.NumRows(), nearest, i0, i1);
+            for (size_t j = 0; j < output.NumColumns(); ++j)
+            {
+                double wj = sample((j + 0.5) * columnScale - 0.5, input.NumColumns(), nearest, j0, j1);
+                for (size_t k = 0; k < output.NumChannels(); ++k)
+                {
+                    double top = input(i0, j0, k) + wj * (input(i0, j1, k) - input(i0, j0, k));
+                    double bottom = input(i1, j0, k) + wj * (input(i1, j1, k) - input(i1, j0, k));
+                    double expected = top + wi * (bottom - top);
+                    ok = ok && std::abs(output(i, j, k) - expected) <= tolerance;
+                }
+            }
+        }
+        return ok;
+    };
+
+    TensorType image(17, 23, 3);
+    for (size_t i = 0; i < image.NumRows(); ++i)
+    {
+        for (size_t j = 0; j < image.NumColumns(); ++j)
+        {
+            for (size_t k = 0; k < image.NumChannels(); ++k)
+            {
+                image(i, j, k) = value(i, j, k);
+            }
+        }
+    }
+
+    // enlarging, shrinking, and the same size, which reproduces the input
+    bool resized = true;
+    for (auto shape : { math::TensorShape{ 40, 31, 3 }, math::TensorShape{ 6, 9, 3 }, math::TensorShape{ 17, 23, 3 } })
+    {
+        TensorType bilinear(shape);
+        TensorType nearest(shape);
+        math::Resize(image, bilinear);
+        math::Resize<math::ResizeInterpolation::nearest>(image, nearest);
+        resized = resized && check(image.GetConstReference(), bilinear, false) && check(image.GetConstReference(), nearest, true);
+    }
+    TensorType same(17, 23, 3);
+    math::Resize(image, same);
+    resized = resized && same.IsEqual(image, tolerance);
+
+    // a center crop of the input, resized into the middle of a larger output
+    auto crop = math::CenterCrop(image.GetConstReference(), 10, 12);
+    bool cropped = crop.NumRows() == 10 && crop.NumColumns() == 12 && crop.NumChannels() == 3 && crop(0, 0, 1) == image(3, 5, 1) && crop(9, 11, 2) == image(12, 16, 2);
+    auto corner = math::Crop(image.GetReference(), 2, 4, 5, 6);
+    cropped = cropped && corner(4, 5, 0) == image(6, 9, 0);
+    TensorType canvas(30, 30, 3);
+    auto window = canvas.GetSubTensor({ 5, 5, 0 }, { 20, 20, 3 });
+    math::Resize(crop, window);
+    resized = resized && check(crop, window, false) && canvas(4, 10, 0) == 0 && canvas(25, 10, 0) == 0;
+
+    bool throws = false;
+    try
+    {
+        TensorType wrongChannels(8, 8, 2);
+        math::Resize(image, wrongChannels);
+    }
+    catch (const utilities::InputException&)
+    {
+        try
+        {
+            math::CenterCrop(image.GetConstReference(), 18, 4);
+        }
+        catch (const utilities::InputException&)
+        {
+            throws = true;
+        }
+    }
+
+    testing::ProcessTest("Tensor resize and crop", resized && cropped && throws);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestTensorConcatenation()
+{
+    using TensorType = math::Tensor<ElementType, dimension0, dimension1, dimension2>;
+    auto value = [](size_t part, size_t i, size_t j, size_t k) { return static_cast<ElementType>(1000 * part + 100 * i + 10 * j + k); };
+
+    // three producers write their outputs into the channels of one tensor, which a consumer splits again
+    math::TensorConcatenationPlan<math::Dimension::channel> plan({ { 4, 5, 2 }, { 4, 5, 3 } });
+    plan.AddPart({ 4, 5, 1 });
+    TensorType output(plan.GetOutputShape());
+    for (size_t part = 0; part < plan.NumParts(); ++part)
+    {
+        auto target = plan.GetPart(output.GetReference(), part);
+        for (size_t i = 0; i < target.NumRows(); ++i)
+        {
+            for (size_t j = 0; j < target.NumColumns(); ++j)
+            {
+                for (size_t k = 0; k < target.NumChannels(); ++k)
+                {
+                    target(i, j, k) = value(part, i, j, k);
+                }
+            }
+        }
+    }
+    bool concatenated = output.GetShape() == math::TensorShape(4, 5, 6) && plan.GetPartOffset(2) == 5 && output(3, 4, 1) == value(0, 3, 4, 1) && output(3, 4, 2) == value(1, 3, 4, 0) && output(0, 1, 5) == value(2, 0, 1, 0);
+
+    auto parts = plan.GetParts(output.GetConstReference());
+    bool split = parts.size() == 3 && parts[1].GetShape() == math::TensorShape(4, 5, 3) && parts[1](2, 3, 2) == value(1, 2, 3, 2) && parts[2].GetConstDataPointer() == &output(0, 0, 5);
+
+    // a concatenation along the rows, nested in the columns of a larger tensor
+    math::TensorConcatenationPlan<math::Dimension::row> rowPlan({ { 2, 3, 6 }, { 5, 3, 6 } });
+    TensorType larger(7, 8, 6);
+    auto window = larger.GetSubTensor({ 0, 5, 0 }, rowPlan.GetOutputShape());
+    rowPlan.GetPart(window, 1).Fill(1);
+    bool nested = larger(1, 5, 0) == 0 && larger(2, 5, 0) == 1 && larger(6, 7, 5) == 1 && larger(6, 4, 5) == 0;
+
+    bool throws = false;
+    try
+    {
+        plan.AddPart({ 4, 6, 1 });
+    }
+    catch (const utilities::InputException&)
+    {
+        try
+        {
+            TensorType wrongShape(4, 5, 5);
+            plan.GetPart(wrongShape.GetReference(), 0);
+        }
+        catch (const utilities::InputException&)
+        {
+            throws = true;
+        }
+    }
+
+    testing::ProcessTest("TensorConcatenationPlan", concatenated && split && nested && throws);
+}
+
+template <typename ElementType, math::Dimension dimension0, math::Dimension dimension1, math::Dimension dimension2>
+void TestPaddedTensor()
+{
+    using TensorType = math::Tensor<ElementType, dimension0, dimension1, dimension2>;
+    TensorType image(6, 7, 2);
+    image.Generate([n = 0]() mutable { return static_cast<ElementType>(1 + n++ % 11); });
+    math::ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2> padded(image, { 2, 1, 1, 3 });
+
+    TensorType materialized(padded.GetShape());
+    materialized.Fill(-1);
+    padded.CopyTo(materialized.GetReference());
+    bool copied = materialized.NumRows() == 9 && materialized.NumColumns() == 11 && materialized(0, 0, 0) == 0 && materialized(8, 10, 1) == 0 && materialized(2, 1, 1) == image(0, 0, 1) && materialized(7, 7, 0) == image(5, 6, 0) && materialized(7, 8, 0) == 0;
+
+    // a 3 x 3 box filter with stride 2, reading the view element by element and through the clipped windows
+    bool filtered = true;
+    for (size_t i = 0; i + 3 <= padded.NumRows(); i += 2)
+    {
+        for (size_t j = 0; j + 3 <= padded.NumColumns(); j += 2)
+        {
+            for (size_t k = 0; k < padded.NumChannels(); ++k)
+            {
+                ElementType viewSum = 0;
+                ElementType materializedSum = 0;
+                for (size_t di = 0; di < 3; ++di)
+                {
+                    for (size_t dj = 0; dj < 3; ++dj)
+                    {
+                        viewSum += padded(i + di, j + dj, k);
+                        materializedSum += materialized(i + di, j + dj, k);
+                    }
+                }
+
+                ElementType clippedSum = 0;
+                auto rows = padded.ClipRows(i, 3);
+                auto columns = padded.ClipColumns(j, 3);
+                auto interior = padded.GetInterior();
+                for (size_t r = rows.first; r < rows.second; ++r)
+                {
+                    for (size_t c = columns.first; c < columns.second; ++c)
+                    {
+                        clippedSum += interior(r - 2, c - 1, k);
+                    }
+                }
+                filtered = filtered && viewSum == materializedSum && clippedSum == materializedSum;
+            }
+        }
+    }
+    auto allPadding = padded.ClipColumns(9, 2);
+    filtered = filtered && allPadding.first == allPadding.second && padded.IsPadding(1, 4) && !padded.IsPadding(2, 1);
+
+    math::ConstPaddedTensorReference<ElementType, dimension0, dimension1, dimension2> symmetric(image, 1, 2);
+    bool shaped = symmetric.GetShape() == math::TensorShape(8, 11, 2) && symmetric(1, 2, 0) == image(0, 0, 0);
+
+    testing::ProcessTest("ConstPaddedTensorReference", copied && filtered && shaped);
+}
+
+#pragma endregion implementation
@@ -40,12 +40,48 @@ void TestVectorNorm2Squared();
 template <typename ElementType>
 void TestVectorToArray();
 
+template <typename ElementType>
+void TestVectorTransformKernels();
+
+template <typename ElementType>
+void TestVectorTransformKernelAccuracy();
+
+template <typename ElementType>
+void TestVectorSoftmax();
+
+template <typename ElementType>
+void TestVectorConversions();
+
+template <typename ElementType>
+void TestVectorRandomFill();
+
+template <typename ElementType>
+void TestVectorFFT();
+
+template <typename ElementType>
+void TestVectorConvolution();
+
+template <typename ElementType>
+void TestKrylovSolvers();
+
 
 
 #pragma region implementation
+#include <math/include/Convolution.h>
+#include <math/include/ElementConversion.h>
+#include <math/include/FFT.h>
+#include <math/include/KrylovSolvers.h>
+#include <math/include/RandomFill.h>
+#include <math/include/Softmax.h>
+#include <math/include/TransformationKernels.h>
 #include <math/include/VectorOperations.h>
 #include <testing/include/testing.h>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 template <typename ElementType>
 void TestVectorIndexer()
@@ -158,4 +194,577 @@ void TestVectorToArray()
                             && r == r0 && s == r1 && t == r0 && u == r1);
 }
 
+template <typename ElementType>
+void TestVectorTransformKernels()
+{
+    const size_t size = 1000;
+    math::RowVector<ElementType> x(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        x[i] = static_cast<ElementType>(-10.0 + 20.0 * i / (size - 1));
+    }
+
+    // the bulk kernels stay within a few ULP of the standard library
+    const double tolerance = std::is_same<ElementType, float>::value ? 2.0e-6 : 1.0e-14;
+    auto isClose = [tolerance](ElementType a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::RowVector<ElementType> y(size);
+    bool ok = true;
+    math::TransformSet(math::VectorizedExponentTransformation<ElementType>, x, y);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ok = ok && isClose(y[i], std::exp(static_cast<double>(x[i])));
+    }
+    math::TransformSet(math::VectorizedHyperbolicTangentTransformation<ElementType>, x, y);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ok = ok && isClose(y[i], std::tanh(static_cast<double>(x[i])));
+    }
+    math::TransformSet(math::VectorizedSigmoidTransformation<ElementType>, x, y);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ok = ok && isClose(y[i], 1.0 / (1.0 + std::exp(-static_cast<double>(x[i]))));
+    }
+    math::TransformSet(math::VectorizedErrorFunctionTransformation<ElementType>, x, y);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ok = ok && isClose(y[i], std::erf(static_cast<double>(x[i])));
+    }
+    math::TransformSet(math::VectorizedNaturalLogTransformation<ElementType>, x, y);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ok = ok && (x[i] < 0 ? std::isnan(y[i]) : isClose(y[i], std::log(static_cast<double>(x[i]))));
+    }
+    testing::ProcessTest("Vector::TransformSet with bulk kernels", ok);
+
+    // the contiguous and the strided path compute the same values as the scalar kernel
+    std::vector<ElementType> values{ -3, -1, 0, 1, 3, 5 };
+    math::RowVector<ElementType> z(values);
+    math::RowVector<ElementType> w(values);
+    math::VectorReference<ElementType, math::VectorOrientation::row> strided(w.GetDataPointer(), 3, 2);
+    math::TransformUpdate(math::VectorizedHyperbolicTangentTransformation<ElementType>, z);
+    math::TransformUpdate(math::VectorizedHyperbolicTangentTransformation<ElementType>, strided);
+    bool sameValues = true;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        auto expected = math::VectorizedHyperbolicTangent(values[i]);
+        sameValues = sameValues && z[i] == expected && w[i] == (i % 2 == 0 ? expected : values[i]);
+    }
+    math::TransformUpdate(math::RectifiedLinearTransformation<ElementType>, w);
+    testing::ProcessTest("Vector::TransformUpdate with bulk kernels", sameValues && w[1] == 0 && w[5] == 5);
+}
+
+template <typename ElementType>
+void TestVectorTransformKernelAccuracy()
+{
+    // the largest error of a bulk kernel in ULP of the result, against the long double standard library, on an even sample of [low, high]
+    const size_t size = 100000;
+    auto maxUlpError = [size](math::BulkTransformation<ElementType> kernel, long double (*reference)(long double), double low, double high) {
+        std::vector<ElementType> x(size);
+        std::vector<ElementType> y(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            x[i] = static_cast<ElementType>(low + (high - low) * i / (size - 1));
+        }
+        kernel(x.data(), y.data(), size);
+
+        double maxError = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            long double exact = reference(x[i]);
+            ElementType magnitude = std::abs(static_cast<ElementType>(exact));
+            ElementType ulp = magnitude < std::numeric_limits<ElementType>::min() ? std::numeric_limits<ElementType>::denorm_min() : std::nextafter(magnitude, std::numeric_limits<ElementType>::infinity()) - magnitude;
+            maxError = std::max(maxError, static_cast<double>(std::abs(y[i] - exact) / ulp));
+        }
+        return maxError;
+    };
+    auto exactExp = [](long double x) { return std::exp(x); };
+    auto exactLog = [](long double x) { return std::log(x); };
+    auto exactTanh = [](long double x) { return std::tanh(x); };
+    auto exactSigmoid = [](long double x) { return 1 / (1 + std::exp(-x)); };
+    auto exactErf = [](long double x) { return std::erf(x); };
+
+    // the bounds in the table of TransformationKernels.h, over the finite range of each result, subnormal results included
+    const bool isFloat = std::is_same<ElementType, float>::value;
+    const double maxExponent = isFloat ? 88 : 709;
+    const double minExponent = isFloat ? -103 : -745;
+    const double maxLog = isFloat ? 1e38 : 1e308;
+    bool expOk = maxUlpError(math::VectorizedExponent, exactExp, minExponent, maxExponent) <= 1 && maxUlpError(math::VectorizedExponent, exactExp, -1, 1) <= 1;
+    bool logOk = maxUlpError(math::VectorizedNaturalLog, exactLog, 1e-6, 4) <= 1 && maxUlpError(math::VectorizedNaturalLog, exactLog, 1, maxLog) <= 1;
+    bool tanhOk = maxUlpError(math::VectorizedHyperbolicTangent, exactTanh, -20, 20) <= 1.5 && maxUlpError(math::VectorizedHyperbolicTangent, exactTanh, -0.01, 0.01) <= 1.5;
+    bool sigmoidOk = maxUlpError(math::VectorizedSigmoid, exactSigmoid, -maxExponent, maxExponent) <= 3 && maxUlpError(math::VectorizedSigmoid, exactSigmoid, -10, 10) <= 3;
+    const double maxErfError = isFloat ? 8 : 2;
+    bool erfOk = maxUlpError(math::VectorizedErrorFunction, exactErf, -7, 7) <= maxErfError && maxUlpError(math::VectorizedErrorFunction, exactErf, -0.01, 0.01) <= maxErfError;
+    testing::ProcessTest("Vector::TransformSet bulk kernel ULP error", expOk && logOk && tanhOk && sigmoidOk && erfOk);
+}
+
+template <typename ElementType>
+void TestVectorSoftmax()
+{
+    const ElementType negativeInfinity = -std::numeric_limits<ElementType>::infinity();
+    // the log-sum-exp is near 1000, so in float its rounding error is about 1e-4
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-12;
+    auto isClose = [tolerance](double a, double b) { return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b)); };
+
+    math::RowVector<ElementType> x{ 1000, negativeInfinity, 1000, 999 };
+    double logSumExp = 1000 + std::log(2 + std::exp(-1.0));
+    bool logSumExpOk = isClose(math::LogSumExp(x), logSumExp) && math::LogSumExp(x.GetSubVector(1, 1)) == negativeInfinity;
+
+    // every other element of y is a copy of x
+    math::RowVector<ElementType> y{ 1000, 0, negativeInfinity, 0, 1000, 0, 999, 0 };
+    math::VectorReference<ElementType, math::VectorOrientation::row> strided(y.GetDataPointer(), 4, 2);
+    math::RowVector<ElementType> z(x);
+    math::SoftmaxUpdate(strided);
+    math::LogSoftmaxUpdate(z);
+    bool softmaxOk = true;
+    for (size_t i = 0; i < x.Size(); ++i)
+    {
+        softmaxOk = softmaxOk && isClose(strided[i], std::exp(x[i] - logSumExp)) && y[2 * i + 1] == 0;
+        softmaxOk = softmaxOk && (i == 1 ? z[i] == negativeInfinity : isClose(z[i], x[i] - logSumExp));
+    }
+
+    testing::ProcessTest("Vector::LogSumExp", logSumExpOk);
+    testing::ProcessTest("Vector::SoftmaxUpdate", softmaxOk);
+}
+
+template <typename ElementType>
+void TestVectorConversions()
+{
+    const ElementType nan = std::numeric_limits<ElementType>::quiet_NaN();
+    const ElementType infinity = std::numeric_limits<ElementType>::infinity();
+
+    // 8-bit pixels to normalized values, into a strided vector
+    math::RowVector<uint8_t> pixels{ 0, 51, 255 };
+    math::RowVector<ElementType> y{ 1, 1, 1, 1, 1, 1 };
+    math::VectorReference<ElementType, math::VectorOrientation::row> strided(y.GetDataPointer(), 3, 2);
+    strided.CopyFrom(pixels, { 1.0 / 255 });
+    bool scaleOk = y[0] == 0 && std::abs(y[2] - 0.2) < 1.0e-6 && std::abs(y[4] - 1) < 1.0e-6 && y[1] == 1 && y[3] == 1 && y[5] == 1;
+
+    // saturation rounds to the nearest integer, clamps, and maps NaN to zero
+    math::RowVector<ElementType> x{ -300, -1.5, 0.4, 2.6, 127.6, 1000, nan, -infinity };
+    math::RowVector<int8_t> bytes(x.Size());
+    bytes.CopyFrom(x, { 1.0, true });
+    math::RowVector<int8_t> expectedBytes{ -128, -2, 0, 3, 127, 127, 0, -128 };
+    bool saturateOk = bytes == expectedBytes;
+
+    // without options, the conversion is a static_cast
+    math::RowVector<int32_t> integers(4);
+    integers.CopyFrom(math::RowVector<ElementType>{ -2.7, -0.5, 0.5, 2.7 });
+    bool plainOk = integers == math::RowVector<int32_t>{ -2, 0, 0, 2 };
+
+    // half precision: exact values, ties to even, a subnormal, overflow and NaN
+    std::vector<ElementType> values = { 1, -2.5, 65504, 1 + std::ldexp(1.0, -11), 1 + 3 * std::ldexp(1.0, -11), 1.0e-7, 1.0e5, -infinity, nan };
+    std::vector<ElementType> expectedHalves = { 1, -2.5, 65504, 1, 1 + std::ldexp(1.0, -9), 2 * std::ldexp(1.0, -24), infinity, -infinity, nan };
+    std::vector<math::Float16> halves(values.size());
+    std::vector<ElementType> roundTrip(values.size());
+    math::ConvertElements(values.data(), 1, halves.data(), 1, values.size());
+    math::ConvertElements(halves.data(), 1, roundTrip.data(), 1, values.size());
+    bool halfOk = true;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        halfOk = halfOk && (std::isnan(expectedHalves[i]) ? std::isnan(roundTrip[i]) : roundTrip[i] == expectedHalves[i]);
+    }
+
+    // bfloat16 keeps the float exponent range, so only the mantissa rounds
+    values = { 1, -2.5, 1 + std::ldexp(1.0, -8), 1 + 3 * std::ldexp(1.0, -8), 3.0e38, nan };
+    std::vector<ElementType> expectedBFloats = { 1, -2.5, 1, 1 + std::ldexp(1.0, -6), 3.0e38, nan };
+    std::vector<math::BFloat16> bfloats(values.size());
+    math::ConvertElements(values.data(), 1, bfloats.data(), 1, values.size());
+    bool bfloatOk = true;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        double value = static_cast<float>(bfloats[i]);
+        bool isExact = i != 4;
+        bfloatOk = bfloatOk && (std::isnan(expectedBFloats[i]) ? std::isnan(value) : (isExact ? value == expectedBFloats[i] : std::abs(value - expectedBFloats[i]) < 1.0e-2 * expectedBFloats[i]));
+    }
+
+    testing::ProcessTest("Vector::CopyFrom with scale", scaleOk);
+    testing::ProcessTest("Vector::CopyFrom with saturation", saturateOk && plainOk);
+    testing::ProcessTest("ConvertElements with Float16", halfOk);
+    testing::ProcessTest("ConvertElements with BFloat16", bfloatOk);
+}
+
+template <typename ElementType>
+void TestVectorRandomFill()
+{
+    // known answers of Philox4x32-10 (Random123)
+    math::Philox4x32 zero(0);
+    math::Philox4x32 ones(0xffffffffffffffffull);
+    bool knownAnswerOk = zero({ 0, 0, 0, 0 }) == math::Philox4x32::Block{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } &&
+                         ones({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }) == math::Philox4x32::Block{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+
+    // large enough to be split across the thread pool, and each element must match a serial computation
+    const uint64_t seed = 0x0123456789abcdefull;
+    const size_t size = 100003;
+    math::RowVector<ElementType> uniform(size);
+    math::FillUniform(uniform, seed, ElementType{ -2 }, ElementType{ 3 });
+    math::Philox4x32 generator(seed);
+    bool uniformOk = true;
+    for (size_t i = 0; i < size; ++i)
+    {
+        ElementType unit;
+        if (sizeof(ElementType) == 4)
+        {
+            auto block = generator({ static_cast<uint32_t>(i / 4), 0, 0, 0 });
+            unit = static_cast<ElementType>(block[i % 4] >> 8) / (1 << 24);
+        }
+        else
+        {
+            auto block = generator({ static_cast<uint32_t>(i / 2), 0, 0, 0 });
+            uint64_t bits = (static_cast<uint64_t>(block[2 * (i % 2)] >> 5) << 26) | (block[2 * (i % 2) + 1] >> 6);
+            unit = static_cast<ElementType>(static_cast<double>(bits) / 9007199254740992.0);
+        }
+        uniformOk = uniformOk && uniform[i] == ElementType{ -2 } + ElementType{ 5 } * unit && uniform[i] >= -2 && uniform[i] < 3;
+    }
+
+    // normal moments
+    math::ColumnVector<ElementType> normal(size);
+    math::FillNormal(normal, seed, ElementType{ 1 }, ElementType{ 2 });
+    double sum = 0;
+    double sumSquares = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        sum += normal[i];
+        sumSquares += normal[i] * normal[i];
+    }
+    double mean = sum / size;
+    double variance = sumSquares / size - mean * mean;
+    bool normalOk = std::abs(mean - 1) < 0.05 && std::abs(variance - 4) < 0.1;
+
+    // strided vectors, padded matrices and tensors are numbered in memory order, so they repeat the contiguous fill
+    math::RowVector<ElementType> padded(2 * 1001);
+    math::VectorReference<ElementType, math::VectorOrientation::row> strided(padded.GetDataPointer() + 1, 1001, 2);
+    math::FillNormal(strided, seed, ElementType{ 1 }, ElementType{ 2 });
+    math::ColumnMatrix<ElementType> matrix(7, 301);
+    auto subMatrix = matrix.GetSubMatrix(1, 0, 5, 301);
+    math::FillNormal(subMatrix, seed, ElementType{ 1 }, ElementType{ 2 });
+    math::ChannelColumnRowTensor<ElementType> tensor(13, 11, 7);
+    math::FillNormal(tensor.GetSubTensor({ 1, 1, 1 }, { 5, 4, 3 }), seed, ElementType{ 1 }, ElementType{ 2 });
+    math::RowMatrix<ElementType> narrow(400, 3);
+    math::FillNormal(narrow, seed, ElementType{ 1 }, ElementType{ 2 });
+    math::ChannelColumnRowTensor<ElementType> channels(9, 8, 3);
+    math::FillNormal(channels, seed, ElementType{ 1 }, ElementType{ 2 });
+    bool layoutOk = true;
+    for (size_t i = 0; i < 400; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+        {
+            layoutOk = layoutOk && narrow(i, j) == normal[i * 3 + j];
+        }
+    }
+    for (size_t i = 0; i < 9; ++i)
+    {
+        for (size_t j = 0; j < 8; ++j)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                layoutOk = layoutOk && channels(i, j, k) == normal[(i * 8 + j) * 3 + k];
+            }
+        }
+    }
+    for (size_t i = 0; i < 1001; ++i)
+    {
+        layoutOk = layoutOk && strided[i] == normal[i];
+    }
+    for (size_t j = 0; j < 301; ++j)
+    {
+        for (size_t i = 0; i < 5; ++i)
+        {
+            layoutOk = layoutOk && subMatrix(i, j) == normal[j * 5 + i];
+        }
+    }
+    for (size_t i = 0; i < 5; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                layoutOk = layoutOk && tensor(1 + i, 1 + j, 1 + k) == normal[(i * 4 + j) * 3 + k];
+            }
+        }
+    }
+
+    testing::ProcessTest("Philox4x32 known answers", knownAnswerOk);
+    testing::ProcessTest("FillUniform", uniformOk);
+    testing::ProcessTest("FillNormal", normalOk);
+    testing::ProcessTest("FillNormal memory order", layoutOk);
+}
+
+
+template <typename ElementType>
+void TestVectorFFT()
+{
+    using ComplexType = std::complex<ElementType>;
+    const double tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-11;
+    auto signal = [](size_t i) { return std::sin(0.37 * i * i + 1.0) + 0.25 * std::cos(1.3 * i); };
+
+    // sizes with every kind of pass: radix 4, 2 and 3, a generic odd prime and a large prime
+    bool complexOk = true;
+    bool realOk = true;
+    for (size_t size : { 1, 2, 3, 8, 12, 30, 64, 77, 97, 256 })
+    {
+        math::ColumnVector<ComplexType> input(size);
+        math::ColumnVector<ElementType> realInput(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = { static_cast<ElementType>(signal(i)), static_cast<ElementType>(signal(i + size)) };
+            realInput[i] = input[i].real();
+        }
+
+        // the definition, in double precision; the error of the FFT grows with the magnitude of the output
+        std::vector<std::complex<double>> expected(size);
+        std::vector<std::complex<double>> expectedReal(size);
+        for (size_t k = 0; k < size; ++k)
+        {
+            for (size_t j = 0; j < size; ++j)
+            {
+                double angle = -2 * math::Constants<double>::pi * static_cast<double>((j * k) % size) / size;
+                std::complex<double> w(std::cos(angle), std::sin(angle));
+                expected[k] += std::complex<double>(input[j].real(), input[j].imag()) * w;
+                expectedReal[k] += static_cast<double>(realInput[j]) * w;
+            }
+        }
+        double scale = tolerance * std::sqrt(static_cast<double>(size)) * 4;
+
+        math::FFTPlan<ElementType> plan(size);
+        math::ColumnVector<ComplexType> output(size);
+        plan.Forward(input, output);
+        for (size_t k = 0; k < size; ++k)
+        {
+            complexOk = complexOk && std::abs(std::complex<double>(output[k].real(), output[k].imag()) - expected[k]) < scale;
+        }
+        plan.Inverse(output, output);
+        for (size_t i = 0; i < size; ++i)
+        {
+            complexOk = complexOk && std::abs(output[i] - input[i]) < tolerance * 4;
+        }
+
+        math::RealFFTPlan<ElementType> realPlan(size);
+        math::ColumnVector<ComplexType> spectrum(realPlan.SpectrumSize());
+        math::ColumnVector<ElementType> roundTrip(size);
+        realPlan.Forward(realInput, spectrum);
+        for (size_t k = 0; k < spectrum.Size(); ++k)
+        {
+            realOk = realOk && std::abs(std::complex<double>(spectrum[k].real(), spectrum[k].imag()) - expectedReal[k]) < scale;
+        }
+        realPlan.Inverse(spectrum, roundTrip);
+        realOk = realOk && roundTrip.IsEqual(realInput, static_cast<ElementType>(tolerance * 4));
+    }
+
+    // a strided vector, the column of a row major matrix in disguise
+    math::ColumnVector<ComplexType> data(24);
+    for (size_t i = 0; i < data.Size(); ++i)
+    {
+        data[i] = { static_cast<ElementType>(signal(i)), 0 };
+    }
+    math::ColumnVector<ComplexType> contiguous(12);
+    math::ColumnVector<ComplexType> strided(24);
+    math::ConstColumnVectorReference<ComplexType> everyOther(data.GetConstDataPointer(), 12, 2);
+    math::ColumnVectorReference<ComplexType> everyOtherOutput(strided.GetDataPointer(), 12, 2);
+    math::ColumnVector<ComplexType> packed(12);
+    for (size_t i = 0; i < 12; ++i)
+    {
+        packed[i] = data[2 * i];
+    }
+    math::FFTPlan<ElementType> plan(12);
+    plan.Forward(packed, contiguous);
+    plan.Forward(everyOther, everyOtherOutput);
+    bool stridedOk = true;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        stridedOk = stridedOk && strided[2 * i] == contiguous[i] && strided[2 * i + 1] == ComplexType{};
+    }
+
+    testing::ProcessTest("FFTPlan", complexOk && stridedOk);
+    testing::ProcessTest("RealFFTPlan", realOk);
+}
+
+template <typename ElementType>
+void TestVectorConvolution()
+{
+    const ElementType tolerance = static_cast<ElementType>(std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-11);
+    auto check = [&](size_t signalSize, size_t kernelSize) {
+        math::RowVector<ElementType> signal(signalSize);
+        math::RowVector<ElementType> kernel(kernelSize);
+        for (size_t i = 0; i < signalSize; ++i)
+        {
+            signal[i] = static_cast<ElementType>(std::sin(0.1 * i) + 0.5 * std::cos(0.77 * i));
+        }
+        for (size_t j = 0; j < kernelSize; ++j)
+        {
+            kernel[j] = static_cast<ElementType>(std::exp(-0.05 * j) * std::cos(0.3 * j));
+        }
+
+        size_t outputSize = signalSize + kernelSize - 1;
+        math::RowVector<ElementType> expectedConvolution(outputSize);
+        math::RowVector<ElementType> expectedCorrelation(outputSize);
+        for (size_t i = 0; i < outputSize; ++i)
+        {
+            double convolution = 0;
+            double correlation = 0;
+            for (size_t j = 0; j < kernelSize; ++j)
+            {
+                if (i >= j && i - j < signalSize)
+                {
+                    convolution += static_cast<double>(kernel[j]) * signal[i - j];
+                }
+                if (i + j + 1 >= kernelSize && i + j + 1 - kernelSize < signalSize)
+                {
+                    correlation += static_cast<double>(kernel[j]) * signal[i + j + 1 - kernelSize];
+                }
+            }
+            expectedConvolution[i] = static_cast<ElementType>(convolution);
+            expectedCorrelation[i] = static_cast<ElementType>(correlation);
+        }
+
+        math::RowVector<ElementType> direct(outputSize);
+        math::RowVector<ElementType> fft(outputSize);
+        math::RowVector<ElementType> automatic(outputSize);
+        math::Convolve<math::ConvolutionMethod::direct>(signal, kernel, direct);
+        math::Convolve<math::ConvolutionMethod::fft>(signal, kernel, fft);
+        math::Convolve(signal, kernel, automatic);
+        bool ok = direct.IsEqual(expectedConvolution, tolerance) && fft.IsEqual(expectedConvolution, tolerance * 10) && automatic.IsEqual(expectedConvolution, tolerance * 10);
+
+        math::Correlate<math::ConvolutionMethod::direct>(signal, kernel, direct);
+        math::Correlate<math::ConvolutionMethod::fft>(signal, kernel, fft);
+        return ok && direct.IsEqual(expectedCorrelation, tolerance) && fft.IsEqual(expectedCorrelation, tolerance * 10);
+    };
+
+    bool sizeThrows = false;
+    try
+    {
+        math::RowVector<ElementType> signal(10);
+        math::RowVector<ElementType> kernel(3);
+        math::RowVector<ElementType> output(10);
+        math::Convolve(signal, kernel, output);
+    }
+    catch (const utilities::InputException&)
+    {
+        sizeThrows = true;
+    }
+
+    // one block, many blocks, a single tap, and a kernel longer than the signal
+    testing::ProcessTest("Convolve and Correlate", check(300, 5) && check(3000, 70) && check(1000, 1) && check(20, 90) && sizeThrows);
+}
+
+template <typename ElementType>
+void TestKrylovSolvers()
+{
+    // tridiagonal operators y[i] = lower * x[i - 1] + diagonal[i] * x[i] + upper * x[i + 1], which are never stored as a matrix
+    const size_t size = 300;
+    auto makeOperator = [](std::vector<ElementType> diagonal, ElementType lower, ElementType upper) {
+        return [=](math::ConstColumnVectorReference<ElementType> x, math::ColumnVectorReference<ElementType> y) {
+            size_t n = x.Size();
+            for (size_t i = 0; i < n; ++i)
+            {
+                ElementType sum = diagonal[i] * x[i];
+                if (i > 0)
+                {
+                    sum += lower * x[i - 1];
+                }
+                if (i + 1 < n)
+                {
+                    sum += upper * x[i + 1];
+                }
+                y[i] = sum;
+            }
+        };
+    };
+    std::vector<ElementType> spdDiagonal(size);
+    std::vector<ElementType> indefiniteDiagonal(size);
+    std::vector<ElementType> nonsymmetricDiagonal(size, 4);
+    for (size_t i = 0; i < size; ++i)
+    {
+        spdDiagonal[i] = static_cast<ElementType>(2.5 + 40.0 * (i % 5));
+        indefiniteDiagonal[i] = static_cast<ElementType>(i % 2 == 0 ? 3.0 + 0.01 * i : -3.0 - 0.01 * i);
+    }
+    auto spdOperator = makeOperator(spdDiagonal, -1, -1);
+    auto indefiniteOperator = makeOperator(indefiniteDiagonal, -1, -1);
+    auto nonsymmetricOperator = makeOperator(nonsymmetricDiagonal, static_cast<ElementType>(-1.8), static_cast<ElementType>(-0.2));
+    auto jacobi = [&](math::ConstColumnVectorReference<ElementType> r, math::ColumnVectorReference<ElementType> z) {
+        for (size_t i = 0; i < r.Size(); ++i)
+        {
+            z[i] = r[i] / spdDiagonal[i];
+        }
+    };
+
+    math::ColumnVector<ElementType> b(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        b[i] = static_cast<ElementType>(std::sin(0.37 * i) + 0.25);
+    }
+
+    math::KrylovSolverParameters parameters;
+    parameters.tolerance = std::is_same<ElementType, float>::value ? 1.0e-4 : 1.0e-10;
+    parameters.restart = 20;
+    auto relativeResidual = [&](auto& linearOperator, const math::ColumnVector<ElementType>& x) {
+        math::ColumnVector<ElementType> r(size);
+        linearOperator(x, r);
+        double sum = 0;
+        double bSum = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            sum += (static_cast<double>(b[i]) - r[i]) * (static_cast<double>(b[i]) - r[i]);
+            bSum += static_cast<double>(b[i]) * b[i];
+        }
+        return std::sqrt(sum / bSum);
+    };
+    auto solved = [&](const math::KrylovSolverResult& result, double residual) {
+        return result.converged && residual <= 10 * parameters.tolerance;
+    };
+
+    // one workspace serves every solve, and keeps its vectors between solves of the same size
+    math::KrylovWorkspace<ElementType> workspace;
+    math::ColumnVector<ElementType> x(size);
+    auto cg = math::SolveConjugateGradient(spdOperator, b, x, parameters);
+    bool cgOk = solved(cg, relativeResidual(spdOperator, x));
+    x.Reset();
+    auto pcg = math::SolveConjugateGradient(spdOperator, b, x, jacobi, parameters, workspace);
+    bool pcgOk = solved(pcg, relativeResidual(spdOperator, x)) && pcg.numIterations < cg.numIterations;
+    x.Reset();
+    auto minres = math::SolveMinres(indefiniteOperator, b, x, math::IdentityPreconditioner(), parameters, workspace);
+    bool minresOk = solved(minres, relativeResidual(indefiniteOperator, x));
+    x.Reset();
+    auto pminres = math::SolveMinres(spdOperator, b, x, jacobi, parameters, workspace);
+    minresOk = minresOk && pminres.converged && relativeResidual(spdOperator, x) <= 1000 * parameters.tolerance;
+
+    // short cycles, so that the solve restarts
+    math::KrylovSolverParameters gmresParameters = parameters;
+    gmresParameters.restart = 4;
+    x.Reset();
+    auto gmres = math::SolveGmres(nonsymmetricOperator, b, x, math::IdentityPreconditioner(), gmresParameters, workspace);
+    bool gmresOk = solved(gmres, relativeResidual(nonsymmetricOperator, x)) && gmres.numIterations > gmresParameters.restart;
+    const ElementType* pWorkspace = workspace.GetVectors(size, 1)[0].GetConstDataPointer();
+
+    // a warm start from the solution needs no iterations, and a second solve of the same size allocates nothing
+    auto warm = math::SolveGmres(nonsymmetricOperator, b, x, math::IdentityPreconditioner(), gmresParameters, workspace);
+    gmresOk = gmresOk && warm.converged && warm.numIterations == 0;
+    x.Reset();
+    auto again = math::SolveGmres(nonsymmetricOperator, b, x, math::IdentityPreconditioner(), gmresParameters, workspace);
+    gmresOk = gmresOk && again.numIterations == gmres.numIterations;
+    bool reused = workspace.GetVectors(size, 1)[0].GetConstDataPointer() == pWorkspace;
+
+    // a badly scaled nonsymmetric operator that the Jacobi preconditioner scales back; with the preconditioner on the
+    // right, the solution must still have a small residual in the original system
+    auto scaledOperator = makeOperator(spdDiagonal, static_cast<ElementType>(-1.8), static_cast<ElementType>(-0.2));
+    x.Reset();
+    auto unpreconditioned = math::SolveGmres(scaledOperator, b, x, math::IdentityPreconditioner(), gmresParameters, workspace);
+    x.Reset();
+    auto pgmres = math::SolveGmres(scaledOperator, b, x, jacobi, gmresParameters, workspace);
+    bool pgmresOk = solved(pgmres, relativeResidual(scaledOperator, x)) && pgmres.numIterations < unpreconditioned.numIterations;
+
+    bool sizeThrows = false;
+    try
+    {
+        math::ColumnVector<ElementType> wrongSize(size + 1);
+        math::SolveConjugateGradient(spdOperator, b, wrongSize, parameters);
+    }
+    catch (const utilities::InputException&)
+    {
+        sizeThrows = true;
+    }
+
+    testing::ProcessTest("Krylov solvers", cgOk && pcgOk && minresOk && gmresOk && pgmresOk && reused && sizeThrows);
+}
+
 #pragma endregion implementation
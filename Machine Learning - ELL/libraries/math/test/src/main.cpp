@@ -9,6 +9,7 @@
 #include "Vector_test.h"
 #include "Matrix_test.h"
 #include "Tensor_test.h"
+#include "MappedFile_test.h"
 
 using namespace ell;
 
@@ -24,12 +25,32 @@ void RunVectorTests()
     TestVectorNorm2<ElementType>();
     TestVectorNorm2Squared<ElementType>();
     TestVectorToArray<ElementType>();
+    TestVectorTransformKernels<ElementType>();
+    TestVectorTransformKernelAccuracy<ElementType>();
+    TestVectorSoftmax<ElementType>();
+    TestVectorConversions<ElementType>();
+    TestVectorRandomFill<ElementType>();
+    TestVectorFFT<ElementType>();
+    TestVectorConvolution<ElementType>();
+    TestKrylovSolvers<ElementType>();
 }
 
 template <typename ElementType, math::MatrixLayout layout>
 void RunLayoutMatrixTests()
 {
     TestMatrixNumRows<ElementType, layout>();
+    TestMatrixSoftmax<ElementType, layout>();
+    TestMatrixMultiplyScaleAddUpdateImplementations<ElementType, layout>();
+    TestPackedMatrix<ElementType, layout>();
+    TestMatrixBroadcast<ElementType, layout>();
+    TestMatrixNormalization<ElementType, layout>();
+    TestMatrixPairwiseDistances<ElementType, layout>();
+    TestMatrixTopK<ElementType, layout>();
+    TestMatrixMultiplyTransposeScaleAddUpdate<ElementType, layout>();
+    TestStructuredMatrices<ElementType, layout>();
+    TestBlockSparseMatrix<ElementType, layout>();
+    TestLowRankMatrix<ElementType, layout>();
+    TestBinaryMatrix<ElementType, layout>();
 }
 
 template <typename ElementType>
@@ -37,6 +58,7 @@ void RunMatrixTests()
 {
     RunLayoutMatrixTests<ElementType, math::MatrixLayout::columnMajor>();
     RunLayoutMatrixTests<ElementType, math::MatrixLayout::rowMajor>();
+    TestKMeans<ElementType>();
 }
 
 
@@ -44,6 +66,14 @@ template <typename ElementType, math::Dimension dimension0, math::Dimension dime
 void RunLayoutTensorTests()
 {
     TestTensorIndexer<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorScaleAddActivationUpdate<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorBatchOperations<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorBroadcast<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorReductions<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorBatchNormalization<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorResize<ElementType, dimension0, dimension1, dimension2>();
+    TestTensorConcatenation<ElementType, dimension0, dimension1, dimension2>();
+    TestPaddedTensor<ElementType, dimension0, dimension1, dimension2>();
 }
 
 template <typename ElementType>
@@ -51,6 +81,18 @@ void RunTensorTests()
 {
     RunLayoutTensorTests<ElementType, math::Dimension::column, math::Dimension::row, math::Dimension::channel>();
     RunLayoutTensorTests<ElementType, math::Dimension::channel, math::Dimension::column, math::Dimension::row>();
+    TestTensorCopyFromPermutations<ElementType>();
+    TestTensorConversions<ElementType>();
+}
+
+template <typename ElementType>
+void RunMappedFileTests()
+{
+    TestMappedFileMatrix<ElementType, math::MatrixLayout::columnMajor>();
+    TestMappedFileMatrix<ElementType, math::MatrixLayout::rowMajor>();
+    TestMappedFileTensor<ElementType, math::Dimension::column, math::Dimension::row, math::Dimension::channel>();
+    TestMappedFileTensor<ElementType, math::Dimension::channel, math::Dimension::column, math::Dimension::row>();
+    TestMappedFileCorruptHeader<ElementType>();
 }
 
 int main()
@@ -60,10 +102,15 @@ int main()
 
     RunMatrixTests<float>();
     RunMatrixTests<double>();
+    TestImplementationThresholds();
+    TestPopcountKernels();
 
     RunTensorTests<float>();
     RunTensorTests<double>();
 
+    RunMappedFileTests<float>();
+    RunMappedFileTests<double>();
+
 
     if (testing::DidTestFail())
     {
@@ -0,0 +1,249 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/microsoft/ELL/blob/master/libraries/math/tools/calibrateMath/src/main.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+// Measures the native, blocked and (when available) BLAS implementations of the matrix-matrix and
+// matrix-vector products on this host, and the direct and FFT convolutions, and writes the sizes at which
+// ImplementationType::automatic and ConvolutionMethod::automatic should switch between them. Point the
+// ELL_MATH_THRESHOLDS environment variable at the output file to use it.
+
+#include <math/include/Convolution.h>
+#include <math/include/ImplementationThresholds.h>
+#include <math/include/Matrix.h>
+#include <math/include/MatrixOperations.h>
+#include <math/include/Vector.h>
+
+#include <utilities/include/CommandLineParser.h>
+#include <utilities/include/Exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ell;
+
+namespace
+{
+    struct CalibrationArguments
+    {
+        std::string outputFilepath;
+        size_t repetitions;
+        size_t maxMatrixMatrixSize;
+        size_t maxMatrixVectorSize;
+        size_t maxKernelSize;
+        bool verbose;
+    };
+
+    // the median time of a number of runs, in seconds
+    double TimeMedian(const std::function<void()>& function, size_t repetitions)
+    {
+        function(); // warm the caches and the thread pool
+        std::vector<double> times;
+        for (size_t r = 0; r < repetitions; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            auto stop = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double>(stop - start).count());
+        }
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2];
+    }
+
+    // the smallest measured size from which the challenger is faster at every larger measured size
+    size_t FindCrossover(const std::vector<size_t>& sizes, const std::vector<double>& baselineTimes, const std::vector<double>& challengerTimes)
+    {
+        size_t crossover = math::ImplementationThresholds::never;
+        for (size_t index = sizes.size(); index > 0; --index)
+        {
+            if (challengerTimes[index - 1] >= baselineTimes[index - 1])
+            {
+                break;
+            }
+            crossover = sizes[index - 1];
+        }
+        return crossover;
+    }
+
+    std::vector<size_t> GetDimensions(size_t maxDimension)
+    {
+        std::vector<size_t> dimensions;
+        for (size_t dimension = 8; dimension <= maxDimension; dimension += (dimension / 2 + 3) / 4 * 2)
+        {
+            dimensions.push_back(dimension);
+        }
+        return dimensions;
+    }
+
+#if USE_BLAS
+    constexpr bool isBlasAvailable = true;
+#else
+    constexpr bool isBlasAvailable = false;
+#endif
+
+    template <math::ImplementationType implementation>
+    double TimeMatrixMatrix(size_t dimension, size_t repetitions)
+    {
+        math::RowMatrix<float> A(dimension, dimension);
+        math::RowMatrix<float> B(dimension, dimension);
+        math::RowMatrix<float> C(dimension, dimension);
+        A.Fill(1.0f);
+        B.Fill(0.5f);
+        return TimeMedian([&]() { math::MultiplyScaleAddUpdate<implementation>(1.0f, A, B, 0.0f, C); }, repetitions);
+    }
+
+    template <math::ImplementationType implementation>
+    double TimeMatrixVector(size_t dimension, size_t repetitions)
+    {
+        math::RowMatrix<float> M(dimension, dimension);
+        math::ColumnVector<float> x(dimension);
+        math::ColumnVector<float> y(dimension);
+        M.Fill(1.0f);
+        x.Fill(0.5f);
+        return TimeMedian([&]() { math::MultiplyScaleAddUpdate<implementation>(1.0f, M, x, 0.0f, y); }, repetitions);
+    }
+
+    // the thresholds for one kind of product: blocked takes over from native, and BLAS from the faster of the two
+    template <double (*timeNative)(size_t, size_t), double (*timeBlocked)(size_t, size_t), double (*timeBlas)(size_t, size_t)>
+    void CalibrateProduct(const std::string& name, size_t maxDimension, size_t power, const CalibrationArguments& arguments, size_t& blockedThreshold, size_t& blasThreshold)
+    {
+        std::vector<size_t> sizes;
+        std::vector<double> nativeTimes;
+        std::vector<double> blockedTimes;
+        std::vector<double> blasTimes;
+        for (auto dimension : GetDimensions(maxDimension))
+        {
+            size_t size = 1;
+            for (size_t p = 0; p < power; ++p)
+            {
+                size *= dimension;
+            }
+            sizes.push_back(size);
+            nativeTimes.push_back(timeNative(dimension, arguments.repetitions));
+            blockedTimes.push_back(timeBlocked(dimension, arguments.repetitions));
+            blasTimes.push_back(isBlasAvailable ? timeBlas(dimension, arguments.repetitions) : 0.0);
+
+            if (arguments.verbose)
+            {
+                std::cout << name << " " << dimension << ": native " << nativeTimes.back() * 1e6 << "us, blocked " << blockedTimes.back() * 1e6 << "us";
+                if (isBlasAvailable)
+                {
+                    std::cout << ", blas " << blasTimes.back() * 1e6 << "us";
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        blockedThreshold = FindCrossover(sizes, nativeTimes, blockedTimes);
+        blasThreshold = math::ImplementationThresholds::never;
+        if (isBlasAvailable)
+        {
+            std::vector<double> bestTimes(sizes.size());
+            for (size_t index = 0; index < sizes.size(); ++index)
+            {
+                bestTimes[index] = sizes[index] >= blockedThreshold ? blockedTimes[index] : nativeTimes[index];
+            }
+            blasThreshold = FindCrossover(sizes, bestTimes, blasTimes);
+        }
+    }
+
+    template <math::ConvolutionMethod method>
+    double TimeConvolution(size_t kernelSize, size_t repetitions)
+    {
+        const size_t signalSize = 1 << 16;
+        math::RowVector<float> signal(signalSize);
+        math::RowVector<float> kernel(kernelSize);
+        math::RowVector<float> output(signalSize + kernelSize - 1);
+        signal.Fill(1.0f);
+        kernel.Fill(0.5f);
+        return TimeMedian([&]() { math::Convolve<method>(signal, kernel, output); }, repetitions);
+    }
+
+    // the kernel size from which the FFT convolution is faster than the direct one
+    size_t CalibrateConvolution(const CalibrationArguments& arguments)
+    {
+        std::vector<size_t> sizes;
+        std::vector<double> directTimes;
+        std::vector<double> fftTimes;
+        for (size_t kernelSize = 4; kernelSize <= arguments.maxKernelSize; kernelSize *= 2)
+        {
+            sizes.push_back(kernelSize);
+            directTimes.push_back(TimeConvolution<math::ConvolutionMethod::direct>(kernelSize, arguments.repetitions));
+            fftTimes.push_back(TimeConvolution<math::ConvolutionMethod::fft>(kernelSize, arguments.repetitions));
+            if (arguments.verbose)
+            {
+                std::cout << "convolution " << kernelSize << ": direct " << directTimes.back() * 1e6 << "us, fft " << fftTimes.back() * 1e6 << "us" << std::endl;
+            }
+        }
+        return FindCrossover(sizes, directTimes, fftTimes);
+    }
+
+    std::string FormatThreshold(size_t threshold)
+    {
+        return threshold == math::ImplementationThresholds::never ? "never" : std::to_string(threshold);
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CalibrationArguments arguments;
+        utilities::CommandLineParser commandLineParser(argc, argv);
+        commandLineParser.AddOption(arguments.outputFilepath, "outputFilename", "o", "Path of the thresholds file to write", "mathThresholds.txt");
+        commandLineParser.AddOption(arguments.repetitions, "repetitions", "r", "Number of timed runs per measurement (the median is used)", 7);
+        commandLineParser.AddOption(arguments.maxMatrixMatrixSize, "maxMatrixMatrixSize", "mm", "Largest matrix dimension timed for matrix-matrix products", 512);
+        commandLineParser.AddOption(arguments.maxMatrixVectorSize, "maxMatrixVectorSize", "mv", "Largest matrix dimension timed for matrix-vector products", 4096);
+        commandLineParser.AddOption(arguments.maxKernelSize, "maxKernelSize", "k", "Largest kernel size timed for convolutions", 1024);
+        commandLineParser.AddOption(arguments.verbose, "verbose", "v", "Print the measurements", false);
+        commandLineParser.Parse();
+
+        if (arguments.repetitions == 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "repetitions must be positive");
+        }
+
+        math::ImplementationThresholds thresholds;
+        CalibrateProduct<TimeMatrixMatrix<math::ImplementationType::native>, TimeMatrixMatrix<math::ImplementationType::blocked>, TimeMatrixMatrix<math::ImplementationType::openBlas>>("matrix-matrix", arguments.maxMatrixMatrixSize, 3, arguments, thresholds.matrixMatrixBlocked, thresholds.matrixMatrixBlas);
+        CalibrateProduct<TimeMatrixVector<math::ImplementationType::native>, TimeMatrixVector<math::ImplementationType::blocked>, TimeMatrixVector<math::ImplementationType::openBlas>>("matrix-vector", arguments.maxMatrixVectorSize, 2, arguments, thresholds.matrixVectorBlocked, thresholds.matrixVectorBlas);
+
+        thresholds.convolutionFFT = CalibrateConvolution(arguments);
+
+        math::WriteImplementationThresholds(arguments.outputFilepath, thresholds);
+        std::cout << "matrixMatrixBlocked = " << FormatThreshold(thresholds.matrixMatrixBlocked) << std::endl;
+        std::cout << "matrixMatrixBlas = " << FormatThreshold(thresholds.matrixMatrixBlas) << std::endl;
+        std::cout << "matrixVectorBlocked = " << FormatThreshold(thresholds.matrixVectorBlocked) << std::endl;
+        std::cout << "matrixVectorBlas = " << FormatThreshold(thresholds.matrixVectorBlas) << std::endl;
+        std::cout << "convolutionFFT = " << FormatThreshold(thresholds.convolutionFFT) << std::endl;
+        std::cout << "Wrote " << arguments.outputFilepath << ", set " << math::implementationThresholdsVariable << " to this path to use it" << std::endl;
+
+        return 0;
+    }
+    catch (const utilities::CommandLineParserPrintHelpException& exception)
+    {
+        std::cout << exception.GetHelpText() << std::endl;
+        return 0;
+    }
+    catch (const utilities::CommandLineParserErrorException& exception)
+    {
+        std::cerr << "Command line parse error:" << std::endl;
+        for (const auto& error : exception.GetParseErrors())
+        {
+            std::cerr << error.GetMessage() << std::endl;
+        }
+        return 1;
+    }
+    catch (const utilities::Exception& exception)
+    {
+        std::cerr << "exception: " << exception.GetMessage() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/Microsoft/ELL/blob/master/libraries/utilities/include/ThreadPool.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ell
+{
+    namespace utilities
+    {
+        /**
+         * A fixed size pool of worker threads. The thread that calls ParallelFor also works on the
+         * loop, so a pool with a single thread has no workers and runs everything inline, and a
+         * ParallelFor called from inside another ParallelFor cannot deadlock.
+        */
+        class ThreadPool
+        {
+            public:
+                /* Creates a pool in which numThreads threads (including the caller) share the work */
+                explicit ThreadPool(size_t numThreads);
+
+                ThreadPool(const ThreadPool&) = delete;
+                ThreadPool& operator=(const ThreadPool&) = delete;
+                ~ThreadPool();
+
+                /* Gets the number of threads that work on a ParallelFor, including the caller */
+                size_t NumThreads() const { return _workers.size() + 1; }
+
+                /**
+                 * Splits [0, count) into contiguous blocks of at least grainSize indices, calls
+                 * function(begin, end) for every block and waits until all blocks are done. The first
+                 * exception thrown by a block is rethrown on the calling thread.
+                */
+                template <typename FunctionType>
+                void ParallelFor(size_t count, size_t grainSize, FunctionType&& function);
+
+            private:
+                void Enqueue(std::function<void()> task);
+                void WorkerLoop();
+
+                std::vector<std::thread> _workers;
+                std::queue<std::function<void()>> _tasks;
+                std::mutex _mutex;
+                std::condition_variable _condition;
+                bool _stop = false;
+        };
+
+        /* Gets the process wide pool, sized to the number of hardware threads */
+        ThreadPool& GetThreadPool();
+
+        /* Runs a ParallelFor on the process wide pool */
+        template <typename FunctionType>
+        void ParallelFor(size_t count, size_t grainSize, FunctionType&& function);
+    }
+}
+
+#pragma region implementation
+
+namespace ell
+{
+    namespace utilities
+    {
+        template <typename FunctionType>
+        void ThreadPool::ParallelFor(size_t count, size_t grainSize, FunctionType&& function)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            grainSize = std::max<size_t>(grainSize, 1);
+            size_t numBlocks = std::min((count + grainSize - 1) / grainSize, 4 * NumThreads());
+            if (numBlocks <= 1 || _workers.empty())
+            {
+                function(size_t{ 0 }, count);
+                return;
+            }
+            size_t blockSize = (count + numBlocks - 1) / numBlocks;
+            numBlocks = (count + blockSize - 1) / blockSize;
+
+            struct LoopState
+            {
+                std::atomic<size_t> nextBlock{ 0 };
+                std::atomic<size_t> doneBlocks{ 0 };
+                std::mutex mutex;
+                std::condition_variable condition;
+                std::exception_ptr error;
+            };
+            auto state = std::make_shared<LoopState>();
+
+            // helpers that start after every block has been claimed return without touching the function
+            auto runBlocks = [state, numBlocks, blockSize, count, &function]() {
+                for (;;)
+                {
+                    size_t block = state->nextBlock++;
+                    if (block >= numBlocks)
+                    {
+                        return;
+                    }
+
+                    try
+                    {
+                        function(block * blockSize, std::min(count, (block + 1) * blockSize));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!state->error)
+                        {
+                            state->error = std::current_exception();
+                        }
+                    }
+
+                    if (++state->doneBlocks == numBlocks)
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->condition.notify_all();
+                    }
+                }
+            };
+
+            size_t numHelpers = std::min(numBlocks - 1, _workers.size());
+            for (size_t i = 0; i < numHelpers; ++i)
+            {
+                Enqueue(runBlocks);
+            }
+            runBlocks();
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->condition.wait(lock, [&state, numBlocks] { return state->doneBlocks == numBlocks; });
+            if (state->error)
+            {
+                std::rethrow_exception(state->error);
+            }
+        }
+
+        template <typename FunctionType>
+        void ParallelFor(size_t count, size_t grainSize, FunctionType&& function)
+        {
+            GetThreadPool().ParallelFor(count, grainSize, std::forward<FunctionType>(function));
+        }
+    }
+}
+
+#pragma endregion implementation
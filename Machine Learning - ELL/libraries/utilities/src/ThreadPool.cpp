@@ -0,0 +1,70 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/Microsoft/ELL/blob/master/libraries/utilities/src/ThreadPool.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "ThreadPool.h"
+
+namespace ell
+{
+    namespace utilities
+    {
+        ThreadPool::ThreadPool(size_t numThreads)
+        {
+            for (size_t i = 1; i < numThreads; ++i)
+            {
+                _workers.emplace_back([this] { WorkerLoop(); });
+            }
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (auto& worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::Enqueue(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push(std::move(task));
+            }
+            _condition.notify_one();
+        }
+
+        void ThreadPool::WorkerLoop()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                    if (_stop && _tasks.empty())
+                    {
+                        return;
+                    }
+                    task = std::move(_tasks.front());
+                    _tasks.pop();
+                }
+                task();
+            }
+        }
+
+        ThreadPool& GetThreadPool()
+        {
+            static ThreadPool threadPool(std::max<size_t>(std::thread::hardware_concurrency(), 1));
+            return threadPool;
+        }
+    }
+}
@@ -0,0 +1,16 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/Microsoft/ELL/blob/master/libraries/utilities/test/include/ThreadPool_test.h
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#pragma once
+
+namespace ell
+{
+    void TestThreadPoolParallelFor();
+    void TestThreadPoolNestedParallelFor();
+    void TestThreadPoolException();
+}
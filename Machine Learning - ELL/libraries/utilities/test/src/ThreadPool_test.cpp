@@ -0,0 +1,73 @@
+/**
+ * Microsoft - Modern Information Technology
+ * https://github.com/Microsoft/ELL/blob/master/libraries/utilities/test/src/ThreadPool_test.cpp
+ *
+ *  Created on: Oct 19, 2019
+ *  Student (MIG Virtual Developer): Tung Dang
+ */
+
+#include "utilities/test/include/ThreadPool_test.h"
+
+#include <testing/include/testing.h>
+#include <utilities/include/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace ell
+{
+    void TestThreadPoolParallelFor()
+    {
+        utilities::ThreadPool threadPool(4);
+        std::vector<int> visits(1000, 0);
+        threadPool.ParallelFor(visits.size(), 16, [&visits](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                visits[i] += 1;
+            }
+        });
+
+        bool passed = std::all_of(visits.begin(), visits.end(), [](int count) { return count == 1; });
+        testing::ProcessTest("utilities::ThreadPool::ParallelFor", passed);
+    }
+
+    void TestThreadPoolNestedParallelFor()
+    {
+        utilities::ThreadPool threadPool(3);
+        std::atomic<size_t> sum{ 0 };
+        threadPool.ParallelFor(8, 1, [&threadPool, &sum](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                threadPool.ParallelFor(100, 1, [&sum](size_t innerBegin, size_t innerEnd) {
+                    sum += innerEnd - innerBegin;
+                });
+            }
+        });
+
+        testing::ProcessTest("utilities::ThreadPool::ParallelFor nested", sum == 800);
+    }
+
+    void TestThreadPoolException()
+    {
+        utilities::ThreadPool threadPool(4);
+        bool caught = false;
+        try
+        {
+            threadPool.ParallelFor(100, 1, [](size_t begin, size_t end) {
+                if (begin <= 50 && 50 < end)
+                {
+                    throw std::runtime_error("block failed");
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+
+        testing::ProcessTest("utilities::ThreadPool::ParallelFor exception", caught);
+    }
+}
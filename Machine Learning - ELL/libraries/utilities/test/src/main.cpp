@@ -9,6 +9,7 @@
 #include "utilities/test/include/Files_test.h"
 #include "utilities/test/include/Iterator_test.h"
 #include "utilities/test/include/Hash_test.h"
+#include "utilities/test/include/ThreadPool_test.h"
 
 #include <testing/include/testing.h>
 
@@ -35,6 +36,10 @@ int main(int argc, char const *argv[])
         TestParallelTransformIterator();
         TestStlStridedIterator();
 
+        TestThreadPoolParallelFor();
+        TestThreadPoolNestedParallelFor();
+        TestThreadPoolException();
+
         TestStringf();
         TestJoinPaths(basePath);
         #ifdef WIN32